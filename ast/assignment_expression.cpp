@@ -18,6 +18,7 @@
  */
 
 #include "assignment_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -29,4 +30,22 @@ void AssignmentExpression::dump(util::DumpTree *dumpNode, util::DumpState &state
     state.setSimple(dumpNode, "beforeEqualComments", beforeEqualComments);
     state.setPointer(dumpNode, "rhs", rhs);
 }
+
+void AssignmentExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::AssignmentExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(lhs);
+    visitor.visitComments(beforeEqualComments);
+    visitor.visitNode(rhs);
+}
+
+AssignmentExpression *AssignmentExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *lhs = reader.readNode<Expression>();
+    auto beforeEqualComments = reader.readComments();
+    auto *rhs = reader.readNode<Expression>();
+    return reader.create<AssignmentExpression>(locationRange, lhs, beforeEqualComments, rhs);
+}
 }
@@ -18,9 +18,23 @@
  */
 
 #include "binary_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
+namespace
+{
+template <typename T>
+T *deserializeBinaryExpression(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *lhs = reader.readNode<Expression>();
+    auto beforeOperatorComments = reader.readComments();
+    auto *rhs = reader.readNode<Expression>();
+    return reader.create<T>(locationRange, lhs, beforeOperatorComments, rhs);
+}
+}
+
 void BinaryExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     Expression::dump(dumpNode, state);
@@ -30,111 +44,317 @@ void BinaryExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     state.setPointer(dumpNode, "rhs", rhs);
 }
 
+void BinaryExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    Expression::visitFields(visitor);
+    visitor.visitNode(lhs);
+    visitor.visitComments(beforeOperatorComments);
+    visitor.visitNode(rhs);
+}
+
 void LogicalAndExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::LogicalAndExpression";
 }
 
+void LogicalAndExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::LogicalAndExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+LogicalAndExpression *LogicalAndExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<LogicalAndExpression>(reader);
+}
+
 void LogicalOrExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::LogicalOrExpression";
 }
 
+void LogicalOrExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::LogicalOrExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+LogicalOrExpression *LogicalOrExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<LogicalOrExpression>(reader);
+}
+
 void BitwiseAndExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::BitwiseAndExpression";
 }
 
+void BitwiseAndExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BitwiseAndExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+BitwiseAndExpression *BitwiseAndExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<BitwiseAndExpression>(reader);
+}
+
 void BitwiseOrExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::BitwiseOrExpression";
 }
 
+void BitwiseOrExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BitwiseOrExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+BitwiseOrExpression *BitwiseOrExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<BitwiseOrExpression>(reader);
+}
+
 void BitwiseXorExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::BitwiseXorExpression";
 }
 
+void BitwiseXorExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BitwiseXorExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+BitwiseXorExpression *BitwiseXorExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<BitwiseXorExpression>(reader);
+}
+
 void LeftShiftExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::LeftShiftExpression";
 }
 
+void LeftShiftExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::LeftShiftExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+LeftShiftExpression *LeftShiftExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<LeftShiftExpression>(reader);
+}
+
 void RightShiftExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::RightShiftExpression";
 }
 
+void RightShiftExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::RightShiftExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+RightShiftExpression *RightShiftExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<RightShiftExpression>(reader);
+}
+
 void CompareEqExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::CompareEqExpression";
 }
 
+void CompareEqExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CompareEqExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+CompareEqExpression *CompareEqExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<CompareEqExpression>(reader);
+}
+
 void CompareNEExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::CompareNEExpression";
 }
 
+void CompareNEExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CompareNEExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+CompareNEExpression *CompareNEExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<CompareNEExpression>(reader);
+}
+
 void CompareLEExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::CompareLEExpression";
 }
 
+void CompareLEExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CompareLEExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+CompareLEExpression *CompareLEExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<CompareLEExpression>(reader);
+}
+
 void CompareGEExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::CompareGEExpression";
 }
 
+void CompareGEExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CompareGEExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+CompareGEExpression *CompareGEExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<CompareGEExpression>(reader);
+}
+
 void CompareLTExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::CompareLTExpression";
 }
 
+void CompareLTExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CompareLTExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+CompareLTExpression *CompareLTExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<CompareLTExpression>(reader);
+}
+
 void CompareGTExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::CompareGTExpression";
 }
 
+void CompareGTExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CompareGTExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+CompareGTExpression *CompareGTExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<CompareGTExpression>(reader);
+}
+
 void AddExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::AddExpression";
 }
 
+void AddExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::AddExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+AddExpression *AddExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<AddExpression>(reader);
+}
+
 void SubExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::SubExpression";
 }
 
+void SubExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::SubExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+SubExpression *SubExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<SubExpression>(reader);
+}
+
 void MulExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::MulExpression";
 }
 
+void MulExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::MulExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+MulExpression *MulExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<MulExpression>(reader);
+}
+
 void DivExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::DivExpression";
 }
 
+void DivExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::DivExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+DivExpression *DivExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<DivExpression>(reader);
+}
+
 void RemExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     BinaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::RemExpression";
 }
+
+void RemExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::RemExpression);
+    BinaryExpression::visitFields(visitor);
+}
+
+RemExpression *RemExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeBinaryExpression<RemExpression>(reader);
+}
 }
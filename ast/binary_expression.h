@@ -43,6 +43,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 class LogicalAndExpression final : public BinaryExpression
@@ -56,6 +57,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static LogicalAndExpression *deserialize(SnapshotReader &reader);
 };
 
 class LogicalOrExpression final : public BinaryExpression
@@ -69,6 +72,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static LogicalOrExpression *deserialize(SnapshotReader &reader);
 };
 
 class BitwiseAndExpression final : public BinaryExpression
@@ -82,6 +87,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static BitwiseAndExpression *deserialize(SnapshotReader &reader);
 };
 
 class BitwiseOrExpression final : public BinaryExpression
@@ -95,6 +102,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static BitwiseOrExpression *deserialize(SnapshotReader &reader);
 };
 
 class BitwiseXorExpression final : public BinaryExpression
@@ -108,6 +117,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static BitwiseXorExpression *deserialize(SnapshotReader &reader);
 };
 
 class LeftShiftExpression final : public BinaryExpression
@@ -121,6 +132,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static LeftShiftExpression *deserialize(SnapshotReader &reader);
 };
 
 class RightShiftExpression final : public BinaryExpression
@@ -134,6 +147,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static RightShiftExpression *deserialize(SnapshotReader &reader);
 };
 
 class CompareEqExpression final : public BinaryExpression
@@ -147,6 +162,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static CompareEqExpression *deserialize(SnapshotReader &reader);
 };
 
 class CompareNEExpression final : public BinaryExpression
@@ -160,6 +177,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static CompareNEExpression *deserialize(SnapshotReader &reader);
 };
 
 class CompareLEExpression final : public BinaryExpression
@@ -173,6 +192,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static CompareLEExpression *deserialize(SnapshotReader &reader);
 };
 
 class CompareGEExpression final : public BinaryExpression
@@ -186,6 +207,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static CompareGEExpression *deserialize(SnapshotReader &reader);
 };
 
 class CompareLTExpression final : public BinaryExpression
@@ -199,6 +222,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static CompareLTExpression *deserialize(SnapshotReader &reader);
 };
 
 class CompareGTExpression final : public BinaryExpression
@@ -212,6 +237,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static CompareGTExpression *deserialize(SnapshotReader &reader);
 };
 
 class AddExpression final : public BinaryExpression
@@ -225,6 +252,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static AddExpression *deserialize(SnapshotReader &reader);
 };
 
 class SubExpression final : public BinaryExpression
@@ -238,6 +267,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static SubExpression *deserialize(SnapshotReader &reader);
 };
 
 class MulExpression final : public BinaryExpression
@@ -251,6 +282,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static MulExpression *deserialize(SnapshotReader &reader);
 };
 
 class DivExpression final : public BinaryExpression
@@ -264,6 +297,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static DivExpression *deserialize(SnapshotReader &reader);
 };
 
 class RemExpression final : public BinaryExpression
@@ -277,5 +312,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static RemExpression *deserialize(SnapshotReader &reader);
 };
 }
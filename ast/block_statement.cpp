@@ -18,6 +18,7 @@
  */
 
 #include "block_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -30,4 +31,36 @@ void BlockStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setPointerArray(dumpNode, "statements", statements);
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void BlockStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BlockStatement);
+    Statement::visitFields(visitor);
+    SymbolScope::visitFields(visitor);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(statements);
+    for(auto *statement : statements)
+        visitor.visitNode(statement);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+BlockStatement *BlockStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto beforeLBraceComments = reader.readComments();
+    auto statementCount = reader.readArraySize();
+    std::vector<Statement *> statements;
+    statements.reserve(statementCount);
+    for(std::size_t i = 0; i < statementCount; i++)
+        statements.push_back(reader.readNode<Statement>());
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<BlockStatement>(locationRange,
+                                         symbolLookupChain,
+                                         symbolTable,
+                                         beforeLBraceComments,
+                                         std::move(statements),
+                                         beforeRBraceComments);
+}
 }
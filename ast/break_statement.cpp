@@ -18,6 +18,7 @@
  */
 
 #include "break_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -28,4 +29,21 @@ void BreakStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setSimple(dumpNode, "beforeBreakComments", beforeBreakComments);
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void BreakStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BreakStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeBreakComments);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+BreakStatement *BreakStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeBreakComments = reader.readComments();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<BreakStatement>(
+        locationRange, beforeBreakComments, beforeSemicolonComments);
+}
 }
@@ -0,0 +1,122 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "constant_evaluator.h"
+#include "constant_operators.h"
+#include "../math/bit_vector.h"
+#include "../parse/source.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ast
+{
+class Function;
+
+/** the register-based bytecode that functions are compiled to for compile-time evaluation.
+ * Registers hold math::BitVector values, which are stored inline up to
+ * math::BitVector::maxInlineBitCount bits. */
+namespace bytecode
+{
+enum class Opcode : std::uint8_t
+{
+    /** destination = constants[a] */
+    LoadConstant,
+    /** destination = a */
+    Move,
+    /** destination = a converted to types[b] */
+    Convert,
+    /** destination = a converted to a type that can hold both a and b */
+    Promote,
+    /** destination = a + 1, keeping the type of a */
+    Increment,
+    /** destination = a != 0 */
+    ToBool,
+    /** destination = b a, where b is a constant_operators::UnaryOperator */
+    Unary,
+    /** destination = a c b, where c is a constant_operators::BinaryOperator */
+    Binary,
+    /** destination = cat(a, a + 1, ..., a + b - 1) */
+    Concatenate,
+    /** destination = fill(a, b) */
+    Fill,
+    /** destination = a[b to c], or a[b] if c is noRegister */
+    Slice,
+    /** destination = a matches patterns[b] */
+    MatchPattern,
+    /** jumps to a */
+    Jump,
+    /** jumps to b if a is zero */
+    JumpIfZero,
+    /** jumps to b if a isn't zero */
+    JumpIfNotZero,
+    /** destination = callees[a](b, b + 1, ..., b + c - 1) */
+    Call,
+    /** returns a */
+    Return,
+    /** returns without a value */
+    ReturnVoid,
+};
+
+constexpr std::uint32_t noRegister = ~static_cast<std::uint32_t>(0);
+
+struct Instruction final
+{
+    Opcode opcode;
+    std::uint32_t destination;
+    std::uint32_t a;
+    std::uint32_t b;
+    std::uint32_t c;
+};
+
+/** a number pattern from a match statement: a value matches if it has the bits of value where mask
+ * is set */
+struct NumberPattern final
+{
+    math::BitVector value;
+    /** sign extended, so the bits above value are all set */
+    math::BitVector mask;
+    /** the number of bits needed to hold value */
+    std::size_t valueBitCount;
+};
+
+struct CompiledFunction final
+{
+    const Function *function;
+    /** false if function can't be evaluated at compile time */
+    bool isValid = false;
+    std::size_t registerCount = 0;
+    /** the arguments are passed in the first registers */
+    std::vector<ConstantEvaluator::IntegerTypeInfo> parameterTypes;
+    bool hasReturnType = false;
+    ConstantEvaluator::IntegerTypeInfo returnType{};
+    std::vector<Instruction> instructions;
+    /** where errors in each instruction are reported */
+    std::vector<parse::LocationRange> locations;
+    std::vector<math::BitVector> constants;
+    std::vector<ConstantEvaluator::IntegerTypeInfo> types;
+    std::vector<NumberPattern> patterns;
+    std::vector<const CompiledFunction *> callees;
+    explicit CompiledFunction(const Function *function) noexcept : function(function)
+    {
+    }
+};
+}
+}
@@ -0,0 +1,712 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bytecode_compiler.h"
+#include "assignment_expression.h"
+#include "binary_expression.h"
+#include "block_statement.h"
+#include "break_statement.h"
+#include "cast_expression.h"
+#include "cat_expression.h"
+#include "conditional_expression.h"
+#include "const_statement.h"
+#include "continue_statement.h"
+#include "empty_statement.h"
+#include "enum_statement.h"
+#include "expression_statement.h"
+#include "fill_expression.h"
+#include "for_statement.h"
+#include "function_call_expression.h"
+#include "function_parameter.h"
+#include "function_statement.h"
+#include "if_statement.h"
+#include "let_statement.h"
+#include "let_statement_name.h"
+#include "let_statement_part.h"
+#include "match_pattern.h"
+#include "match_statement.h"
+#include "match_statement_part.h"
+#include "number_expression.h"
+#include "paren_expression.h"
+#include "pop_count_expression.h"
+#include "return_statement.h"
+#include "scoped_id_expression.h"
+#include "slice_expression.h"
+#include "type_statement.h"
+#include "unary_expression.h"
+#include "../parse/parse_error.h"
+#include "../util/memory_usage.h"
+#include <utility>
+
+namespace ast
+{
+using bytecode::Opcode;
+using bytecode::noRegister;
+
+class BytecodeCompiler::FunctionCompiler final
+{
+private:
+    struct Variable final
+    {
+        std::uint32_t registerIndex;
+        std::uint32_t typeIndex;
+    };
+    struct Loop final
+    {
+        std::vector<std::size_t> breakJumps;
+        std::vector<std::size_t> continueJumps;
+    };
+
+private:
+    BytecodeCompiler &compiler;
+    bytecode::CompiledFunction &compiledFunction;
+    std::unordered_map<const Symbol *, Variable> variables;
+    std::vector<Loop> loops;
+    std::uint32_t nextRegister = 0;
+
+private:
+    std::uint32_t allocateRegister()
+    {
+        auto retval = nextRegister++;
+        if(nextRegister > compiledFunction.registerCount)
+            compiledFunction.registerCount = nextRegister;
+        return retval;
+    }
+    std::size_t emit(Opcode opcode,
+                     parse::LocationRange location,
+                     std::uint32_t destination,
+                     std::uint32_t a = 0,
+                     std::uint32_t b = 0,
+                     std::uint32_t c = 0)
+    {
+        compiledFunction.instructions.push_back(
+            bytecode::Instruction{opcode, destination, a, b, c});
+        compiledFunction.locations.push_back(location);
+        return compiledFunction.instructions.size() - 1;
+    }
+    std::uint32_t getNextInstructionIndex() const noexcept
+    {
+        return static_cast<std::uint32_t>(compiledFunction.instructions.size());
+    }
+    /** points the jump at instructionIndex to the next instruction */
+    void patchJump(std::size_t instructionIndex) noexcept
+    {
+        auto &instruction = compiledFunction.instructions[instructionIndex];
+        if(instruction.opcode == Opcode::Jump)
+            instruction.a = getNextInstructionIndex();
+        else
+            instruction.b = getNextInstructionIndex();
+    }
+    std::uint32_t addConstant(math::BitVector value)
+    {
+        compiledFunction.constants.push_back(std::move(value));
+        return static_cast<std::uint32_t>(compiledFunction.constants.size() - 1);
+    }
+    std::uint32_t addType(const ConstantEvaluator::IntegerTypeInfo &type)
+    {
+        for(std::size_t i = 0; i < compiledFunction.types.size(); i++)
+        {
+            auto &existingType = compiledFunction.types[i];
+            if(existingType.kind == type.kind && existingType.bitCount == type.bitCount)
+                return static_cast<std::uint32_t>(i);
+        }
+        compiledFunction.types.push_back(type);
+        return static_cast<std::uint32_t>(compiledFunction.types.size() - 1);
+    }
+    bool getIntegerType(const Type *type, ConstantEvaluator::IntegerTypeInfo &result)
+    {
+        return type && compiler.constantEvaluator.getIntegerType(type, nullptr, result);
+    }
+    bool compileStatements(const std::vector<Statement *> &statements)
+    {
+        for(auto *statement : statements)
+            if(!compileStatement(statement))
+                return false;
+        return true;
+    }
+    bool compileStatement(const Statement *statement);
+    bool compileLoopBody(const Statement *statement, std::uint32_t continueTarget);
+    bool compileMatch(const MatchStatement *matchStatement);
+    /** compiles expression to a new register or, for variables, the variable's register */
+    bool compileExpression(const Expression *expression, std::uint32_t &result);
+    bool compileExpressionInto(const Expression *expression, std::uint32_t destination);
+    bool compileExpressions(const std::vector<const Expression *> &expressions,
+                            std::uint32_t &firstRegister);
+
+public:
+    FunctionCompiler(BytecodeCompiler &compiler,
+                     bytecode::CompiledFunction &compiledFunction) noexcept
+        : compiler(compiler),
+          compiledFunction(compiledFunction)
+    {
+    }
+    bool compile();
+};
+
+bool BytecodeCompiler::FunctionCompiler::compile()
+{
+    auto *function = compiledFunction.function;
+    if(function->templateParameters)
+        return false;
+    std::vector<const FunctionParameter *> parameters;
+    if(function->firstFunctionParameter)
+        parameters.push_back(function->firstFunctionParameter);
+    for(auto &parameter : function->parameters)
+        parameters.push_back(parameter.functionParameter);
+    for(auto *parameter : parameters)
+    {
+        ConstantEvaluator::IntegerTypeInfo type;
+        if(!getIntegerType(parameter->type, type))
+            return false;
+        compiledFunction.parameterTypes.push_back(type);
+        variables[parameter] = Variable{allocateRegister(), addType(type)};
+    }
+    if(function->returnType)
+    {
+        if(!getIntegerType(function->returnType, compiledFunction.returnType))
+            return false;
+        compiledFunction.hasReturnType = true;
+    }
+    if(!compileStatements(function->statements))
+        return false;
+    emit(Opcode::ReturnVoid, function->locationRange, noRegister);
+    return true;
+}
+
+bool BytecodeCompiler::FunctionCompiler::compileStatement(const Statement *statement)
+{
+    auto location = statement->locationRange;
+    if(auto *letStatement = dynamic_cast<const LetStatement *>(statement))
+    {
+        // variables start out as zero
+        std::vector<const LetStatementPart *> parts;
+        parts.push_back(letStatement->firstPart);
+        for(auto &part : letStatement->parts)
+            parts.push_back(part.part);
+        for(auto *part : parts)
+        {
+            ConstantEvaluator::IntegerTypeInfo type;
+            if(!getIntegerType(part->type, type))
+                return false;
+            auto typeIndex = addType(type);
+            auto zero = addConstant(math::BitVector(type.kind, type.bitCount));
+            std::vector<const LetStatementName *> names;
+            names.push_back(part->firstName);
+            for(auto &namePart : part->parts)
+                names.push_back(namePart.name);
+            for(auto *name : names)
+            {
+                auto registerIndex = allocateRegister();
+                variables[name] = Variable{registerIndex, typeIndex};
+                emit(Opcode::LoadConstant, location, registerIndex, zero);
+            }
+        }
+        return true;
+    }
+    // temporaries and the variables declared in nested statements go out of scope at the end of
+    // the statement
+    auto savedNextRegister = nextRegister;
+    struct RegisterRestorer final
+    {
+        std::uint32_t &nextRegister;
+        std::uint32_t savedNextRegister;
+        ~RegisterRestorer()
+        {
+            nextRegister = savedNextRegister;
+        }
+    } registerRestorer{nextRegister, savedNextRegister};
+    if(dynamic_cast<const EmptyStatement *>(statement)
+       || dynamic_cast<const ConstStatement *>(statement)
+       || dynamic_cast<const TypeStatement *>(statement)
+       || dynamic_cast<const EnumStatement *>(statement)
+       || dynamic_cast<const FunctionStatement *>(statement))
+        return true;
+    if(auto *blockStatement = dynamic_cast<const BlockStatement *>(statement))
+        return compileStatements(blockStatement->statements);
+    if(auto *expressionStatement = dynamic_cast<const ExpressionStatement *>(statement))
+    {
+        auto *assignmentExpression =
+            dynamic_cast<const AssignmentExpression *>(expressionStatement->expression);
+        if(!assignmentExpression)
+        {
+            std::uint32_t value;
+            return compileExpression(expressionStatement->expression, value);
+        }
+        auto *scopedIdExpression =
+            dynamic_cast<const ScopedIdExpression *>(assignmentExpression->lhs);
+        if(!scopedIdExpression)
+            return false;
+        auto iter = variables.find(
+            compiler.constantEvaluator.getNameResolver().resolve(scopedIdExpression->value));
+        // for loop variables can't be assigned to
+        if(iter == variables.end() || std::get<1>(*iter).typeIndex == noRegister)
+            return false;
+        auto variable = std::get<1>(*iter);
+        std::uint32_t value;
+        if(!compileExpression(assignmentExpression->rhs, value))
+            return false;
+        emit(Opcode::Convert, location, variable.registerIndex, value, variable.typeIndex);
+        return true;
+    }
+    if(auto *ifStatement = dynamic_cast<const IfStatement *>(statement))
+    {
+        std::uint32_t condition;
+        if(!compileExpression(ifStatement->condition, condition))
+            return false;
+        auto skipThenJump = emit(Opcode::JumpIfZero, location, noRegister, condition);
+        if(!compileStatement(ifStatement->thenStatement))
+            return false;
+        if(!ifStatement->elseStatement)
+        {
+            patchJump(skipThenJump);
+            return true;
+        }
+        auto skipElseJump = emit(Opcode::Jump, location, noRegister);
+        patchJump(skipThenJump);
+        if(!compileStatement(ifStatement->elseStatement))
+            return false;
+        patchJump(skipElseJump);
+        return true;
+    }
+    if(auto *forStatement = dynamic_cast<const ForStatement *>(statement))
+    {
+        // for(i in end) counts from 0 up to but not including end; for(i in start to end) counts
+        // from start up to but not including end
+        // end gets its own register so assigning to a variable named in it inside the loop
+        // doesn't move the bound
+        std::uint32_t start;
+        std::uint32_t end;
+        if(forStatement->secondExpression)
+        {
+            if(!compileExpression(forStatement->firstExpression, start))
+                return false;
+            end = allocateRegister();
+            if(!compileExpressionInto(forStatement->secondExpression, end))
+                return false;
+        }
+        else
+        {
+            start = allocateRegister();
+            emit(Opcode::LoadConstant,
+                 location,
+                 start,
+                 addConstant(constant_operators::makeBool(false)));
+            end = allocateRegister();
+            if(!compileExpressionInto(forStatement->firstExpression, end))
+                return false;
+        }
+        // the variable can hold end, so incrementing it can't overflow
+        auto variable = allocateRegister();
+        auto condition = allocateRegister();
+        variables[forStatement->variable] = Variable{variable, noRegister};
+        emit(Opcode::Promote, location, variable, start, end);
+        auto loopStart = getNextInstructionIndex();
+        emit(Opcode::Binary,
+             location,
+             condition,
+             variable,
+             end,
+             static_cast<std::uint32_t>(constant_operators::BinaryOperator::CompareLT));
+        auto exitJump = emit(Opcode::JumpIfZero, location, noRegister, condition);
+        loops.emplace_back();
+        if(!compileStatement(forStatement->statement))
+            return false;
+        for(auto continueJump : loops.back().continueJumps)
+            patchJump(continueJump);
+        emit(Opcode::Increment, location, variable, variable);
+        emit(Opcode::Jump, location, noRegister, loopStart);
+        patchJump(exitJump);
+        for(auto breakJump : loops.back().breakJumps)
+            patchJump(breakJump);
+        loops.pop_back();
+        return true;
+    }
+    if(dynamic_cast<const BreakStatement *>(statement)
+       || dynamic_cast<const ContinueStatement *>(statement))
+    {
+        if(loops.empty())
+            return false;
+        auto jump = emit(Opcode::Jump, location, noRegister);
+        if(dynamic_cast<const BreakStatement *>(statement))
+            loops.back().breakJumps.push_back(jump);
+        else
+            loops.back().continueJumps.push_back(jump);
+        return true;
+    }
+    if(auto *returnStatement = dynamic_cast<const ReturnStatement *>(statement))
+    {
+        if(!returnStatement->expression)
+        {
+            emit(Opcode::ReturnVoid, location, noRegister);
+            return true;
+        }
+        std::uint32_t value;
+        if(!compileExpression(returnStatement->expression, value))
+            return false;
+        emit(Opcode::Return, location, noRegister, value);
+        return true;
+    }
+    if(auto *matchStatement = dynamic_cast<const MatchStatement *>(statement))
+        return compileMatch(matchStatement);
+    return false;
+}
+
+bool BytecodeCompiler::FunctionCompiler::compileMatch(const MatchStatement *matchStatement)
+{
+    // the first part with a matching pattern runs; range patterns match from the first value up
+    // to but not including the second
+    std::uint32_t matchee;
+    if(!compileExpression(matchStatement->matchee, matchee))
+        return false;
+    auto condition = allocateRegister();
+    std::vector<std::size_t> endJumps;
+    for(auto *part : matchStatement->parts)
+    {
+        std::vector<const MatchPattern *> patterns;
+        patterns.push_back(part->firstMatchPattern);
+        for(auto &patternPart : part->parts)
+            patterns.push_back(patternPart.matchPattern);
+        std::vector<std::size_t> bodyJumps;
+        for(auto *pattern : patterns)
+        {
+            auto patternLocation = pattern->locationRange;
+            if(auto *numberPattern = dynamic_cast<const NumberPatternMatchPattern *>(pattern))
+            {
+                auto value =
+                    constant_operators::makeLiteral(numberPattern->pattern.value, patternLocation);
+                auto mask =
+                    constant_operators::makeLiteral(numberPattern->pattern.mask, patternLocation);
+                auto mpzView = numberPattern->pattern.value.getMpz();
+                mpz_srcptr mpz = mpzView;
+                std::size_t valueBitCount = mpz_sgn(mpz) == 0 ? 0 : mpz_sizeinbase(mpz, 2);
+                compiledFunction.patterns.push_back(
+                    bytecode::NumberPattern{std::move(value), std::move(mask), valueBitCount});
+                emit(Opcode::MatchPattern,
+                     patternLocation,
+                     condition,
+                     matchee,
+                     static_cast<std::uint32_t>(compiledFunction.patterns.size() - 1));
+                bodyJumps.push_back(
+                    emit(Opcode::JumpIfNotZero, patternLocation, noRegister, condition));
+                continue;
+            }
+            auto *rangePattern = dynamic_cast<const RangeMatchPattern *>(pattern);
+            if(!rangePattern)
+                return false;
+            auto savedNextRegister = nextRegister;
+            std::uint32_t first;
+            if(!compileExpression(rangePattern->firstExpression, first))
+                return false;
+            if(!rangePattern->secondExpression)
+            {
+                emit(Opcode::Binary,
+                     patternLocation,
+                     condition,
+                     matchee,
+                     first,
+                     static_cast<std::uint32_t>(constant_operators::BinaryOperator::CompareEq));
+                bodyJumps.push_back(
+                    emit(Opcode::JumpIfNotZero, patternLocation, noRegister, condition));
+                nextRegister = savedNextRegister;
+                continue;
+            }
+            emit(Opcode::Binary,
+                 patternLocation,
+                 condition,
+                 matchee,
+                 first,
+                 static_cast<std::uint32_t>(constant_operators::BinaryOperator::CompareGE));
+            auto skipJump = emit(Opcode::JumpIfZero, patternLocation, noRegister, condition);
+            std::uint32_t second;
+            if(!compileExpression(rangePattern->secondExpression, second))
+                return false;
+            emit(Opcode::Binary,
+                 patternLocation,
+                 condition,
+                 matchee,
+                 second,
+                 static_cast<std::uint32_t>(constant_operators::BinaryOperator::CompareLT));
+            bodyJumps.push_back(
+                emit(Opcode::JumpIfNotZero, patternLocation, noRegister, condition));
+            patchJump(skipJump);
+            nextRegister = savedNextRegister;
+        }
+        auto nextPartJump = emit(Opcode::Jump, part->locationRange, noRegister);
+        for(auto bodyJump : bodyJumps)
+            patchJump(bodyJump);
+        if(!compileStatement(part->statement))
+            return false;
+        endJumps.push_back(emit(Opcode::Jump, part->locationRange, noRegister));
+        patchJump(nextPartJump);
+    }
+    for(auto endJump : endJumps)
+        patchJump(endJump);
+    return true;
+}
+
+bool BytecodeCompiler::FunctionCompiler::compileExpressions(
+    const std::vector<const Expression *> &expressions, std::uint32_t &firstRegister)
+{
+    // the values need to be in consecutive registers, so allocate them before compiling
+    firstRegister = nextRegister;
+    for(std::size_t i = 0; i < expressions.size(); i++)
+        allocateRegister();
+    for(std::size_t i = 0; i < expressions.size(); i++)
+    {
+        auto savedNextRegister = nextRegister;
+        if(!compileExpressionInto(expressions[i], firstRegister + static_cast<std::uint32_t>(i)))
+            return false;
+        nextRegister = savedNextRegister;
+    }
+    return true;
+}
+
+bool BytecodeCompiler::FunctionCompiler::compileExpressionInto(const Expression *expression,
+                                                               std::uint32_t destination)
+{
+    std::uint32_t value;
+    if(!compileExpression(expression, value))
+        return false;
+    if(value != destination)
+        emit(Opcode::Move, expression->locationRange, destination, value);
+    return true;
+}
+
+bool BytecodeCompiler::FunctionCompiler::compileExpression(const Expression *expression,
+                                                           std::uint32_t &result)
+{
+    auto location = expression->locationRange;
+    constant_operators::UnaryOperator unaryOperator;
+    constant_operators::BinaryOperator binaryOperator;
+    if(auto *numberExpression = dynamic_cast<const NumberExpression *>(expression))
+    {
+        result = allocateRegister();
+        emit(Opcode::LoadConstant,
+             location,
+             result,
+             addConstant(constant_operators::makeLiteral(numberExpression->value, location)));
+        return true;
+    }
+    if(auto *parenExpression = dynamic_cast<const ParenExpression *>(expression))
+        return compileExpression(parenExpression->expression, result);
+    if(auto *scopedIdExpression = dynamic_cast<const ScopedIdExpression *>(expression))
+    {
+        auto *symbol =
+            compiler.constantEvaluator.getNameResolver().resolve(scopedIdExpression->value);
+        if(!symbol)
+            return false;
+        auto iter = variables.find(symbol);
+        if(iter != variables.end())
+        {
+            result = std::get<1>(*iter).registerIndex;
+            return true;
+        }
+        auto *value = compiler.constantEvaluator.getSymbolValue(symbol);
+        if(!value)
+            return false;
+        result = allocateRegister();
+        emit(Opcode::LoadConstant, location, result, addConstant(*value));
+        return true;
+    }
+    if(constant_operators::getUnaryOperator(expression, unaryOperator))
+    {
+        auto *argument = dynamic_cast<const PopCountExpression *>(expression) ?
+                             static_cast<const PopCountExpression *>(expression)->expression :
+                             static_cast<const UnaryExpression *>(expression)->argument;
+        std::uint32_t value;
+        if(!compileExpression(argument, value))
+            return false;
+        result = allocateRegister();
+        emit(Opcode::Unary, location, result, value, static_cast<std::uint32_t>(unaryOperator));
+        return true;
+    }
+    if(auto *binaryExpression = dynamic_cast<const BinaryExpression *>(expression))
+    {
+        bool isAnd = dynamic_cast<const LogicalAndExpression *>(expression);
+        bool isOr = dynamic_cast<const LogicalOrExpression *>(expression);
+        if(isAnd || isOr)
+        {
+            result = allocateRegister();
+            std::uint32_t l;
+            if(!compileExpression(binaryExpression->lhs, l))
+                return false;
+            emit(Opcode::ToBool, location, result, l);
+            auto skipJump = emit(
+                isAnd ? Opcode::JumpIfZero : Opcode::JumpIfNotZero, location, noRegister, result);
+            std::uint32_t r;
+            if(!compileExpression(binaryExpression->rhs, r))
+                return false;
+            emit(Opcode::ToBool, location, result, r);
+            patchJump(skipJump);
+            return true;
+        }
+        std::uint32_t l;
+        std::uint32_t r;
+        if(!constant_operators::getBinaryOperator(binaryExpression, binaryOperator)
+           || !compileExpression(binaryExpression->lhs, l)
+           || !compileExpression(binaryExpression->rhs, r))
+            return false;
+        result = allocateRegister();
+        emit(Opcode::Binary, location, result, l, r, static_cast<std::uint32_t>(binaryOperator));
+        return true;
+    }
+    if(auto *conditionalExpression = dynamic_cast<const ConditionalExpression *>(expression))
+    {
+        result = allocateRegister();
+        std::uint32_t condition;
+        if(!compileExpression(conditionalExpression->condition, condition))
+            return false;
+        auto falseJump = emit(Opcode::JumpIfZero, location, noRegister, condition);
+        if(!compileExpressionInto(conditionalExpression->trueValue, result))
+            return false;
+        auto endJump = emit(Opcode::Jump, location, noRegister);
+        patchJump(falseJump);
+        if(!compileExpressionInto(conditionalExpression->falseValue, result))
+            return false;
+        patchJump(endJump);
+        return true;
+    }
+    if(auto *castExpression = dynamic_cast<const CastExpression *>(expression))
+    {
+        ConstantEvaluator::IntegerTypeInfo type;
+        std::uint32_t value;
+        if(!getIntegerType(castExpression->type, type)
+           || !compileExpression(castExpression->expression, value))
+            return false;
+        result = allocateRegister();
+        emit(Opcode::Convert, location, result, value, addType(type));
+        return true;
+    }
+    if(auto *catExpression = dynamic_cast<const CatExpression *>(expression))
+    {
+        std::vector<const Expression *> parts;
+        parts.push_back(catExpression->firstExpression);
+        for(auto &part : catExpression->parts)
+            parts.push_back(part.expression);
+        std::uint32_t firstRegister;
+        if(!compileExpressions(parts, firstRegister))
+            return false;
+        result = allocateRegister();
+        emit(Opcode::Concatenate,
+             location,
+             result,
+             firstRegister,
+             static_cast<std::uint32_t>(parts.size()));
+        return true;
+    }
+    if(auto *fillExpression = dynamic_cast<const FillExpression *>(expression))
+    {
+        std::uint32_t count;
+        std::uint32_t value;
+        if(!compileExpression(fillExpression->countExpression, count)
+           || !compileExpression(fillExpression->valueExpression, value))
+            return false;
+        result = allocateRegister();
+        emit(Opcode::Fill, location, result, count, value);
+        return true;
+    }
+    if(auto *sliceExpression = dynamic_cast<const SliceExpression *>(expression))
+    {
+        std::uint32_t value;
+        std::uint32_t startIndex;
+        std::uint32_t endIndex = noRegister;
+        if(!compileExpression(sliceExpression->slicedValue, value)
+           || !compileExpression(sliceExpression->startIndex, startIndex)
+           || (sliceExpression->endIndex
+               && !compileExpression(sliceExpression->endIndex, endIndex)))
+            return false;
+        result = allocateRegister();
+        emit(Opcode::Slice, location, result, value, startIndex, endIndex);
+        return true;
+    }
+    if(auto *functionCallExpression = dynamic_cast<const FunctionCallExpression *>(expression))
+    {
+        auto *scopedIdExpression =
+            dynamic_cast<const ScopedIdExpression *>(functionCallExpression->function);
+        if(!scopedIdExpression)
+            return false;
+        auto *function = dynamic_cast<const Function *>(
+            compiler.constantEvaluator.getNameResolver().resolve(scopedIdExpression->value));
+        auto *callee = function ? compiler.compile(function) : nullptr;
+        if(!callee)
+            return false;
+        std::vector<const Expression *> arguments;
+        if(functionCallExpression->firstExpression)
+            arguments.push_back(functionCallExpression->firstExpression);
+        for(auto &part : functionCallExpression->parts)
+            arguments.push_back(part.expression);
+        if(arguments.size() != callee->parameterTypes.size())
+            throw parse::ParseError(location, "wrong number of arguments");
+        std::uint32_t firstRegister;
+        if(!compileExpressions(arguments, firstRegister))
+            return false;
+        compiledFunction.callees.push_back(callee);
+        result = allocateRegister();
+        emit(Opcode::Call,
+             location,
+             result,
+             static_cast<std::uint32_t>(compiledFunction.callees.size() - 1),
+             firstRegister,
+             static_cast<std::uint32_t>(arguments.size()));
+        return true;
+    }
+    return false;
+}
+
+const bytecode::CompiledFunction *BytecodeCompiler::compile(const Function *function)
+{
+    auto iter = functionMap.find(function);
+    if(iter != functionMap.end())
+        return std::get<1>(*iter)->isValid ? std::get<1>(*iter) : nullptr;
+    compiledFunctions.emplace_back(function);
+    auto &compiledFunction = compiledFunctions.back();
+    functionMap.emplace(function, &compiledFunction);
+    // valid while compiling, so recursive calls compile
+    compiledFunction.isValid = true;
+    try
+    {
+        compiledFunction.isValid = FunctionCompiler(*this, compiledFunction).compile();
+    }
+    catch(...)
+    {
+        compiledFunction.isValid = false;
+        throw;
+    }
+    if(!compiledFunction.isValid)
+        return nullptr;
+    return &compiledFunction;
+}
+
+std::size_t BytecodeCompiler::getHeapBytes() const noexcept
+{
+    std::size_t retval = util::getHashTableHeapBytes(functionMap)
+                         + compiledFunctions.size() * sizeof(bytecode::CompiledFunction);
+    for(auto &compiledFunction : compiledFunctions)
+    {
+        retval += util::getHeapBytes(compiledFunction.parameterTypes)
+                  + util::getHeapBytes(compiledFunction.instructions)
+                  + util::getHeapBytes(compiledFunction.locations)
+                  + util::getHeapBytes(compiledFunction.constants)
+                  + util::getHeapBytes(compiledFunction.types)
+                  + util::getHeapBytes(compiledFunction.patterns)
+                  + util::getHeapBytes(compiledFunction.callees);
+    }
+    return retval;
+}
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "bytecode.h"
+#include "constant_evaluator.h"
+#include "function.h"
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+
+namespace ast
+{
+/** compiles function bodies to bytecode for compile-time evaluation. Names of constants, enum
+ * values, and types are resolved while compiling, so they cost nothing when the function runs.
+ * Functions are compiled once, when they're first called. Functions with template parameters,
+ * or that use anything other than integer variables, if, for over integer ranges, match, let,
+ * assignment, break, continue, return, and calls to other such functions can't be compiled. */
+class BytecodeCompiler final
+{
+private:
+    class FunctionCompiler;
+
+private:
+    ConstantEvaluator &constantEvaluator;
+    std::deque<bytecode::CompiledFunction> compiledFunctions;
+    std::unordered_map<const Function *, bytecode::CompiledFunction *> functionMap;
+
+public:
+    explicit BytecodeCompiler(ConstantEvaluator &constantEvaluator) noexcept
+        : constantEvaluator(constantEvaluator)
+    {
+    }
+    BytecodeCompiler(const BytecodeCompiler &) = delete;
+    BytecodeCompiler &operator=(const BytecodeCompiler &) = delete;
+    ConstantEvaluator &getConstantEvaluator() const noexcept
+    {
+        return constantEvaluator;
+    }
+    /** returns nullptr if function can't be evaluated at compile time. While function is being
+     * compiled, returns the unfinished CompiledFunction, so recursive calls can refer to it. */
+    const bytecode::CompiledFunction *compile(const Function *function);
+    std::size_t getCompiledFunctionCount() const noexcept
+    {
+        return compiledFunctions.size();
+    }
+    /** the bytes allocated for the compiled functions */
+    std::size_t getHeapBytes() const noexcept;
+};
+}
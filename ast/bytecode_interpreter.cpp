@@ -0,0 +1,307 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bytecode_interpreter.h"
+#include "constant_operators.h"
+#include "../parse/parse_error.h"
+#include "../util/memory_usage.h"
+#include <utility>
+
+namespace ast
+{
+using bytecode::Opcode;
+using math::BitVector;
+
+std::size_t BytecodeInterpreter::CallKeyHasher::operator()(const CallKey &value) const noexcept
+{
+    std::size_t retval = std::hash<const void *>()(value.function);
+    for(auto &argument : value.arguments)
+        retval = retval * 0x100000001B3ULL ^ argument.getHash();
+    return retval;
+}
+
+BytecodeInterpreter::CallKey BytecodeInterpreter::makeCallKey(
+    const bytecode::CompiledFunction *function,
+    const BitVector *arguments,
+    std::size_t argumentCount)
+{
+    CallKey retval{function, {}};
+    retval.arguments.reserve(argumentCount);
+    for(std::size_t i = 0; i < argumentCount; i++)
+    {
+        auto &type = function->parameterTypes[i];
+        retval.arguments.push_back(BitVector::cast(type.kind, type.bitCount, arguments[i]));
+    }
+    return retval;
+}
+
+void BytecodeInterpreter::setRegister(std::size_t index, BitVector value) noexcept
+{
+    auto &target = registers[index];
+    registerHeapBytes -= target.getHeapBytes();
+    registerHeapBytes += value.getHeapBytes();
+    target = std::move(value);
+}
+
+void BytecodeInterpreter::pushFrame(CallKey key,
+                                    std::size_t resultRegister,
+                                    parse::LocationRange location)
+{
+    auto *function = key.function;
+    if(!function->isValid)
+        throw NotConstant();
+    auto firstRegister = registers.size();
+    registers.resize(firstRegister + function->registerCount);
+    frames.push_back(Frame{function, firstRegister, 0, resultRegister, std::move(key)});
+    auto &arguments = frames.back().key.arguments;
+    for(std::size_t i = 0; i < arguments.size(); i++)
+        setRegister(firstRegister + i, arguments[i]);
+    if(registers.size() * sizeof(BitVector) + registerHeapBytes + frames.size() * sizeof(Frame)
+       > limits.maxMemoryBytes)
+        throw parse::ParseError(location, "compile-time evaluation used too much memory");
+}
+
+void BytecodeInterpreter::popFrame() noexcept
+{
+    auto firstRegister = frames.back().firstRegister;
+    for(std::size_t i = firstRegister; i < registers.size(); i++)
+        registerHeapBytes -= registers[i].getHeapBytes();
+    registers.resize(firstRegister);
+    frames.pop_back();
+}
+
+const BytecodeInterpreter::CallResult &BytecodeInterpreter::run(std::size_t baseFrameIndex)
+{
+    static const BitVector one = constant_operators::makeBool(true);
+    for(;;)
+    {
+        auto &frame = frames.back();
+        auto *function = frame.function;
+        auto programCounter = frame.programCounter++;
+        auto &instruction = function->instructions[programCounter];
+        auto location = function->locations[programCounter];
+        if(++stepCount > limits.maxStepCount)
+            throw parse::ParseError(location, "compile-time evaluation took too many steps");
+        if(registerHeapBytes > limits.maxMemoryBytes)
+            throw parse::ParseError(location, "compile-time evaluation used too much memory");
+        // a function can have no registers, and not every opcode's operands are registers, so
+        // registers are only indexed by the cases that read them
+        auto *frameRegisters = registers.data() + frame.firstRegister;
+        auto destination = frame.firstRegister + instruction.destination;
+        switch(instruction.opcode)
+        {
+        case Opcode::LoadConstant:
+            setRegister(destination, function->constants[instruction.a]);
+            break;
+        case Opcode::Move:
+            setRegister(destination, frameRegisters[instruction.a]);
+            break;
+        case Opcode::Convert:
+        {
+            auto &a = frameRegisters[instruction.a];
+            auto &type = function->types[instruction.b];
+            setRegister(destination, BitVector::cast(type.kind, type.bitCount, a));
+            break;
+        }
+        case Opcode::Promote:
+        {
+            auto &a = frameRegisters[instruction.a];
+            BitVector::Kind kind;
+            std::size_t bitCount;
+            constant_operators::getCommonType(a, frameRegisters[instruction.b], kind, bitCount);
+            setRegister(destination, BitVector::cast(kind, bitCount, a));
+            break;
+        }
+        case Opcode::Increment:
+        {
+            auto &a = frameRegisters[instruction.a];
+            setRegister(destination, BitVector::add(a.getKind(), a.getBitCount(), a, one));
+            break;
+        }
+        case Opcode::ToBool:
+            setRegister(destination,
+                        constant_operators::makeBool(!frameRegisters[instruction.a].isZero()));
+            break;
+        case Opcode::Unary:
+            setRegister(destination,
+                        constant_operators::evaluate(
+                            static_cast<constant_operators::UnaryOperator>(instruction.b),
+                            frameRegisters[instruction.a],
+                            location));
+            break;
+        case Opcode::Binary:
+            setRegister(destination,
+                        constant_operators::evaluate(
+                            static_cast<constant_operators::BinaryOperator>(instruction.c),
+                            frameRegisters[instruction.a],
+                            frameRegisters[instruction.b],
+                            location));
+            break;
+        case Opcode::Concatenate:
+            setRegister(destination,
+                        constant_operators::concatenate(
+                            frameRegisters + instruction.a, instruction.b, location));
+            break;
+        case Opcode::Fill:
+            setRegister(destination,
+                        constant_operators::fill(frameRegisters[instruction.a],
+                                                 frameRegisters[instruction.b],
+                                                 location));
+            break;
+        case Opcode::Slice:
+        {
+            auto &a = frameRegisters[instruction.a];
+            auto high = constant_operators::getSize(
+                frameRegisters[instruction.b], constant_operators::maxBitCount, location);
+            auto low = instruction.c == bytecode::noRegister ?
+                           high :
+                           constant_operators::getSize(frameRegisters[instruction.c],
+                                                       constant_operators::maxBitCount,
+                                                       location);
+            setRegister(destination, constant_operators::slice(a, high, low, location));
+            break;
+        }
+        case Opcode::MatchPattern:
+        {
+            auto &a = frameRegisters[instruction.a];
+            auto &pattern = function->patterns[instruction.b];
+            bool matches = pattern.valueBitCount <= a.getBitCount()
+                           && BitVector::compareUnsigned(
+                                  BitVector::bitwiseAnd(
+                                      BitVector::Kind::Unsigned, a.getBitCount(), a, pattern.mask),
+                                  pattern.value)
+                                  == 0;
+            setRegister(destination, constant_operators::makeBool(matches));
+            break;
+        }
+        case Opcode::Jump:
+            frame.programCounter = instruction.a;
+            break;
+        case Opcode::JumpIfZero:
+            if(frameRegisters[instruction.a].isZero())
+                frame.programCounter = instruction.b;
+            break;
+        case Opcode::JumpIfNotZero:
+            if(!frameRegisters[instruction.a].isZero())
+                frame.programCounter = instruction.b;
+            break;
+        case Opcode::Call:
+        {
+            auto *callee = function->callees[instruction.a];
+            auto key = makeCallKey(callee, frameRegisters + instruction.b, instruction.c);
+            auto iter = resultCache.find(key);
+            if(iter == resultCache.end())
+            {
+                missCount++;
+                // invalidates frame and the registers
+                pushFrame(std::move(key), destination, location);
+                break;
+            }
+            hitCount++;
+            auto &result = std::get<1>(*iter);
+            setRegister(destination, result.hasValue ? result.value : BitVector());
+            break;
+        }
+        case Opcode::Return:
+        case Opcode::ReturnVoid:
+        {
+            CallResult result{instruction.opcode == Opcode::Return, BitVector()};
+            if(result.hasValue && function->hasReturnType)
+                result.value = BitVector::cast(function->returnType.kind,
+                                               function->returnType.bitCount,
+                                               frameRegisters[instruction.a]);
+            else if(result.hasValue)
+                result.value = frameRegisters[instruction.a];
+            else if(function->hasReturnType)
+                throw parse::ParseError(location, "function ended without returning a value");
+            auto resultRegister = frame.resultRegister;
+            auto key = std::move(frame.key);
+            popFrame();
+            auto &cachedResult = std::get<1>(
+                *std::get<0>(resultCache.emplace(std::move(key), std::move(result))));
+            if(frames.size() == baseFrameIndex)
+                return cachedResult;
+            setRegister(resultRegister,
+                        cachedResult.hasValue ? cachedResult.value : BitVector());
+            break;
+        }
+        }
+    }
+}
+
+const BitVector *BytecodeInterpreter::call(const Function *function,
+                                           std::vector<BitVector> arguments,
+                                           parse::LocationRange callLocation)
+{
+    auto *compiledFunction = compiler.compile(function);
+    if(!compiledFunction)
+        return nullptr;
+    if(arguments.size() != compiledFunction->parameterTypes.size())
+        throw parse::ParseError(callLocation, "wrong number of arguments");
+    auto key = makeCallKey(compiledFunction, arguments.data(), arguments.size());
+    auto iter = resultCache.find(key);
+    if(iter != resultCache.end())
+    {
+        hitCount++;
+        auto &result = std::get<1>(*iter);
+        return result.hasValue ? &result.value : nullptr;
+    }
+    missCount++;
+    // compiling can evaluate constants that call functions, so calls can nest
+    struct Unwinder final
+    {
+        BytecodeInterpreter &interpreter;
+        std::size_t baseFrameIndex;
+        ~Unwinder()
+        {
+            while(interpreter.frames.size() > baseFrameIndex)
+                interpreter.popFrame();
+            if(baseFrameIndex == 0)
+            {
+                interpreter.totalStepCount += interpreter.stepCount;
+                interpreter.stepCount = 0;
+            }
+        }
+    } unwinder{*this, frames.size()};
+    try
+    {
+        pushFrame(std::move(key), 0, callLocation);
+        auto &result = run(unwinder.baseFrameIndex);
+        return result.hasValue ? &result.value : nullptr;
+    }
+    catch(NotConstant &)
+    {
+        return nullptr;
+    }
+}
+
+std::size_t BytecodeInterpreter::getHeapBytes() const noexcept
+{
+    std::size_t retval = util::getHashTableHeapBytes(resultCache) + util::getHeapBytes(registers)
+                         + registerHeapBytes + util::getHeapBytes(frames);
+    for(auto &entry : resultCache)
+    {
+        auto &key = std::get<0>(entry);
+        retval += util::getHeapBytes(key.arguments) + std::get<1>(entry).value.getHeapBytes();
+        for(auto &argument : key.arguments)
+            retval += argument.getHeapBytes();
+    }
+    return retval;
+}
+}
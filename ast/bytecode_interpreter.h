@@ -0,0 +1,147 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "bytecode.h"
+#include "bytecode_compiler.h"
+#include "constant_evaluator.h"
+#include "../math/bit_vector.h"
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ast
+{
+/** runs compiled functions at compile time. Each call from outside the interpreter gets a budget
+ * of instructions and of memory for registers; running out throws parse::ParseError. Functions
+ * can't have side effects, so results are cached by function and argument values, including for
+ * calls from one function to another. */
+class BytecodeInterpreter final : public ConstantEvaluator::FunctionEvaluator
+{
+public:
+    struct Limits final
+    {
+        std::size_t maxStepCount;
+        std::size_t maxMemoryBytes;
+    };
+
+private:
+    struct CallKey final
+    {
+        const bytecode::CompiledFunction *function;
+        std::vector<math::BitVector> arguments;
+        /** the arguments are converted to the parameter types, so only their bits are compared */
+        friend bool operator==(const CallKey &a, const CallKey &b) noexcept
+        {
+            if(a.function != b.function)
+                return false;
+            for(std::size_t i = 0; i < a.arguments.size(); i++)
+                if(math::BitVector::compareUnsigned(a.arguments[i], b.arguments[i]) != 0)
+                    return false;
+            return true;
+        }
+    };
+    struct CallKeyHasher final
+    {
+        std::size_t operator()(const CallKey &value) const noexcept;
+    };
+    struct CallResult final
+    {
+        bool hasValue;
+        math::BitVector value;
+    };
+    struct Frame final
+    {
+        const bytecode::CompiledFunction *function;
+        std::size_t firstRegister;
+        std::size_t programCounter;
+        /** the caller's register that gets the return value */
+        std::size_t resultRegister;
+        CallKey key;
+    };
+    /** thrown when a function calls a function that can't be evaluated at compile time */
+    struct NotConstant final
+    {
+    };
+
+private:
+    BytecodeCompiler &compiler;
+    Limits limits;
+    std::vector<math::BitVector> registers;
+    std::vector<Frame> frames;
+    std::unordered_map<CallKey, CallResult, CallKeyHasher> resultCache;
+    /** the bytes the wide values in registers have allocated */
+    std::size_t registerHeapBytes = 0;
+    std::size_t stepCount = 0;
+    std::size_t hitCount = 0;
+    std::size_t missCount = 0;
+    std::size_t totalStepCount = 0;
+
+private:
+    void setRegister(std::size_t index, math::BitVector value) noexcept;
+    /** pushes a frame for key, which must be converted to the parameter types */
+    void pushFrame(CallKey key, std::size_t resultRegister, parse::LocationRange location);
+    void popFrame() noexcept;
+    /** runs until the frame at baseFrameIndex returns */
+    const CallResult &run(std::size_t baseFrameIndex);
+    static CallKey makeCallKey(const bytecode::CompiledFunction *function,
+                               const math::BitVector *arguments,
+                               std::size_t argumentCount);
+
+public:
+    static Limits getDefaultLimits() noexcept
+    {
+        return Limits{100000000, static_cast<std::size_t>(1) << 30};
+    }
+    explicit BytecodeInterpreter(BytecodeCompiler &compiler,
+                                 Limits limits = getDefaultLimits()) noexcept
+        : compiler(compiler),
+          limits(limits)
+    {
+    }
+    BytecodeInterpreter(const BytecodeInterpreter &) = delete;
+    BytecodeInterpreter &operator=(const BytecodeInterpreter &) = delete;
+    /** returns nullptr if function can't be evaluated at compile time or doesn't return a value */
+    virtual const math::BitVector *call(const Function *function,
+                                        std::vector<math::BitVector> arguments,
+                                        parse::LocationRange callLocation) override;
+    /** the calls that were answered from the result cache */
+    std::size_t getHitCount() const noexcept
+    {
+        return hitCount;
+    }
+    /** the calls that ran */
+    std::size_t getMissCount() const noexcept
+    {
+        return missCount;
+    }
+    /** the instructions run by every call */
+    std::size_t getTotalStepCount() const noexcept
+    {
+        return totalStepCount + stepCount;
+    }
+    std::size_t getCachedResultCount() const noexcept
+    {
+        return resultCache.size();
+    }
+    /** the bytes allocated for the result cache and the registers */
+    std::size_t getHeapBytes() const noexcept;
+};
+}
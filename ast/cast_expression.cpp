@@ -18,6 +18,7 @@
  */
 
 #include "cast_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -34,4 +35,40 @@ void CastExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setPointer(dumpNode, "expression", expression);
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void CastExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CastExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeCastComments);
+    visitor.visitComments(beforeEMarkComments);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitNode(type);
+    visitor.visitComments(beforeRBraceComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(expression);
+    visitor.visitComments(beforeRParenComments);
+}
+
+CastExpression *CastExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeCastComments = reader.readComments();
+    auto beforeEMarkComments = reader.readComments();
+    auto beforeLBraceComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    auto beforeRBraceComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *expression = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<CastExpression>(locationRange,
+                                         beforeCastComments,
+                                         beforeEMarkComments,
+                                         beforeLBraceComments,
+                                         type,
+                                         beforeRBraceComments,
+                                         beforeLParenComments,
+                                         expression,
+                                         beforeRParenComments);
+}
 }
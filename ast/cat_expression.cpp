@@ -18,6 +18,7 @@
  */
 
 #include "cat_expression.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -39,4 +40,44 @@ void CatExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     }
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void CatExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::CatExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeCatComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(firstExpression);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.expression);
+    }
+    visitor.visitComments(beforeRParenComments);
+}
+
+CatExpression *CatExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeCatComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *firstExpression = reader.readNode<Expression>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *expression = reader.readNode<Expression>();
+        parts.push_back(Part(beforeCommaComments, expression));
+    }
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<CatExpression>(locationRange,
+                                        beforeCatComments,
+                                        beforeLParenComments,
+                                        firstExpression,
+                                        std::move(parts),
+                                        beforeRParenComments);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "conditional_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -31,4 +32,27 @@ void ConditionalExpression::dump(util::DumpTree *dumpNode, util::DumpState &stat
     state.setSimple(dumpNode, "beforeColonComments", beforeColonComments);
     state.setPointer(dumpNode, "falseValue", falseValue);
 }
+
+void ConditionalExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ConditionalExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(condition);
+    visitor.visitComments(beforeQMarkComments);
+    visitor.visitNode(trueValue);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(falseValue);
+}
+
+ConditionalExpression *ConditionalExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *condition = reader.readNode<Expression>();
+    auto beforeQMarkComments = reader.readComments();
+    auto *trueValue = reader.readNode<Expression>();
+    auto beforeColonComments = reader.readComments();
+    auto *falseValue = reader.readNode<Expression>();
+    return reader.create<ConditionalExpression>(
+        locationRange, condition, beforeQMarkComments, trueValue, beforeColonComments, falseValue);
+}
 }
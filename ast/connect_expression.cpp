@@ -18,6 +18,7 @@
  */
 
 #include "connect_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -29,4 +30,22 @@ void ConnectExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     state.setSimple(dumpNode, "beforeOperatorComments", beforeOperatorComments);
     state.setPointer(dumpNode, "rhs", rhs);
 }
+
+void ConnectExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ConnectExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(lhs);
+    visitor.visitComments(beforeOperatorComments);
+    visitor.visitNode(rhs);
+}
+
+ConnectExpression *ConnectExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *lhs = reader.readNode<Expression>();
+    auto beforeOperatorComments = reader.readComments();
+    auto *rhs = reader.readNode<Expression>();
+    return reader.create<ConnectExpression>(locationRange, lhs, beforeOperatorComments, rhs);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "const_statement.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -38,4 +39,38 @@ void ConstStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     }
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void ConstStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ConstStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeConstComments);
+    visitor.visitNode(firstPart);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.part);
+    }
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+ConstStatement *ConstStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeConstComments = reader.readComments();
+    auto *firstPart = reader.readNode<ConstStatementPart>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *part = reader.readNode<ConstStatementPart>();
+        parts.push_back(Part(beforeCommaComments, part));
+    }
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<ConstStatement>(
+        locationRange, beforeConstComments, firstPart, std::move(parts), beforeSemicolonComments);
+}
 }
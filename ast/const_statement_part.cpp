@@ -18,6 +18,7 @@
  */
 
 #include "const_statement_part.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -30,4 +31,26 @@ void ConstStatementPart::dump(util::DumpTree *dumpNode, util::DumpState &state)
     state.setSimple(dumpNode, "beforeEqualComments", beforeEqualComments);
     state.setPointer(dumpNode, "value", value);
 }
+
+void ConstStatementPart::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ConstStatementPart);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeEqualComments);
+    visitor.visitNode(value);
+}
+
+ConstStatementPart *ConstStatementPart::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    auto beforeEqualComments = reader.readComments();
+    auto *value = reader.readNode<Expression>();
+    return reader.create<ConstStatementPart>(
+        locationRange, beforeNameComments, symbolLocationRange, name, beforeEqualComments, value);
+}
 }
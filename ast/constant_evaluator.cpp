@@ -0,0 +1,615 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "constant_evaluator.h"
+#include "binary_expression.h"
+#include "cast_expression.h"
+#include "cat_expression.h"
+#include "conditional_expression.h"
+#include "const_statement_part.h"
+#include "constant_operators.h"
+#include "enum.h"
+#include "fill_expression.h"
+#include "flip_type.h"
+#include "function.h"
+#include "function_call_expression.h"
+#include "int_type.h"
+#include "node_field_visitor.h"
+#include "number_expression.h"
+#include "paren_expression.h"
+#include "pop_count_expression.h"
+#include "scoped_id_expression.h"
+#include "scoped_id_type.h"
+#include "slice_expression.h"
+#include "type_statement.h"
+#include "type_template_parameter.h"
+#include "unary_expression.h"
+#include "value_template_parameter.h"
+#include "../parse/parse_error.h"
+#include "../util/memory_usage.h"
+#include <algorithm>
+
+namespace ast
+{
+namespace
+{
+typedef math::BitVector BitVector;
+typedef BitVector::Kind Kind;
+
+BitVector convert(const ConstantEvaluator::IntegerTypeInfo &type, const BitVector &value)
+{
+    if(value.getKind() == type.kind && value.getBitCount() == type.bitCount)
+        return value;
+    return BitVector::cast(type.kind, type.bitCount, value);
+}
+
+template <typename T>
+bool getBuiltInIntegerType(const Type *type, ConstantEvaluator::IntegerTypeInfo &result) noexcept
+{
+    if(!dynamic_cast<const T *>(type))
+        return false;
+    result = {T::isSigned ? Kind::Signed : Kind::Unsigned, T::bitCount};
+    return true;
+}
+
+bool areBitVectorsIdentical(const BitVector &a, const BitVector &b) noexcept
+{
+    return a.getKind() == b.getKind() && a.getBitCount() == b.getBitCount()
+           && BitVector::compareUnsigned(a, b) == 0;
+}
+}
+
+const TemplateBinding::Argument *TemplateBinding::find(const TemplateParameter *parameter) const
+    noexcept
+{
+    auto iter = std::lower_bound(
+        arguments.begin(),
+        arguments.end(),
+        parameter,
+        [](const Argument &argument, const TemplateParameter *parameter) noexcept
+        {
+            return std::less<const TemplateParameter *>()(argument.parameter, parameter);
+        });
+    if(iter == arguments.end() || iter->parameter != parameter)
+        return nullptr;
+    return &*iter;
+}
+
+class ConstantEvaluator::InProgressGuard final
+{
+private:
+    ConstantEvaluator &evaluator;
+    CacheKey key;
+    bool isFinished = false;
+
+public:
+    InProgressGuard(ConstantEvaluator &evaluator, CacheKey key) noexcept : evaluator(evaluator),
+                                                                           key(key)
+    {
+    }
+    InProgressGuard(const InProgressGuard &) = delete;
+    InProgressGuard &operator=(const InProgressGuard &) = delete;
+    ~InProgressGuard()
+    {
+        if(!isFinished)
+            evaluator.cache.erase(key);
+    }
+    const BitVector *finish(bool isConstant, BitVector value)
+    {
+        isFinished = true;
+        auto &entry = std::get<1>(*evaluator.cache.find(key));
+        if(!isConstant)
+        {
+            entry.state = State::NotConstant;
+            return nullptr;
+        }
+        entry.state = State::Done;
+        entry.value = std::move(value);
+        return &entry.value;
+    }
+};
+
+class ConstantEvaluator::Visitor final : public NodeFieldVisitor
+{
+private:
+    ConstantEvaluator &constantEvaluator;
+    const TemplateBinding *binding;
+
+public:
+    explicit Visitor(ConstantEvaluator &constantEvaluator, const TemplateBinding *binding) noexcept
+        : constantEvaluator(constantEvaluator),
+          binding(binding)
+    {
+    }
+    virtual void visitNodeKind(NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value)
+            return;
+        if(dynamic_cast<const ConstStatementPart *>(value) || dynamic_cast<const EnumPart *>(value))
+        {
+            constantEvaluator.getSymbolValue(dynamic_cast<const Symbol *>(value), binding);
+        }
+        else if(dynamic_cast<const UIntType *>(value) || dynamic_cast<const SIntType *>(value))
+        {
+            IntegerTypeInfo integerType;
+            constantEvaluator.getIntegerType(
+                static_cast<const Type *>(value), binding, integerType);
+        }
+        else if(auto *memoryType = dynamic_cast<const MemoryType *>(value))
+        {
+            std::size_t size;
+            constantEvaluator.getMemorySize(memoryType, binding, size);
+        }
+        value->visitFields(*this);
+    }
+    virtual void visitSymbolTable(const SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &) override
+    {
+    }
+};
+
+std::size_t ConstantEvaluator::TemplateBindingHasher::operator()(const TemplateBinding *value) const
+    noexcept
+{
+    std::size_t retval = 0;
+    for(auto &argument : value->arguments)
+    {
+        retval = retval * 0x100000001B3ULL ^ std::hash<const void *>()(argument.parameter);
+        retval = retval * 0x100000001B3ULL ^ std::hash<const void *>()(argument.type);
+        retval = retval * 0x100000001B3ULL ^ std::hash<const void *>()(argument.typeBinding);
+        retval = retval * 0x100000001B3ULL ^ argument.value.getHash();
+    }
+    return retval;
+}
+
+bool ConstantEvaluator::TemplateBindingEqual::operator()(const TemplateBinding *a,
+                                                         const TemplateBinding *b) const noexcept
+{
+    if(a->arguments.size() != b->arguments.size())
+        return false;
+    for(std::size_t i = 0; i < a->arguments.size(); i++)
+    {
+        auto &aArgument = a->arguments[i];
+        auto &bArgument = b->arguments[i];
+        if(aArgument.parameter != bArgument.parameter || aArgument.type != bArgument.type
+           || aArgument.typeBinding != bArgument.typeBinding
+           || !areBitVectorsIdentical(aArgument.value, bArgument.value))
+            return false;
+    }
+    return true;
+}
+
+const TemplateBinding *ConstantEvaluator::bind(std::vector<TemplateBinding::Argument> arguments)
+{
+    if(arguments.empty())
+        return nullptr;
+    std::sort(arguments.begin(),
+              arguments.end(),
+              [](const TemplateBinding::Argument &a, const TemplateBinding::Argument &b) noexcept
+              {
+                  return std::less<const TemplateParameter *>()(a.parameter, b.parameter);
+              });
+    TemplateBinding binding;
+    binding.arguments = std::move(arguments);
+    auto iter = bindingSet.find(&binding);
+    if(iter != bindingSet.end())
+        return *iter;
+    bindings.push_back(std::move(binding));
+    auto *retval = &bindings.back();
+    bindingSet.insert(retval);
+    return retval;
+}
+
+const ConstantEvaluator::CacheEntry *ConstantEvaluator::findOrStart(
+    const Node *node, const TemplateBinding *binding, parse::LocationRange referenceLocation)
+{
+    auto emplaceResult = cache.emplace(CacheKey{node, binding}, CacheEntry{State::InProgress, {}});
+    if(std::get<1>(emplaceResult))
+    {
+        missCount++;
+        return nullptr;
+    }
+    auto &entry = std::get<1>(*std::get<0>(emplaceResult));
+    if(entry.state == State::InProgress)
+        throw parse::ParseError(referenceLocation, "constant's value depends on itself");
+    hitCount++;
+    return &entry;
+}
+
+const BitVector *ConstantEvaluator::evaluate(const Expression *expression,
+                                             const TemplateBinding *binding)
+{
+    if(auto *entry = findOrStart(expression, binding, expression->locationRange))
+        return entry->state == State::Done ? &entry->value : nullptr;
+    InProgressGuard guard(*this, CacheKey{expression, binding});
+    BitVector value;
+    bool isConstant = evaluateUncached(expression, binding, value);
+    return guard.finish(isConstant, std::move(value));
+}
+
+const BitVector *ConstantEvaluator::getSymbolValue(const Symbol *symbol,
+                                                   const TemplateBinding *binding,
+                                                   parse::LocationRange referenceLocation)
+{
+    if(auto *parameter = dynamic_cast<const ValueTemplateParameter *>(symbol))
+    {
+        auto *argument = binding ? binding->find(parameter) : nullptr;
+        return argument ? &argument->value : nullptr;
+    }
+    if(!dynamic_cast<const ConstStatementPart *>(symbol) && !dynamic_cast<const EnumPart *>(symbol))
+        return nullptr;
+    auto *node = dynamic_cast<const Node *>(symbol);
+    if(auto *entry = findOrStart(node, binding, referenceLocation))
+        return entry->state == State::Done ? &entry->value : nullptr;
+    InProgressGuard guard(*this, CacheKey{node, binding});
+    BitVector value;
+    bool isConstant = evaluateSymbolUncached(symbol, binding, value);
+    return guard.finish(isConstant, std::move(value));
+}
+
+bool ConstantEvaluator::evaluateSymbolUncached(const Symbol *symbol,
+                                               const TemplateBinding *binding,
+                                               BitVector &result)
+{
+    if(auto *constStatementPart = dynamic_cast<const ConstStatementPart *>(symbol))
+        return constStatementPart->value
+               && evaluateUncached(constStatementPart->value, binding, result);
+    auto *enumPart = dynamic_cast<const EnumPart *>(symbol);
+    assert(enumPart);
+    auto *parentEnum = enumPart->parentEnum;
+    IntegerTypeInfo underlyingType{};
+    bool hasUnderlyingType = parentEnum && parentEnum->underlyingType;
+    if(hasUnderlyingType && !getIntegerType(parentEnum->underlyingType, binding, underlyingType))
+        return false;
+    if(enumPart->value)
+    {
+        if(!evaluateUncached(enumPart->value, binding, result))
+            return false;
+    }
+    else
+    {
+        // parts without a value are one more than the part before them, or zero if they're first
+        const EnumPart *previousPart = nullptr;
+        if(parentEnum)
+        {
+            for(auto &part : parentEnum->parts)
+            {
+                if(part.enumPart == enumPart)
+                    break;
+                previousPart = part.enumPart;
+            }
+        }
+        if(previousPart)
+        {
+            auto *previousValue =
+                getSymbolValue(previousPart, binding, enumPart->symbolLocationRange);
+            if(!previousValue)
+                return false;
+            // only widen when the next value doesn't fit, so long enums stay narrow
+            auto kind = previousValue->getKind();
+            auto bitCount = previousValue->getBitCount();
+            auto one = constant_operators::makeBool(true);
+            result = BitVector::add(kind, bitCount, *previousValue, one);
+            bool overflowed = kind == Kind::Signed ?
+                                  result.isNegative() && !previousValue->isNegative() :
+                                  result.isZero();
+            if(overflowed)
+            {
+                if(++bitCount > maxBitCount)
+                    throw parse::ParseError(enumPart->symbolLocationRange, "constant is too wide");
+                result = BitVector::add(kind, bitCount, *previousValue, one);
+            }
+        }
+        else
+        {
+            result = BitVector(Kind::Signed, 1);
+        }
+    }
+    if(hasUnderlyingType)
+    {
+        auto converted = convert(underlyingType, result);
+        if(converted.getValue() != result.getValue())
+            throw parse::ParseError(enumPart->value ? enumPart->value->locationRange :
+                                                      enumPart->symbolLocationRange,
+                                    "enum value doesn't fit in the enum's underlying type");
+        result = std::move(converted);
+    }
+    return true;
+}
+
+bool ConstantEvaluator::evaluateSize(const Expression *expression,
+                                     const TemplateBinding *binding,
+                                     std::size_t maxValue,
+                                     std::size_t &result)
+{
+    auto *value = evaluate(expression, binding);
+    if(!value)
+        return false;
+    result = constant_operators::getSize(*value, maxValue, expression->locationRange);
+    return true;
+}
+
+bool ConstantEvaluator::getIntegerType(const Type *type,
+                                       const TemplateBinding *binding,
+                                       IntegerTypeInfo &result)
+{
+    while(type)
+    {
+        if(auto *uIntType = dynamic_cast<const UIntType *>(type))
+        {
+            result.kind = Kind::Unsigned;
+            return evaluateSize(uIntType->bitCount, binding, maxBitCount, result.bitCount);
+        }
+        if(auto *sIntType = dynamic_cast<const SIntType *>(type))
+        {
+            result.kind = Kind::Signed;
+            return evaluateSize(sIntType->bitCount, binding, maxBitCount, result.bitCount);
+        }
+        if(dynamic_cast<const IntegerType *>(type))
+            return getBuiltInIntegerType<BitType>(type, result)
+                   || getBuiltInIntegerType<U8Type>(type, result)
+                   || getBuiltInIntegerType<U16Type>(type, result)
+                   || getBuiltInIntegerType<U32Type>(type, result)
+                   || getBuiltInIntegerType<U64Type>(type, result)
+                   || getBuiltInIntegerType<S8Type>(type, result)
+                   || getBuiltInIntegerType<S16Type>(type, result)
+                   || getBuiltInIntegerType<S32Type>(type, result)
+                   || getBuiltInIntegerType<S64Type>(type, result);
+        if(auto *flipType = dynamic_cast<const FlipType *>(type))
+        {
+            type = flipType->type;
+            continue;
+        }
+        auto *scopedIdType = dynamic_cast<const ScopedIdType *>(type);
+        if(!scopedIdType)
+            return false;
+        auto *symbol = nameResolver.resolve(scopedIdType->value);
+        if(auto *typeStatement = dynamic_cast<const TypeStatement *>(symbol))
+        {
+            // aliases aren't cached, the entry only detects aliases of themselves
+            CacheKey key{typeStatement, binding};
+            if(!std::get<1>(cache.emplace(key, CacheEntry{State::InProgress, {}})))
+                throw parse::ParseError(scopedIdType->locationRange, "type is an alias of itself");
+            InProgressGuard guard(*this, key);
+            return getIntegerType(typeStatement->type, binding, result);
+        }
+        if(auto *enumSymbol = dynamic_cast<const Enum *>(symbol))
+        {
+            type = enumSymbol->underlyingType;
+            continue;
+        }
+        auto *parameter = dynamic_cast<const TypeTemplateParameter *>(symbol);
+        auto *argument = parameter && binding ? binding->find(parameter) : nullptr;
+        if(!argument)
+            return false;
+        type = argument->type;
+        binding = argument->typeBinding;
+    }
+    return false;
+}
+
+bool ConstantEvaluator::getMemorySize(const MemoryType *memoryType,
+                                      const TemplateBinding *binding,
+                                      std::size_t &result)
+{
+    return evaluateSize(
+        memoryType->size, binding, std::numeric_limits<std::size_t>::max(), result);
+}
+
+bool ConstantEvaluator::evaluateUncached(const Expression *expression,
+                                         const TemplateBinding *binding,
+                                         BitVector &result)
+{
+    constant_operators::UnaryOperator unaryOperator;
+    constant_operators::BinaryOperator binaryOperator;
+    if(auto *numberExpression = dynamic_cast<const NumberExpression *>(expression))
+    {
+        result =
+            constant_operators::makeLiteral(numberExpression->value, expression->locationRange);
+        return true;
+    }
+    if(auto *parenExpression = dynamic_cast<const ParenExpression *>(expression))
+        return evaluateUncached(parenExpression->expression, binding, result);
+    if(auto *scopedIdExpression = dynamic_cast<const ScopedIdExpression *>(expression))
+    {
+        auto *symbol = nameResolver.resolve(scopedIdExpression->value);
+        auto *value = symbol ? getSymbolValue(symbol, binding, expression->locationRange) : nullptr;
+        if(!value)
+            return false;
+        result = *value;
+        return true;
+    }
+    if(constant_operators::getUnaryOperator(expression, unaryOperator))
+    {
+        auto *argument = dynamic_cast<const PopCountExpression *>(expression) ?
+                             static_cast<const PopCountExpression *>(expression)->expression :
+                             static_cast<const UnaryExpression *>(expression)->argument;
+        BitVector value;
+        if(!evaluateUncached(argument, binding, value))
+            return false;
+        result = constant_operators::evaluate(unaryOperator, value, expression->locationRange);
+        return true;
+    }
+    if(auto *binaryExpression = dynamic_cast<const BinaryExpression *>(expression))
+    {
+        BitVector l;
+        if(!evaluateUncached(binaryExpression->lhs, binding, l))
+            return false;
+        bool isAnd = dynamic_cast<const LogicalAndExpression *>(expression);
+        bool isOr = dynamic_cast<const LogicalOrExpression *>(expression);
+        if(isAnd || isOr)
+        {
+            // short circuits, so the right side only needs to be constant when it's used
+            if(l.isZero() == isAnd)
+            {
+                result = constant_operators::makeBool(isOr);
+                return true;
+            }
+            BitVector r;
+            if(!evaluateUncached(binaryExpression->rhs, binding, r))
+                return false;
+            result = constant_operators::makeBool(!r.isZero());
+            return true;
+        }
+        BitVector r;
+        if(!constant_operators::getBinaryOperator(binaryExpression, binaryOperator)
+           || !evaluateUncached(binaryExpression->rhs, binding, r))
+            return false;
+        result = constant_operators::evaluate(binaryOperator, l, r, expression->locationRange);
+        return true;
+    }
+    if(auto *conditionalExpression = dynamic_cast<const ConditionalExpression *>(expression))
+    {
+        BitVector condition;
+        if(!evaluateUncached(conditionalExpression->condition, binding, condition))
+            return false;
+        return evaluateUncached(condition.isZero() ? conditionalExpression->falseValue :
+                                                     conditionalExpression->trueValue,
+                                binding,
+                                result);
+    }
+    if(auto *castExpression = dynamic_cast<const CastExpression *>(expression))
+    {
+        IntegerTypeInfo type;
+        if(!getIntegerType(castExpression->type, binding, type)
+           || !evaluateUncached(castExpression->expression, binding, result))
+            return false;
+        result = convert(type, result);
+        return true;
+    }
+    if(auto *catExpression = dynamic_cast<const CatExpression *>(expression))
+    {
+        std::vector<BitVector> parts;
+        parts.resize(catExpression->parts.size() + 1);
+        if(!evaluateUncached(catExpression->firstExpression, binding, parts[0]))
+            return false;
+        for(std::size_t i = 0; i < catExpression->parts.size(); i++)
+            if(!evaluateUncached(catExpression->parts[i].expression, binding, parts[i + 1]))
+                return false;
+        result =
+            constant_operators::concatenate(parts.data(), parts.size(), expression->locationRange);
+        return true;
+    }
+    if(auto *fillExpression = dynamic_cast<const FillExpression *>(expression))
+    {
+        BitVector count;
+        BitVector value;
+        if(!evaluateUncached(fillExpression->countExpression, binding, count)
+           || !evaluateUncached(fillExpression->valueExpression, binding, value))
+            return false;
+        result = constant_operators::fill(count, value, expression->locationRange);
+        return true;
+    }
+    if(auto *sliceExpression = dynamic_cast<const SliceExpression *>(expression))
+    {
+        // value[index] is one bit, value[high to low] is the bits from high down to low
+        BitVector value;
+        BitVector startIndex;
+        BitVector endIndex;
+        if(!evaluateUncached(sliceExpression->slicedValue, binding, value)
+           || !evaluateUncached(sliceExpression->startIndex, binding, startIndex)
+           || (sliceExpression->endIndex
+               && !evaluateUncached(sliceExpression->endIndex, binding, endIndex)))
+            return false;
+        auto high = constant_operators::getSize(startIndex,
+                                                constant_operators::maxBitCount,
+                                                sliceExpression->startIndex->locationRange);
+        auto low = sliceExpression->endIndex ?
+                       constant_operators::getSize(endIndex,
+                                                   constant_operators::maxBitCount,
+                                                   sliceExpression->endIndex->locationRange) :
+                       high;
+        result = constant_operators::slice(value, high, low, expression->locationRange);
+        return true;
+    }
+    if(auto *functionCallExpression = dynamic_cast<const FunctionCallExpression *>(expression))
+    {
+        auto *scopedIdExpression =
+            dynamic_cast<const ScopedIdExpression *>(functionCallExpression->function);
+        auto *function =
+            scopedIdExpression ?
+                dynamic_cast<const Function *>(nameResolver.resolve(scopedIdExpression->value)) :
+                nullptr;
+        if(!function || !functionEvaluator)
+            return false;
+        std::vector<BitVector> arguments;
+        if(functionCallExpression->firstExpression)
+        {
+            arguments.resize(functionCallExpression->parts.size() + 1);
+            if(!evaluateUncached(functionCallExpression->firstExpression, binding, arguments[0]))
+                return false;
+            for(std::size_t i = 0; i < functionCallExpression->parts.size(); i++)
+                if(!evaluateUncached(
+                       functionCallExpression->parts[i].expression, binding, arguments[i + 1]))
+                    return false;
+        }
+        auto *value =
+            functionEvaluator->call(function, std::move(arguments), expression->locationRange);
+        if(!value)
+            return false;
+        result = *value;
+        return true;
+    }
+    return false;
+}
+
+void ConstantEvaluator::evaluateAll(const Node *root, const TemplateBinding *binding)
+{
+    Visitor(*this, binding).visitNode(root);
+}
+
+std::size_t ConstantEvaluator::getHeapBytes() const noexcept
+{
+    std::size_t retval = util::getHashTableHeapBytes(cache)
+                         + util::getHashTableHeapBytes(bindingSet)
+                         + bindings.size() * sizeof(TemplateBinding);
+    for(auto &entry : cache)
+        retval += std::get<1>(entry).value.getHeapBytes();
+    for(auto &binding : bindings)
+    {
+        retval += util::getHeapBytes(binding.arguments);
+        for(auto &argument : binding.arguments)
+            retval += argument.value.getHeapBytes();
+    }
+    return retval;
+}
+}
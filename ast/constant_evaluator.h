@@ -0,0 +1,220 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "constant_operators.h"
+#include "expression.h"
+#include "memory_type.h"
+#include "name_resolver.h"
+#include "node.h"
+#include "symbol.h"
+#include "template_parameter.h"
+#include "type.h"
+#include "../math/bit_vector.h"
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ast
+{
+class Function;
+
+/** the arguments a template is instantiated with. Bindings are interned by ConstantEvaluator::bind,
+ * so bindings with the same arguments are the same object and can be compared by pointer. */
+class TemplateBinding final
+{
+public:
+    struct Argument final
+    {
+        const TemplateParameter *parameter;
+        /** the bound type for a TypeTemplateParameter, otherwise nullptr */
+        const Type *type;
+        /** the binding type is evaluated in */
+        const TemplateBinding *typeBinding;
+        /** the bound value for a ValueTemplateParameter */
+        math::BitVector value;
+    };
+
+public:
+    /** sorted by parameter */
+    std::vector<Argument> arguments;
+
+public:
+    /** returns nullptr if parameter isn't bound */
+    const Argument *find(const TemplateParameter *parameter) const noexcept;
+};
+
+/** evaluates constant expressions: const statements, enum values, integer type widths, and memory
+ * sizes, with the operators in constant_operators.h. Values are cached per node and template
+ * binding, so an expression shared by many declarations is only evaluated once per
+ * instantiation. Errors, including constants that depend on themselves, are thrown as
+ * parse::ParseError. */
+class ConstantEvaluator final
+{
+public:
+    struct IntegerTypeInfo final
+    {
+        math::BitVector::Kind kind;
+        std::size_t bitCount;
+    };
+    /** the widest constant that can be computed */
+    static constexpr std::size_t maxBitCount = constant_operators::maxBitCount;
+    /** evaluates calls to functions in constant expressions */
+    class FunctionEvaluator
+    {
+    public:
+        virtual ~FunctionEvaluator() = default;
+        /** returns nullptr if function can't be evaluated at compile time */
+        virtual const math::BitVector *call(const Function *function,
+                                            std::vector<math::BitVector> arguments,
+                                            parse::LocationRange callLocation) = 0;
+    };
+
+private:
+    class InProgressGuard;
+    class Visitor;
+    enum class State
+    {
+        InProgress,
+        NotConstant,
+        Done,
+    };
+    struct CacheKey final
+    {
+        const Node *node;
+        const TemplateBinding *binding;
+        friend bool operator==(const CacheKey &a, const CacheKey &b) noexcept
+        {
+            return a.node == b.node && a.binding == b.binding;
+        }
+    };
+    struct CacheKeyHasher final
+    {
+        std::size_t operator()(const CacheKey &value) const noexcept
+        {
+            return std::hash<const void *>()(value.node) * 0x100000001B3ULL
+                   ^ std::hash<const void *>()(value.binding);
+        }
+    };
+    struct CacheEntry final
+    {
+        State state;
+        math::BitVector value;
+    };
+    struct TemplateBindingHasher final
+    {
+        std::size_t operator()(const TemplateBinding *value) const noexcept;
+    };
+    struct TemplateBindingEqual final
+    {
+        bool operator()(const TemplateBinding *a, const TemplateBinding *b) const noexcept;
+    };
+
+private:
+    NameResolver &nameResolver;
+    FunctionEvaluator *functionEvaluator = nullptr;
+    std::unordered_map<CacheKey, CacheEntry, CacheKeyHasher> cache;
+    std::deque<TemplateBinding> bindings;
+    std::unordered_set<const TemplateBinding *, TemplateBindingHasher, TemplateBindingEqual>
+        bindingSet;
+    std::size_t hitCount = 0;
+    std::size_t missCount = 0;
+
+private:
+    /** looks up or starts a cache entry; returns the finished entry, or nullptr after adding an
+     * in-progress entry for the caller to fill in */
+    const CacheEntry *findOrStart(const Node *node,
+                                  const TemplateBinding *binding,
+                                  parse::LocationRange referenceLocation);
+    bool evaluateUncached(const Expression *expression,
+                          const TemplateBinding *binding,
+                          math::BitVector &result);
+    const math::BitVector *getSymbolValue(const Symbol *symbol,
+                                          const TemplateBinding *binding,
+                                          parse::LocationRange referenceLocation);
+    bool evaluateSymbolUncached(const Symbol *symbol,
+                                const TemplateBinding *binding,
+                                math::BitVector &result);
+    /** throws if the value is negative or bigger than maxValue */
+    bool evaluateSize(const Expression *expression,
+                      const TemplateBinding *binding,
+                      std::size_t maxValue,
+                      std::size_t &result);
+
+public:
+    explicit ConstantEvaluator(NameResolver &nameResolver) noexcept : nameResolver(nameResolver)
+    {
+    }
+    ConstantEvaluator(const ConstantEvaluator &) = delete;
+    ConstantEvaluator &operator=(const ConstantEvaluator &) = delete;
+    NameResolver &getNameResolver() const noexcept
+    {
+        return nameResolver;
+    }
+    /** without a function evaluator, function calls aren't constant */
+    void setFunctionEvaluator(FunctionEvaluator *newFunctionEvaluator) noexcept
+    {
+        functionEvaluator = newFunctionEvaluator;
+    }
+    /** returns the interned binding with arguments, which don't need to be sorted */
+    const TemplateBinding *bind(std::vector<TemplateBinding::Argument> arguments);
+    /** returns nullptr if expression isn't constant, such as when it names a template parameter
+     * that binding doesn't bind, a variable, or a function */
+    const math::BitVector *evaluate(const Expression *expression,
+                                    const TemplateBinding *binding = nullptr);
+    /** returns the value of a const statement part, enum part, or value template parameter, or
+     * nullptr if symbol isn't one of those or its value isn't constant */
+    const math::BitVector *getSymbolValue(const Symbol *symbol,
+                                          const TemplateBinding *binding = nullptr)
+    {
+        return getSymbolValue(symbol, binding, symbol->symbolLocationRange);
+    }
+    /** returns false if type isn't an integer type, enum, or alias of one, or if its width isn't
+     * constant */
+    bool getIntegerType(const Type *type,
+                        const TemplateBinding *binding,
+                        IntegerTypeInfo &result);
+    /** returns false if the size isn't constant */
+    bool getMemorySize(const MemoryType *memoryType,
+                       const TemplateBinding *binding,
+                       std::size_t &result);
+    /** evaluates every const statement, enum value, integer type width, and memory size reachable
+     * from root that is constant with binding; without a binding, only the ones that don't depend
+     * on template arguments are constant */
+    void evaluateAll(const Node *root, const TemplateBinding *binding = nullptr);
+    /** the number of values that are cached, including the values that aren't constant */
+    std::size_t getCachedValueCount() const noexcept
+    {
+        return cache.size();
+    }
+    std::size_t getHitCount() const noexcept
+    {
+        return hitCount;
+    }
+    std::size_t getMissCount() const noexcept
+    {
+        return missCount;
+    }
+    /** the bytes allocated for the cached values and the bindings */
+    std::size_t getHeapBytes() const noexcept;
+};
+}
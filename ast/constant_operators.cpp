@@ -0,0 +1,320 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "constant_operators.h"
+#include "binary_expression.h"
+#include "pop_count_expression.h"
+#include "unary_expression.h"
+#include "../math/bit_vector_view.h"
+#include "../parse/parse_error.h"
+#include <algorithm>
+
+namespace ast
+{
+namespace constant_operators
+{
+namespace
+{
+typedef math::BitVector BitVector;
+typedef BitVector::Kind Kind;
+
+void checkBitCount(std::size_t bitCount, parse::LocationRange location)
+{
+    if(bitCount > maxBitCount)
+        throw parse::ParseError(location, "constant is too wide");
+}
+
+BitVector convert(Kind kind, std::size_t bitCount, const BitVector &value)
+{
+    if(value.getKind() == kind && value.getBitCount() == bitCount)
+        return value;
+    return BitVector::cast(kind, bitCount, value);
+}
+
+/** returns false if the non-negative value is bigger than maxValue */
+bool getSize(const BitVector &value, std::size_t maxValue, std::size_t &result) noexcept
+{
+    auto *words = value.getWords();
+    for(std::size_t i = 1; i < value.getWordCount(); i++)
+        if(words[i] != 0)
+            return false;
+    if(words[0] > maxValue)
+        return false;
+    result = static_cast<std::size_t>(words[0]);
+    return true;
+}
+}
+
+void getCommonType(const BitVector &l,
+                   const BitVector &r,
+                   Kind &kind,
+                   std::size_t &bitCount) noexcept
+{
+    if(l.getKind() == r.getKind())
+    {
+        kind = l.getKind();
+        bitCount = std::max(l.getBitCount(), r.getBitCount());
+        return;
+    }
+    auto getSignedBitCount = [](const BitVector &value) noexcept
+    {
+        return value.getKind() == Kind::Unsigned ? value.getBitCount() + 1 : value.getBitCount();
+    };
+    kind = Kind::Signed;
+    bitCount = std::max(getSignedBitCount(l), getSignedBitCount(r));
+}
+
+bool getUnaryOperator(const Expression *expression, UnaryOperator &result) noexcept
+{
+    if(dynamic_cast<const LogicalNotExpression *>(expression))
+        result = UnaryOperator::LogicalNot;
+    else if(dynamic_cast<const BitwiseNotExpression *>(expression))
+        result = UnaryOperator::BitwiseNot;
+    else if(dynamic_cast<const UnaryPlusExpression *>(expression))
+        result = UnaryOperator::Plus;
+    else if(dynamic_cast<const UnaryMinusExpression *>(expression))
+        result = UnaryOperator::Minus;
+    else if(dynamic_cast<const AndReduceExpression *>(expression))
+        result = UnaryOperator::AndReduce;
+    else if(dynamic_cast<const OrReduceExpression *>(expression))
+        result = UnaryOperator::OrReduce;
+    else if(dynamic_cast<const XorReduceExpression *>(expression))
+        result = UnaryOperator::XorReduce;
+    else if(dynamic_cast<const PopCountExpression *>(expression))
+        result = UnaryOperator::PopCount;
+    else
+        return false;
+    return true;
+}
+
+bool getBinaryOperator(const BinaryExpression *expression, BinaryOperator &result) noexcept
+{
+    if(dynamic_cast<const AddExpression *>(expression))
+        result = BinaryOperator::Add;
+    else if(dynamic_cast<const SubExpression *>(expression))
+        result = BinaryOperator::Subtract;
+    else if(dynamic_cast<const MulExpression *>(expression))
+        result = BinaryOperator::Multiply;
+    else if(dynamic_cast<const DivExpression *>(expression))
+        result = BinaryOperator::Divide;
+    else if(dynamic_cast<const RemExpression *>(expression))
+        result = BinaryOperator::Remainder;
+    else if(dynamic_cast<const BitwiseAndExpression *>(expression))
+        result = BinaryOperator::BitwiseAnd;
+    else if(dynamic_cast<const BitwiseOrExpression *>(expression))
+        result = BinaryOperator::BitwiseOr;
+    else if(dynamic_cast<const BitwiseXorExpression *>(expression))
+        result = BinaryOperator::BitwiseXor;
+    else if(dynamic_cast<const LeftShiftExpression *>(expression))
+        result = BinaryOperator::ShiftLeft;
+    else if(dynamic_cast<const RightShiftExpression *>(expression))
+        result = BinaryOperator::ShiftRight;
+    else if(dynamic_cast<const CompareEqExpression *>(expression))
+        result = BinaryOperator::CompareEq;
+    else if(dynamic_cast<const CompareNEExpression *>(expression))
+        result = BinaryOperator::CompareNE;
+    else if(dynamic_cast<const CompareLTExpression *>(expression))
+        result = BinaryOperator::CompareLT;
+    else if(dynamic_cast<const CompareLEExpression *>(expression))
+        result = BinaryOperator::CompareLE;
+    else if(dynamic_cast<const CompareGTExpression *>(expression))
+        result = BinaryOperator::CompareGT;
+    else if(dynamic_cast<const CompareGEExpression *>(expression))
+        result = BinaryOperator::CompareGE;
+    else
+        return false;
+    return true;
+}
+
+BitVector makeBool(bool value)
+{
+    return BitVector(Kind::Unsigned, 1, math::GMPInteger(value ? 1L : 0L));
+}
+
+BitVector makeLiteral(const math::GMPInteger &value, parse::LocationRange location)
+{
+    auto mpzView = value.getMpz();
+    mpz_srcptr mpz = mpzView;
+    std::size_t bitCount = mpz_sgn(mpz) == 0 ? 1 : mpz_sizeinbase(mpz, 2) + 1;
+    checkBitCount(bitCount, location);
+    return BitVector(Kind::Signed, bitCount, value);
+}
+
+std::size_t getSize(const BitVector &value, std::size_t maxValue, parse::LocationRange location)
+{
+    if(value.isNegative())
+        throw parse::ParseError(location, "size can't be negative");
+    std::size_t retval;
+    if(!getSize(value, maxValue, retval))
+        throw parse::ParseError(location, "size is too big");
+    return retval;
+}
+
+BitVector evaluate(UnaryOperator unaryOperator,
+                   const BitVector &value,
+                   parse::LocationRange location)
+{
+    switch(unaryOperator)
+    {
+    case UnaryOperator::LogicalNot:
+        return makeBool(value.isZero());
+    case UnaryOperator::BitwiseNot:
+        return BitVector::bitwiseNot(value.getKind(), value.getBitCount(), value);
+    case UnaryOperator::Plus:
+        return value;
+    case UnaryOperator::Minus:
+    {
+        auto bitCount = value.getBitCount() + 1;
+        checkBitCount(bitCount, location);
+        return BitVector::negate(Kind::Signed, bitCount, convert(Kind::Signed, bitCount, value));
+    }
+    case UnaryOperator::AndReduce:
+        return BitVector::reduceAnd(value);
+    case UnaryOperator::OrReduce:
+        return BitVector::reduceOr(value);
+    case UnaryOperator::XorReduce:
+        return BitVector::reduceXor(value);
+    case UnaryOperator::PopCount:
+    {
+        // wide enough to hold the bit count of value
+        std::size_t bitCount = 1;
+        while(bitCount < sizeof(std::size_t) * 8 && value.getBitCount() >> bitCount != 0)
+            bitCount++;
+        return BitVector::popCount(Kind::Unsigned, bitCount, value);
+    }
+    }
+    assert(false);
+    return value;
+}
+
+BitVector evaluate(BinaryOperator binaryOperator,
+                   const BitVector &l,
+                   const BitVector &r,
+                   parse::LocationRange location)
+{
+    if(binaryOperator == BinaryOperator::ShiftLeft || binaryOperator == BinaryOperator::ShiftRight)
+    {
+        if(r.isNegative())
+            throw parse::ParseError(location, "shift count can't be negative");
+        if(binaryOperator == BinaryOperator::ShiftRight)
+            return BitVector::shiftRight(l.getKind(), l.getBitCount(), l, r);
+        std::size_t shiftCount;
+        if(!getSize(r, maxBitCount - l.getBitCount(), shiftCount))
+            throw parse::ParseError(location, "constant is too wide");
+        auto bitCount = l.getBitCount() + shiftCount;
+        return BitVector::shiftLeft(
+            l.getKind(), bitCount, convert(l.getKind(), bitCount, l), r);
+    }
+    Kind kind;
+    std::size_t bitCount;
+    getCommonType(l, r, kind, bitCount);
+    checkBitCount(bitCount, location);
+    auto convertedL = convert(kind, bitCount, l);
+    auto convertedR = convert(kind, bitCount, r);
+    switch(binaryOperator)
+    {
+    case BinaryOperator::ShiftLeft:
+    case BinaryOperator::ShiftRight:
+        break;
+    case BinaryOperator::CompareEq:
+        return makeBool(BitVector::compare(convertedL, convertedR) == 0);
+    case BinaryOperator::CompareNE:
+        return makeBool(BitVector::compare(convertedL, convertedR) != 0);
+    case BinaryOperator::CompareLT:
+        return makeBool(BitVector::compare(convertedL, convertedR) < 0);
+    case BinaryOperator::CompareLE:
+        return makeBool(BitVector::compare(convertedL, convertedR) <= 0);
+    case BinaryOperator::CompareGT:
+        return makeBool(BitVector::compare(convertedL, convertedR) > 0);
+    case BinaryOperator::CompareGE:
+        return makeBool(BitVector::compare(convertedL, convertedR) >= 0);
+    case BinaryOperator::BitwiseAnd:
+        return BitVector::bitwiseAnd(kind, bitCount, convertedL, convertedR);
+    case BinaryOperator::BitwiseOr:
+        return BitVector::bitwiseOr(kind, bitCount, convertedL, convertedR);
+    case BinaryOperator::BitwiseXor:
+        return BitVector::bitwiseXor(kind, bitCount, convertedL, convertedR);
+    case BinaryOperator::Add:
+        checkBitCount(bitCount + 1, location);
+        return BitVector::add(kind, bitCount + 1, convertedL, convertedR);
+    case BinaryOperator::Subtract:
+        // unsigned values can go negative
+        checkBitCount(bitCount + 1, location);
+        return BitVector::subtract(Kind::Signed, bitCount + 1, convertedL, convertedR);
+    case BinaryOperator::Multiply:
+        checkBitCount(bitCount * 2, location);
+        return BitVector::multiply(kind, bitCount * 2, convertedL, convertedR);
+    case BinaryOperator::Divide:
+    {
+        if(convertedR.isZero())
+            throw parse::ParseError(location, "division by zero");
+        // the most negative value divided by -1 needs one more bit
+        auto resultBitCount = bitCount + (kind == Kind::Signed);
+        checkBitCount(resultBitCount, location);
+        return BitVector::divide(kind, resultBitCount, convertedL, convertedR);
+    }
+    case BinaryOperator::Remainder:
+        if(convertedR.isZero())
+            throw parse::ParseError(location, "division by zero");
+        return BitVector::remainder(kind, bitCount, convertedL, convertedR);
+    }
+    assert(false);
+    return l;
+}
+
+BitVector concatenate(const BitVector *values,
+                      std::size_t valueCount,
+                      parse::LocationRange location)
+{
+    math::BitVectorConcatenator concatenator;
+    concatenator.reserve(valueCount);
+    for(std::size_t i = 0; i < valueCount; i++)
+        concatenator.append(math::BitVectorView(values[i]));
+    checkBitCount(concatenator.getBitCount(), location);
+    return concatenator.finish(Kind::Unsigned);
+}
+
+BitVector fill(const BitVector &count, const BitVector &value, parse::LocationRange location)
+{
+    auto countValue = getSize(count, maxBitCount, location);
+    if(countValue == 0)
+        throw parse::ParseError(location, "fill count can't be zero");
+    if(countValue > maxBitCount / value.getBitCount())
+        throw parse::ParseError(location, "constant is too wide");
+    math::BitVectorView valueView(value);
+    math::BitVectorConcatenator concatenator;
+    concatenator.reserve(countValue);
+    for(std::size_t i = 0; i < countValue; i++)
+        concatenator.append(valueView);
+    return concatenator.finish(Kind::Unsigned);
+}
+
+BitVector slice(const BitVector &value,
+                std::size_t high,
+                std::size_t low,
+                parse::LocationRange location)
+{
+    if(high < low)
+        throw parse::ParseError(location, "slice indexes are reversed, slices are [high to low]");
+    if(high >= value.getBitCount())
+        throw parse::ParseError(location, "slice is out of range");
+    return BitVector::slice(Kind::Unsigned, high - low + 1, value, low);
+}
+}
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "../math/bit_vector.h"
+#include "../math/gmp_integer.h"
+#include "../parse/source.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace ast
+{
+class BinaryExpression;
+class Expression;
+
+/** the operators shared by the constant evaluator and the bytecode interpreter. Results are
+ * exact: every operator produces a result wide enough that it can't overflow. Errors, such as
+ * division by zero, are thrown as parse::ParseError at location. */
+namespace constant_operators
+{
+enum class UnaryOperator : std::uint8_t
+{
+    LogicalNot,
+    BitwiseNot,
+    Plus,
+    Minus,
+    AndReduce,
+    OrReduce,
+    XorReduce,
+    PopCount,
+};
+
+enum class BinaryOperator : std::uint8_t
+{
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Remainder,
+    BitwiseAnd,
+    BitwiseOr,
+    BitwiseXor,
+    ShiftLeft,
+    ShiftRight,
+    CompareEq,
+    CompareNE,
+    CompareLT,
+    CompareLE,
+    CompareGT,
+    CompareGE,
+};
+
+/** the widest value that can be computed */
+constexpr std::size_t maxBitCount = static_cast<std::size_t>(1) << 24;
+
+/** returns false if expression isn't a unary operator or a pop count */
+bool getUnaryOperator(const Expression *expression, UnaryOperator &result) noexcept;
+/** returns false if expression isn't a binary operator, including for the logical operators,
+ * which short circuit */
+bool getBinaryOperator(const BinaryExpression *expression, BinaryOperator &result) noexcept;
+/** the type both operands of a binary operator are converted to: signed if either is signed, and
+ * wide enough to hold both */
+void getCommonType(const math::BitVector &l,
+                   const math::BitVector &r,
+                   math::BitVector::Kind &kind,
+                   std::size_t &bitCount) noexcept;
+math::BitVector makeBool(bool value);
+/** number literals are signed and just wide enough to hold their value */
+math::BitVector makeLiteral(const math::GMPInteger &value, parse::LocationRange location);
+/** throws if value is negative or bigger than maxValue */
+std::size_t getSize(const math::BitVector &value,
+                    std::size_t maxValue,
+                    parse::LocationRange location);
+math::BitVector evaluate(UnaryOperator unaryOperator,
+                         const math::BitVector &value,
+                         parse::LocationRange location);
+math::BitVector evaluate(BinaryOperator binaryOperator,
+                         const math::BitVector &l,
+                         const math::BitVector &r,
+                         parse::LocationRange location);
+/** the first value is the most significant; the result is unsigned */
+math::BitVector concatenate(const math::BitVector *values,
+                            std::size_t valueCount,
+                            parse::LocationRange location);
+math::BitVector fill(const math::BitVector &count,
+                     const math::BitVector &value,
+                     parse::LocationRange location);
+/** the bits of value from high down to and including low, like value[high to low]; the result is
+ * unsigned */
+math::BitVector slice(const math::BitVector &value,
+                      std::size_t high,
+                      std::size_t low,
+                      parse::LocationRange location);
+}
+}
@@ -18,6 +18,7 @@
  */
 
 #include "continue_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -28,4 +29,21 @@ void ContinueStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     state.setSimple(dumpNode, "beforeContinueComments", beforeContinueComments);
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void ContinueStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ContinueStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeContinueComments);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+ContinueStatement *ContinueStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeContinueComments = reader.readComments();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<ContinueStatement>(
+        locationRange, beforeContinueComments, beforeSemicolonComments);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "empty_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void EmptyStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     dumpNode->nodeName = "ast::EmptyStatement";
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void EmptyStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::EmptyStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+EmptyStatement *EmptyStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<EmptyStatement>(locationRange, beforeSemicolonComments);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "enum.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -33,6 +34,28 @@ void EnumPart::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointer(dumpNode, "parentEnum", parentEnum);
 }
 
+void EnumPart::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::EnumPart);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeEqualComments);
+    visitor.visitNode(value);
+}
+
+EnumPart *EnumPart::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    auto beforeEqualComments = reader.readComments();
+    auto *value = reader.readNode<Expression>();
+    return reader.create<EnumPart>(
+        locationRange, beforeNameComments, symbolLocationRange, name, beforeEqualComments, value);
+}
+
 void Enum::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     Node::dump(dumpNode, state);
@@ -54,4 +77,63 @@ void Enum::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     }
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void Enum::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::Enum);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    SymbolScope::visitFields(visitor);
+    visitor.visitComments(beforeEnumComments);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(underlyingType);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitNode(part.enumPart);
+        visitor.visitComments(part.beforeCommaComments);
+    }
+    visitor.visitComments(beforeRBraceComments);
+}
+
+Enum *Enum::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto beforeEnumComments = reader.readComments();
+    auto beforeNameComments = reader.readComments();
+    auto beforeColonComments = reader.readComments();
+    auto *underlyingType = reader.readNode<Type>();
+    auto beforeLBraceComments = reader.readComments();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto *enumPart = reader.readNode<EnumPart>();
+        auto beforeCommaComments = reader.readComments();
+        parts.push_back(Part(enumPart, beforeCommaComments));
+    }
+    auto beforeRBraceComments = reader.readComments();
+    auto *retval = reader.create<Enum>(locationRange,
+                                       symbolLookupChain,
+                                       symbolTable,
+                                       beforeEnumComments,
+                                       beforeNameComments,
+                                       symbolLocationRange,
+                                       name,
+                                       beforeColonComments,
+                                       underlyingType,
+                                       beforeLBraceComments,
+                                       std::move(parts),
+                                       beforeRBraceComments);
+    for(auto &part : retval->parts)
+        part.enumPart->parentEnum = retval;
+    return retval;
+}
 }
@@ -55,6 +55,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static EnumPart *deserialize(SnapshotReader &reader);
 };
 
 class Enum final : public Node, public Symbol, public SymbolScope
@@ -102,5 +104,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static Enum *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "enum_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void EnumStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     dumpNode->nodeName = "ast::EnumStatement";
     state.setPointer(dumpNode, "value", value);
 }
+
+void EnumStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::EnumStatement);
+    Statement::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+EnumStatement *EnumStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<Enum>();
+    return reader.create<EnumStatement>(locationRange, value);
+}
 }
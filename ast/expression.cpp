@@ -26,4 +26,9 @@ void Expression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     Node::dump(dumpNode, state);
     dumpNode->nodeName = "ast::Expression";
 }
+
+void Expression::visitFields(NodeFieldVisitor &visitor) const
+{
+    Node::visitFields(visitor);
+}
 }
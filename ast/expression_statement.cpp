@@ -18,6 +18,7 @@
  */
 
 #include "expression_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -28,4 +29,20 @@ void ExpressionStatement::dump(util::DumpTree *dumpNode, util::DumpState &state)
     state.setPointer(dumpNode, "expression", expression);
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void ExpressionStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ExpressionStatement);
+    Statement::visitFields(visitor);
+    visitor.visitNode(expression);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+ExpressionStatement *ExpressionStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *expression = reader.readNode<Expression>();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<ExpressionStatement>(locationRange, expression, beforeSemicolonComments);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "fill_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -32,4 +33,34 @@ void FillExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setPointer(dumpNode, "valueExpression", valueExpression);
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void FillExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::FillExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeFillComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(countExpression);
+    visitor.visitComments(beforeCommaComments);
+    visitor.visitNode(valueExpression);
+    visitor.visitComments(beforeRParenComments);
+}
+
+FillExpression *FillExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeFillComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *countExpression = reader.readNode<Expression>();
+    auto beforeCommaComments = reader.readComments();
+    auto *valueExpression = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<FillExpression>(locationRange,
+                                         beforeFillComments,
+                                         beforeLParenComments,
+                                         countExpression,
+                                         beforeCommaComments,
+                                         valueExpression,
+                                         beforeRParenComments);
+}
 }
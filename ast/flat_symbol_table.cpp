@@ -0,0 +1,84 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "flat_symbol_table.h"
+#include <cassert>
+
+namespace ast
+{
+constexpr std::size_t FlatSymbolTable::noBinding;
+
+void FlatSymbolTable::pushScope(const SymbolLookupChainNode *chainNode)
+{
+    scopes.push_back(Scope{bindings.size(), chainNode});
+}
+
+void FlatSymbolTable::pushScope(const SymbolTable *symbolTable,
+                                const SymbolLookupChainNode *chainNode)
+{
+    pushScope(chainNode);
+    for(auto *symbol : symbolTable->getLocalSymbols())
+        insert(symbol);
+}
+
+void FlatSymbolTable::popScope() noexcept
+{
+    assert(!scopes.empty());
+    auto bindingsStart = scopes.back().bindingsStart;
+    scopes.pop_back();
+    while(bindings.size() > bindingsStart)
+    {
+        auto &binding = bindings.back();
+        innermostBindings[binding.nameId] = binding.shadowedBinding;
+        bindings.pop_back();
+    }
+}
+
+bool FlatSymbolTable::insert(Symbol *symbol)
+{
+    assert(symbol);
+    assert(!scopes.empty());
+    auto id = symbol->name.getId();
+    if(id >= innermostBindings.size())
+        innermostBindings.resize(id + 1, noBinding);
+    auto shadowedBinding = innermostBindings[id];
+    if(shadowedBinding != noBinding && shadowedBinding >= scopes.back().bindingsStart)
+        return false;
+    innermostBindings[id] = bindings.size();
+    bindings.push_back(Binding{symbol, id, shadowedBinding});
+    return true;
+}
+
+void FlatSymbolTable::enterSymbolLookupChain(const SymbolLookupChain &chain)
+{
+    if(!scopes.empty() && scopes.back().chainNode == chain.head)
+        return;
+    chainScratch.clear();
+    for(auto *node = chain.head; node; node = node->parent)
+        chainScratch.push_back(node);
+    std::size_t commonScopeCount = 0;
+    while(commonScopeCount < scopes.size() && commonScopeCount < chainScratch.size()
+          && scopes[commonScopeCount].chainNode
+                 == chainScratch[chainScratch.size() - commonScopeCount - 1])
+        commonScopeCount++;
+    while(scopes.size() > commonScopeCount)
+        popScope();
+    for(std::size_t i = chainScratch.size() - commonScopeCount; i > 0; i--)
+        pushScope(chainScratch[i - 1]->symbolTable, chainScratch[i - 1]);
+}
+}
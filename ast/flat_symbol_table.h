@@ -0,0 +1,83 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "symbol.h"
+#include "symbol_table.h"
+#include "symbol_lookup_chain.h"
+#include "../util/string_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ast
+{
+/** a single table of every symbol in the active scopes. Each name (by its string pool ID) maps
+ * to the innermost of a stack of bindings, so lookups are one indexed access no matter how deep
+ * the scopes nest. Bindings are appended to a log, and popping a scope rolls the log back to the
+ * mark taken when the scope was pushed. The per-scope SymbolTables stay the source of truth; a
+ * FlatSymbolTable is a lookup view over a chain of them. */
+class FlatSymbolTable final
+{
+private:
+    static constexpr std::size_t noBinding = static_cast<std::size_t>(-1);
+    struct Binding final
+    {
+        Symbol *symbol;
+        std::uint32_t nameId;
+        /** the binding this one shadows, or noBinding */
+        std::size_t shadowedBinding;
+    };
+    struct Scope final
+    {
+        std::size_t bindingsStart;
+        const SymbolLookupChainNode *chainNode;
+    };
+
+private:
+    /** indexed by name ID */
+    std::vector<std::size_t> innermostBindings;
+    std::vector<Binding> bindings;
+    std::vector<Scope> scopes;
+    std::vector<const SymbolLookupChainNode *> chainScratch;
+
+public:
+    void pushScope(const SymbolLookupChainNode *chainNode = nullptr);
+    /** pushes a scope holding every symbol in symbolTable */
+    void pushScope(const SymbolTable *symbolTable,
+                   const SymbolLookupChainNode *chainNode = nullptr);
+    void popScope() noexcept;
+    std::size_t getScopeDepth() const noexcept
+    {
+        return scopes.size();
+    }
+    /** returns false if the innermost scope already has a symbol with the same name */
+    bool insert(Symbol *symbol);
+    Symbol *find(util::StringPool::Entry name) const noexcept
+    {
+        auto id = name.getId();
+        if(id >= innermostBindings.size() || innermostBindings[id] == noBinding)
+            return nullptr;
+        return bindings[innermostBindings[id]].symbol;
+    }
+    /** makes the active scopes match chain, popping and pushing only the scopes that differ. After
+     * this, find gives the same results as chain.find. */
+    void enterSymbolLookupChain(const SymbolLookupChain &chain);
+};
+}
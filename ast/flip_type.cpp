@@ -18,6 +18,7 @@
  */
 
 #include "flip_type.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -28,4 +29,20 @@ void FlipType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeFlipComments", beforeFlipComments);
     state.setPointer(dumpNode, "type", type);
 }
+
+void FlipType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::FlipType);
+    Type::visitFields(visitor);
+    visitor.visitComments(beforeFlipComments);
+    visitor.visitNode(type);
+}
+
+FlipType *FlipType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeFlipComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    return reader.create<FlipType>(locationRange, beforeFlipComments, type);
+}
 }
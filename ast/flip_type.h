@@ -39,5 +39,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static FlipType *deserialize(SnapshotReader &reader);
 };
 }
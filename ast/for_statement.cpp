@@ -18,6 +18,7 @@
  */
 
 #include "for_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -34,6 +35,18 @@ void GenericForStatement::dump(util::DumpTree *dumpNode, util::DumpState &state)
     state.setPointer(dumpNode, "statement", statement);
 }
 
+void GenericForStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    Statement::visitFields(visitor);
+    SymbolScope::visitFields(visitor);
+    visitor.visitComments(beforeForComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(variable);
+    visitor.visitComments(beforeInComments);
+    visitor.visitComments(beforeRParenComments);
+    visitor.visitNode(statement);
+}
+
 void ForStatementVariable::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     Node::dump(dumpNode, state);
@@ -43,6 +56,24 @@ void ForStatementVariable::dump(util::DumpTree *dumpNode, util::DumpState &state
     state.setPointer(dumpNode, "forStatement", forStatement);
 }
 
+void ForStatementVariable::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ForStatementVariable);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+}
+
+ForStatementVariable *ForStatementVariable::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    return reader.create<ForStatementVariable>(
+        locationRange, beforeNameComments, symbolLocationRange, name, nullptr);
+}
+
 void ForTypeStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericForStatement::dump(dumpNode, state);
@@ -51,6 +82,42 @@ void ForTypeStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     state.setPointer(dumpNode, "type", type);
 }
 
+void ForTypeStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ForTypeStatement);
+    GenericForStatement::visitFields(visitor);
+    visitor.visitComments(beforeTypeKeywordComments);
+    visitor.visitNode(type);
+}
+
+ForTypeStatement *ForTypeStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto beforeForComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *variable = reader.readNode<ForStatementVariable>();
+    auto beforeInComments = reader.readComments();
+    auto beforeRParenComments = reader.readComments();
+    auto *statement = reader.readNode<Statement>();
+    auto beforeTypeKeywordComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    auto *retval = reader.create<ForTypeStatement>(locationRange,
+                                                   symbolLookupChain,
+                                                   symbolTable,
+                                                   beforeForComments,
+                                                   beforeLParenComments,
+                                                   beforeTypeKeywordComments,
+                                                   variable,
+                                                   beforeInComments,
+                                                   type,
+                                                   beforeRParenComments,
+                                                   statement);
+    variable->forStatement = retval;
+    return retval;
+}
+
 void ForStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericForStatement::dump(dumpNode, state);
@@ -59,4 +126,43 @@ void ForStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeToComments", beforeToComments);
     state.setPointer(dumpNode, "secondExpression", secondExpression);
 }
+
+void ForStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ForStatement);
+    GenericForStatement::visitFields(visitor);
+    visitor.visitNode(firstExpression);
+    visitor.visitComments(beforeToComments);
+    visitor.visitNode(secondExpression);
+}
+
+ForStatement *ForStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto beforeForComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *variable = reader.readNode<ForStatementVariable>();
+    auto beforeInComments = reader.readComments();
+    auto beforeRParenComments = reader.readComments();
+    auto *statement = reader.readNode<Statement>();
+    auto *firstExpression = reader.readNode<Expression>();
+    auto beforeToComments = reader.readComments();
+    auto *secondExpression = reader.readNode<Expression>();
+    auto *retval = reader.create<ForStatement>(locationRange,
+                                               symbolLookupChain,
+                                               symbolTable,
+                                               beforeForComments,
+                                               beforeLParenComments,
+                                               variable,
+                                               beforeInComments,
+                                               firstExpression,
+                                               beforeToComments,
+                                               secondExpression,
+                                               beforeRParenComments,
+                                               statement);
+    variable->forStatement = retval;
+    return retval;
+}
 }
@@ -63,6 +63,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 class ForStatementVariable final : public Node, public Symbol
@@ -82,6 +83,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static ForStatementVariable *deserialize(SnapshotReader &reader);
 };
 
 class ForTypeStatement final : public GenericForStatement
@@ -114,6 +117,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static ForTypeStatement *deserialize(SnapshotReader &reader);
 };
 
 class ForStatement final : public GenericForStatement
@@ -148,5 +153,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static ForStatement *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "function.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -48,4 +49,81 @@ void Function::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointerArray(dumpNode, "statements", statements);
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void Function::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::Function);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    SymbolScope::visitFields(visitor);
+    visitor.visitComments(beforeFunctionComments);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitNode(templateParameters);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(firstFunctionParameter);
+    visitor.visitArraySize(parameters);
+    for(auto &parameter : parameters)
+    {
+        visitor.visitComments(parameter.beforeCommaComments);
+        visitor.visitNode(parameter.functionParameter);
+    }
+    visitor.visitComments(beforeRParenComments);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(returnType);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(statements);
+    for(auto *statement : statements)
+        visitor.visitNode(statement);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+Function *Function::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto beforeFunctionComments = reader.readComments();
+    auto beforeNameComments = reader.readComments();
+    auto *templateParameters = reader.readNode<TemplateParameters>();
+    auto beforeLParenComments = reader.readComments();
+    auto *firstFunctionParameter = reader.readNode<FunctionParameter>();
+    auto parameterCount = reader.readArraySize();
+    std::vector<Parameter> parameters;
+    parameters.reserve(parameterCount);
+    for(std::size_t i = 0; i < parameterCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *functionParameter = reader.readNode<FunctionParameter>();
+        parameters.push_back(Parameter(beforeCommaComments, functionParameter));
+    }
+    auto beforeRParenComments = reader.readComments();
+    auto beforeColonComments = reader.readComments();
+    auto *returnType = reader.readNode<Type>();
+    auto beforeLBraceComments = reader.readComments();
+    auto statementCount = reader.readArraySize();
+    std::vector<Statement *> statements;
+    statements.reserve(statementCount);
+    for(std::size_t i = 0; i < statementCount; i++)
+        statements.push_back(reader.readNode<Statement>());
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<Function>(locationRange,
+                                   symbolLookupChain,
+                                   symbolTable,
+                                   beforeFunctionComments,
+                                   beforeNameComments,
+                                   nameLocationRange,
+                                   name,
+                                   templateParameters,
+                                   beforeLParenComments,
+                                   firstFunctionParameter,
+                                   std::move(parameters),
+                                   beforeRParenComments,
+                                   beforeColonComments,
+                                   returnType,
+                                   beforeLBraceComments,
+                                   std::move(statements),
+                                   beforeRBraceComments);
+}
 }
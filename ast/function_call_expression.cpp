@@ -18,6 +18,7 @@
  */
 
 #include "function_call_expression.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -39,4 +40,44 @@ void FunctionCallExpression::dump(util::DumpTree *dumpNode, util::DumpState &sta
     }
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void FunctionCallExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::FunctionCallExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(function);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(firstExpression);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.expression);
+    }
+    visitor.visitComments(beforeRParenComments);
+}
+
+FunctionCallExpression *FunctionCallExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *function = reader.readNode<Expression>();
+    auto beforeLParenComments = reader.readComments();
+    auto *firstExpression = reader.readNode<Expression>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *expression = reader.readNode<Expression>();
+        parts.push_back(Part(beforeCommaComments, expression));
+    }
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<FunctionCallExpression>(locationRange,
+                                                 function,
+                                                 beforeLParenComments,
+                                                 firstExpression,
+                                                 std::move(parts),
+                                                 beforeRParenComments);
+}
 }
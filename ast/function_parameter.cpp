@@ -18,6 +18,7 @@
  */
 
 #include "function_parameter.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -31,4 +32,26 @@ void FunctionParameter::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     state.setSimple(dumpNode, "beforeColonComments", beforeColonComments);
     state.setPointer(dumpNode, "type", type);
 }
+
+void FunctionParameter::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::FunctionParameter);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(type);
+}
+
+FunctionParameter *FunctionParameter::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    auto beforeColonComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    return reader.create<FunctionParameter>(
+        locationRange, beforeNameComments, nameLocationRange, name, beforeColonComments, type);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "function_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void FunctionStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     dumpNode->nodeName = "ast::FunctionStatement";
     state.setPointer(dumpNode, "value", value);
 }
+
+void FunctionStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::FunctionStatement);
+    Statement::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+FunctionStatement *FunctionStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<Function>();
+    return reader.create<FunctionStatement>(locationRange, value);
+}
 }
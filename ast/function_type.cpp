@@ -18,10 +18,25 @@
  */
 
 #include "function_type.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
 {
+namespace
+{
+FunctionType::Parameter deserializeParameter(SnapshotReader &reader)
+{
+    auto beforeNameComments = reader.readComments();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeColonComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    return FunctionType::Parameter(
+        beforeNameComments, nameLocationRange, name, beforeColonComments, type);
+}
+}
+
 void FunctionType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     Type::dump(dumpNode, state);
@@ -51,4 +66,58 @@ void FunctionType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeColonComments", beforeColonComments);
     state.setPointer(dumpNode, "returnType", returnType);
 }
+
+void FunctionType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::FunctionType);
+    Type::visitFields(visitor);
+    visitor.visitComments(beforeFunctionComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitComments(firstParameter.beforeNameComments);
+    visitor.visitLocationRange(firstParameter.nameLocationRange);
+    visitor.visitName(firstParameter.name);
+    visitor.visitComments(firstParameter.beforeColonComments);
+    visitor.visitNode(firstParameter.type);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeNameComments);
+        visitor.visitLocationRange(part.nameLocationRange);
+        visitor.visitName(part.name);
+        visitor.visitComments(part.beforeColonComments);
+        visitor.visitNode(part.type);
+        visitor.visitComments(part.beforeCommaComments);
+    }
+    visitor.visitComments(beforeRParenComments);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(returnType);
+}
+
+FunctionType *FunctionType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeFunctionComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto firstParameter = deserializeParameter(reader);
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto parameter = deserializeParameter(reader);
+        auto beforeCommaComments = reader.readComments();
+        parts.push_back(Part(beforeCommaComments, parameter));
+    }
+    auto beforeRParenComments = reader.readComments();
+    auto beforeColonComments = reader.readComments();
+    auto *returnType = reader.readNode<Type>();
+    return reader.create<FunctionType>(locationRange,
+                                       beforeFunctionComments,
+                                       beforeLParenComments,
+                                       firstParameter,
+                                       std::move(parts),
+                                       beforeRParenComments,
+                                       beforeColonComments,
+                                       returnType);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "if_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -33,4 +34,37 @@ void IfStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeElseComments", beforeElseComments);
     state.setPointer(dumpNode, "elseStatement", elseStatement);
 }
+
+void IfStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::IfStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeIfComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(condition);
+    visitor.visitComments(beforeRParenComments);
+    visitor.visitNode(thenStatement);
+    visitor.visitComments(beforeElseComments);
+    visitor.visitNode(elseStatement);
+}
+
+IfStatement *IfStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeIfComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *condition = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    auto *thenStatement = reader.readNode<Statement>();
+    auto beforeElseComments = reader.readComments();
+    auto *elseStatement = reader.readNode<Statement>();
+    return reader.create<IfStatement>(locationRange,
+                                      beforeIfComments,
+                                      beforeLParenComments,
+                                      condition,
+                                      beforeRParenComments,
+                                      thenStatement,
+                                      beforeElseComments,
+                                      elseStatement);
+}
 }
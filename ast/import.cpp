@@ -18,6 +18,8 @@
  */
 
 #include "import.h"
+#include "top_level_module.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -29,5 +31,32 @@ void Import::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeImportComments", beforeImportComments);
     state.setSimple(dumpNode, "beforeNameComments", beforeNameComments);
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
+    state.setPointer(dumpNode, "importedModule", importedModule);
+}
+
+void Import::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::Import);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeImportComments);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+Import *Import::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeImportComments = reader.readComments();
+    auto beforeNameComments = reader.readComments();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<Import>(locationRange,
+                                 beforeImportComments,
+                                 beforeNameComments,
+                                 symbolLocationRange,
+                                 name,
+                                 beforeSemicolonComments);
 }
 }
@@ -28,12 +28,15 @@
 
 namespace ast
 {
+class TopLevelModule;
+
 class Import final : public Node, public Symbol
 {
 public:
     ConsecutiveComments beforeImportComments;
     ConsecutiveComments beforeNameComments;
     ConsecutiveComments beforeSemicolonComments;
+    TopLevelModule *importedModule;
     explicit Import(parse::LocationRange locationRange,
                     ConsecutiveComments beforeImportComments,
                     ConsecutiveComments beforeNameComments,
@@ -44,9 +47,12 @@ public:
           Symbol(symbolLocationRange, name),
           beforeImportComments(beforeImportComments),
           beforeNameComments(beforeNameComments),
-          beforeSemicolonComments(beforeSemicolonComments)
+          beforeSemicolonComments(beforeSemicolonComments),
+          importedModule(nullptr)
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static Import *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "input_output_statement.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -39,4 +40,48 @@ void InputOutputStatement::dump(util::DumpTree *dumpNode, util::DumpState &state
     }
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void InputOutputStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::InputOutputStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeInputOutputComments);
+    visitor.visitBool(isInput);
+    visitor.visitNode(firstPart);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.part);
+    }
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+InputOutputStatement *InputOutputStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeInputOutputComments = reader.readComments();
+    auto isInput = reader.readBool();
+    auto *firstPart = reader.readNode<InputOutputStatementPart>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *part = reader.readNode<InputOutputStatementPart>();
+        parts.push_back(Part(beforeCommaComments, part));
+    }
+    auto beforeSemicolonComments = reader.readComments();
+    auto *retval = reader.create<InputOutputStatement>(locationRange,
+                                                       beforeInputOutputComments,
+                                                       isInput,
+                                                       firstPart,
+                                                       std::move(parts),
+                                                       beforeSemicolonComments);
+    firstPart->parentStatement = retval;
+    for(auto &part : retval->parts)
+        part.part->parentStatement = retval;
+    return retval;
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "input_output_statement_name.h"
+#include "snapshot.h"
 #include "input_output_statement_part.h"
 
 namespace ast
@@ -30,4 +31,22 @@ void InputOutputStatementName::dump(util::DumpTree *dumpNode, util::DumpState &s
     state.setSimple(dumpNode, "beforeNameComments", beforeNameComments);
     state.setPointer(dumpNode, "parentPart", parentPart);
 }
+
+void InputOutputStatementName::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::InputOutputStatementName);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+}
+
+InputOutputStatementName *InputOutputStatementName::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    return reader.create<InputOutputStatementName>(
+        locationRange, beforeNameComments, nameLocationRange, name);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "input_output_statement_part.h"
+#include "snapshot.h"
 #include "input_output_statement.h"
 #include <sstream>
 
@@ -40,4 +41,42 @@ void InputOutputStatementPart::dump(util::DumpTree *dumpNode, util::DumpState &s
     state.setPointer(dumpNode, "type", type);
     state.setPointer(dumpNode, "parentStatement", parentStatement);
 }
+
+void InputOutputStatementPart::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::InputOutputStatementPart);
+    Node::visitFields(visitor);
+    visitor.visitNode(firstName);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.name);
+    }
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(type);
+}
+
+InputOutputStatementPart *InputOutputStatementPart::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *firstName = reader.readNode<InputOutputStatementName>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *name = reader.readNode<InputOutputStatementName>();
+        parts.push_back(Part(beforeCommaComments, name));
+    }
+    auto beforeColonComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    auto *retval = reader.create<InputOutputStatementPart>(
+        locationRange, firstName, std::move(parts), beforeColonComments, type);
+    firstName->parentPart = retval;
+    for(auto &part : retval->parts)
+        part.name->parentPart = retval;
+    return retval;
+}
 }
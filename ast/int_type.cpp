@@ -18,9 +18,21 @@
  */
 
 #include "int_type.h"
+#include "snapshot.h"
 
 namespace ast
 {
+namespace
+{
+template <typename T>
+T *deserializeGenericBuiltInIntegerType(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeNameComments = reader.readComments();
+    return reader.create<T>(locationRange, beforeNameComments);
+}
+}
+
 void IntegerType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     Type::dump(dumpNode, state);
@@ -28,6 +40,11 @@ void IntegerType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "isSigned", isSigned);
 }
 
+void IntegerType::visitFields(NodeFieldVisitor &visitor) const
+{
+    Type::visitFields(visitor);
+}
+
 void UIntType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     IntegerType::dump(dumpNode, state);
@@ -39,6 +56,33 @@ void UIntType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeLBraceComments", beforeLBraceComments);
 }
 
+void UIntType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::UIntType);
+    IntegerType::visitFields(visitor);
+    visitor.visitComments(beforeUIntComments);
+    visitor.visitComments(beforeEMarkComments);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitNode(bitCount);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+UIntType *UIntType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeUIntComments = reader.readComments();
+    auto beforeEMarkComments = reader.readComments();
+    auto beforeLBraceComments = reader.readComments();
+    auto *bitCount = reader.readNode<Expression>();
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<UIntType>(locationRange,
+                                   beforeUIntComments,
+                                   beforeEMarkComments,
+                                   beforeLBraceComments,
+                                   bitCount,
+                                   beforeRBraceComments);
+}
+
 void SIntType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     IntegerType::dump(dumpNode, state);
@@ -50,57 +94,183 @@ void SIntType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeLBraceComments", beforeLBraceComments);
 }
 
+void SIntType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::SIntType);
+    IntegerType::visitFields(visitor);
+    visitor.visitComments(beforeSIntComments);
+    visitor.visitComments(beforeEMarkComments);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitNode(bitCount);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+SIntType *SIntType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeSIntComments = reader.readComments();
+    auto beforeEMarkComments = reader.readComments();
+    auto beforeLBraceComments = reader.readComments();
+    auto *bitCount = reader.readNode<Expression>();
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<SIntType>(locationRange,
+                                   beforeSIntComments,
+                                   beforeEMarkComments,
+                                   beforeLBraceComments,
+                                   bitCount,
+                                   beforeRBraceComments);
+}
+
 void U8Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::U8Type";
 }
 
+void U8Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::U8Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+U8Type *U8Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<U8Type>(reader);
+}
+
 void U16Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::U16Type";
 }
 
+void U16Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::U16Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+U16Type *U16Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<U16Type>(reader);
+}
+
 void U32Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::U32Type";
 }
 
+void U32Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::U32Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+U32Type *U32Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<U32Type>(reader);
+}
+
 void U64Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::U64Type";
 }
 
+void U64Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::U64Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+U64Type *U64Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<U64Type>(reader);
+}
+
 void S8Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::S8Type";
 }
 
+void S8Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::S8Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+S8Type *S8Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<S8Type>(reader);
+}
+
 void S16Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::S16Type";
 }
 
+void S16Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::S16Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+S16Type *S16Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<S16Type>(reader);
+}
+
 void S32Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::S32Type";
 }
 
+void S32Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::S32Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+S32Type *S32Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<S32Type>(reader);
+}
+
 void S64Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::S64Type";
 }
 
+void S64Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::S64Type);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+S64Type *S64Type::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<S64Type>(reader);
+}
+
 void BitType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     GenericBuiltInIntegerType::dump(dumpNode, state);
     dumpNode->nodeName = "ast::BitType";
 }
+
+void BitType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BitType);
+    GenericBuiltInIntegerType::visitFields(visitor);
+}
+
+BitType *BitType::deserialize(SnapshotReader &reader)
+{
+    return deserializeGenericBuiltInIntegerType<BitType>(reader);
+}
 }
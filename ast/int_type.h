@@ -37,6 +37,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 class UIntType final : public IntegerType
@@ -62,6 +63,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static UIntType *deserialize(SnapshotReader &reader);
 };
 
 class SIntType final : public IntegerType
@@ -87,6 +90,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static SIntType *deserialize(SnapshotReader &reader);
 };
 
 template <bool Signed, std::size_t BitCount>
@@ -103,6 +108,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 template <bool Signed, std::size_t BitCount>
@@ -122,6 +128,13 @@ void GenericBuiltInIntegerType<Signed, BitCount>::dump(util::DumpTree *dumpNode,
     state.setSimple(dumpNode, "beforeNameComments", beforeNameComments);
 }
 
+template <bool Signed, std::size_t BitCount>
+void GenericBuiltInIntegerType<Signed, BitCount>::visitFields(NodeFieldVisitor &visitor) const
+{
+    IntegerType::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+}
+
 class U8Type final : public GenericBuiltInIntegerType<false, 8>
 {
 public:
@@ -131,6 +144,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static U8Type *deserialize(SnapshotReader &reader);
 };
 
 class U16Type final : public GenericBuiltInIntegerType<false, 16>
@@ -142,6 +157,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static U16Type *deserialize(SnapshotReader &reader);
 };
 
 class U32Type final : public GenericBuiltInIntegerType<false, 32>
@@ -153,6 +170,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static U32Type *deserialize(SnapshotReader &reader);
 };
 
 class U64Type final : public GenericBuiltInIntegerType<false, 64>
@@ -164,6 +183,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static U64Type *deserialize(SnapshotReader &reader);
 };
 
 class S8Type final : public GenericBuiltInIntegerType<true, 8>
@@ -175,6 +196,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static S8Type *deserialize(SnapshotReader &reader);
 };
 
 class S16Type final : public GenericBuiltInIntegerType<true, 16>
@@ -186,6 +209,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static S16Type *deserialize(SnapshotReader &reader);
 };
 
 class S32Type final : public GenericBuiltInIntegerType<true, 32>
@@ -197,6 +222,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static S32Type *deserialize(SnapshotReader &reader);
 };
 
 class S64Type final : public GenericBuiltInIntegerType<true, 64>
@@ -208,6 +235,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static S64Type *deserialize(SnapshotReader &reader);
 };
 
 class BitType final : public GenericBuiltInIntegerType<false, 1>
@@ -219,5 +248,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static BitType *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "interface.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -36,4 +37,56 @@ void Interface::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointerArray(dumpNode, "statements", statements);
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void Interface::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::Interface);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    SymbolScope::visitFields(visitor);
+    visitor.visitComments(beforeInterfaceComments);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitNode(templateParameters);
+    visitor.visitComments(beforeImplementsComments);
+    visitor.visitNode(parentType);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(statements);
+    for(auto *statement : statements)
+        visitor.visitNode(statement);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+Interface *Interface::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto beforeInterfaceComments = reader.readComments();
+    auto beforeNameComments = reader.readComments();
+    auto *templateParameters = reader.readNode<TemplateParameters>();
+    auto beforeImplementsComments = reader.readComments();
+    auto *parentType = reader.readNode<Type>();
+    auto beforeLBraceComments = reader.readComments();
+    auto statementCount = reader.readArraySize();
+    std::vector<Statement *> statements;
+    statements.reserve(statementCount);
+    for(std::size_t i = 0; i < statementCount; i++)
+        statements.push_back(reader.readNode<Statement>());
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<Interface>(locationRange,
+                                    symbolLookupChain,
+                                    symbolTable,
+                                    beforeInterfaceComments,
+                                    beforeNameComments,
+                                    symbolLocationRange,
+                                    name,
+                                    templateParameters,
+                                    beforeImplementsComments,
+                                    parentType,
+                                    beforeLBraceComments,
+                                    std::move(statements),
+                                    beforeRBraceComments);
+}
 }
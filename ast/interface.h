@@ -71,5 +71,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static Interface *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "interface_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void InterfaceStatement::dump(util::DumpTree *dumpNode, util::DumpState &state)
     dumpNode->nodeName = "ast::InterfaceStatement";
     state.setPointer(dumpNode, "value", value);
 }
+
+void InterfaceStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::InterfaceStatement);
+    Statement::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+InterfaceStatement *InterfaceStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<Interface>();
+    return reader.create<InterfaceStatement>(locationRange, value);
+}
 }
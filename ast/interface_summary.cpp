@@ -0,0 +1,124 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "interface_summary.h"
+#include "ast.h"
+#include <cassert>
+#include <ostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace ast
+{
+namespace
+{
+/** change the version whenever the summary format changes */
+constexpr util::string_view formatVersionLine = "// hdlc interface summary format 2\n";
+
+class InterfaceSummaryWriter final
+{
+private:
+    std::ostream &os;
+    std::unordered_set<const InputOutputStatement *> writtenInputOutputStatements;
+
+private:
+    static util::string_view getText(parse::Location begin, parse::Location end) noexcept
+    {
+        assert(begin.source == end.source && begin.offset <= end.offset);
+        auto text = parse::LocationRange(begin, end).getText();
+        while(!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'
+                                || text.back() == '\n'))
+            text.remove_suffix(1);
+        return text;
+    }
+    void writeLine(std::size_t depth, util::string_view text)
+    {
+        for(std::size_t i = 0; i < depth; i++)
+            os << "    ";
+        os << text << "\n";
+    }
+    void writeModule(const Module *module, std::size_t depth)
+    {
+        writeLine(depth,
+                  getText(module->locationRange.begin(),
+                          module->beforeLBraceComments.locationRange.begin()));
+        writeLine(depth, "{");
+        writeSymbolTable(module->symbolTable, depth + 1);
+        writeLine(depth, "}");
+    }
+
+public:
+    explicit InterfaceSummaryWriter(std::ostream &os) : os(os)
+    {
+    }
+    void writeSymbolTable(const SymbolTable *symbolTable, std::size_t depth)
+    {
+        // lets, regs and template parameters are private to their scope. Functions keep their
+        // bodies so importers can still evaluate them at compile time.
+        for(auto *symbol : symbolTable->getLocalSymbols())
+        {
+            if(auto *module = dynamic_cast<const Module *>(symbol))
+            {
+                writeModule(module, depth);
+            }
+            else if(auto *name = dynamic_cast<const InputOutputStatementName *>(symbol))
+            {
+                auto *statement = name->parentPart->parentStatement;
+                if(std::get<1>(writtenInputOutputStatements.insert(statement)))
+                    writeLine(depth, statement->locationRange.getText());
+            }
+            else if(auto *constStatementPart = dynamic_cast<const ConstStatementPart *>(symbol))
+            {
+                std::string text = "const ";
+                text += constStatementPart->locationRange.getText();
+                text += ";";
+                writeLine(depth, text);
+            }
+            else if(dynamic_cast<const Import *>(symbol) || dynamic_cast<const Interface *>(symbol)
+                    || dynamic_cast<const Function *>(symbol) || dynamic_cast<const Enum *>(symbol)
+                    || dynamic_cast<const TypeStatement *>(symbol))
+            {
+                writeLine(depth, dynamic_cast<const Node *>(symbol)->locationRange.getText());
+            }
+        }
+    }
+};
+}
+
+void writeInterfaceSummary(std::ostream &os, const TopLevelModule *topLevelModule)
+{
+    os << formatVersionLine;
+    os << "// interface summary generated by hdlc from "
+       << topLevelModule->locationRange.getNonnullSource()->getFileName() << "\n";
+    InterfaceSummaryWriter(os).writeSymbolTable(topLevelModule->symbolTable, 0);
+}
+
+std::string makeInterfaceSummary(const TopLevelModule *topLevelModule)
+{
+    std::ostringstream ss;
+    writeInterfaceSummary(ss, topLevelModule);
+    return ss.str();
+}
+
+bool isCurrentInterfaceSummary(util::string_view text) noexcept
+{
+    return text.size() >= formatVersionLine.size()
+           && text.substr(0, formatVersionLine.size()) == formatVersionLine;
+}
+}
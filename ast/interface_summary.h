@@ -0,0 +1,38 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "top_level_module.h"
+#include "../util/string_view.h"
+#include <iosfwd>
+#include <string>
+
+namespace ast
+{
+/** writes the parts of a module that importers can see as HDL source text: imports, ports,
+ * types, consts, enums, interfaces, functions and nested modules. The summary parses like any
+ * other source file but leaves out the regs and lets in module bodies. It starts with a line
+ * naming the summary format's version. */
+void writeInterfaceSummary(std::ostream &os, const TopLevelModule *topLevelModule);
+std::string makeInterfaceSummary(const TopLevelModule *topLevelModule);
+/** returns false if text wasn't written in the current summary format, such as a summary written by
+ * an older hdlc */
+bool isCurrentInterfaceSummary(util::string_view text) noexcept;
+}
@@ -18,6 +18,7 @@
  */
 
 #include "let_statement.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -38,4 +39,38 @@ void LetStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     }
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void LetStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::LetStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeLetComments);
+    visitor.visitNode(firstPart);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.part);
+    }
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+LetStatement *LetStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeLetComments = reader.readComments();
+    auto *firstPart = reader.readNode<LetStatementPart>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *part = reader.readNode<LetStatementPart>();
+        parts.push_back(Part(beforeCommaComments, part));
+    }
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<LetStatement>(
+        locationRange, beforeLetComments, firstPart, std::move(parts), beforeSemicolonComments);
+}
 }
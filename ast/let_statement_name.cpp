@@ -18,6 +18,7 @@
  */
 
 #include "let_statement_name.h"
+#include "snapshot.h"
 #include "let_statement_part.h"
 
 namespace ast
@@ -30,4 +31,22 @@ void LetStatementName::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     state.setSimple(dumpNode, "beforeNameComments", beforeNameComments);
     state.setPointer(dumpNode, "parentPart", parentPart);
 }
+
+void LetStatementName::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::LetStatementName);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+}
+
+LetStatementName *LetStatementName::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    return reader.create<LetStatementName>(
+        locationRange, beforeNameComments, nameLocationRange, name);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "list_expression.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -38,4 +39,41 @@ void ListExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setSimple(dumpNode, "hasTrailingComma", hasTrailingComma);
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void ListExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ListExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitNode(part.part);
+        visitor.visitComments(part.beforeCommaComments);
+    }
+    visitor.visitBool(hasTrailingComma);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+ListExpression *ListExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeLBraceComments = reader.readComments();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto *part = reader.readNode<Expression>();
+        auto beforeCommaComments = reader.readComments();
+        parts.push_back(Part(part, beforeCommaComments));
+    }
+    auto hasTrailingComma = reader.readBool();
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<ListExpression>(locationRange,
+                                         beforeLBraceComments,
+                                         std::move(parts),
+                                         hasTrailingComma,
+                                         beforeRBraceComments);
+}
 }
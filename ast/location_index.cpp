@@ -0,0 +1,224 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "location_index.h"
+#include <algorithm>
+#include <cassert>
+
+namespace ast
+{
+namespace
+{
+class LocationIndexBuilder final : public NodeFieldVisitor
+{
+private:
+    const parse::Source *source;
+    std::vector<LocationIndex::Entry> &entries;
+    std::size_t currentIndex = LocationIndex::npos;
+
+public:
+    LocationIndexBuilder(const parse::Source *source,
+                         std::vector<LocationIndex::Entry> &entries) noexcept : source(source),
+                                                                                entries(entries)
+    {
+    }
+    virtual void visitNodeKind(NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value)
+            return;
+        auto parentIndex = currentIndex;
+        auto &locationRange = value->locationRange;
+        if(source && locationRange.source == source)
+        {
+            // the breakpoints and parent links are only right if ranges nest
+            assert(parentIndex == LocationIndex::npos
+                   || (entries[parentIndex].begin <= locationRange.offset
+                       && locationRange.offset + locationRange.size <= entries[parentIndex].end));
+            currentIndex = entries.size();
+            entries.emplace_back(locationRange.offset,
+                                 locationRange.offset + locationRange.size,
+                                 value,
+                                 parentIndex);
+        }
+        value->visitFields(*this);
+        currentIndex = parentIndex;
+    }
+    virtual void visitSymbolTable(const SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &) override
+    {
+    }
+};
+}
+
+constexpr std::size_t LocationIndex::npos;
+
+LocationIndex::LocationIndex(const Node *root)
+    : source(root ? root->locationRange.source : nullptr),
+      entries(),
+      innermostBreakpoints(),
+      nodeIndexes()
+{
+    LocationIndexBuilder builder(source, entries);
+    builder.visitNode(root);
+    sortEntries();
+    buildInnermostBreakpoints();
+}
+
+void LocationIndex::sortEntries()
+{
+    // entries are in pre-order, so a stable sort keeps parents before children with equal ranges
+    std::vector<std::size_t> order;
+    order.reserve(entries.size());
+    for(std::size_t i = 0; i < entries.size(); i++)
+        order.push_back(i);
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [this](std::size_t a, std::size_t b)
+                     {
+                         if(entries[a].begin != entries[b].begin)
+                             return entries[a].begin < entries[b].begin;
+                         return entries[a].end > entries[b].end;
+                     });
+    std::vector<std::size_t> newIndexes(entries.size());
+    for(std::size_t i = 0; i < order.size(); i++)
+        newIndexes[order[i]] = i;
+    std::vector<Entry> sortedEntries;
+    sortedEntries.reserve(entries.size());
+    nodeIndexes.reserve(entries.size());
+    for(auto oldIndex : order)
+    {
+        auto entry = entries[oldIndex];
+        if(entry.parentIndex != npos)
+            entry.parentIndex = newIndexes[entry.parentIndex];
+        nodeIndexes.emplace(entry.node, sortedEntries.size());
+        sortedEntries.push_back(entry);
+    }
+    entries = std::move(sortedEntries);
+}
+
+void LocationIndex::buildInnermostBreakpoints()
+{
+    auto addBreakpoint = [this](std::size_t offset, std::size_t index)
+    {
+        if(!innermostBreakpoints.empty() && std::get<0>(innermostBreakpoints.back()) == offset)
+            innermostBreakpoints.pop_back();
+        if(!innermostBreakpoints.empty() && std::get<1>(innermostBreakpoints.back()) == index)
+            return;
+        innermostBreakpoints.emplace_back(offset, index);
+    };
+    // the end of each open node, clipped to the end of the node enclosing it
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    auto popUntil = [&](std::size_t offset)
+    {
+        while(!stack.empty() && std::get<1>(stack.back()) <= offset)
+        {
+            auto end = std::get<1>(stack.back());
+            stack.pop_back();
+            addBreakpoint(end, stack.empty() ? npos : std::get<0>(stack.back()));
+        }
+    };
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        auto &entry = entries[i];
+        if(entry.begin == entry.end)
+            continue;
+        popUntil(entry.begin);
+        auto end = entry.end;
+        if(!stack.empty())
+            end = std::min(end, std::get<1>(stack.back()));
+        stack.emplace_back(i, end);
+        addBreakpoint(entry.begin, i);
+    }
+    popUntil(npos);
+}
+
+std::size_t LocationIndex::getIndex(const Node *node) const noexcept
+{
+    auto iter = nodeIndexes.find(node);
+    if(iter == nodeIndexes.end())
+        return npos;
+    return std::get<1>(*iter);
+}
+
+const Node *LocationIndex::getParent(const Node *node) const noexcept
+{
+    auto index = getIndex(node);
+    if(index == npos || entries[index].parentIndex == npos)
+        return nullptr;
+    return entries[entries[index].parentIndex].node;
+}
+
+std::size_t LocationIndex::findInnermost(std::size_t offset) const noexcept
+{
+    auto iter = std::upper_bound(innermostBreakpoints.begin(),
+                                 innermostBreakpoints.end(),
+                                 offset,
+                                 [](std::size_t offset,
+                                    const std::pair<std::size_t, std::size_t> &breakpoint)
+                                 {
+                                     return offset < std::get<0>(breakpoint);
+                                 });
+    if(iter == innermostBreakpoints.begin())
+        return npos;
+    return std::get<1>(*--iter);
+}
+
+std::vector<std::size_t> LocationIndex::findOverlapping(std::size_t begin, std::size_t end) const
+{
+    std::vector<std::size_t> retval;
+    if(begin >= end)
+        return retval;
+    for(auto index = findInnermost(begin); index != npos; index = entries[index].parentIndex)
+        retval.push_back(index);
+    std::reverse(retval.begin(), retval.end());
+    auto iter = std::upper_bound(entries.begin(),
+                                 entries.end(),
+                                 begin,
+                                 [](std::size_t offset, const Entry &entry)
+                                 {
+                                     return offset < entry.begin;
+                                 });
+    for(; iter != entries.end() && iter->begin < end; ++iter)
+        if(iter->begin != iter->end)
+            retval.push_back(iter - entries.begin());
+    return retval;
+}
+}
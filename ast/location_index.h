@@ -0,0 +1,94 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "node.h"
+#include "node_field_visitor.h"
+#include "../parse/source.h"
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ast
+{
+/** maps offsets in one source to the nodes parsed from it. The nodes are stored sorted by start
+ * offset, outer nodes first, along with the index of their parent, so parent links don't need a
+ * pointer in every node. The innermost node at each offset is precomputed as a sorted list of
+ * breakpoints, so position queries are a binary search. Node ranges must nest, which is asserted
+ * while building the index. */
+class LocationIndex final
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    struct Entry final
+    {
+        std::size_t begin;
+        std::size_t end;
+        const Node *node;
+        std::size_t parentIndex;
+        constexpr Entry(std::size_t begin,
+                        std::size_t end,
+                        const Node *node,
+                        std::size_t parentIndex) noexcept : begin(begin),
+                                                           end(end),
+                                                           node(node),
+                                                           parentIndex(parentIndex)
+        {
+        }
+    };
+
+private:
+    const parse::Source *source;
+    std::vector<Entry> entries;
+    /** pairs of a start offset and the index of the innermost node from there on (or npos) */
+    std::vector<std::pair<std::size_t, std::size_t>> innermostBreakpoints;
+    std::unordered_map<const Node *, std::size_t> nodeIndexes;
+
+private:
+    void sortEntries();
+    void buildInnermostBreakpoints();
+
+public:
+    /** indexes every node reachable from root that has a location in root's source */
+    explicit LocationIndex(const Node *root);
+    const parse::Source *getSource() const noexcept
+    {
+        return source;
+    }
+    const std::vector<Entry> &getEntries() const noexcept
+    {
+        return entries;
+    }
+    /** returns npos if node isn't in the index */
+    std::size_t getIndex(const Node *node) const noexcept;
+    /** returns nullptr for the root or for nodes not in the index */
+    const Node *getParent(const Node *node) const noexcept;
+    /** returns the index of the innermost node containing offset, or npos if there is none */
+    std::size_t findInnermost(std::size_t offset) const noexcept;
+    const Node *findInnermostNode(std::size_t offset) const noexcept
+    {
+        auto index = findInnermost(offset);
+        return index == npos ? nullptr : entries[index].node;
+    }
+    /** returns the indexes of the nodes sharing at least one offset with [begin, end): the nodes
+     * containing begin from the outermost in, then the nodes starting inside the range */
+    std::vector<std::size_t> findOverlapping(std::size_t begin, std::size_t end) const;
+};
+}
@@ -18,6 +18,7 @@
  */
 
 #include "match_pattern.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,6 +28,11 @@ void MatchPattern::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     dumpNode->nodeName = "ast::MatchPattern";
 }
 
+void MatchPattern::visitFields(NodeFieldVisitor &visitor) const
+{
+    Node::visitFields(visitor);
+}
+
 void NumberPatternMatchPattern::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     MatchPattern::dump(dumpNode, state);
@@ -35,6 +41,27 @@ void NumberPatternMatchPattern::dump(util::DumpTree *dumpNode, util::DumpState &
     state.setSimple(dumpNode, "pattern", pattern);
 }
 
+void NumberPatternMatchPattern::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::NumberPatternMatchPattern);
+    MatchPattern::visitFields(visitor);
+    visitor.visitComments(beforeNumberComments);
+    visitor.visitInteger(pattern.value);
+    visitor.visitInteger(pattern.mask);
+}
+
+NumberPatternMatchPattern *NumberPatternMatchPattern::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeNumberComments = reader.readComments();
+    auto patternValue = reader.readInteger();
+    auto patternMask = reader.readInteger();
+    return reader.create<NumberPatternMatchPattern>(
+        locationRange,
+        beforeNumberComments,
+        parse::Token::IntegerValue(std::move(patternValue), std::move(patternMask)));
+}
+
 void RangeMatchPattern::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     MatchPattern::dump(dumpNode, state);
@@ -43,4 +70,23 @@ void RangeMatchPattern::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     state.setSimple(dumpNode, "beforeToComments", beforeToComments);
     state.setPointer(dumpNode, "secondExpression", secondExpression);
 }
+
+void RangeMatchPattern::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::RangeMatchPattern);
+    MatchPattern::visitFields(visitor);
+    visitor.visitNode(firstExpression);
+    visitor.visitComments(beforeToComments);
+    visitor.visitNode(secondExpression);
+}
+
+RangeMatchPattern *RangeMatchPattern::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *firstExpression = reader.readNode<Expression>();
+    auto beforeToComments = reader.readComments();
+    auto *secondExpression = reader.readNode<Expression>();
+    return reader.create<RangeMatchPattern>(
+        locationRange, firstExpression, beforeToComments, secondExpression);
+}
 }
@@ -35,6 +35,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 class NumberPatternMatchPattern final : public MatchPattern
@@ -51,6 +52,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static NumberPatternMatchPattern *deserialize(SnapshotReader &reader);
 };
 
 class RangeMatchPattern final : public MatchPattern
@@ -70,5 +73,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static RangeMatchPattern *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "match_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -33,4 +34,43 @@ void MatchStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setPointerArray(dumpNode, "parts", parts);
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void MatchStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::MatchStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeMatchComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(matchee);
+    visitor.visitComments(beforeRParenComments);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(parts);
+    for(auto *part : parts)
+        visitor.visitNode(part);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+MatchStatement *MatchStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeMatchComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *matchee = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    auto beforeLBraceComments = reader.readComments();
+    auto partCount = reader.readArraySize();
+    std::vector<MatchStatementPart *> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+        parts.push_back(reader.readNode<MatchStatementPart>());
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<MatchStatement>(locationRange,
+                                         beforeMatchComments,
+                                         beforeLParenComments,
+                                         matchee,
+                                         beforeRParenComments,
+                                         beforeLBraceComments,
+                                         std::move(parts),
+                                         beforeRBraceComments);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "match_statement_part.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -38,4 +39,38 @@ void MatchStatementPart::dump(util::DumpTree *dumpNode, util::DumpState &state)
     state.setSimple(dumpNode, "beforeEqualRAngleComments", beforeEqualRAngleComments);
     state.setPointer(dumpNode, "statement", statement);
 }
+
+void MatchStatementPart::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::MatchStatementPart);
+    Node::visitFields(visitor);
+    visitor.visitNode(firstMatchPattern);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.matchPattern);
+    }
+    visitor.visitComments(beforeEqualRAngleComments);
+    visitor.visitNode(statement);
+}
+
+MatchStatementPart *MatchStatementPart::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *firstMatchPattern = reader.readNode<MatchPattern>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *matchPattern = reader.readNode<MatchPattern>();
+        parts.push_back(Part(beforeCommaComments, matchPattern));
+    }
+    auto beforeEqualRAngleComments = reader.readComments();
+    auto *statement = reader.readNode<Statement>();
+    return reader.create<MatchStatementPart>(
+        locationRange, firstMatchPattern, std::move(parts), beforeEqualRAngleComments, statement);
+}
 }
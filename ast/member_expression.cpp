@@ -18,6 +18,7 @@
  */
 
 #include "member_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -31,4 +32,31 @@ void MemberExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     state.setSimple(dumpNode, "nameLocationRange", nameLocationRange);
     state.setSimple(dumpNode, "name", name);
 }
+
+void MemberExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::MemberExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(compositeValue);
+    visitor.visitComments(beforeDotComments);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitLocationRange(nameLocationRange);
+    visitor.visitName(name);
+}
+
+MemberExpression *MemberExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *compositeValue = reader.readNode<Expression>();
+    auto beforeDotComments = reader.readComments();
+    auto beforeNameComments = reader.readComments();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    return reader.create<MemberExpression>(locationRange,
+                                           compositeValue,
+                                           beforeDotComments,
+                                           beforeNameComments,
+                                           nameLocationRange,
+                                           name);
+}
 }
@@ -0,0 +1,228 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "memory_report.h"
+#include "ast.h"
+#include "../math/bit_vector.h"
+#include "../util/memory_usage.h"
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+
+namespace ast
+{
+std::size_t MemoryReport::getNodeSize(NodeKind kind) noexcept
+{
+    switch(kind)
+    {
+#define AST_MEMORY_REPORT_NODE_KIND(name) \
+    case NodeKind::name:                  \
+        return sizeof(name);
+        AST_NODE_KINDS(AST_MEMORY_REPORT_NODE_KIND)
+#undef AST_MEMORY_REPORT_NODE_KIND
+    }
+    assert(false);
+    return 0;
+}
+
+void MemoryReport::visitNodeKind(NodeKind kind)
+{
+    usageStack.push_back(&nodeKindUsages[static_cast<std::size_t>(kind)]);
+    currentUsage().objectCount++;
+    currentUsage().objectBytes += getNodeSize(kind);
+}
+
+void MemoryReport::visitLocationRange(const parse::LocationRange &)
+{
+    currentUsage().locationRangeBytes += sizeof(parse::LocationRange);
+}
+
+void MemoryReport::visitComments(const ConsecutiveComments &)
+{
+    currentUsage().commentBytes += sizeof(ConsecutiveComments);
+}
+
+void MemoryReport::visitName(util::StringPool::Entry)
+{
+}
+
+void MemoryReport::visitBool(bool)
+{
+}
+
+void MemoryReport::visitInteger(const math::GMPInteger &value)
+{
+    currentUsage().heapBytes += value.getHeapBytes();
+}
+
+void MemoryReport::visitArraySize(std::size_t, std::size_t heapBytes)
+{
+    currentUsage().heapBytes += heapBytes;
+}
+
+void MemoryReport::visitNode(const Node *value)
+{
+    if(!value || !std::get<1>(visitedNodes.insert(value)))
+        return;
+    auto usageStackSize = usageStack.size();
+    value->visitFields(*this);
+    assert(usageStack.size() == usageStackSize + 1);
+    usageStack.resize(usageStackSize);
+}
+
+void MemoryReport::visitSymbolTable(const SymbolTable *value)
+{
+    if(!value || !std::get<1>(visitedSymbolTables.insert(value)))
+        return;
+    symbolTableUsage.objectCount++;
+    symbolTableUsage.objectBytes += sizeof(SymbolTable);
+    symbolTableUsage.heapBytes += value->getHeapBytes();
+}
+
+void MemoryReport::visitSymbolLookupChain(const SymbolLookupChain &value)
+{
+    for(auto *node = value.head; node; node = node->parent)
+    {
+        if(!std::get<1>(visitedSymbolLookupChainNodes.insert(node)))
+            break;
+        symbolLookupChainNodeUsage.objectCount++;
+        symbolLookupChainNodeUsage.objectBytes += sizeof(SymbolLookupChainNode);
+        visitSymbolTable(node->symbolTable);
+    }
+}
+
+void MemoryReport::addPhase(std::string name)
+{
+    phasePeakResidentSetSizes.emplace_back(std::move(name), util::getPeakResidentSetSize());
+}
+
+void MemoryReport::addTree(const Node *tree, const parse::Source *source)
+{
+    if(source)
+        sourceSize += source->size();
+    visitNode(tree);
+}
+
+void MemoryReport::addContext(const Context &context)
+{
+    MemoryUsage stringPoolUsage;
+    stringPoolUsage.objectCount = context.stringPool.size();
+    stringPoolUsage.objectBytes = sizeof(util::StringPool);
+    stringPoolUsage.heapBytes = context.stringPool.getHeapBytes();
+    addOther("string pool", stringPoolUsage);
+    MemoryUsage arenaUsage;
+    arenaUsage.objectCount = context.arena.getObjectCount();
+    arenaUsage.objectBytes = sizeof(util::Arena);
+    arenaUsage.heapBytes = context.arena.getBookkeepingBytes();
+    addOther("arena bookkeeping", arenaUsage);
+}
+
+void MemoryReport::addDumpTree(const util::DumpTree *dumpTree, const util::Arena &dumpArena)
+{
+    MemoryUsage usage;
+    usage.objectCount = dumpArena.getObjectCount();
+    usage.objectBytes = dumpArena.getObjectBytes();
+    usage.heapBytes = dumpArena.getBookkeepingBytes();
+    std::unordered_set<const util::DumpTree *> visited;
+    std::vector<const util::DumpTree *> worklist;
+    worklist.push_back(dumpTree);
+    while(!worklist.empty())
+    {
+        auto *node = worklist.back();
+        worklist.pop_back();
+        if(!node || !std::get<1>(visited.insert(node)))
+            continue;
+        usage.heapBytes += util::getHashTableHeapBytes(node->simpleVariables)
+                           + util::getHashTableHeapBytes(node->pointerVariables);
+        for(auto &variable : node->simpleVariables)
+            usage.heapBytes += util::getHeapBytes(std::get<1>(variable));
+        for(auto &variable : node->pointerVariables)
+            worklist.push_back(std::get<1>(variable));
+    }
+    addOther("dump tree", usage);
+}
+
+void MemoryReport::addOther(std::string name, const MemoryUsage &usage)
+{
+    otherUsages.emplace_back(std::move(name), usage);
+}
+
+namespace
+{
+void writeUsageHeader(std::ostream &os)
+{
+    os << std::left << std::setw(36) << "name" << std::right << std::setw(10) << "count"
+       << std::setw(12) << "bytes" << std::setw(12) << "comments" << std::setw(12) << "locations"
+       << std::setw(12) << "heap" << std::setw(12) << "total" << "\n";
+}
+
+void writeUsage(std::ostream &os, util::string_view name, const MemoryUsage &usage)
+{
+    os << std::left << std::setw(36) << static_cast<std::string>(name) << std::right
+       << std::setw(10) << usage.objectCount << std::setw(12) << usage.objectBytes << std::setw(12)
+       << usage.commentBytes << std::setw(12) << usage.locationRangeBytes << std::setw(12)
+       << usage.heapBytes << std::setw(12) << usage.objectBytes + usage.heapBytes << "\n";
+}
+}
+
+void MemoryReport::write(std::ostream &os) const
+{
+    os << "peak resident set size by phase:\n";
+    for(auto &phase : phasePeakResidentSetSizes)
+        os << std::left << std::setw(36) << std::get<0>(phase) << std::right << std::setw(10)
+           << std::get<1>(phase) / 1024 << " KiB\n";
+    os << "\n";
+    writeUsageHeader(os);
+    std::vector<std::size_t> kindIndexes;
+    for(std::size_t i = 0; i < nodeKindCount; i++)
+        if(nodeKindUsages[i].objectCount != 0)
+            kindIndexes.push_back(i);
+    std::stable_sort(kindIndexes.begin(),
+                     kindIndexes.end(),
+                     [this](std::size_t a, std::size_t b)
+                     {
+                         return nodeKindUsages[a].objectBytes + nodeKindUsages[a].heapBytes
+                                > nodeKindUsages[b].objectBytes + nodeKindUsages[b].heapBytes;
+                     });
+    MemoryUsage nodeTotal;
+    for(auto i : kindIndexes)
+    {
+        writeUsage(os, getNodeKindName(static_cast<NodeKind>(i)), nodeKindUsages[i]);
+        nodeTotal += nodeKindUsages[i];
+    }
+    writeUsage(os, "all nodes", nodeTotal);
+    os << "\n";
+    MemoryUsage total = nodeTotal;
+    writeUsage(os, "symbol tables", symbolTableUsage);
+    total += symbolTableUsage;
+    writeUsage(os, "symbol lookup chain nodes", symbolLookupChainNodeUsage);
+    total += symbolLookupChainNodeUsage;
+    for(auto &other : otherUsages)
+    {
+        writeUsage(os, std::get<0>(other), std::get<1>(other));
+        total += std::get<1>(other);
+    }
+    writeUsage(os, "total", total);
+    if(sourceSize != 0)
+        os << "\nsource bytes: " << sourceSize << ", AST bytes per source byte: " << std::fixed
+           << std::setprecision(1)
+           << static_cast<double>(nodeTotal.objectBytes + nodeTotal.heapBytes) / sourceSize
+           << "\n";
+}
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "node.h"
+#include "node_field_visitor.h"
+#include "node_kind.h"
+#include "context.h"
+#include "symbol_table.h"
+#include "symbol_lookup_chain.h"
+#include "../util/dump_tree.h"
+#include "../util/string_view.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace ast
+{
+struct MemoryUsage final
+{
+    std::size_t objectCount = 0;
+    /** the sum of sizeof of the objects */
+    std::size_t objectBytes = 0;
+    /** the bytes spent on ConsecutiveComments fields, included in objectBytes or heapBytes */
+    std::size_t commentBytes = 0;
+    /** the bytes spent on other LocationRange fields, included in objectBytes */
+    std::size_t locationRangeBytes = 0;
+    /** the bytes allocated by owned std::vector and math::GMPInteger fields */
+    std::size_t heapBytes = 0;
+    MemoryUsage &operator+=(const MemoryUsage &rt) noexcept
+    {
+        objectCount += rt.objectCount;
+        objectBytes += rt.objectBytes;
+        commentBytes += rt.commentBytes;
+        locationRangeBytes += rt.locationRangeBytes;
+        heapBytes += rt.heapBytes;
+        return *this;
+    }
+};
+
+/** accumulates per-node-kind memory usage by walking the fields of every reachable node once, then
+ * writes a table of it along with the peak resident set size after each recorded phase. */
+class MemoryReport final : private NodeFieldVisitor
+{
+private:
+    MemoryUsage nodeKindUsages[nodeKindCount];
+    MemoryUsage symbolTableUsage;
+    MemoryUsage symbolLookupChainNodeUsage;
+    std::vector<std::pair<std::string, MemoryUsage>> otherUsages;
+    std::vector<std::pair<std::string, std::size_t>> phasePeakResidentSetSizes;
+    std::size_t sourceSize = 0;
+    std::unordered_set<const Node *> visitedNodes;
+    std::unordered_set<const SymbolTable *> visitedSymbolTables;
+    std::unordered_set<const SymbolLookupChainNode *> visitedSymbolLookupChainNodes;
+    std::vector<MemoryUsage *> usageStack;
+
+private:
+    MemoryUsage &currentUsage() noexcept
+    {
+        return *usageStack.back();
+    }
+    virtual void visitNodeKind(NodeKind kind) override;
+    virtual void visitLocationRange(const parse::LocationRange &value) override;
+    virtual void visitComments(const ConsecutiveComments &value) override;
+    virtual void visitName(util::StringPool::Entry value) override;
+    virtual void visitBool(bool value) override;
+    virtual void visitInteger(const math::GMPInteger &value) override;
+    virtual void visitArraySize(std::size_t size, std::size_t heapBytes) override;
+    virtual void visitNode(const Node *value) override;
+    virtual void visitSymbolTable(const SymbolTable *value) override;
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &value) override;
+
+public:
+    static std::size_t getNodeSize(NodeKind kind) noexcept;
+    /** records the peak resident set size at the end of the named phase */
+    void addPhase(std::string name);
+    /** adds every node reachable from tree, along with the size of the source it was parsed from */
+    void addTree(const Node *tree, const parse::Source *source);
+    /** adds the string pool and arena of context */
+    void addContext(const Context &context);
+    void addDumpTree(const util::DumpTree *dumpTree, const util::Arena &dumpArena);
+    void addOther(std::string name, const MemoryUsage &usage);
+    void write(std::ostream &os) const;
+};
+}
@@ -18,6 +18,7 @@
  */
 
 #include "memory_type.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -32,4 +33,34 @@ void MemoryType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "beforeColonComments", beforeColonComments);
     state.setPointer(dumpNode, "elementType", elementType);
 }
+
+void MemoryType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::MemoryType);
+    Type::visitFields(visitor);
+    visitor.visitComments(beforeMemoryComments);
+    visitor.visitComments(beforeLBracketComments);
+    visitor.visitNode(size);
+    visitor.visitComments(beforeRBracketComments);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(elementType);
+}
+
+MemoryType *MemoryType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeMemoryComments = reader.readComments();
+    auto beforeLBracketComments = reader.readComments();
+    auto *size = reader.readNode<Expression>();
+    auto beforeRBracketComments = reader.readComments();
+    auto beforeColonComments = reader.readComments();
+    auto *elementType = reader.readNode<Type>();
+    return reader.create<MemoryType>(locationRange,
+                                     beforeMemoryComments,
+                                     beforeLBracketComments,
+                                     size,
+                                     beforeRBracketComments,
+                                     beforeColonComments,
+                                     elementType);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "module_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void ModuleStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) con
     dumpNode->nodeName = "ast::ModuleStatement";
     state.setPointer(dumpNode, "value", value);
 }
+
+void ModuleStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ModuleStatement);
+    Statement::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+ModuleStatement *ModuleStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<Module>();
+    return reader.create<ModuleStatement>(locationRange, value);
+}
 }
@@ -0,0 +1,170 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "name_resolver.h"
+#include "enum.h"
+#include "import.h"
+#include "interface.h"
+#include "module.h"
+#include "node_field_visitor.h"
+#include "top_level_module.h"
+#include "../util/memory_usage.h"
+
+namespace ast
+{
+class NameResolver::Visitor final : public NodeFieldVisitor
+{
+private:
+    NameResolver &nameResolver;
+
+public:
+    explicit Visitor(NameResolver &nameResolver) noexcept : nameResolver(nameResolver)
+    {
+    }
+    virtual void visitNodeKind(NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value)
+            return;
+        if(auto *scopedId = dynamic_cast<const ScopedId *>(value))
+            nameResolver.resolve(scopedId);
+        value->visitFields(*this);
+    }
+    virtual void visitSymbolTable(const SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &) override
+    {
+    }
+};
+
+Symbol *NameResolver::lookup(const SymbolLookupChainNode *chainNode,
+                             util::StringPool::Entry name)
+{
+    Symbol *retval = nullptr;
+    auto *node = chainNode;
+    for(; node; node = node->parent)
+    {
+        auto iter = lookupCache.find(LookupKey{node, name.getId()});
+        if(iter != lookupCache.end())
+        {
+            retval = std::get<1>(*iter);
+            break;
+        }
+        retval = node->symbolTable->find(name);
+        if(retval)
+            break;
+    }
+    // every scope from chainNode up to where the name was found gives the same result
+    for(auto *i = chainNode; i; i = i->parent)
+    {
+        if(!std::get<1>(lookupCache.emplace(LookupKey{i, name.getId()}, retval)) || i == node)
+            break;
+    }
+    return retval;
+}
+
+Symbol *NameResolver::lookup(const SymbolTable *symbolTable, util::StringPool::Entry name)
+{
+    auto iter = lookupCache.find(LookupKey{symbolTable, name.getId()});
+    if(iter != lookupCache.end())
+        return std::get<1>(*iter);
+    auto *retval = symbolTable->find(name);
+    lookupCache.emplace(LookupKey{symbolTable, name.getId()}, retval);
+    return retval;
+}
+
+const SymbolTable *NameResolver::getMemberSymbolTable(const Symbol *symbol) noexcept
+{
+    if(auto *import = dynamic_cast<const Import *>(symbol))
+    {
+        if(import->importedModule && import->importedModule->mainModule)
+            return import->importedModule->mainModule->symbolTable;
+        return nullptr;
+    }
+    if(dynamic_cast<const Module *>(symbol) || dynamic_cast<const Interface *>(symbol)
+       || dynamic_cast<const Enum *>(symbol))
+        return dynamic_cast<const SymbolScope *>(symbol)->symbolTable;
+    return nullptr;
+}
+
+Symbol *NameResolver::resolve(const ScopedId *scopedId)
+{
+    auto iter = resolvedScopedIds.find(scopedId);
+    if(iter != resolvedScopedIds.end())
+        return std::get<1>(*iter);
+    Symbol *retval = nullptr;
+    bool isParentResolved = true;
+    if(scopedId->parentScope)
+    {
+        auto *parentSymbol = resolve(scopedId->parentScope);
+        isParentResolved = parentSymbol != nullptr;
+        auto *memberSymbolTable = parentSymbol ? getMemberSymbolTable(parentSymbol) : nullptr;
+        if(memberSymbolTable)
+            retval = lookup(memberSymbolTable, scopedId->name);
+    }
+    else if(scopedId->symbolLookupChain.head)
+    {
+        retval = lookup(scopedId->symbolLookupChain.head, scopedId->name);
+    }
+    resolvedScopedIds.emplace(scopedId, retval);
+    if(!retval && isParentResolved)
+        unresolvedScopedIds.push_back(scopedId);
+    return retval;
+}
+
+void NameResolver::resolveAll(const Node *root)
+{
+    Visitor(*this).visitNode(root);
+}
+
+Symbol *NameResolver::getSymbol(const ScopedId *scopedId) const noexcept
+{
+    auto iter = resolvedScopedIds.find(scopedId);
+    if(iter == resolvedScopedIds.end())
+        return nullptr;
+    return std::get<1>(*iter);
+}
+
+std::size_t NameResolver::getHeapBytes() const noexcept
+{
+    return util::getHashTableHeapBytes(lookupCache) + util::getHashTableHeapBytes(resolvedScopedIds)
+           + util::getHeapBytes(unresolvedScopedIds);
+}
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "node.h"
+#include "scoped_id.h"
+#include "scoped_id_expression.h"
+#include "scoped_id_type.h"
+#include "symbol.h"
+#include "symbol_lookup_chain.h"
+#include "symbol_table.h"
+#include "../util/string_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ast
+{
+/** binds ScopedIds to the symbols they name. The first segment is looked up through its symbol
+ * lookup chain; each later segment is looked up in the members of the symbol the segment before
+ * it resolved to, which must be a module, interface, enum, or import. Lookups are cached per
+ * scope and name, so repeated references to a name resolve in amortized constant time no matter
+ * how deeply they're nested. */
+class NameResolver final
+{
+private:
+    class Visitor;
+    struct LookupKey final
+    {
+        /** the SymbolLookupChainNode or SymbolTable the name is looked up in */
+        const void *scope;
+        std::uint32_t nameId;
+        friend bool operator==(const LookupKey &a, const LookupKey &b) noexcept
+        {
+            return a.scope == b.scope && a.nameId == b.nameId;
+        }
+    };
+    struct LookupKeyHasher final
+    {
+        std::size_t operator()(const LookupKey &value) const noexcept
+        {
+            return std::hash<const void *>()(value.scope) * 0x100000001B3ULL ^ value.nameId;
+        }
+    };
+
+private:
+    /** maps to nullptr for names that aren't found */
+    std::unordered_map<LookupKey, Symbol *, LookupKeyHasher> lookupCache;
+    /** maps to nullptr for ScopedIds that don't resolve */
+    std::unordered_map<const ScopedId *, Symbol *> resolvedScopedIds;
+    std::vector<const ScopedId *> unresolvedScopedIds;
+
+private:
+    Symbol *lookup(const SymbolLookupChainNode *chainNode, util::StringPool::Entry name);
+    Symbol *lookup(const SymbolTable *symbolTable, util::StringPool::Entry name);
+
+public:
+    /** returns the symbol table holding the symbols that can be named as symbol::name, or nullptr
+     * if there isn't one */
+    static const SymbolTable *getMemberSymbolTable(const Symbol *symbol) noexcept;
+    /** returns nullptr if scopedId doesn't resolve */
+    Symbol *resolve(const ScopedId *scopedId);
+    /** resolves every ScopedId reachable from root */
+    void resolveAll(const Node *root);
+    /** returns the symbol scopedId was resolved to, or nullptr if it wasn't resolved or doesn't
+     * resolve */
+    Symbol *getSymbol(const ScopedId *scopedId) const noexcept;
+    Symbol *getSymbol(const ScopedIdExpression *scopedIdExpression) const noexcept
+    {
+        return getSymbol(scopedIdExpression->value);
+    }
+    Symbol *getSymbol(const ScopedIdType *scopedIdType) const noexcept
+    {
+        return getSymbol(scopedIdType->value);
+    }
+    /** the ScopedIds that didn't resolve, in the order they were resolved. If a segment doesn't
+     * resolve then the segments after it don't either, but only the first one is listed. */
+    const std::vector<const ScopedId *> &getUnresolvedScopedIds() const noexcept
+    {
+        return unresolvedScopedIds;
+    }
+    std::size_t getResolvedScopedIdCount() const noexcept
+    {
+        return resolvedScopedIds.size();
+    }
+    /** the bytes allocated for the lookup cache and the resolved ScopedIds */
+    std::size_t getHeapBytes() const noexcept;
+};
+}
@@ -28,4 +28,9 @@ void Node::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     dumpNode->nodeName = "ast::Node"_sv;
     state.setSimple(dumpNode, "locationRange"_sv, locationRange);
 }
+
+void Node::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitLocationRange(locationRange);
+}
 }
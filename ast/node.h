@@ -21,9 +21,12 @@
 
 #include "../parse/source.h"
 #include "../util/dump_tree.h"
+#include "node_field_visitor.h"
 
 namespace ast
 {
+class SnapshotReader;
+
 class Node
 {
 public:
@@ -33,6 +36,7 @@ public:
     }
     virtual ~Node() = default;
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const = 0;
 };
 
 inline void utilDumpFunction(const Node *sourceNode, util::DumpTree *dumpNode, util::DumpState &state)
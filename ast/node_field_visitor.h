@@ -0,0 +1,64 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "node_kind.h"
+#include "../parse/source.h"
+#include "../util/string_pool.h"
+
+namespace math
+{
+class GMPInteger;
+}
+
+namespace ast
+{
+class Node;
+class SymbolTable;
+struct SymbolLookupChain;
+struct ConsecutiveComments;
+
+/** visits the fields of a node in declaration order, starting with the fields of the base classes.
+ * Pointers to child nodes are visited through visitNode, back-pointers to parent nodes and links
+ * filled in after parsing (like Import::importedModule) are not visited at all. */
+class NodeFieldVisitor
+{
+public:
+    virtual ~NodeFieldVisitor() = default;
+    virtual void visitNodeKind(NodeKind kind) = 0;
+    virtual void visitLocationRange(const parse::LocationRange &value) = 0;
+    virtual void visitComments(const ConsecutiveComments &value) = 0;
+    virtual void visitName(util::StringPool::Entry value) = 0;
+    virtual void visitBool(bool value) = 0;
+    virtual void visitInteger(const math::GMPInteger &value) = 0;
+    /** heapBytes is the size of the storage allocated for the array */
+    virtual void visitArraySize(std::size_t size, std::size_t heapBytes) = 0;
+    template <typename T>
+    void visitArraySize(const std::vector<T> &array)
+    {
+        visitArraySize(array.size(), array.capacity() * sizeof(T));
+    }
+    virtual void visitNode(const Node *value) = 0;
+    virtual void visitSymbolTable(const SymbolTable *value) = 0;
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &value) = 0;
+};
+}
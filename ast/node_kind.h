@@ -0,0 +1,158 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "../util/string_view.h"
+
+namespace ast
+{
+/** invokes <tt>macro(name)</tt> for every node kind in declaration order; each name is both the
+ * enumerant and the node class name in namespace ast */
+#define AST_NODE_KINDS(macro)             \
+    macro(AddExpression)                  \
+    macro(AndReduceExpression)            \
+    macro(AssignmentExpression)           \
+    macro(BitType)                        \
+    macro(BitwiseAndExpression)           \
+    macro(BitwiseNotExpression)           \
+    macro(BitwiseOrExpression)            \
+    macro(BitwiseXorExpression)           \
+    macro(BlockStatement)                 \
+    macro(BreakStatement)                 \
+    macro(CastExpression)                 \
+    macro(CatExpression)                  \
+    macro(CompareEqExpression)            \
+    macro(CompareGEExpression)            \
+    macro(CompareGTExpression)            \
+    macro(CompareLEExpression)            \
+    macro(CompareLTExpression)            \
+    macro(CompareNEExpression)            \
+    macro(ConditionalExpression)          \
+    macro(ConnectExpression)              \
+    macro(ConstStatement)                 \
+    macro(ConstStatementPart)             \
+    macro(ContinueStatement)              \
+    macro(DivExpression)                  \
+    macro(EmptyStatement)                 \
+    macro(Enum)                           \
+    macro(EnumPart)                       \
+    macro(EnumStatement)                  \
+    macro(ExpressionStatement)            \
+    macro(FillExpression)                 \
+    macro(FlipType)                       \
+    macro(ForStatement)                   \
+    macro(ForStatementVariable)           \
+    macro(ForTypeStatement)               \
+    macro(Function)                       \
+    macro(FunctionCallExpression)         \
+    macro(FunctionParameter)              \
+    macro(FunctionStatement)              \
+    macro(FunctionType)                   \
+    macro(IfStatement)                    \
+    macro(Import)                         \
+    macro(InputOutputStatement)           \
+    macro(InputOutputStatementName)       \
+    macro(InputOutputStatementPart)       \
+    macro(Interface)                      \
+    macro(InterfaceStatement)             \
+    macro(LeftShiftExpression)            \
+    macro(LetStatement)                   \
+    macro(LetStatementName)               \
+    macro(LetStatementPart)               \
+    macro(ListExpression)                 \
+    macro(LogicalAndExpression)           \
+    macro(LogicalNotExpression)           \
+    macro(LogicalOrExpression)            \
+    macro(MatchStatement)                 \
+    macro(MatchStatementPart)             \
+    macro(MemberExpression)               \
+    macro(MemoryType)                     \
+    macro(Module)                         \
+    macro(ModuleStatement)                \
+    macro(MulExpression)                  \
+    macro(NumberExpression)               \
+    macro(NumberPatternMatchPattern)      \
+    macro(OrReduceExpression)             \
+    macro(ParenExpression)                \
+    macro(PopCountExpression)             \
+    macro(RangeMatchPattern)              \
+    macro(RegStatement)                   \
+    macro(RegStatementNameAndInitializer) \
+    macro(RegStatementPart)               \
+    macro(RemExpression)                  \
+    macro(ReturnStatement)                \
+    macro(RightShiftExpression)           \
+    macro(S16Type)                        \
+    macro(S32Type)                        \
+    macro(S64Type)                        \
+    macro(S8Type)                         \
+    macro(SIntType)                       \
+    macro(ScopedId)                       \
+    macro(ScopedIdExpression)             \
+    macro(ScopedIdType)                   \
+    macro(SliceExpression)                \
+    macro(SubExpression)                  \
+    macro(TemplateArguments)              \
+    macro(TemplateParameters)             \
+    macro(TopLevelModule)                 \
+    macro(TupleType)                      \
+    macro(TypeOfType)                     \
+    macro(TypeStatement)                  \
+    macro(TypeTemplateArgument)           \
+    macro(TypeTemplateParameter)          \
+    macro(U16Type)                        \
+    macro(U32Type)                        \
+    macro(U64Type)                        \
+    macro(U8Type)                         \
+    macro(UIntType)                       \
+    macro(UnaryMinusExpression)           \
+    macro(UnaryPlusExpression)            \
+    macro(ValueTemplateArgument)          \
+    macro(ValueTemplateParameter)         \
+    macro(XorReduceExpression)
+
+enum class NodeKind : std::uint16_t
+{
+#define AST_NODE_KIND_ENUMERANT(name) name,
+    AST_NODE_KINDS(AST_NODE_KIND_ENUMERANT)
+#undef AST_NODE_KIND_ENUMERANT
+};
+
+constexpr std::size_t nodeKindCount = 0
+#define AST_NODE_KIND_COUNT(name) +1
+    AST_NODE_KINDS(AST_NODE_KIND_COUNT)
+#undef AST_NODE_KIND_COUNT
+    ;
+
+constexpr util::string_view getNodeKindName(NodeKind kind) noexcept
+{
+    using namespace util::string_view_literals;
+    switch(kind)
+    {
+#define AST_NODE_KIND_NAME(name) \
+    case NodeKind::name:         \
+        return "ast::" #name ""_sv;
+        AST_NODE_KINDS(AST_NODE_KIND_NAME)
+#undef AST_NODE_KIND_NAME
+    }
+    return {};
+}
+}
@@ -18,6 +18,7 @@
  */
 
 #include "number_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -28,4 +29,20 @@ void NumberExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     state.setSimple(dumpNode, "beforeNumberComments", beforeNumberComments);
     state.setSimple(dumpNode, "value", value);
 }
+
+void NumberExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::NumberExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeNumberComments);
+    visitor.visitInteger(value);
+}
+
+NumberExpression *NumberExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeNumberComments = reader.readComments();
+    auto value = reader.readInteger();
+    return reader.create<NumberExpression>(locationRange, beforeNumberComments, std::move(value));
+}
 }
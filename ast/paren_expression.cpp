@@ -18,6 +18,7 @@
  */
 
 #include "paren_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -29,4 +30,23 @@ void ParenExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) con
     state.setPointer(dumpNode, "expression", expression);
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void ParenExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ParenExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(expression);
+    visitor.visitComments(beforeRParenComments);
+}
+
+ParenExpression *ParenExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeLParenComments = reader.readComments();
+    auto *expression = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<ParenExpression>(
+        locationRange, beforeLParenComments, expression, beforeRParenComments);
+}
 }
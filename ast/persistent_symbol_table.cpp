@@ -0,0 +1,213 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "persistent_symbol_table.h"
+#include <cassert>
+#include <limits>
+
+namespace ast
+{
+namespace
+{
+constexpr std::size_t hashBits = std::numeric_limits<std::size_t>::digits;
+
+std::uint32_t getSlotBit(std::size_t hash, std::size_t shift) noexcept
+{
+    return static_cast<std::uint32_t>(1) << ((hash >> shift) & 0x1F);
+}
+
+/** the index in the compact array of the entry for slotBit */
+std::size_t getPosition(std::uint32_t bitmap, std::uint32_t slotBit) noexcept
+{
+    return __builtin_popcount(bitmap & (slotBit - 1));
+}
+}
+
+constexpr std::size_t PersistentSymbolTable::bitsPerLevel;
+
+std::shared_ptr<const PersistentSymbolTable::Node> PersistentSymbolTable::insert(
+    const std::shared_ptr<const Node> &node, std::size_t shift, Symbol *symbol)
+{
+    auto retval = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    if(shift >= hashBits)
+    {
+        for(auto &existingSymbol : retval->symbols)
+        {
+            if(existingSymbol->name == symbol->name)
+            {
+                existingSymbol = symbol;
+                return retval;
+            }
+        }
+        retval->symbols.push_back(symbol);
+        retval->size++;
+        return retval;
+    }
+    auto slotBit = getSlotBit(symbol->name.getHash(), shift);
+    if(retval->symbolBitmap & slotBit)
+    {
+        auto symbolPosition = getPosition(retval->symbolBitmap, slotBit);
+        auto *existingSymbol = retval->symbols[symbolPosition];
+        if(existingSymbol->name == symbol->name)
+        {
+            retval->symbols[symbolPosition] = symbol;
+            return retval;
+        }
+        // move the existing symbol down into a new child along with the new symbol
+        auto child = insert(insert(nullptr, shift + bitsPerLevel, existingSymbol),
+                            shift + bitsPerLevel,
+                            symbol);
+        retval->symbols.erase(retval->symbols.begin() + symbolPosition);
+        retval->symbolBitmap &= ~slotBit;
+        retval->childBitmap |= slotBit;
+        retval->children.insert(
+            retval->children.begin() + getPosition(retval->childBitmap, slotBit), child);
+        retval->size++;
+        return retval;
+    }
+    if(retval->childBitmap & slotBit)
+    {
+        auto &child = retval->children[getPosition(retval->childBitmap, slotBit)];
+        auto childSize = child->size;
+        child = insert(child, shift + bitsPerLevel, symbol);
+        retval->size += child->size - childSize;
+        return retval;
+    }
+    retval->symbolBitmap |= slotBit;
+    retval->symbols.insert(
+        retval->symbols.begin() + getPosition(retval->symbolBitmap, slotBit), symbol);
+    retval->size++;
+    return retval;
+}
+
+std::shared_ptr<const PersistentSymbolTable::Node> PersistentSymbolTable::erase(
+    const std::shared_ptr<const Node> &node, std::size_t shift, util::StringPool::Entry name)
+{
+    if(shift >= hashBits)
+    {
+        for(std::size_t i = 0; i < node->symbols.size(); i++)
+        {
+            if(node->symbols[i]->name != name)
+                continue;
+            if(node->size == 1)
+                return nullptr;
+            auto retval = std::make_shared<Node>(*node);
+            retval->symbols.erase(retval->symbols.begin() + i);
+            retval->size--;
+            return retval;
+        }
+        return node;
+    }
+    auto slotBit = getSlotBit(name.getHash(), shift);
+    if(node->symbolBitmap & slotBit)
+    {
+        auto symbolPosition = getPosition(node->symbolBitmap, slotBit);
+        if(node->symbols[symbolPosition]->name != name)
+            return node;
+        if(node->size == 1)
+            return nullptr;
+        auto retval = std::make_shared<Node>(*node);
+        retval->symbols.erase(retval->symbols.begin() + symbolPosition);
+        retval->symbolBitmap &= ~slotBit;
+        retval->size--;
+        return retval;
+    }
+    if(node->childBitmap & slotBit)
+    {
+        auto childPosition = getPosition(node->childBitmap, slotBit);
+        auto &child = node->children[childPosition];
+        auto newChild = erase(child, shift + bitsPerLevel, name);
+        if(newChild == child)
+            return node;
+        if(node->size == 1)
+            return nullptr;
+        auto retval = std::make_shared<Node>(*node);
+        retval->size--;
+        if(newChild && (newChild->size > 1 || !newChild->children.empty()))
+        {
+            retval->children[childPosition] = std::move(newChild);
+            return retval;
+        }
+        retval->children.erase(retval->children.begin() + childPosition);
+        retval->childBitmap &= ~slotBit;
+        if(newChild)
+        {
+            // pull a lone symbol back up so the trie stays as shallow as possible
+            retval->symbolBitmap |= slotBit;
+            retval->symbols.insert(
+                retval->symbols.begin() + getPosition(retval->symbolBitmap, slotBit),
+                newChild->symbols.front());
+        }
+        return retval;
+    }
+    return node;
+}
+
+PersistentSymbolTable PersistentSymbolTable::fromSymbolTable(const SymbolTable &symbolTable)
+{
+    PersistentSymbolTable retval;
+    for(auto *symbol : symbolTable.getLocalSymbols())
+        retval.root = insert(retval.root, 0, symbol);
+    return retval;
+}
+
+std::size_t PersistentSymbolTable::size() const noexcept
+{
+    return root ? root->size : 0;
+}
+
+Symbol *PersistentSymbolTable::find(util::StringPool::Entry name) const noexcept
+{
+    auto hash = name.getHash();
+    auto *node = root.get();
+    for(std::size_t shift = 0; node; shift += bitsPerLevel)
+    {
+        if(shift >= hashBits)
+        {
+            for(auto *symbol : node->symbols)
+                if(symbol->name == name)
+                    return symbol;
+            return nullptr;
+        }
+        auto slotBit = getSlotBit(hash, shift);
+        if(node->symbolBitmap & slotBit)
+        {
+            auto *symbol = node->symbols[getPosition(node->symbolBitmap, slotBit)];
+            return symbol->name == name ? symbol : nullptr;
+        }
+        if(!(node->childBitmap & slotBit))
+            return nullptr;
+        node = node->children[getPosition(node->childBitmap, slotBit)].get();
+    }
+    return nullptr;
+}
+
+PersistentSymbolTable PersistentSymbolTable::insert(Symbol *symbol) const
+{
+    assert(symbol);
+    return PersistentSymbolTable(insert(root, 0, symbol));
+}
+
+PersistentSymbolTable PersistentSymbolTable::erase(util::StringPool::Entry name) const
+{
+    if(!root)
+        return *this;
+    return PersistentSymbolTable(erase(root, 0, name));
+}
+}
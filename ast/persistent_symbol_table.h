@@ -0,0 +1,140 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "symbol.h"
+#include "symbol_table.h"
+#include "../util/string_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ast
+{
+/** an immutable symbol table stored as a hash array mapped trie. Inserting or erasing returns a
+ * new table that shares everything but the path to the changed symbol with the old one, so
+ * keeping a snapshot is just copying a pointer, and snapshots can be read from any number of
+ * threads while another thread builds newer versions. Unlike SymbolTable, symbols can be in
+ * several tables at once, so containingSymbolTable isn't set. */
+class PersistentSymbolTable final
+{
+    friend class AtomicPersistentSymbolTable;
+
+private:
+    struct Node;
+    static constexpr std::size_t bitsPerLevel = 5;
+
+private:
+    std::shared_ptr<const Node> root;
+
+private:
+    explicit PersistentSymbolTable(std::shared_ptr<const Node> root) noexcept
+        : root(std::move(root))
+    {
+    }
+    static std::shared_ptr<const Node> insert(const std::shared_ptr<const Node> &node,
+                                              std::size_t shift,
+                                              Symbol *symbol);
+    static std::shared_ptr<const Node> erase(const std::shared_ptr<const Node> &node,
+                                             std::size_t shift,
+                                             util::StringPool::Entry name);
+    template <typename Fn>
+    static void forEach(const Node *node, Fn &fn);
+
+public:
+    PersistentSymbolTable() noexcept = default;
+    static PersistentSymbolTable fromSymbolTable(const SymbolTable &symbolTable);
+    std::size_t size() const noexcept;
+    bool empty() const noexcept
+    {
+        return root == nullptr;
+    }
+    Symbol *find(util::StringPool::Entry name) const noexcept;
+    /** returns a table with symbol added, replacing any symbol with the same name */
+    PersistentSymbolTable insert(Symbol *symbol) const;
+    /** returns a table without the symbol named name */
+    PersistentSymbolTable erase(util::StringPool::Entry name) const;
+    /** calls fn(symbol) for every symbol, in no particular order */
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        if(root)
+            forEach(root.get(), fn);
+    }
+    /** true if both tables are the same version, so comparing snapshots is cheap */
+    friend bool operator==(const PersistentSymbolTable &a, const PersistentSymbolTable &b) noexcept
+    {
+        return a.root == b.root;
+    }
+    friend bool operator!=(const PersistentSymbolTable &a, const PersistentSymbolTable &b) noexcept
+    {
+        return a.root != b.root;
+    }
+};
+
+struct PersistentSymbolTable::Node final
+{
+    /** the symbols in this subtree */
+    std::size_t size = 0;
+    /** the slots holding a symbol; unused past the last level, where symbols whose hashes are
+     * equal are just listed */
+    std::uint32_t symbolBitmap = 0;
+    /** the slots holding a child */
+    std::uint32_t childBitmap = 0;
+    std::vector<Symbol *> symbols;
+    std::vector<std::shared_ptr<const Node>> children;
+};
+
+template <typename Fn>
+void PersistentSymbolTable::forEach(const Node *node, Fn &fn)
+{
+    for(auto *symbol : node->symbols)
+        fn(symbol);
+    for(auto &child : node->children)
+        forEach(child.get(), fn);
+}
+
+/** the current version of a PersistentSymbolTable, for publishing edits from one thread to
+ * readers in others. Readers load a snapshot once and then query it without synchronization. */
+class AtomicPersistentSymbolTable final
+{
+private:
+    /** only accessed through std::atomic_load and std::atomic_store */
+    std::shared_ptr<const PersistentSymbolTable::Node> root;
+
+public:
+    AtomicPersistentSymbolTable() noexcept = default;
+    explicit AtomicPersistentSymbolTable(const PersistentSymbolTable &value) noexcept
+        : root(value.root)
+    {
+    }
+    AtomicPersistentSymbolTable(const AtomicPersistentSymbolTable &) = delete;
+    AtomicPersistentSymbolTable &operator=(const AtomicPersistentSymbolTable &) = delete;
+    PersistentSymbolTable load() const noexcept
+    {
+        return PersistentSymbolTable(std::atomic_load(&root));
+    }
+    void store(const PersistentSymbolTable &value) noexcept
+    {
+        std::atomic_store(&root, value.root);
+    }
+};
+}
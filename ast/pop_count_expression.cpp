@@ -18,6 +18,7 @@
  */
 
 #include "pop_count_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -30,4 +31,28 @@ void PopCountExpression::dump(util::DumpTree *dumpNode, util::DumpState &state)
     state.setPointer(dumpNode, "expression", expression);
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void PopCountExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::PopCountExpression);
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforePopCountComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(expression);
+    visitor.visitComments(beforeRParenComments);
+}
+
+PopCountExpression *PopCountExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforePopCountComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *expression = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<PopCountExpression>(locationRange,
+                                             beforePopCountComments,
+                                             beforeLParenComments,
+                                             expression,
+                                             beforeRParenComments);
+}
 }
@@ -46,5 +46,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static PopCountExpression *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "reg_statement.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -38,4 +39,38 @@ void RegStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     }
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void RegStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::RegStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeRegComments);
+    visitor.visitNode(firstPart);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.part);
+    }
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+RegStatement *RegStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeRegComments = reader.readComments();
+    auto *firstPart = reader.readNode<RegStatementPart>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *part = reader.readNode<RegStatementPart>();
+        parts.push_back(Part(beforeCommaComments, part));
+    }
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<RegStatement>(
+        locationRange, beforeRegComments, firstPart, std::move(parts), beforeSemicolonComments);
+}
 }
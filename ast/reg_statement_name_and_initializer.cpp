@@ -18,6 +18,7 @@
  */
 
 #include "reg_statement_name_and_initializer.h"
+#include "snapshot.h"
 #include "reg_statement.h"
 
 namespace ast
@@ -32,4 +33,30 @@ void RegStatementNameAndInitializer::dump(util::DumpTree *dumpNode, util::DumpSt
     state.setPointer(dumpNode, "initializer", initializer);
     state.setPointer(dumpNode, "parentPart", parentPart);
 }
+
+void RegStatementNameAndInitializer::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::RegStatementNameAndInitializer);
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeEqualComments);
+    visitor.visitNode(initializer);
+}
+
+RegStatementNameAndInitializer *RegStatementNameAndInitializer::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    auto beforeEqualComments = reader.readComments();
+    auto *initializer = reader.readNode<Expression>();
+    return reader.create<RegStatementNameAndInitializer>(locationRange,
+                                                         beforeNameComments,
+                                                         nameLocationRange,
+                                                         name,
+                                                         beforeEqualComments,
+                                                         initializer);
+}
 }
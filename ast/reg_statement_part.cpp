@@ -18,6 +18,7 @@
  */
 
 #include "reg_statement_part.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -38,4 +39,42 @@ void RegStatementPart::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     state.setSimple(dumpNode, "beforeColonComments", beforeColonComments);
     state.setPointer(dumpNode, "type", type);
 }
+
+void RegStatementPart::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::RegStatementPart);
+    Node::visitFields(visitor);
+    visitor.visitNode(firstName);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.name);
+    }
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(type);
+}
+
+RegStatementPart *RegStatementPart::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *firstName = reader.readNode<RegStatementNameAndInitializer>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *name = reader.readNode<RegStatementNameAndInitializer>();
+        parts.push_back(Part(beforeCommaComments, name));
+    }
+    auto beforeColonComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    auto *retval = reader.create<RegStatementPart>(
+        locationRange, firstName, std::move(parts), beforeColonComments, type);
+    firstName->parentPart = retval;
+    for(auto &part : retval->parts)
+        part.name->parentPart = retval;
+    return retval;
+}
 }
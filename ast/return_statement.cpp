@@ -18,6 +18,7 @@
  */
 
 #include "return_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -29,4 +30,23 @@ void ReturnStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) con
     state.setPointer(dumpNode, "expression", expression);
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void ReturnStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ReturnStatement);
+    Statement::visitFields(visitor);
+    visitor.visitComments(beforeReturnComments);
+    visitor.visitNode(expression);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+ReturnStatement *ReturnStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeReturnComments = reader.readComments();
+    auto *expression = reader.readNode<Expression>();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<ReturnStatement>(
+        locationRange, beforeReturnComments, expression, beforeSemicolonComments);
+}
 }
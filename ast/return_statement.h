@@ -43,5 +43,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static ReturnStatement *deserialize(SnapshotReader &reader);
 };
 }
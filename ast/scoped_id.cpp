@@ -18,6 +18,7 @@
  */
 
 #include "scoped_id.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -34,4 +35,40 @@ void ScopedId::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointer(dumpNode, "templateArguments", templateArguments);
     state.setPointer(dumpNode, "symbolLookupChain", &symbolLookupChain);
 }
+
+void ScopedId::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ScopedId);
+    Node::visitFields(visitor);
+    visitor.visitNode(parentScope);
+    visitor.visitComments(beforeColonColonComments);
+    visitor.visitBool(hasColonColon);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitLocationRange(nameLocationRange);
+    visitor.visitName(name);
+    visitor.visitNode(templateArguments);
+    visitor.visitSymbolLookupChain(symbolLookupChain);
+}
+
+ScopedId *ScopedId::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *parentScope = reader.readNode<ScopedId>();
+    auto beforeColonColonComments = reader.readComments();
+    auto hasColonColon = reader.readBool();
+    auto beforeNameComments = reader.readComments();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto *templateArguments = reader.readNode<TemplateArguments>();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    return reader.create<ScopedId>(locationRange,
+                                   parentScope,
+                                   beforeColonColonComments,
+                                   hasColonColon,
+                                   beforeNameComments,
+                                   nameLocationRange,
+                                   name,
+                                   templateArguments,
+                                   symbolLookupChain);
+}
 }
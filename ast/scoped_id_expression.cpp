@@ -18,6 +18,7 @@
  */
 
 #include "scoped_id_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void ScopedIdExpression::dump(util::DumpTree *dumpNode, util::DumpState &state)
     dumpNode->nodeName = "ast::ScopedIdExpression";
     state.setPointer(dumpNode, "value", value);
 }
+
+void ScopedIdExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ScopedIdExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+ScopedIdExpression *ScopedIdExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<ScopedId>();
+    return reader.create<ScopedIdExpression>(locationRange, value);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "scoped_id_type.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,4 +28,18 @@ void ScopedIdType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     dumpNode->nodeName = "ast::ScopedIdType";
     state.setPointer(dumpNode, "value", value);
 }
+
+void ScopedIdType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ScopedIdType);
+    Type::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+ScopedIdType *ScopedIdType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<ScopedId>();
+    return reader.create<ScopedIdType>(locationRange, value);
+}
 }
@@ -18,6 +18,7 @@
  */
 
 #include "slice_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -32,4 +33,34 @@ void SliceExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) con
     state.setPointer(dumpNode, "endIndex", endIndex);
     state.setSimple(dumpNode, "beforeRBracketComments", beforeRBracketComments);
 }
+
+void SliceExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::SliceExpression);
+    Expression::visitFields(visitor);
+    visitor.visitNode(slicedValue);
+    visitor.visitComments(beforeLBracketComments);
+    visitor.visitNode(startIndex);
+    visitor.visitComments(beforeToComments);
+    visitor.visitNode(endIndex);
+    visitor.visitComments(beforeRBracketComments);
+}
+
+SliceExpression *SliceExpression::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *slicedValue = reader.readNode<Expression>();
+    auto beforeLBracketComments = reader.readComments();
+    auto *startIndex = reader.readNode<Expression>();
+    auto beforeToComments = reader.readComments();
+    auto *endIndex = reader.readNode<Expression>();
+    auto beforeRBracketComments = reader.readComments();
+    return reader.create<SliceExpression>(locationRange,
+                                          slicedValue,
+                                          beforeLBracketComments,
+                                          startIndex,
+                                          beforeToComments,
+                                          endIndex,
+                                          beforeRBracketComments);
+}
 }
@@ -26,6 +26,9 @@
 
 namespace ast
 {
+/** value[index] is the bit at index, and value[high to low] is the bits from high down to and
+ * including low, so bus[7 to 0] is the low byte of bus. startIndex is high and endIndex is low, or
+ * nullptr for a single bit. Indexes count from the least significant bit, which is 0. */
 class SliceExpression final : public Expression
 {
 public:
@@ -52,5 +55,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static SliceExpression *deserialize(SnapshotReader &reader);
 };
 }
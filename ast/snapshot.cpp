@@ -0,0 +1,479 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "snapshot.h"
+#include "ast.h"
+#include "../util/memory_mapped_file.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+
+namespace ast
+{
+namespace
+{
+constexpr char snapshotMagic[8] = {'H', 'D', 'L', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t snapshotVersion = 1;
+constexpr std::uint32_t snapshotByteOrderMark = 0x01020304UL;
+constexpr std::size_t snapshotHeaderWordCount = 13;
+constexpr std::uint32_t nullSourceOffset = 0xFFFFFFFFUL;
+constexpr std::size_t bytesPerWord = sizeof(std::uint32_t);
+
+void appendWord64(std::vector<std::uint32_t> &words, std::uint64_t value)
+{
+    words.push_back(static_cast<std::uint32_t>(value));
+    words.push_back(static_cast<std::uint32_t>(value >> 32));
+}
+
+std::uint32_t checkedWord(std::size_t value, const char *what)
+{
+    if(value > std::numeric_limits<std::uint32_t>::max())
+        throw SnapshotError(std::string(what) + " too big for snapshot");
+    return static_cast<std::uint32_t>(value);
+}
+}
+
+std::uint64_t hashSourceText(util::string_view text) noexcept
+{
+    // 64-bit FNV-1a
+    std::uint64_t retval = 0xCBF29CE484222325ULL;
+    for(unsigned char ch : text)
+    {
+        retval ^= ch;
+        retval *= 0x100000001B3ULL;
+    }
+    return retval;
+}
+
+SnapshotWriter::SnapshotWriter(const parse::Source *source, const SymbolTable *globalSymbolTable)
+    : source(source), globalSymbolTable(globalSymbolTable), symbolTables{nullptr, globalSymbolTable}
+{
+    symbolTableIndexes[nullptr] = 0;
+    symbolTableIndexes[globalSymbolTable] = 1;
+    recordStack.emplace_back();
+    recordStackDepth = 1;
+}
+
+std::uint32_t SnapshotWriter::getStringIndex(util::StringPool::Entry value)
+{
+    if(!value)
+        return 0;
+    auto id = value.getId();
+    if(id >= stringIndexesById.size())
+        stringIndexesById.resize(id + 1, 0);
+    if(stringIndexesById[id] != 0)
+        return stringIndexesById[id];
+    auto &text = *value;
+    stringSection.push_back(checkedWord(text.size(), "string"));
+    auto start = stringSection.size();
+    stringSection.resize(start + (text.size() + bytesPerWord - 1) / bytesPerWord);
+    if(!text.empty())
+        std::memcpy(&stringSection[start], text.data(), text.size());
+    auto retval = ++stringCount;
+    stringIndexesById[id] = retval;
+    return retval;
+}
+
+std::uint32_t SnapshotWriter::getSymbolTableIndex(const SymbolTable *value)
+{
+    auto iter = symbolTableIndexes.find(value);
+    if(iter != symbolTableIndexes.end())
+        return std::get<1>(*iter);
+    auto retval = checkedWord(symbolTables.size(), "symbol table count");
+    symbolTables.push_back(value);
+    symbolTableIndexes.emplace(value, retval);
+    return retval;
+}
+
+std::uint32_t SnapshotWriter::getSymbolLookupChainNodeIndex(const SymbolLookupChainNode *value)
+{
+    if(!value)
+        return 0;
+    auto iter = symbolLookupChainNodeIndexes.find(value);
+    if(iter != symbolLookupChainNodeIndexes.end())
+        return std::get<1>(*iter);
+    auto parentIndex = getSymbolLookupChainNodeIndex(value->parent);
+    auto symbolTableIndex = getSymbolTableIndex(value->symbolTable);
+    symbolLookupChainSection.push_back(parentIndex);
+    symbolLookupChainSection.push_back(symbolTableIndex);
+    auto retval = ++symbolLookupChainNodeCount;
+    symbolLookupChainNodeIndexes.emplace(value, retval);
+    return retval;
+}
+
+std::uint32_t SnapshotWriter::getNodeIndex(const Node *value)
+{
+    if(!value)
+        return 0;
+    auto iter = nodeIndexes.find(value);
+    if(iter != nodeIndexes.end())
+        return std::get<1>(*iter);
+    if(recordStackDepth >= recordStack.size())
+        recordStack.emplace_back();
+    recordStack[recordStackDepth++].clear();
+    value->visitFields(*this);
+    auto &record = recordStack[--recordStackDepth];
+    nodeSection.insert(nodeSection.end(), record.begin(), record.end());
+    auto retval = ++nodeCount;
+    nodeIndexes.emplace(value, retval);
+    return retval;
+}
+
+void SnapshotWriter::visitNodeKind(NodeKind kind)
+{
+    writeWord(static_cast<std::uint32_t>(kind));
+}
+
+void SnapshotWriter::visitLocationRange(const parse::LocationRange &value)
+{
+    if(!value.source)
+    {
+        writeWord(nullSourceOffset);
+        writeWord(0);
+        return;
+    }
+    if(value.source != source)
+        throw SnapshotError("can't write a snapshot of nodes from a different source");
+    writeWord(checkedWord(value.offset, "source offset"));
+    writeWord(checkedWord(value.size, "location range"));
+}
+
+void SnapshotWriter::visitComments(const ConsecutiveComments &value)
+{
+    visitLocationRange(value.locationRange);
+}
+
+void SnapshotWriter::visitName(util::StringPool::Entry value)
+{
+    writeWord(getStringIndex(value));
+}
+
+void SnapshotWriter::visitBool(bool value)
+{
+    writeWord(value ? 1 : 0);
+}
+
+void SnapshotWriter::visitInteger(const math::GMPInteger &value)
+{
+    auto mpzView = value.getMpz();
+    mpz_srcptr mpz = mpzView;
+    bool isNegative = mpz_sgn(mpz) < 0;
+    std::size_t wordCount = (mpz_sizeinbase(mpz, 2) + 31) / 32;
+    if(mpz_sgn(mpz) == 0)
+        wordCount = 0;
+    writeWord(checkedWord(wordCount, "integer") << 1 | (isNegative ? 1 : 0));
+    auto &record = currentRecord();
+    auto start = record.size();
+    record.resize(start + wordCount);
+    std::size_t writtenWordCount = 0;
+    if(wordCount != 0)
+        mpz_export(&record[start], &writtenWordCount, -1, bytesPerWord, 0, 0, mpz);
+    assert(writtenWordCount == wordCount);
+}
+
+void SnapshotWriter::visitArraySize(std::size_t size, std::size_t)
+{
+    writeWord(checkedWord(size, "array"));
+}
+
+void SnapshotWriter::visitNode(const Node *value)
+{
+    writeWord(getNodeIndex(value));
+}
+
+void SnapshotWriter::visitSymbolTable(const SymbolTable *value)
+{
+    writeWord(getSymbolTableIndex(value));
+}
+
+void SnapshotWriter::visitSymbolLookupChain(const SymbolLookupChain &value)
+{
+    writeWord(getSymbolLookupChainNodeIndex(value.head));
+}
+
+void SnapshotWriter::write(std::ostream &os, const TopLevelModule *topLevelModule)
+{
+    auto rootNodeIndex = getNodeIndex(topLevelModule);
+    // the global symbol table is shared between modules, so its contents aren't part of the
+    // snapshot. writing the contents of a table can discover more nodes and tables.
+    std::vector<std::uint32_t> symbolTableSection;
+    for(std::size_t i = 2; i < symbolTables.size(); i++)
+    {
+        auto symbols = symbolTables[i]->getLocalSymbols();
+        symbolTableSection.push_back(checkedWord(symbols.size(), "symbol table"));
+        for(auto *symbol : symbols)
+        {
+            auto *node = dynamic_cast<const Node *>(symbol);
+            if(!node)
+                throw SnapshotError("symbol isn't a node");
+            symbolTableSection.push_back(getNodeIndex(node));
+        }
+    }
+    std::vector<std::uint32_t> header(sizeof(snapshotMagic) / bytesPerWord);
+    std::memcpy(header.data(), snapshotMagic, sizeof(snapshotMagic));
+    header.push_back(snapshotVersion);
+    header.push_back(snapshotByteOrderMark);
+    appendWord64(header, source->size());
+    appendWord64(header, hashSourceText(source->text()));
+    header.push_back(stringCount);
+    header.push_back(checkedWord(symbolTables.size(), "symbol table count"));
+    header.push_back(symbolLookupChainNodeCount);
+    header.push_back(nodeCount);
+    header.push_back(rootNodeIndex);
+    assert(header.size() == snapshotHeaderWordCount);
+    for(auto *section :
+        {&header, &stringSection, &symbolLookupChainSection, &nodeSection, &symbolTableSection})
+    {
+        os.write(reinterpret_cast<const char *>(section->data()), section->size() * bytesPerWord);
+    }
+}
+
+SnapshotReader::SnapshotReader(Context &context,
+                               const parse::Source *source,
+                               const unsigned char *data,
+                               std::size_t size) noexcept : context(context),
+                                                            source(source),
+                                                            data(data),
+                                                            wordCount(size / bytesPerWord)
+{
+}
+
+std::uint32_t SnapshotReader::readWord()
+{
+    if(position >= wordCount)
+        throw SnapshotError("snapshot is truncated");
+    std::uint32_t retval;
+    std::memcpy(&retval, data + position++ * bytesPerWord, bytesPerWord);
+    return retval;
+}
+
+std::uint64_t SnapshotReader::readWord64()
+{
+    std::uint64_t low = readWord();
+    std::uint64_t high = readWord();
+    return low | high << 32;
+}
+
+bool SnapshotReader::readBool()
+{
+    auto word = readWord();
+    if(word > 1)
+        throw SnapshotError("snapshot has invalid bool");
+    return word != 0;
+}
+
+std::size_t SnapshotReader::readArraySize()
+{
+    // every element takes at least one word, so this bounds the memory allocated for arrays
+    std::size_t retval = readWord();
+    if(retval > wordCount - position)
+        throw SnapshotError("snapshot has invalid array size");
+    return retval;
+}
+
+parse::LocationRange SnapshotReader::readLocationRange()
+{
+    std::size_t offset = readWord();
+    std::size_t size = readWord();
+    if(offset == nullSourceOffset)
+        return parse::LocationRange();
+    if(offset > source->size() || size > source->size() - offset)
+        throw SnapshotError("snapshot has invalid location");
+    return parse::LocationRange(source, offset, size);
+}
+
+util::StringPool::Entry SnapshotReader::readName()
+{
+    std::size_t index = readWord();
+    if(index > strings.size())
+        throw SnapshotError("snapshot has invalid string index");
+    if(index == 0)
+        return util::StringPool::Entry();
+    return strings[index - 1];
+}
+
+math::GMPInteger SnapshotReader::readInteger()
+{
+    auto sizeAndSign = readWord();
+    std::size_t integerWordCount = sizeAndSign >> 1;
+    if(integerWordCount > wordCount - position)
+        throw SnapshotError("snapshot is truncated");
+    math::GMPInteger retval;
+    auto mpz = retval.getMutableMpz();
+    mpz_import(mpz, integerWordCount, -1, bytesPerWord, 0, 0, data + position * bytesPerWord);
+    position += integerWordCount;
+    if(sizeAndSign & 1)
+        mpz_neg(mpz, mpz);
+    retval.shrinkToFit();
+    return retval;
+}
+
+SymbolTable *SnapshotReader::readSymbolTable()
+{
+    std::size_t index = readWord();
+    if(index >= symbolTables.size())
+        throw SnapshotError("snapshot has invalid symbol table index");
+    return symbolTables[index];
+}
+
+SymbolLookupChain SnapshotReader::readSymbolLookupChain()
+{
+    std::size_t index = readWord();
+    if(index > symbolLookupChainNodes.size())
+        throw SnapshotError("snapshot has invalid symbol lookup chain index");
+    if(index == 0)
+        return SymbolLookupChain();
+    return SymbolLookupChain(symbolLookupChainNodes[index - 1]);
+}
+
+Node *SnapshotReader::readNodeReference()
+{
+    std::size_t index = readWord();
+    if(index > nodes.size())
+        throw SnapshotError("snapshot has invalid node index");
+    if(index == 0)
+        return nullptr;
+    return nodes[index - 1];
+}
+
+Node *SnapshotReader::readNodeRecord()
+{
+    auto kind = readWord();
+    if(kind >= nodeKindCount)
+        throw SnapshotError("snapshot has invalid node kind");
+    switch(static_cast<NodeKind>(kind))
+    {
+#define AST_SNAPSHOT_NODE_KIND(name) \
+    case NodeKind::name:             \
+        return name::deserialize(*this);
+        AST_NODE_KINDS(AST_SNAPSHOT_NODE_KIND)
+#undef AST_SNAPSHOT_NODE_KIND
+    }
+    throw SnapshotError("snapshot has invalid node kind");
+}
+
+TopLevelModule *SnapshotReader::read()
+{
+    position = 0;
+    if(wordCount < snapshotHeaderWordCount)
+        return nullptr;
+    if(std::memcmp(data, snapshotMagic, sizeof(snapshotMagic)) != 0)
+        return nullptr;
+    position = sizeof(snapshotMagic) / bytesPerWord;
+    if(readWord() != snapshotVersion || readWord() != snapshotByteOrderMark)
+        return nullptr;
+    if(readWord64() != source->size() || readWord64() != hashSourceText(source->text()))
+        return nullptr;
+    std::size_t stringCount = readArraySize();
+    std::size_t symbolTableCount = readWord();
+    std::size_t symbolLookupChainNodeCount = readArraySize();
+    std::size_t nodeCount = readArraySize();
+    std::size_t rootNodeIndex = readWord();
+    if(symbolTableCount < 2 || symbolTableCount - 2 > wordCount - position)
+        throw SnapshotError("snapshot has invalid symbol table count");
+    strings.reserve(stringCount);
+    for(std::size_t i = 0; i < stringCount; i++)
+    {
+        std::size_t size = readWord();
+        std::size_t sizeInWords = (size + bytesPerWord - 1) / bytesPerWord;
+        if(sizeInWords > wordCount - position)
+            throw SnapshotError("snapshot is truncated");
+        auto *text = reinterpret_cast<const char *>(data + position * bytesPerWord);
+        strings.push_back(context.stringPool.intern(util::string_view(text, size)));
+        position += sizeInWords;
+    }
+    symbolTables.reserve(symbolTableCount);
+    symbolTables.push_back(nullptr);
+    symbolTables.push_back(SymbolTable::getGlobalSymbolTable(context));
+    for(std::size_t i = 2; i < symbolTableCount; i++)
+        symbolTables.push_back(context.arena.create<SymbolTable>());
+    symbolLookupChainNodes.reserve(symbolLookupChainNodeCount);
+    for(std::size_t i = 0; i < symbolLookupChainNodeCount; i++)
+    {
+        auto parent = readSymbolLookupChain();
+        auto *symbolTable = readSymbolTable();
+        if(!symbolTable)
+            throw SnapshotError("snapshot has symbol lookup chain node without symbol table");
+        symbolLookupChainNodes.push_back(
+            context.arena.create<SymbolLookupChainNode>(parent.head, symbolTable));
+    }
+    nodes.reserve(nodeCount);
+    for(std::size_t i = 0; i < nodeCount; i++)
+        nodes.push_back(readNodeRecord());
+    for(std::size_t i = 2; i < symbolTableCount; i++)
+    {
+        auto symbolCount = readArraySize();
+        for(std::size_t j = 0; j < symbolCount; j++)
+        {
+            auto *symbol = dynamic_cast<Symbol *>(readNode<Node>());
+            if(!symbol || !symbolTables[i]->insert(symbol))
+                throw SnapshotError("snapshot has invalid symbol table entry");
+        }
+    }
+    if(rootNodeIndex == 0 || rootNodeIndex > nodes.size())
+        throw SnapshotError("snapshot has invalid root node");
+    auto *retval = dynamic_cast<TopLevelModule *>(nodes[rootNodeIndex - 1]);
+    if(!retval)
+        throw SnapshotError("snapshot root isn't a top-level module");
+    if(position != wordCount)
+        throw SnapshotError("snapshot has extra data at end");
+    return retval;
+}
+
+void writeSnapshot(std::ostream &os,
+                   const Context &context,
+                   const parse::Source *source,
+                   const TopLevelModule *topLevelModule)
+{
+    SnapshotWriter(source, context.globalSymbolTable).write(os, topLevelModule);
+}
+
+TopLevelModule *readSnapshot(Context &context,
+                             const parse::Source *source,
+                             const unsigned char *data,
+                             std::size_t size)
+{
+    return SnapshotReader(context, source, data, size).read();
+}
+
+TopLevelModule *loadSnapshotFile(Context &context,
+                                 const parse::Source *source,
+                                 const std::string &fileName)
+{
+    auto file = util::MemoryMappedFile::open(fileName);
+    if(!file)
+        return nullptr;
+    return readSnapshot(context, source, file->data(), file->size());
+}
+
+void saveSnapshotFile(const std::string &fileName,
+                      const Context &context,
+                      const parse::Source *source,
+                      const TopLevelModule *topLevelModule)
+{
+    std::ofstream os(fileName, std::ios::binary);
+    if(!os)
+        throw SnapshotError("can't open " + fileName);
+    writeSnapshot(os, context, source, topLevelModule);
+    os.close();
+    if(!os)
+        throw SnapshotError("writing " + fileName + " failed");
+}
+}
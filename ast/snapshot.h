@@ -0,0 +1,180 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "node.h"
+#include "node_field_visitor.h"
+#include "node_kind.h"
+#include "comment.h"
+#include "context.h"
+#include "symbol_table.h"
+#include "symbol_lookup_chain.h"
+#include "top_level_module.h"
+#include "../math/bit_vector.h"
+#include "../parse/source.h"
+#include "../util/string_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ast
+{
+class SnapshotError : public std::runtime_error
+{
+public:
+    using runtime_error::runtime_error;
+};
+
+/** A snapshot is a stream of native-endian 32-bit words: a header, the interned strings, the
+ * symbol lookup chain nodes, the nodes in post-order (so every reference points backwards), and
+ * finally the contents of the symbol tables. Every pointer is stored as an index, so loading is a
+ * single linear pass with no fixups beyond the parser's own back-pointers. */
+class SnapshotWriter final : public NodeFieldVisitor
+{
+private:
+    const parse::Source *source;
+    const SymbolTable *globalSymbolTable;
+    std::vector<std::uint32_t> stringSection;
+    std::vector<std::uint32_t> symbolLookupChainSection;
+    std::vector<std::uint32_t> nodeSection;
+    std::vector<std::vector<std::uint32_t>> recordStack;
+    std::size_t recordStackDepth = 0;
+    /** indexed by StringPoolEntry::getId(), 0 for strings not written yet */
+    std::vector<std::uint32_t> stringIndexesById;
+    std::unordered_map<const SymbolTable *, std::uint32_t> symbolTableIndexes;
+    std::vector<const SymbolTable *> symbolTables;
+    std::unordered_map<const SymbolLookupChainNode *, std::uint32_t> symbolLookupChainNodeIndexes;
+    std::unordered_map<const Node *, std::uint32_t> nodeIndexes;
+    std::uint32_t stringCount = 0;
+    std::uint32_t symbolLookupChainNodeCount = 0;
+    std::uint32_t nodeCount = 0;
+
+private:
+    std::vector<std::uint32_t> &currentRecord() noexcept
+    {
+        return recordStack[recordStackDepth - 1];
+    }
+    void writeWord(std::uint32_t word)
+    {
+        currentRecord().push_back(word);
+    }
+    std::uint32_t getStringIndex(util::StringPool::Entry value);
+    std::uint32_t getSymbolTableIndex(const SymbolTable *value);
+    std::uint32_t getSymbolLookupChainNodeIndex(const SymbolLookupChainNode *value);
+    std::uint32_t getNodeIndex(const Node *value);
+
+public:
+    SnapshotWriter(const parse::Source *source, const SymbolTable *globalSymbolTable);
+    virtual void visitNodeKind(NodeKind kind) override;
+    virtual void visitLocationRange(const parse::LocationRange &value) override;
+    virtual void visitComments(const ConsecutiveComments &value) override;
+    virtual void visitName(util::StringPool::Entry value) override;
+    virtual void visitBool(bool value) override;
+    virtual void visitInteger(const math::GMPInteger &value) override;
+    virtual void visitArraySize(std::size_t size, std::size_t heapBytes) override;
+    virtual void visitNode(const Node *value) override;
+    virtual void visitSymbolTable(const SymbolTable *value) override;
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &value) override;
+    void write(std::ostream &os, const TopLevelModule *topLevelModule);
+};
+
+class SnapshotReader final
+{
+private:
+    Context &context;
+    const parse::Source *source;
+    const unsigned char *data;
+    std::size_t wordCount;
+    std::size_t position = 0;
+    std::vector<util::StringPool::Entry> strings;
+    std::vector<SymbolTable *> symbolTables;
+    std::vector<const SymbolLookupChainNode *> symbolLookupChainNodes;
+    std::vector<Node *> nodes;
+
+private:
+    Node *readNodeRecord();
+    Node *readNodeReference();
+
+public:
+    SnapshotReader(Context &context,
+                   const parse::Source *source,
+                   const unsigned char *data,
+                   std::size_t size) noexcept;
+    std::uint32_t readWord();
+    std::uint64_t readWord64();
+    bool readBool();
+    std::size_t readArraySize();
+    parse::LocationRange readLocationRange();
+    ConsecutiveComments readComments()
+    {
+        return ConsecutiveComments(readLocationRange());
+    }
+    util::StringPool::Entry readName();
+    math::GMPInteger readInteger();
+    SymbolTable *readSymbolTable();
+    SymbolLookupChain readSymbolLookupChain();
+    template <typename T>
+    T *readNode()
+    {
+        auto *node = readNodeReference();
+        if(!node)
+            return nullptr;
+        auto *retval = dynamic_cast<T *>(node);
+        if(!retval)
+            throw SnapshotError("snapshot node has wrong kind");
+        return retval;
+    }
+    template <typename T, typename... Args>
+    T *create(Args &&... args)
+    {
+        return context.arena.create<T>(std::forward<Args>(args)...);
+    }
+    /** returns nullptr if the snapshot was made from a different source text or by a different
+     * version of the compiler */
+    TopLevelModule *read();
+};
+
+std::uint64_t hashSourceText(util::string_view text) noexcept;
+
+void writeSnapshot(std::ostream &os,
+                   const Context &context,
+                   const parse::Source *source,
+                   const TopLevelModule *topLevelModule);
+
+/** returns nullptr if the snapshot is stale; throws SnapshotError if it is corrupt */
+TopLevelModule *readSnapshot(Context &context,
+                             const parse::Source *source,
+                             const unsigned char *data,
+                             std::size_t size);
+
+/** returns nullptr if the file doesn't exist or the snapshot is stale */
+TopLevelModule *loadSnapshotFile(Context &context,
+                                 const parse::Source *source,
+                                 const std::string &fileName);
+
+void saveSnapshotFile(const std::string &fileName,
+                      const Context &context,
+                      const parse::Source *source,
+                      const TopLevelModule *topLevelModule);
+}
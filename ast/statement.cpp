@@ -26,4 +26,9 @@ void Statement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     Node::dump(dumpNode, state);
     dumpNode->nodeName = "ast::Statement";
 }
+
+void Statement::visitFields(NodeFieldVisitor &visitor) const
+{
+    Node::visitFields(visitor);
+}
 }
@@ -0,0 +1,244 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "structural_interner.h"
+#include "ast.h"
+#include "../math/gmp_integer.h"
+#include "../util/memory_usage.h"
+
+namespace ast
+{
+class StructuralInterner::KeyBuilder final : public NodeFieldVisitor
+{
+private:
+    StructuralInterner &interner;
+    std::vector<std::uintptr_t> &key;
+    bool isInType;
+
+public:
+    bool isInternable = true;
+
+public:
+    KeyBuilder(StructuralInterner &interner,
+               std::vector<std::uintptr_t> &key,
+               bool isInType) noexcept : interner(interner),
+                                         key(key),
+                                         isInType(isInType)
+    {
+    }
+    /** keys scopedId by the symbol it resolves to instead of by its name and scope. The template
+     * arguments of scopedId and its parent scopes are kept, since they select the instance the
+     * symbol is in. */
+    void visitResolvedScopedId(const ScopedId *scopedId, const Symbol *symbol)
+    {
+        visitNodeKind(NodeKind::ScopedId);
+        key.push_back(reinterpret_cast<std::uintptr_t>(symbol));
+        for(auto *i = scopedId; i; i = i->parentScope)
+            if(i->templateArguments)
+                visitNode(i->templateArguments);
+    }
+    virtual void visitNodeKind(NodeKind kind) override
+    {
+        key.push_back(static_cast<std::uintptr_t>(kind));
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry value) override
+    {
+        key.push_back(reinterpret_cast<std::uintptr_t>(value.operator->()));
+    }
+    virtual void visitBool(bool value) override
+    {
+        key.push_back(value);
+    }
+    virtual void visitInteger(const math::GMPInteger &value) override
+    {
+        auto mpzView = value.getMpz();
+        mpz_srcptr mpz = mpzView;
+        auto size = mpz_size(mpz);
+        key.push_back(static_cast<std::uintptr_t>(mpz_sgn(mpz) + 1));
+        key.push_back(size);
+        for(std::size_t i = 0; i < size; i++)
+        {
+            auto limb = mpz_getlimbn(mpz, i);
+            for(std::size_t shift = 0; shift < GMP_NUMB_BITS; shift += sizeof(std::uintptr_t) * 8)
+                key.push_back(static_cast<std::uintptr_t>(limb >> shift));
+        }
+    }
+    virtual void visitArraySize(std::size_t size, std::size_t) override
+    {
+        key.push_back(size);
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value)
+        {
+            key.push_back(0);
+            return;
+        }
+        auto *canonicalNode = interner.intern(value, isInType);
+        if(!canonicalNode)
+            isInternable = false;
+        key.push_back(reinterpret_cast<std::uintptr_t>(canonicalNode));
+    }
+    virtual void visitSymbolTable(const SymbolTable *value) override
+    {
+        key.push_back(reinterpret_cast<std::uintptr_t>(value));
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &value) override
+    {
+        key.push_back(reinterpret_cast<std::uintptr_t>(value.head));
+    }
+};
+
+namespace
+{
+class InternAllVisitor final : public NodeFieldVisitor
+{
+private:
+    StructuralInterner &interner;
+
+public:
+    explicit InternAllVisitor(StructuralInterner &interner) noexcept : interner(interner)
+    {
+    }
+    virtual void visitNodeKind(NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value)
+            return;
+        // interning a node interns everything below it, so only descend into what wasn't interned
+        if(!interner.intern(value))
+            value->visitFields(*this);
+    }
+    virtual void visitSymbolTable(const SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &) override
+    {
+    }
+};
+
+bool isConstantExpressionKind(NodeKind kind) noexcept
+{
+    switch(kind)
+    {
+    case NodeKind::AssignmentExpression:
+    case NodeKind::ConnectExpression:
+    case NodeKind::FunctionCallExpression:
+    case NodeKind::ScopedIdExpression:
+        return false;
+    default:
+        return true;
+    }
+}
+}
+
+const CanonicalNode *StructuralInterner::intern(const Node *node, bool isInType)
+{
+    isInType = isInType || dynamic_cast<const Type *>(node);
+    NodeMapKey nodeMapKey{node, isInType};
+    auto iter = nodeMap.find(nodeMapKey);
+    if(iter != nodeMap.end())
+        return std::get<1>(*iter);
+    CanonicalNode canonicalNode{};
+    KeyBuilder keyBuilder(*this, canonicalNode.key, isInType);
+    auto *scopedId = dynamic_cast<const ScopedId *>(node);
+    auto *symbol = scopedId ? nameResolver.resolve(scopedId) : nullptr;
+    if(symbol)
+        keyBuilder.visitResolvedScopedId(scopedId, symbol);
+    else
+        node->visitFields(keyBuilder);
+    canonicalNode.kind = static_cast<NodeKind>(canonicalNode.key.front());
+    if(!isInType && !isConstantExpressionKind(canonicalNode.kind))
+        keyBuilder.isInternable = false;
+    if(!keyBuilder.isInternable)
+    {
+        nodeMap.emplace(nodeMapKey, nullptr);
+        return nullptr;
+    }
+    std::size_t hash = 0;
+    for(auto word : canonicalNode.key)
+        hash = hash * 0x100000001B3ULL ^ std::hash<std::uintptr_t>()(word);
+    canonicalNode.hash = hash;
+    canonicalNode.representative = node;
+    const CanonicalNode *retval;
+    auto setIter = canonicalNodeSet.find(&canonicalNode);
+    if(setIter != canonicalNodeSet.end())
+    {
+        retval = *setIter;
+    }
+    else
+    {
+        canonicalNodes.push_back(std::move(canonicalNode));
+        retval = &canonicalNodes.back();
+        canonicalNodeSet.insert(retval);
+    }
+    nodeMap.emplace(nodeMapKey, retval);
+    internedNodeCount++;
+    return retval;
+}
+
+const CanonicalNode *StructuralInterner::intern(const Node *node)
+{
+    if(!node)
+        return nullptr;
+    if(!dynamic_cast<const Type *>(node) && !dynamic_cast<const Expression *>(node))
+        return nullptr;
+    return intern(node, false);
+}
+
+void StructuralInterner::internAll(const Node *root)
+{
+    InternAllVisitor visitor(*this);
+    visitor.visitNode(root);
+}
+
+std::size_t StructuralInterner::getHeapBytes() const noexcept
+{
+    std::size_t retval = canonicalNodes.size() * sizeof(CanonicalNode);
+    for(auto &canonicalNode : canonicalNodes)
+        retval += util::getHeapBytes(canonicalNode.key);
+    return retval + util::getHashTableHeapBytes(canonicalNodeSet)
+           + util::getHashTableHeapBytes(nodeMap);
+}
+}
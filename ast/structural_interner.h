@@ -0,0 +1,121 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "name_resolver.h"
+#include "node.h"
+#include "node_kind.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ast
+{
+/** the shared representation of a group of structurally identical nodes */
+struct CanonicalNode final
+{
+    NodeKind kind;
+    std::size_t hash;
+    /** the node kind, names, flags, integers, array sizes, canonical children, and scope of the
+     * nodes, without locations or comments */
+    std::vector<std::uintptr_t> key;
+    /** the first node interned with this structure */
+    const Node *representative;
+};
+
+/** maps structurally identical types and constant expressions to one CanonicalNode, so comparing
+ * them is a pointer compare. Types are interned with everything below them, including the names
+ * they reference, which are keyed by the symbol they resolve to and their template arguments, so
+ * the same symbol named from a different scope or by a qualified name is the same type. Names
+ * that don't resolve are keyed by their symbol lookup chain instead. Outside of types, only
+ * expressions that don't reference names, call functions, or assign are interned. */
+class StructuralInterner final
+{
+private:
+    class KeyBuilder;
+    struct CanonicalNodeHasher final
+    {
+        std::size_t operator()(const CanonicalNode *value) const noexcept
+        {
+            return value->hash;
+        }
+    };
+    struct CanonicalNodeEqual final
+    {
+        bool operator()(const CanonicalNode *a, const CanonicalNode *b) const noexcept
+        {
+            return a->kind == b->kind && a->hash == b->hash && a->key == b->key;
+        }
+    };
+    /** whether a node can be interned depends on whether it's inside a type */
+    struct NodeMapKey final
+    {
+        const Node *node;
+        bool isInType;
+        friend bool operator==(const NodeMapKey &a, const NodeMapKey &b) noexcept
+        {
+            return a.node == b.node && a.isInType == b.isInType;
+        }
+    };
+    struct NodeMapKeyHasher final
+    {
+        std::size_t operator()(const NodeMapKey &value) const noexcept
+        {
+            return std::hash<const void *>()(value.node) ^ value.isInType;
+        }
+    };
+
+private:
+    NameResolver &nameResolver;
+    std::deque<CanonicalNode> canonicalNodes;
+    std::unordered_set<const CanonicalNode *, CanonicalNodeHasher, CanonicalNodeEqual>
+        canonicalNodeSet;
+    /** maps to nullptr for nodes that can't be interned */
+    std::unordered_map<NodeMapKey, const CanonicalNode *, NodeMapKeyHasher> nodeMap;
+    std::size_t internedNodeCount = 0;
+
+private:
+    const CanonicalNode *intern(const Node *node, bool isInType);
+
+public:
+    explicit StructuralInterner(NameResolver &nameResolver) noexcept : nameResolver(nameResolver)
+    {
+    }
+    StructuralInterner(const StructuralInterner &) = delete;
+    StructuralInterner &operator=(const StructuralInterner &) = delete;
+    /** returns nullptr if node isn't a type or constant expression */
+    const CanonicalNode *intern(const Node *node);
+    /** interns every type and constant expression reachable from root */
+    void internAll(const Node *root);
+    std::size_t getCanonicalNodeCount() const noexcept
+    {
+        return canonicalNodes.size();
+    }
+    std::size_t getInternedNodeCount() const noexcept
+    {
+        return internedNodeCount;
+    }
+    /** the bytes allocated for the canonical nodes and the lookup tables */
+    std::size_t getHeapBytes() const noexcept;
+};
+}
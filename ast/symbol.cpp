@@ -27,4 +27,10 @@ void Symbol::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "symbolLocationRange", symbolLocationRange);
     state.setSimple(dumpNode, "name", name);
 }
+
+void Symbol::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitLocationRange(symbolLocationRange);
+    visitor.visitName(name);
+}
 }
@@ -22,6 +22,7 @@
 #include "../parse/source.h"
 #include "../util/string_pool.h"
 #include "../util/dump_tree.h"
+#include "node_field_visitor.h"
 
 namespace ast
 {
@@ -41,5 +42,6 @@ public:
     {
     }
     void dump(util::DumpTree *dumpNode, util::DumpState &state) const;
+    void visitFields(NodeFieldVisitor &visitor) const;
 };
 }
@@ -27,4 +27,10 @@ void SymbolScope::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointer(dumpNode, "symbolLookupChain", &symbolLookupChain);
     state.setPointer(dumpNode, "symbolTable", symbolTable);
 }
+
+void SymbolScope::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitSymbolLookupChain(symbolLookupChain);
+    visitor.visitSymbolTable(symbolTable);
+}
 }
@@ -22,6 +22,7 @@
 #include "symbol_table.h"
 #include "symbol_lookup_chain.h"
 #include "../util/dump_tree.h"
+#include "node_field_visitor.h"
 
 namespace ast
 {
@@ -37,6 +38,7 @@ public:
     {
     }
     void dump(util::DumpTree *dumpNode, util::DumpState &state) const;
+    void visitFields(NodeFieldVisitor &visitor) const;
 };
 
 inline SymbolScope::~SymbolScope()
@@ -19,9 +19,40 @@
 
 #include "symbol_table.h"
 #include "node.h"
+#include "../util/memory_usage.h"
 
 namespace ast
 {
+constexpr std::size_t SymbolTable::inlineCapacity;
+
+// every scope has a SymbolTable, so storing symbols inline mustn't make small scopes bigger than
+// the map and list they used to have
+static_assert(sizeof(SymbolTable)
+                  <= sizeof(std::unordered_map<util::StringPool::Entry, Symbol *>)
+                         + sizeof(std::vector<Symbol *>),
+              "SymbolTable grew");
+
+void SymbolTable::makeLarge()
+{
+    largeSymbols.reset(new LargeSymbols());
+    largeSymbols->map.reserve(inlineSymbolCount * 2);
+    largeSymbols->list.reserve(inlineSymbolCount * 2);
+    for(std::size_t i = 0; i < inlineSymbolCount; i++)
+    {
+        largeSymbols->map.emplace(inlineSymbols[i]->name, inlineSymbols[i]);
+        largeSymbols->list.push_back(inlineSymbols[i]);
+    }
+    inlineSymbolCount = 0;
+}
+
+std::size_t SymbolTable::getHeapBytes() const noexcept
+{
+    if(!isLarge())
+        return 0;
+    return sizeof(LargeSymbols) + util::getHashTableHeapBytes(largeSymbols->map)
+           + util::getHeapBytes(largeSymbols->list);
+}
+
 SymbolTable *SymbolTable::getGlobalSymbolTable(Context &context)
 {
     if(!context.globalSymbolTable)
@@ -34,9 +65,10 @@ SymbolTable *SymbolTable::getGlobalSymbolTable(Context &context)
 void SymbolTable::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     dumpNode->nodeName = "ast::SymbolTable";
-    for(std::size_t i = 0; i < localSymbolsList.size(); i++)
+    auto localSymbols = getLocalSymbols();
+    for(std::size_t i = 0; i < localSymbols.size(); i++)
     {
-        auto *symbolAsNode = dynamic_cast<Node *>(localSymbolsList[i]);
+        auto *symbolAsNode = dynamic_cast<Node *>(localSymbols[i]);
         state.setPointerIndexed(dumpNode, "localSymbolsList", i, symbolAsNode);
     }
 }
@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstddef>
+#include <memory>
 #include <unordered_map>
 #include "../util/string_pool.h"
 #include "symbol.h"
@@ -28,33 +31,117 @@
 
 namespace ast
 {
+/** the symbols declared directly in one scope. Most scopes hold only a few symbols, so up to
+ * inlineCapacity symbols are stored inline and found by linear search; a hash map is only built
+ * once a scope grows past that. Empty scopes don't allocate. The list and map of a large table
+ * share one heap allocation, so a table is no bigger than the unordered_map and vector it
+ * replaces. */
 class SymbolTable
 {
 public:
-    std::unordered_map<util::StringPool::Entry, Symbol *> localSymbolsMap = {};
-    std::vector<Symbol *> localSymbolsList = {};
+    static constexpr std::size_t inlineCapacity = 8;
+    class LocalSymbols final
+    {
+    private:
+        Symbol *const *first;
+        std::size_t count;
+
+    public:
+        constexpr LocalSymbols(Symbol *const *first, std::size_t count) noexcept : first(first),
+                                                                                  count(count)
+        {
+        }
+        constexpr Symbol *const *begin() const noexcept
+        {
+            return first;
+        }
+        constexpr Symbol *const *end() const noexcept
+        {
+            return first + count;
+        }
+        constexpr std::size_t size() const noexcept
+        {
+            return count;
+        }
+        constexpr bool empty() const noexcept
+        {
+            return count == 0;
+        }
+        constexpr Symbol *operator[](std::size_t index) const noexcept
+        {
+            return first[index];
+        }
+    };
+
+private:
+    struct LargeSymbols final
+    {
+        /** in the order they were inserted */
+        std::vector<Symbol *> list;
+        std::unordered_map<util::StringPool::Entry, Symbol *> map;
+    };
+
+private:
+    std::size_t inlineSymbolCount = 0;
+    Symbol *inlineSymbols[inlineCapacity];
+    std::unique_ptr<LargeSymbols> largeSymbols;
+
+private:
+    bool isLarge() const noexcept
+    {
+        return largeSymbols != nullptr;
+    }
+    void makeLarge();
+
+public:
     SymbolTable()
     {
     }
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+    /** the symbols in the order they were inserted */
+    LocalSymbols getLocalSymbols() const noexcept
+    {
+        if(isLarge())
+            return LocalSymbols(largeSymbols->list.data(), largeSymbols->list.size());
+        return LocalSymbols(inlineSymbols, inlineSymbolCount);
+    }
     Symbol *find(util::StringPool::Entry name) const
     {
-        auto iter = localSymbolsMap.find(name);
-        if(iter != localSymbolsMap.end())
-            return std::get<1>(*iter);
+        if(isLarge())
+        {
+            auto iter = largeSymbols->map.find(name);
+            if(iter != largeSymbols->map.end())
+                return std::get<1>(*iter);
+            return nullptr;
+        }
+        for(std::size_t i = 0; i < inlineSymbolCount; i++)
+            if(inlineSymbols[i]->name == name)
+                return inlineSymbols[i];
         return nullptr;
     }
     bool insert(Symbol *symbol)
     {
         assert(symbol);
         assert(symbol->containingSymbolTable == nullptr);
-        if(std::get<1>(localSymbolsMap.emplace(symbol->name, symbol)))
+        if(find(symbol->name))
+            return false;
+        if(!isLarge() && inlineSymbolCount >= inlineCapacity)
+            makeLarge();
+        if(isLarge())
+        {
+            largeSymbols->map.emplace(symbol->name, symbol);
+            largeSymbols->list.push_back(symbol);
+        }
+        else
         {
-            symbol->containingSymbolTable = this;
-            localSymbolsList.push_back(symbol);
-            return true;
+            inlineSymbols[inlineSymbolCount++] = symbol;
         }
-        return false;
+        symbol->containingSymbolTable = this;
+        return true;
     }
+    /** the bytes allocated once the table has grown past inlineCapacity */
+    std::size_t getHeapBytes() const noexcept;
     static SymbolTable *getGlobalSymbolTable(Context &context);
     void dump(util::DumpTree *dumpNode, util::DumpState &state) const;
 };
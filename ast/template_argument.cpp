@@ -18,6 +18,7 @@
  */
 
 #include "template_argument.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -27,6 +28,11 @@ void TemplateArgument::dump(util::DumpTree *dumpNode, util::DumpState &state) co
     dumpNode->nodeName = "ast::TemplateArgument";
 }
 
+void TemplateArgument::visitFields(NodeFieldVisitor &visitor) const
+{
+    Node::visitFields(visitor);
+}
+
 void TypeTemplateArgument::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     TemplateArgument::dump(dumpNode, state);
@@ -35,10 +41,40 @@ void TypeTemplateArgument::dump(util::DumpTree *dumpNode, util::DumpState &state
     state.setPointer(dumpNode, "type", type);
 }
 
+void TypeTemplateArgument::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TypeTemplateArgument);
+    TemplateArgument::visitFields(visitor);
+    visitor.visitComments(beforeTypeComments);
+    visitor.visitNode(type);
+}
+
+TypeTemplateArgument *TypeTemplateArgument::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeTypeComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    return reader.create<TypeTemplateArgument>(locationRange, beforeTypeComments, type);
+}
+
 void ValueTemplateArgument::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     TemplateArgument::dump(dumpNode, state);
     dumpNode->nodeName = "ast::ValueTemplateArgument";
     state.setPointer(dumpNode, "value", value);
 }
+
+void ValueTemplateArgument::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ValueTemplateArgument);
+    TemplateArgument::visitFields(visitor);
+    visitor.visitNode(value);
+}
+
+ValueTemplateArgument *ValueTemplateArgument::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto *value = reader.readNode<Expression>();
+    return reader.create<ValueTemplateArgument>(locationRange, value);
+}
 }
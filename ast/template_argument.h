@@ -35,6 +35,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 class TypeTemplateArgument final : public TemplateArgument
@@ -50,6 +51,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static TypeTemplateArgument *deserialize(SnapshotReader &reader);
 };
 
 class ValueTemplateArgument final : public TemplateArgument
@@ -62,5 +65,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static ValueTemplateArgument *deserialize(SnapshotReader &reader);
 };
 }
@@ -18,6 +18,7 @@
  */
 
 #include "template_arguments.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -39,4 +40,44 @@ void TemplateArguments::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     }
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void TemplateArguments::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TemplateArguments);
+    Node::visitFields(visitor);
+    visitor.visitComments(beforeEMarkComments);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitNode(firstArgument);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.argument);
+    }
+    visitor.visitComments(beforeRBraceComments);
+}
+
+TemplateArguments *TemplateArguments::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeEMarkComments = reader.readComments();
+    auto beforeLBraceComments = reader.readComments();
+    auto *firstArgument = reader.readNode<TemplateArgument>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *argument = reader.readNode<TemplateArgument>();
+        parts.push_back(Part(beforeCommaComments, argument));
+    }
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<TemplateArguments>(locationRange,
+                                            beforeEMarkComments,
+                                            beforeLBraceComments,
+                                            firstArgument,
+                                            std::move(parts),
+                                            beforeRBraceComments);
+}
 }
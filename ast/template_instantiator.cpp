@@ -0,0 +1,411 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "template_instantiator.h"
+#include "const_statement_part.h"
+#include "enum.h"
+#include "function.h"
+#include "interface.h"
+#include "module.h"
+#include "node_field_visitor.h"
+#include "scoped_id_type.h"
+#include "template_argument.h"
+#include "template_arguments.h"
+#include "template_parameters.h"
+#include "type_statement.h"
+#include "type_template_parameter.h"
+#include "value_template_parameter.h"
+#include "../parse/parse_error.h"
+#include "../util/memory_usage.h"
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+
+namespace ast
+{
+namespace
+{
+/** returns nullptr if node isn't a template */
+const TemplateParameters *getTemplateParameters(const Node *node) noexcept
+{
+    if(auto *module = dynamic_cast<const Module *>(node))
+        return module->templateParameters;
+    if(auto *interface = dynamic_cast<const Interface *>(node))
+        return interface->templateParameters;
+    if(auto *function = dynamic_cast<const Function *>(node))
+        return function->templateParameters;
+    return nullptr;
+}
+
+std::size_t getParameterCount(const TemplateParameters *templateParameters) noexcept
+{
+    return templateParameters->firstTemplateParameter ? 1 + templateParameters->parts.size() : 0;
+}
+
+const TemplateParameter *getParameter(const TemplateParameters *templateParameters,
+                                      std::size_t index) noexcept
+{
+    return index == 0 ? templateParameters->firstTemplateParameter :
+                        templateParameters->parts[index - 1].templateParameter;
+}
+
+/** returns true if parameter is a parameter of a template that scope is nested in */
+bool isEnclosingParameter(const SymbolScope *scope, const TemplateParameter *parameter)
+{
+    for(auto *node = scope->symbolLookupChain.head->parent; node; node = node->parent)
+        if(node->symbolTable->find(parameter->name) == parameter)
+            return true;
+    return false;
+}
+
+std::size_t getArgumentCount(const TemplateArguments *templateArguments) noexcept
+{
+    return templateArguments->firstArgument ? 1 + templateArguments->parts.size() : 0;
+}
+
+const TemplateArgument *getArgument(const TemplateArguments *templateArguments,
+                                    std::size_t index) noexcept
+{
+    return index == 0 ? templateArguments->firstArgument :
+                        templateArguments->parts[index - 1].argument;
+}
+}
+
+class TemplateInstantiator::DependencyVisitor final : public NodeFieldVisitor
+{
+private:
+    TemplateInstantiator &templateInstantiator;
+
+public:
+    bool isDependent = false;
+
+public:
+    explicit DependencyVisitor(TemplateInstantiator &templateInstantiator) noexcept
+        : templateInstantiator(templateInstantiator)
+    {
+    }
+    virtual void visitNodeKind(NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value || isDependent)
+            return;
+        if(auto *scopedId = dynamic_cast<const ScopedId *>(value))
+        {
+            auto *symbol = templateInstantiator.nameResolver.resolve(scopedId);
+            if(dynamic_cast<const TemplateParameter *>(symbol))
+            {
+                isDependent = true;
+                return;
+            }
+            // modules, interfaces, and functions only depend on the template arguments in
+            // scopedId, which are visited below
+            if(dynamic_cast<const ConstStatementPart *>(symbol)
+               || dynamic_cast<const EnumPart *>(symbol) || dynamic_cast<const Enum *>(symbol)
+               || dynamic_cast<const TypeStatement *>(symbol))
+            {
+                if(templateInstantiator.dependsOnTemplateParameters(
+                       dynamic_cast<const Node *>(symbol)))
+                {
+                    isDependent = true;
+                    return;
+                }
+            }
+        }
+        value->visitFields(*this);
+    }
+    virtual void visitSymbolTable(const SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &) override
+    {
+    }
+};
+
+class TemplateInstantiator::Visitor final : public NodeFieldVisitor
+{
+private:
+    TemplateInstantiator &templateInstantiator;
+    const TemplateBinding *binding;
+    /** the template being elaborated; the bodies of other templates are skipped, since their
+     * template arguments depend on parameters that aren't bound */
+    const Node *instanceNode;
+
+public:
+    explicit Visitor(TemplateInstantiator &templateInstantiator,
+                     const TemplateBinding *binding,
+                     const Node *instanceNode) noexcept
+        : templateInstantiator(templateInstantiator),
+          binding(binding),
+          instanceNode(instanceNode)
+    {
+    }
+    virtual void visitNodeKind(NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const Node *value) override
+    {
+        if(!value || (value != instanceNode && getTemplateParameters(value)))
+            return;
+        if(auto *scopedId = dynamic_cast<const ScopedId *>(value))
+            templateInstantiator.instantiate(scopedId, binding);
+        value->visitFields(*this);
+    }
+    virtual void visitSymbolTable(const SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const SymbolLookupChain &) override
+    {
+    }
+};
+
+bool TemplateInstantiator::dependsOnTemplateParameters(const Node *node)
+{
+    // a node that depends on itself is an error that the constant evaluator reports, so it's
+    // treated as independent while it's being visited
+    auto emplaceResult = dependentNodes.emplace(node, false);
+    if(!std::get<1>(emplaceResult))
+        return std::get<1>(*std::get<0>(emplaceResult));
+    DependencyVisitor visitor(*this);
+    visitor.visitNode(node);
+    dependentNodes[node] = visitor.isDependent;
+    return visitor.isDependent;
+}
+
+void TemplateInstantiator::canonicalizeType(const Type *&type, const TemplateBinding *&typeBinding)
+{
+    // follow aliases to the type they name; named types are interned by the symbol they resolve
+    // to, so every spelling of a type ends up at the same representative
+    std::unordered_set<const TypeStatement *> visitedAliases;
+    while(auto *scopedIdType = dynamic_cast<const ScopedIdType *>(type))
+    {
+        auto *symbol = nameResolver.resolve(scopedIdType->value);
+        if(auto *typeStatement = dynamic_cast<const TypeStatement *>(symbol))
+        {
+            if(!std::get<1>(visitedAliases.insert(typeStatement)))
+                throw parse::ParseError(scopedIdType->locationRange, "type is an alias of itself");
+            type = typeStatement->type;
+            continue;
+        }
+        auto *parameter = dynamic_cast<const TypeTemplateParameter *>(symbol);
+        auto *argument = parameter && typeBinding ? typeBinding->find(parameter) : nullptr;
+        if(argument)
+        {
+            // bound arguments are already canonical
+            type = argument->type;
+            typeBinding = argument->typeBinding;
+            return;
+        }
+        break;
+    }
+    if(auto *canonicalNode = structuralInterner.intern(type))
+        type = static_cast<const Type *>(canonicalNode->representative);
+    if(typeBinding && !dependsOnTemplateParameters(type))
+        typeBinding = nullptr;
+}
+
+bool TemplateInstantiator::bindArguments(const SymbolScope *templateScope,
+                                         const TemplateParameters *templateParameters,
+                                         const TemplateArguments *templateArguments,
+                                         const TemplateBinding *binding,
+                                         const TemplateBinding *&result)
+{
+    std::size_t parameterCount = getParameterCount(templateParameters);
+    std::size_t argumentCount = getArgumentCount(templateArguments);
+    std::vector<TemplateBinding::Argument> boundArguments;
+    boundArguments.reserve(parameterCount);
+    if(binding)
+    {
+        for(auto &argument : binding->arguments)
+            if(isEnclosingParameter(templateScope, argument.parameter))
+                boundArguments.push_back(argument);
+    }
+    for(std::size_t i = 0; i < parameterCount; i++)
+    {
+        auto *parameter = getParameter(templateParameters, i);
+        if(parameter->hasDotDotDot)
+            return false;
+        if(i >= argumentCount)
+            throw parse::ParseError(templateArguments->locationRange,
+                                    "not enough template arguments");
+        auto *argument = getArgument(templateArguments, i);
+        if(auto *typeParameter = dynamic_cast<const TypeTemplateParameter *>(parameter))
+        {
+            auto *typeArgument = dynamic_cast<const TypeTemplateArgument *>(argument);
+            if(!typeArgument)
+                throw parse::ParseError(argument->locationRange,
+                                        "expected a type template argument");
+            const Type *type = typeArgument->type;
+            const TemplateBinding *typeBinding = binding;
+            canonicalizeType(type, typeBinding);
+            boundArguments.push_back({typeParameter, type, typeBinding, {}});
+            continue;
+        }
+        auto *valueParameter = dynamic_cast<const ValueTemplateParameter *>(parameter);
+        assert(valueParameter);
+        auto *valueArgument = dynamic_cast<const ValueTemplateArgument *>(argument);
+        if(!valueArgument)
+            throw parse::ParseError(argument->locationRange, "expected a value template argument");
+        auto *value = constantEvaluator.evaluate(valueArgument->value, binding);
+        if(!value)
+            throw parse::ParseError(argument->locationRange, "template argument isn't constant");
+        // the parameter's type can depend on the parameters before it
+        auto *valueTypeBinding = dependsOnTemplateParameters(valueParameter->valueType) ?
+                                     constantEvaluator.bind(boundArguments) :
+                                     nullptr;
+        ConstantEvaluator::IntegerTypeInfo valueType;
+        if(!constantEvaluator.getIntegerType(
+               valueParameter->valueType, valueTypeBinding, valueType))
+            throw parse::ParseError(valueParameter->valueType->locationRange,
+                                    "template parameter's type isn't an integer type with a "
+                                    "constant width");
+        auto castValue = math::BitVector::cast(valueType.kind, valueType.bitCount, *value);
+        if(castValue.getValue() != value->getValue())
+            throw parse::ParseError(argument->locationRange,
+                                    "template argument doesn't fit in the parameter's type");
+        boundArguments.push_back({valueParameter, nullptr, nullptr, std::move(castValue)});
+    }
+    if(argumentCount > parameterCount)
+        throw parse::ParseError(getArgument(templateArguments, parameterCount)->locationRange,
+                                "too many template arguments");
+    result = constantEvaluator.bind(std::move(boundArguments));
+    return true;
+}
+
+void TemplateInstantiator::elaborate(const TemplateInstance *instance)
+{
+    auto *node = dynamic_cast<const Node *>(instance->templateSymbol);
+    constantEvaluator.evaluateAll(node, instance->binding);
+    Visitor(*this, instance->binding, node).visitNode(node);
+}
+
+const TemplateInstance *TemplateInstantiator::instantiate(const ScopedId *scopedId,
+                                                          const TemplateBinding *binding)
+{
+    if(!scopedId->templateArguments)
+        return nullptr;
+    auto *symbol = nameResolver.resolve(scopedId);
+    if(!symbol)
+        return nullptr;
+    auto *templateParameters = getTemplateParameters(dynamic_cast<const Node *>(symbol));
+    if(!templateParameters)
+        throw parse::ParseError(scopedId->nameLocationRange, "not a template");
+    const TemplateBinding *instanceBinding;
+    if(!bindArguments(dynamic_cast<const SymbolScope *>(symbol),
+                      templateParameters,
+                      scopedId->templateArguments,
+                      binding,
+                      instanceBinding))
+        return nullptr;
+    auto emplaceResult = templateStatisticsIndexes.emplace(symbol, templateStatistics.size());
+    if(std::get<1>(emplaceResult))
+        templateStatistics.push_back(TemplateStatistics{symbol, 0, 0});
+    auto &statistics = templateStatistics[std::get<1>(*std::get<0>(emplaceResult))];
+    CacheKey key{symbol, instanceBinding};
+    auto iter = cache.find(key);
+    if(iter != cache.end())
+    {
+        statistics.hitCount++;
+        return std::get<1>(*iter);
+    }
+    statistics.missCount++;
+    if(instantiationDepth >= maxInstantiationDepth)
+        throw parse::ParseError(scopedId->locationRange,
+                                "templates are instantiated too deeply, they might be recursive");
+    instances.push_back(TemplateInstance{symbol, instanceBinding});
+    auto *instance = &instances.back();
+    // added before elaborating, so an instance that uses itself finds itself
+    cache.emplace(key, instance);
+    instantiationDepth++;
+    try
+    {
+        elaborate(instance);
+    }
+    catch(...)
+    {
+        instantiationDepth--;
+        throw;
+    }
+    instantiationDepth--;
+    return instance;
+}
+
+void TemplateInstantiator::instantiateAll(const Node *root)
+{
+    Visitor(*this, nullptr, nullptr).visitNode(root);
+}
+
+void TemplateInstantiator::writeReport(std::ostream &os) const
+{
+    os << "template instances:\n";
+    os << std::left << std::setw(36) << "template" << std::right << std::setw(10) << "instances"
+       << std::setw(10) << "hits" << "  location\n";
+    for(auto &statistics : templateStatistics)
+        os << std::left << std::setw(36)
+           << static_cast<std::string>(*statistics.templateSymbol->name) << std::right
+           << std::setw(10) << statistics.missCount << std::setw(10) << statistics.hitCount << "  "
+           << statistics.templateSymbol->symbolLocationRange << "\n";
+}
+
+std::size_t TemplateInstantiator::getHeapBytes() const noexcept
+{
+    return instances.size() * sizeof(TemplateInstance) + util::getHashTableHeapBytes(cache)
+           + util::getHeapBytes(templateStatistics)
+           + util::getHashTableHeapBytes(templateStatisticsIndexes)
+           + util::getHashTableHeapBytes(dependentNodes);
+}
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "constant_evaluator.h"
+#include "name_resolver.h"
+#include "node.h"
+#include "scoped_id.h"
+#include "structural_interner.h"
+#include "symbol.h"
+#include "symbol_scope.h"
+#include "template_parameters.h"
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+namespace ast
+{
+/** one specialization of a module, interface, or function template */
+struct TemplateInstance final
+{
+    const Symbol *templateSymbol;
+    /** interned by ConstantEvaluator::bind */
+    const TemplateBinding *binding;
+};
+
+/** instantiates the templates named by ScopedIds with template arguments. The arguments are
+ * canonicalized before lookup: types are resolved through aliases and replaced by their
+ * StructuralInterner representative (or by the type a template parameter is bound to), and
+ * values are evaluated and checked to fit the parameter's type. So every use of a template with
+ * the same arguments shares one instance, and each instance is only elaborated once, which
+ * evaluates its constants and instantiates the templates it uses. Errors are thrown as
+ * parse::ParseError. */
+class TemplateInstantiator final
+{
+public:
+    /** the instances deeper than this are assumed to be infinite recursion */
+    static constexpr std::size_t maxInstantiationDepth = 1024;
+    struct TemplateStatistics final
+    {
+        const Symbol *templateSymbol;
+        /** the uses whose instance already existed */
+        std::size_t hitCount;
+        /** the uses that created an instance */
+        std::size_t missCount;
+    };
+
+private:
+    class DependencyVisitor;
+    class Visitor;
+    struct CacheKey final
+    {
+        const Symbol *templateSymbol;
+        const TemplateBinding *binding;
+        friend bool operator==(const CacheKey &a, const CacheKey &b) noexcept
+        {
+            return a.templateSymbol == b.templateSymbol && a.binding == b.binding;
+        }
+    };
+    struct CacheKeyHasher final
+    {
+        std::size_t operator()(const CacheKey &value) const noexcept
+        {
+            return std::hash<const void *>()(value.templateSymbol) * 0x100000001B3ULL
+                   ^ std::hash<const void *>()(value.binding);
+        }
+    };
+
+private:
+    ConstantEvaluator &constantEvaluator;
+    NameResolver &nameResolver;
+    StructuralInterner &structuralInterner;
+    std::deque<TemplateInstance> instances;
+    std::unordered_map<CacheKey, const TemplateInstance *, CacheKeyHasher> cache;
+    /** in the order the templates were first used */
+    std::vector<TemplateStatistics> templateStatistics;
+    std::unordered_map<const Symbol *, std::size_t> templateStatisticsIndexes;
+    /** whether a node references a template parameter, directly or through a constant or type
+     * alias */
+    std::unordered_map<const Node *, bool> dependentNodes;
+    std::size_t instantiationDepth = 0;
+
+private:
+    bool dependsOnTemplateParameters(const Node *node);
+    /** replaces type with the canonical type for it, and sets typeBinding to nullptr if the type
+     * doesn't depend on it */
+    void canonicalizeType(const Type *&type, const TemplateBinding *&typeBinding);
+    /** returns false if a parameter is a parameter pack, which can't be bound yet. The result
+     * also binds the parameters of the templates enclosing templateScope that binding binds, since
+     * the template's body can use them */
+    bool bindArguments(const SymbolScope *templateScope,
+                       const TemplateParameters *templateParameters,
+                       const TemplateArguments *templateArguments,
+                       const TemplateBinding *binding,
+                       const TemplateBinding *&result);
+    void elaborate(const TemplateInstance *instance);
+
+public:
+    explicit TemplateInstantiator(ConstantEvaluator &constantEvaluator,
+                                  StructuralInterner &structuralInterner) noexcept
+        : constantEvaluator(constantEvaluator),
+          nameResolver(constantEvaluator.getNameResolver()),
+          structuralInterner(structuralInterner)
+    {
+    }
+    TemplateInstantiator(const TemplateInstantiator &) = delete;
+    TemplateInstantiator &operator=(const TemplateInstantiator &) = delete;
+    /** returns the instance scopedId names, with its template arguments evaluated with binding.
+     * Returns nullptr if scopedId doesn't have template arguments, doesn't resolve, or names a
+     * template with a parameter pack. */
+    const TemplateInstance *instantiate(const ScopedId *scopedId,
+                                        const TemplateBinding *binding = nullptr);
+    /** instantiates every template used outside of a template that's reachable from root, along
+     * with the templates used by those instances */
+    void instantiateAll(const Node *root);
+    std::size_t getInstanceCount() const noexcept
+    {
+        return instances.size();
+    }
+    const std::vector<TemplateStatistics> &getTemplateStatistics() const noexcept
+    {
+        return templateStatistics;
+    }
+    /** writes the instance and hit counts of every template that was used */
+    void writeReport(std::ostream &os) const;
+    /** the bytes allocated for the instances and the lookup tables */
+    std::size_t getHeapBytes() const noexcept;
+};
+}
@@ -30,4 +30,13 @@ void TemplateParameter::dump(util::DumpTree *dumpNode, util::DumpState &state) c
     state.setSimple(dumpNode, "beforeDotDotDotComments", beforeDotDotDotComments);
     state.setSimple(dumpNode, "hasDotDotDot", hasDotDotDot);
 }
+
+void TemplateParameter::visitFields(NodeFieldVisitor &visitor) const
+{
+    Node::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeDotDotDotComments);
+    visitor.visitBool(hasDotDotDot);
+}
 }
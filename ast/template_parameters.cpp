@@ -18,6 +18,7 @@
  */
 
 #include "template_parameters.h"
+#include "snapshot.h"
 #include <sstream>
 
 namespace ast
@@ -39,4 +40,44 @@ void TemplateParameters::dump(util::DumpTree *dumpNode, util::DumpState &state)
     }
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void TemplateParameters::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TemplateParameters);
+    Node::visitFields(visitor);
+    visitor.visitComments(beforeEMarkComments);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitNode(firstTemplateParameter);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitComments(part.beforeCommaComments);
+        visitor.visitNode(part.templateParameter);
+    }
+    visitor.visitComments(beforeRBraceComments);
+}
+
+TemplateParameters *TemplateParameters::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeEMarkComments = reader.readComments();
+    auto beforeLBraceComments = reader.readComments();
+    auto *firstTemplateParameter = reader.readNode<TemplateParameter>();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto beforeCommaComments = reader.readComments();
+        auto *templateParameter = reader.readNode<TemplateParameter>();
+        parts.push_back(Part(beforeCommaComments, templateParameter));
+    }
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<TemplateParameters>(locationRange,
+                                             beforeEMarkComments,
+                                             beforeLBraceComments,
+                                             firstTemplateParameter,
+                                             std::move(parts),
+                                             beforeRBraceComments);
+}
 }
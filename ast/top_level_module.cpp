@@ -18,6 +18,7 @@
  */
 
 #include "top_level_module.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -30,4 +31,36 @@ void TopLevelModule::dump(util::DumpTree *dumpNode, util::DumpState &state) cons
     state.setPointer(dumpNode, "mainModule", mainModule);
     state.setSimple(dumpNode, "beforeEndOfFileComments", beforeEndOfFileComments);
 }
+
+void TopLevelModule::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TopLevelModule);
+    Node::visitFields(visitor);
+    SymbolScope::visitFields(visitor);
+    visitor.visitArraySize(imports);
+    for(auto *import : imports)
+        visitor.visitNode(import);
+    visitor.visitNode(mainModule);
+    visitor.visitComments(beforeEndOfFileComments);
+}
+
+TopLevelModule *TopLevelModule::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLookupChain = reader.readSymbolLookupChain();
+    auto *symbolTable = reader.readSymbolTable();
+    auto importCount = reader.readArraySize();
+    std::vector<Import *> imports;
+    imports.reserve(importCount);
+    for(std::size_t i = 0; i < importCount; i++)
+        imports.push_back(reader.readNode<Import>());
+    auto *mainModule = reader.readNode<Module>();
+    auto beforeEndOfFileComments = reader.readComments();
+    return reader.create<TopLevelModule>(locationRange,
+                                         symbolLookupChain,
+                                         symbolTable,
+                                         std::move(imports),
+                                         mainModule,
+                                         beforeEndOfFileComments);
+}
 }
@@ -49,5 +49,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static TopLevelModule *deserialize(SnapshotReader &reader);
 };
 }
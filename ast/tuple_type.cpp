@@ -18,6 +18,7 @@
  */
 
 #include "tuple_type.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -37,4 +38,41 @@ void TupleType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setSimple(dumpNode, "hasTrailingComma", hasTrailingComma);
     state.setSimple(dumpNode, "beforeRBraceComments", beforeRBraceComments);
 }
+
+void TupleType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TupleType);
+    Type::visitFields(visitor);
+    visitor.visitComments(beforeLBraceComments);
+    visitor.visitArraySize(parts);
+    for(auto &part : parts)
+    {
+        visitor.visitNode(part.part);
+        visitor.visitComments(part.beforeCommaComments);
+    }
+    visitor.visitBool(hasTrailingComma);
+    visitor.visitComments(beforeRBraceComments);
+}
+
+TupleType *TupleType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeLBraceComments = reader.readComments();
+    auto partCount = reader.readArraySize();
+    std::vector<Part> parts;
+    parts.reserve(partCount);
+    for(std::size_t i = 0; i < partCount; i++)
+    {
+        auto *part = reader.readNode<Type>();
+        auto beforeCommaComments = reader.readComments();
+        parts.push_back(Part(part, beforeCommaComments));
+    }
+    auto hasTrailingComma = reader.readBool();
+    auto beforeRBraceComments = reader.readComments();
+    return reader.create<TupleType>(locationRange,
+                                    beforeLBraceComments,
+                                    std::move(parts),
+                                    hasTrailingComma,
+                                    beforeRBraceComments);
+}
 }
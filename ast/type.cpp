@@ -26,4 +26,9 @@ void Type::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     Node::dump(dumpNode, state);
     dumpNode->nodeName = "ast::Type";
 }
+
+void Type::visitFields(NodeFieldVisitor &visitor) const
+{
+    Node::visitFields(visitor);
+}
 }
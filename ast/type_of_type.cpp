@@ -18,6 +18,7 @@
  */
 
 #include "type_of_type.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -30,4 +31,28 @@ void TypeOfType::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointer(dumpNode, "expression", expression);
     state.setSimple(dumpNode, "beforeRParenComments", beforeRParenComments);
 }
+
+void TypeOfType::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TypeOfType);
+    Type::visitFields(visitor);
+    visitor.visitComments(beforeTypeOfComments);
+    visitor.visitComments(beforeLParenComments);
+    visitor.visitNode(expression);
+    visitor.visitComments(beforeRParenComments);
+}
+
+TypeOfType *TypeOfType::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeTypeOfComments = reader.readComments();
+    auto beforeLParenComments = reader.readComments();
+    auto *expression = reader.readNode<Expression>();
+    auto beforeRParenComments = reader.readComments();
+    return reader.create<TypeOfType>(locationRange,
+                                     beforeTypeOfComments,
+                                     beforeLParenComments,
+                                     expression,
+                                     beforeRParenComments);
+}
 }
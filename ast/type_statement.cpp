@@ -18,6 +18,7 @@
  */
 
 #include "type_statement.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -32,4 +33,36 @@ void TypeStatement::dump(util::DumpTree *dumpNode, util::DumpState &state) const
     state.setPointer(dumpNode, "type", type);
     state.setSimple(dumpNode, "beforeSemicolonComments", beforeSemicolonComments);
 }
+
+void TypeStatement::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TypeStatement);
+    Statement::visitFields(visitor);
+    Symbol::visitFields(visitor);
+    visitor.visitComments(beforeTypeComments);
+    visitor.visitComments(beforeNameComments);
+    visitor.visitComments(beforeEqualComments);
+    visitor.visitNode(type);
+    visitor.visitComments(beforeSemicolonComments);
+}
+
+TypeStatement *TypeStatement::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto nameLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeTypeComments = reader.readComments();
+    auto beforeNameComments = reader.readComments();
+    auto beforeEqualComments = reader.readComments();
+    auto *type = reader.readNode<Type>();
+    auto beforeSemicolonComments = reader.readComments();
+    return reader.create<TypeStatement>(locationRange,
+                                        beforeTypeComments,
+                                        beforeNameComments,
+                                        nameLocationRange,
+                                        name,
+                                        beforeEqualComments,
+                                        type,
+                                        beforeSemicolonComments);
+}
 }
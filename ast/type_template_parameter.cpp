@@ -18,6 +18,7 @@
  */
 
 #include "type_template_parameter.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -29,4 +30,35 @@ void TypeTemplateParameter::dump(util::DumpTree *dumpNode, util::DumpState &stat
     state.setSimple(dumpNode, "beforeImplementsComments", beforeImplementsComments);
     state.setPointer(dumpNode, "parentType", parentType);
 }
+
+void TypeTemplateParameter::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::TypeTemplateParameter);
+    TemplateParameter::visitFields(visitor);
+    visitor.visitComments(beforeTypeComments);
+    visitor.visitComments(beforeImplementsComments);
+    visitor.visitNode(parentType);
+}
+
+TypeTemplateParameter *TypeTemplateParameter::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    auto beforeDotDotDotComments = reader.readComments();
+    auto hasDotDotDot = reader.readBool();
+    auto beforeTypeComments = reader.readComments();
+    auto beforeImplementsComments = reader.readComments();
+    auto *parentType = reader.readNode<Type>();
+    return reader.create<TypeTemplateParameter>(locationRange,
+                                                beforeTypeComments,
+                                                beforeNameComments,
+                                                symbolLocationRange,
+                                                name,
+                                                beforeImplementsComments,
+                                                parentType,
+                                                beforeDotDotDotComments,
+                                                hasDotDotDot);
+}
 }
@@ -18,9 +18,22 @@
  */
 
 #include "unary_expression.h"
+#include "snapshot.h"
 
 namespace ast
 {
+namespace
+{
+template <typename T>
+T *deserializeUnaryExpression(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto beforeOperatorComments = reader.readComments();
+    auto *argument = reader.readNode<Expression>();
+    return reader.create<T>(locationRange, beforeOperatorComments, argument);
+}
+}
+
 void UnaryExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     Expression::dump(dumpNode, state);
@@ -29,45 +42,129 @@ void UnaryExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) con
     state.setPointer(dumpNode, "argument", argument);
 }
 
+void UnaryExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    Expression::visitFields(visitor);
+    visitor.visitComments(beforeOperatorComments);
+    visitor.visitNode(argument);
+}
+
 void LogicalNotExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::LogicalNotExpression";
 }
 
+void LogicalNotExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::LogicalNotExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+LogicalNotExpression *LogicalNotExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<LogicalNotExpression>(reader);
+}
+
 void BitwiseNotExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::BitwiseNotExpression";
 }
 
+void BitwiseNotExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::BitwiseNotExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+BitwiseNotExpression *BitwiseNotExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<BitwiseNotExpression>(reader);
+}
+
 void UnaryPlusExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::UnaryPlusExpression";
 }
 
+void UnaryPlusExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::UnaryPlusExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+UnaryPlusExpression *UnaryPlusExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<UnaryPlusExpression>(reader);
+}
+
 void UnaryMinusExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::UnaryMinusExpression";
 }
 
+void UnaryMinusExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::UnaryMinusExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+UnaryMinusExpression *UnaryMinusExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<UnaryMinusExpression>(reader);
+}
+
 void AndReduceExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::AndReduceExpression";
 }
 
+void AndReduceExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::AndReduceExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+AndReduceExpression *AndReduceExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<AndReduceExpression>(reader);
+}
+
 void OrReduceExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::OrReduceExpression";
 }
 
+void OrReduceExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::OrReduceExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+OrReduceExpression *OrReduceExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<OrReduceExpression>(reader);
+}
+
 void XorReduceExpression::dump(util::DumpTree *dumpNode, util::DumpState &state) const
 {
     UnaryExpression::dump(dumpNode, state);
     dumpNode->nodeName = "ast::XorReduceExpression";
 }
+
+void XorReduceExpression::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::XorReduceExpression);
+    UnaryExpression::visitFields(visitor);
+}
+
+XorReduceExpression *XorReduceExpression::deserialize(SnapshotReader &reader)
+{
+    return deserializeUnaryExpression<XorReduceExpression>(reader);
+}
 }
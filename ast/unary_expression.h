@@ -40,6 +40,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override = 0;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override = 0;
 };
 
 class LogicalNotExpression final : public UnaryExpression
@@ -52,6 +53,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static LogicalNotExpression *deserialize(SnapshotReader &reader);
 };
 
 class BitwiseNotExpression final : public UnaryExpression
@@ -64,6 +67,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static BitwiseNotExpression *deserialize(SnapshotReader &reader);
 };
 
 class UnaryPlusExpression final : public UnaryExpression
@@ -76,6 +81,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static UnaryPlusExpression *deserialize(SnapshotReader &reader);
 };
 
 class UnaryMinusExpression final : public UnaryExpression
@@ -88,6 +95,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static UnaryMinusExpression *deserialize(SnapshotReader &reader);
 };
 
 class AndReduceExpression final : public UnaryExpression
@@ -100,6 +109,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static AndReduceExpression *deserialize(SnapshotReader &reader);
 };
 
 class OrReduceExpression final : public UnaryExpression
@@ -112,6 +123,8 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static OrReduceExpression *deserialize(SnapshotReader &reader);
 };
 
 class XorReduceExpression final : public UnaryExpression
@@ -124,5 +137,7 @@ public:
     {
     }
     virtual void dump(util::DumpTree *dumpNode, util::DumpState &state) const override;
+    virtual void visitFields(NodeFieldVisitor &visitor) const override;
+    static XorReduceExpression *deserialize(SnapshotReader &reader);
 };
 }
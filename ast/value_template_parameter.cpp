@@ -18,6 +18,7 @@
  */
 
 #include "value_template_parameter.h"
+#include "snapshot.h"
 
 namespace ast
 {
@@ -28,4 +29,32 @@ void ValueTemplateParameter::dump(util::DumpTree *dumpNode, util::DumpState &sta
     state.setSimple(dumpNode, "beforeColonComments", beforeColonComments);
     state.setPointer(dumpNode, "valueType", valueType);
 }
+
+void ValueTemplateParameter::visitFields(NodeFieldVisitor &visitor) const
+{
+    visitor.visitNodeKind(NodeKind::ValueTemplateParameter);
+    TemplateParameter::visitFields(visitor);
+    visitor.visitComments(beforeColonComments);
+    visitor.visitNode(valueType);
+}
+
+ValueTemplateParameter *ValueTemplateParameter::deserialize(SnapshotReader &reader)
+{
+    auto locationRange = reader.readLocationRange();
+    auto symbolLocationRange = reader.readLocationRange();
+    auto name = reader.readName();
+    auto beforeNameComments = reader.readComments();
+    auto beforeDotDotDotComments = reader.readComments();
+    auto hasDotDotDot = reader.readBool();
+    auto beforeColonComments = reader.readComments();
+    auto *valueType = reader.readNode<Type>();
+    return reader.create<ValueTemplateParameter>(locationRange,
+                                                 beforeNameComments,
+                                                 symbolLocationRange,
+                                                 name,
+                                                 beforeColonComments,
+                                                 valueType,
+                                                 beforeDotDotDotComments,
+                                                 hasDotDotDot);
+}
 }
@@ -0,0 +1,366 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../math/bit_vector.h"
+#include "../math/gmp_integer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// measures the time and heap allocations per operation of every math::BitVector and
+// math::GMPInteger operation. usage: bit_vector_benchmark [<operation name substring>]
+// configure with -DCMAKE_BUILD_TYPE=Release for meaningful times.
+
+namespace
+{
+std::size_t allocationCount = 0;
+
+void *allocateCounted(std::size_t size)
+{
+    allocationCount++;
+    if(auto *retval = std::malloc(size ? size : 1))
+        return retval;
+    throw std::bad_alloc();
+}
+
+void *gmpAllocate(std::size_t size)
+{
+    return allocateCounted(size);
+}
+
+void *gmpReallocate(void *pointer, std::size_t, std::size_t newSize)
+{
+    allocationCount++;
+    if(auto *retval = std::realloc(pointer, newSize))
+        return retval;
+    throw std::bad_alloc();
+}
+
+void gmpFree(void *pointer, std::size_t)
+{
+    std::free(pointer);
+}
+
+typedef math::BitVector::Kind Kind;
+constexpr std::size_t operandCount = 16;
+constexpr std::chrono::milliseconds minimumTime(10);
+/** keeps the results from being optimized away */
+volatile std::uint64_t resultSink;
+
+/** the operands for one width and kind */
+struct Operands final
+{
+    Kind kind;
+    std::size_t bitCount;
+    std::vector<math::BitVector> values;
+    std::vector<math::BitVector> divisors;
+    std::vector<math::BitVector> shiftCounts;
+    std::vector<math::GMPInteger> integers;
+    std::vector<math::GMPInteger> integerDivisors;
+    std::vector<std::size_t> sizeShiftCounts;
+    Operands(Kind kind, std::size_t bitCount, std::mt19937_64 &randomEngine)
+        : kind(kind), bitCount(bitCount)
+    {
+        for(std::size_t i = 0; i < operandCount; i++)
+        {
+            math::GMPInteger value;
+            for(std::size_t j = 0; j < bitCount; j += 32)
+            {
+                auto word = static_cast<unsigned long>(randomEngine() & 0xFFFFFFFFUL);
+                value = (value << 32) + math::GMPInteger(word);
+            }
+            values.emplace_back(kind, bitCount, value);
+            integers.push_back(values.back().getValue());
+            divisors.emplace_back(kind, bitCount, value >> (bitCount / 2));
+            if(divisors.back().isZero())
+                divisors.back() = math::BitVector(kind, bitCount, math::GMPInteger(1L));
+            integerDivisors.push_back(divisors.back().getValue());
+            sizeShiftCounts.push_back(randomEngine() % (bitCount + 1));
+            shiftCounts.emplace_back(
+                Kind::Unsigned,
+                64,
+                math::GMPInteger(static_cast<unsigned long>(sizeShiftCounts.back())));
+        }
+    }
+};
+
+struct Operation final
+{
+    const char *name;
+    std::function<std::uint64_t(const Operands &operands, std::size_t index)> run;
+};
+
+std::uint64_t getResult(const math::BitVector &value) noexcept
+{
+    return value.getWords()[0];
+}
+
+std::uint64_t getResult(const math::GMPInteger &value) noexcept
+{
+    return value.getLowBits(64);
+}
+
+std::vector<Operation> getOperations()
+{
+    typedef math::BitVector BitVector;
+    typedef math::GMPInteger GMPInteger;
+    std::vector<Operation> retval;
+#define BIT_VECTOR_BINARY_OPERATION(name)                                                     \
+    retval.push_back(Operation{"BitVector::" #name,                                           \
+                               [](const Operands &o, std::size_t i)                          \
+                               {                                                             \
+                                   return getResult(BitVector::name(                         \
+                                       o.kind, o.bitCount, o.values[i], o.values[i ^ 1])); \
+                               }});
+    BIT_VECTOR_BINARY_OPERATION(add)
+    BIT_VECTOR_BINARY_OPERATION(subtract)
+    BIT_VECTOR_BINARY_OPERATION(multiply)
+    BIT_VECTOR_BINARY_OPERATION(bitwiseAnd)
+    BIT_VECTOR_BINARY_OPERATION(bitwiseOr)
+    BIT_VECTOR_BINARY_OPERATION(bitwiseXor)
+#undef BIT_VECTOR_BINARY_OPERATION
+    retval.push_back(Operation{"BitVector::divide",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::divide(
+                                       o.kind, o.bitCount, o.values[i], o.divisors[i ^ 1]));
+                               }});
+    retval.push_back(Operation{"BitVector::remainder",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::remainder(
+                                       o.kind, o.bitCount, o.values[i], o.divisors[i ^ 1]));
+                               }});
+    retval.push_back(Operation{"BitVector::shiftLeft",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::shiftLeft(
+                                       o.kind, o.bitCount, o.values[i], o.shiftCounts[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::shiftRight",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::shiftRight(
+                                       o.kind, o.bitCount, o.values[i], o.shiftCounts[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::negate",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(
+                                       BitVector::negate(o.kind, o.bitCount, o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::bitwiseNot",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(
+                                       BitVector::bitwiseNot(o.kind, o.bitCount, o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::popCount",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(
+                                       BitVector::popCount(o.kind, o.bitCount, o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::reduceAnd",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::reduceAnd(o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::reduceOr",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::reduceOr(o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::reduceXor",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::reduceXor(o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::compare",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return static_cast<std::uint64_t>(
+                                       BitVector::compare(o.values[i], o.values[i ^ 1]));
+                               }});
+    retval.push_back(Operation{"BitVector::compareUnsigned",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return static_cast<std::uint64_t>(
+                                       BitVector::compareUnsigned(o.values[i], o.values[i ^ 1]));
+                               }});
+    retval.push_back(Operation{"BitVector::concatenate",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(
+                                       BitVector::concatenate(o.values[i], o.values[i ^ 1]));
+                               }});
+    retval.push_back(Operation{"BitVector::slice",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector::slice(o.kind,
+                                                                     o.bitCount / 2 + 1,
+                                                                     o.values[i],
+                                                                     o.sizeShiftCounts[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::cast",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(
+                                       BitVector::cast(o.kind, o.bitCount * 2, o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::copy",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector(o.values[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::fromGMPInteger",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(BitVector(o.kind, o.bitCount, o.integers[i]));
+                               }});
+    retval.push_back(Operation{"BitVector::getValue",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(o.values[i].getValue());
+                               }});
+    retval.push_back(Operation{"GMPInteger::add",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(o.integers[i] + o.integers[i ^ 1]);
+                               }});
+    retval.push_back(Operation{"GMPInteger::subtract",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(o.integers[i] - o.integers[i ^ 1]);
+                               }});
+    retval.push_back(Operation{"GMPInteger::multiply",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(o.integers[i] * o.integers[i ^ 1]);
+                               }});
+    retval.push_back(Operation{"GMPInteger::shiftLeft",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(o.integers[i] << o.sizeShiftCounts[i]);
+                               }});
+    retval.push_back(Operation{"GMPInteger::shiftRight",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(o.integers[i] >> o.sizeShiftCounts[i]);
+                               }});
+    retval.push_back(Operation{"GMPInteger::compare",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return static_cast<std::uint64_t>(
+                                       GMPInteger::compare(o.integers[i], o.integers[i ^ 1]));
+                               }});
+    retval.push_back(Operation{"GMPInteger::truncate",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   auto value = o.integers[i] * o.integerDivisors[i ^ 1];
+                                   if(o.kind == Kind::Signed)
+                                       value.truncateSigned(o.bitCount);
+                                   else
+                                       value.truncateUnsigned(o.bitCount);
+                                   return getResult(value);
+                               }});
+    retval.push_back(Operation{"GMPInteger::copy",
+                               [](const Operands &o, std::size_t i)
+                               {
+                                   return getResult(GMPInteger(o.integers[i]));
+                               }});
+    return retval;
+}
+
+struct Measurement final
+{
+    double nanosecondsPerOperation;
+    double allocationsPerOperation;
+};
+
+Measurement measure(const Operation &operation, const Operands &operands)
+{
+    typedef std::chrono::steady_clock Clock;
+    for(std::size_t iterationCount = 1;; iterationCount *= 2)
+    {
+        std::uint64_t result = 0;
+        auto startAllocationCount = allocationCount;
+        auto startTime = Clock::now();
+        for(std::size_t i = 0; i < iterationCount; i++)
+            result ^= operation.run(operands, i % operandCount);
+        auto elapsed = Clock::now() - startTime;
+        resultSink = result;
+        if(elapsed >= minimumTime)
+            return Measurement{
+                std::chrono::duration<double, std::nano>(elapsed).count() / iterationCount,
+                static_cast<double>(allocationCount - startAllocationCount) / iterationCount};
+    }
+}
+}
+
+void *operator new(std::size_t size)
+{
+    return allocateCounted(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+int main(int argc, char **argv)
+{
+    if(argc > 2 || (argc == 2 && argv[1][0] == '-'))
+    {
+        std::cerr << "usage: " << argv[0] << " [<operation name substring>]" << std::endl;
+        return 1;
+    }
+    const char *filter = argc == 2 ? argv[1] : "";
+    mp_set_memory_functions(gmpAllocate, gmpReallocate, gmpFree);
+    std::mt19937_64 randomEngine(0);
+    auto operations = getOperations();
+    std::printf("%-28s %-8s %6s %14s %10s\n", "operation", "kind", "bits", "ns/op", "allocs/op");
+    for(std::size_t bitCount : {1, 8, 64, 65, 128, 512, 4096, 65536})
+    {
+        for(auto kind : {Kind::Unsigned, Kind::Signed})
+        {
+            Operands operands(kind, bitCount, randomEngine);
+            for(auto &operation : operations)
+            {
+                if(!std::strstr(operation.name, filter))
+                    continue;
+                auto measurement = measure(operation, operands);
+                std::printf("%-28s %-8s %6zu %14.1f %10.2f\n",
+                            operation.name,
+                            kind == Kind::Signed ? "signed" : "unsigned",
+                            bitCount,
+                            measurement.nanosecondsPerOperation,
+                            measurement.allocationsPerOperation);
+                std::fflush(stdout);
+            }
+        }
+    }
+}
@@ -2,47 +2,171 @@
 #include <fstream>
 #include "parse/parse_error.h"
 #include "parse/parser.h"
+#include "parse/import_loader.h"
 #include "parse/source.h"
 #include "ast/context.h"
+#include "ast/bytecode_compiler.h"
+#include "ast/bytecode_interpreter.h"
+#include "ast/constant_evaluator.h"
+#include "ast/memory_report.h"
+#include "ast/name_resolver.h"
+#include "ast/structural_interner.h"
+#include "ast/template_instantiator.h"
 #include "util/dump_tree.h"
 #include <string>
+#include <vector>
 
 void help(const char *arg0)
 {
-    std::cerr << "usage: " << arg0 << " <filename.hdl>" << std::endl;
+    std::cerr << "usage: " << arg0
+              << " [--snapshot] [--mem-report] [-I <directory>]... <filename.hdl>" << std::endl;
+    std::cerr << "  --snapshot  load <filename.hdl>.snapshot if it's up to date," << std::endl;
+    std::cerr << "              otherwise parse and write it" << std::endl;
+    std::cerr << "  -I <directory>  search <directory> for imports before the directory of"
+              << std::endl;
+    std::cerr << "                  <filename.hdl>" << std::endl;
+    std::cerr << "  --mem-report    write the memory used by each kind of node and the peak"
+              << std::endl;
+    std::cerr << "                  resident set size after each phase, along with the instance"
+              << std::endl;
+    std::cerr << "                  and hit counts of each template, to stdout" << std::endl;
 }
 
 int main(int argc, char **argv)
 {
     try
     {
-        if(argc != 2)
+        bool useSnapshot = false;
+        bool writeMemoryReport = false;
+        std::vector<std::string> importSearchPath;
+        bool haveFileName = false;
+        std::string fileName;
+        for(int i = 1; i < argc; i++)
         {
-            help(argv[0]);
-            return 1;
-        }
-        std::string arg = argv[1];
-        if(arg == "-h" || arg == "--help")
-        {
-            help(argv[0]);
-            return 0;
+            std::string arg = argv[i];
+            if(arg == "-h" || arg == "--help")
+            {
+                help(argv[0]);
+                return 0;
+            }
+            if(arg == "--snapshot")
+            {
+                useSnapshot = true;
+                continue;
+            }
+            if(arg == "--mem-report")
+            {
+                writeMemoryReport = true;
+                continue;
+            }
+            if(arg == "-I")
+            {
+                if(++i >= argc)
+                {
+                    help(argv[0]);
+                    return 1;
+                }
+                importSearchPath.push_back(argv[i]);
+                continue;
+            }
+            if(haveFileName || arg.empty() || (arg != "-" && arg[0] == '-'))
+            {
+                help(argv[0]);
+                return 1;
+            }
+            fileName = std::move(arg);
+            haveFileName = true;
         }
-        if(arg.empty() || (arg != "-" && arg[0] == '-'))
+        if(!haveFileName || (useSnapshot && fileName == "-"))
         {
             help(argv[0]);
             return 1;
         }
-        auto source = parse::Source::makeSourceFromFile(std::move(arg), true);
+        std::string snapshotFileName = fileName + ".snapshot";
+        auto directorySeparator = fileName.find_last_of('/');
+        if(directorySeparator == std::string::npos)
+            importSearchPath.push_back(".");
+        else
+            importSearchPath.push_back(fileName.substr(0, directorySeparator));
+        ast::MemoryReport memoryReport;
+        auto source = parse::Source::makeSourceFromFile(std::move(fileName), true);
+        memoryReport.addPhase("read source");
         ast::Context context;
+        parse::ImportLoader importLoader(context, std::move(importSearchPath));
         try
         {
-            auto *tree = parse::parseTopLevelModule(context, source.get());
+            ast::TopLevelModule *tree;
+            if(useSnapshot)
+                tree = parse::parseTopLevelModuleWithSnapshot(
+                    context, source.get(), snapshotFileName);
+            else
+                tree = parse::parseTopLevelModule(context, source.get());
             assert(tree);
+            memoryReport.addPhase("parse");
+            importLoader.resolveImports(tree);
+            memoryReport.addPhase("resolve imports");
+            ast::NameResolver nameResolver;
+            nameResolver.resolveAll(tree);
+            memoryReport.addPhase("resolve names");
+            ast::ConstantEvaluator constantEvaluator(nameResolver);
+            ast::BytecodeCompiler bytecodeCompiler(constantEvaluator);
+            ast::BytecodeInterpreter bytecodeInterpreter(bytecodeCompiler);
+            constantEvaluator.setFunctionEvaluator(&bytecodeInterpreter);
+            constantEvaluator.evaluateAll(tree);
+            memoryReport.addPhase("evaluate constants");
+            ast::StructuralInterner structuralInterner(nameResolver);
+            ast::TemplateInstantiator templateInstantiator(constantEvaluator, structuralInterner);
+            templateInstantiator.instantiateAll(tree);
+            memoryReport.addPhase("instantiate templates");
+            structuralInterner.internAll(tree);
+            memoryReport.addPhase("intern types and constants");
             util::Arena dumpArena;
             util::DumpState dumpState(dumpArena, context.stringPool);
             auto *dumpTree = dumpState.getDumpNode(tree);
+            memoryReport.addPhase("dump");
             std::ofstream os("out.gv");
             util::DumpTree::writeGraphvizDOT(os, dumpTree);
+            os.close();
+            memoryReport.addPhase("write graph");
+            if(writeMemoryReport)
+            {
+                memoryReport.addTree(tree, source.get());
+                memoryReport.addContext(context);
+                memoryReport.addDumpTree(dumpTree, dumpArena);
+                ast::MemoryUsage internerUsage;
+                internerUsage.objectCount = structuralInterner.getCanonicalNodeCount();
+                internerUsage.objectBytes = sizeof(ast::StructuralInterner);
+                internerUsage.heapBytes = structuralInterner.getHeapBytes();
+                memoryReport.addOther("canonical types and constants", internerUsage);
+                ast::MemoryUsage nameResolverUsage;
+                nameResolverUsage.objectCount = nameResolver.getResolvedScopedIdCount();
+                nameResolverUsage.objectBytes = sizeof(ast::NameResolver);
+                nameResolverUsage.heapBytes = nameResolver.getHeapBytes();
+                memoryReport.addOther("resolved names", nameResolverUsage);
+                ast::MemoryUsage constantEvaluatorUsage;
+                constantEvaluatorUsage.objectCount = constantEvaluator.getCachedValueCount();
+                constantEvaluatorUsage.objectBytes = sizeof(ast::ConstantEvaluator);
+                constantEvaluatorUsage.heapBytes = constantEvaluator.getHeapBytes();
+                memoryReport.addOther("constant values", constantEvaluatorUsage);
+                ast::MemoryUsage bytecodeUsage;
+                bytecodeUsage.objectCount = bytecodeCompiler.getCompiledFunctionCount();
+                bytecodeUsage.objectBytes = sizeof(ast::BytecodeCompiler);
+                bytecodeUsage.heapBytes = bytecodeCompiler.getHeapBytes();
+                memoryReport.addOther("compiled functions", bytecodeUsage);
+                ast::MemoryUsage callResultUsage;
+                callResultUsage.objectCount = bytecodeInterpreter.getCachedResultCount();
+                callResultUsage.objectBytes = sizeof(ast::BytecodeInterpreter);
+                callResultUsage.heapBytes = bytecodeInterpreter.getHeapBytes();
+                memoryReport.addOther("function call results", callResultUsage);
+                ast::MemoryUsage templateInstanceUsage;
+                templateInstanceUsage.objectCount = templateInstantiator.getInstanceCount();
+                templateInstanceUsage.objectBytes = sizeof(ast::TemplateInstantiator);
+                templateInstanceUsage.heapBytes = templateInstantiator.getHeapBytes();
+                memoryReport.addOther("template instances", templateInstanceUsage);
+                memoryReport.write(std::cout);
+                std::cout << "\n";
+                templateInstantiator.writeReport(std::cout);
+            }
 #warning finish
         }
         catch(parse::ParseError &e)
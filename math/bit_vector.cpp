@@ -0,0 +1,340 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bit_vector.h"
+
+namespace math
+{
+static_assert(GMP_NUMB_BITS == kernels::bitsPerWord && sizeof(mp_limb_t) == sizeof(std::uint64_t),
+              "BitVector words are passed to GMP as limbs");
+
+constexpr std::size_t BitVector::maxInlineBitCount;
+constexpr std::size_t BitVector::inlineWordCount;
+
+/** the words of a value sign or zero extended (or truncated) to wordCount words. Only copies if
+ * the value has fewer words. */
+class BitVector::ExtendedWords final
+{
+private:
+    std::unique_ptr<std::uint64_t[]> buffer;
+    const std::uint64_t *words;
+
+public:
+    ExtendedWords(const BitVector &value, std::size_t wordCount)
+        : buffer(), words(value.getWords())
+    {
+        auto valueWordCount = value.getWordCount();
+        if(valueWordCount >= wordCount)
+            return;
+        buffer.reset(new std::uint64_t[wordCount]);
+        std::copy(words, words + valueWordCount, buffer.get());
+        std::fill(buffer.get() + valueWordCount, buffer.get() + wordCount, value.getFillWord());
+        words = buffer.get();
+    }
+    const std::uint64_t *get() const noexcept
+    {
+        return words;
+    }
+};
+
+GMPInteger BitVector::toGMPInteger(Kind kind, InlineValue value)
+{
+    bool isNegative = kind == Kind::Signed && static_cast<SignedInlineValue>(value) < 0;
+    auto magnitude = isNegative ? 0 - value : value;
+    auto retval = (GMPInteger(static_cast<unsigned long>(magnitude >> 64)) << 64)
+                  + GMPInteger(static_cast<unsigned long>(magnitude));
+    if(isNegative)
+        return GMPInteger() - retval;
+    return retval;
+}
+
+void BitVector::normalize() noexcept
+{
+    if(isInline())
+    {
+        setInlineValue(normalizeInline(kind, bitCount, getInlineValue()));
+        return;
+    }
+    auto &topWord = heapWords[getWordCount() - 1];
+    auto shiftCount =
+        (kernels::bitsPerWord - bitCount % kernels::bitsPerWord) % kernels::bitsPerWord;
+    auto shifted = topWord << shiftCount;
+    auto signExtended =
+        static_cast<std::uint64_t>(static_cast<std::int64_t>(shifted) >> shiftCount);
+    topWord = kind == Kind::Signed ? signExtended : shifted >> shiftCount;
+}
+
+void BitVector::setValue(const GMPInteger &newValue)
+{
+    auto mpzView = newValue.getMpz();
+    mpz_srcptr mpz = mpzView;
+    auto *words = getWords();
+    auto wordCount = getWordCount();
+    std::size_t limbCount = mpz_size(mpz);
+    for(std::size_t i = 0; i < wordCount; i++)
+        words[i] = i < limbCount ? mpz_getlimbn(mpz, i) : 0;
+    if(mpz_sgn(mpz) < 0)
+        kernels::negateWords(words, words, wordCount);
+    normalize();
+}
+
+GMPInteger BitVector::getValue() const
+{
+    if(isInline())
+        return toGMPInteger(kind, getInlineValue());
+    auto wordCount = getWordCount();
+    std::unique_ptr<std::uint64_t[]> magnitude(new std::uint64_t[wordCount]);
+    bool isNegative = this->isNegative();
+    if(isNegative)
+        kernels::negateWords(magnitude.get(), heapWords.get(), wordCount);
+    else
+        std::copy(heapWords.get(), heapWords.get() + wordCount, magnitude.get());
+    GMPInteger retval;
+    auto *mpz = retval.getMutableMpz();
+    mpz_import(mpz, wordCount, -1, sizeof(std::uint64_t), 0, 0, magnitude.get());
+    if(isNegative)
+        mpz_neg(mpz, mpz);
+    retval.shrinkToFit();
+    return retval;
+}
+
+std::size_t BitVector::getShiftCount(const BitVector &shiftCount, std::size_t bitCount) noexcept
+{
+    if(shiftCount.isNegative())
+        return bitCount;
+    auto *words = shiftCount.getWords();
+    for(std::size_t i = 1; i < shiftCount.getWordCount(); i++)
+        if(words[i] != 0)
+            return bitCount;
+    return words[0] >= bitCount ? bitCount : static_cast<std::size_t>(words[0]);
+}
+
+BitVector BitVector::addSlow(Kind kind,
+                             std::size_t bitCount,
+                             const BitVector &l,
+                             const BitVector &r)
+{
+    BitVector retval(kind, bitCount);
+    auto wordCount = retval.getWordCount();
+    ExtendedWords lWords(l, wordCount);
+    ExtendedWords rWords(r, wordCount);
+    kernels::addWords(retval.getWords(), lWords.get(), rWords.get(), wordCount);
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVector::subtractSlow(Kind kind,
+                                  std::size_t bitCount,
+                                  const BitVector &l,
+                                  const BitVector &r)
+{
+    BitVector retval(kind, bitCount);
+    auto wordCount = retval.getWordCount();
+    ExtendedWords lWords(l, wordCount);
+    ExtendedWords rWords(r, wordCount);
+    kernels::subtractWords(retval.getWords(), lWords.get(), rWords.get(), wordCount);
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVector::multiplySlow(Kind kind,
+                                  std::size_t bitCount,
+                                  const BitVector &l,
+                                  const BitVector &r)
+{
+    // the low words of the product of the two's complement words are the same for signed and
+    // unsigned operands
+    BitVector retval(kind, bitCount);
+    auto wordCount = retval.getWordCount();
+    ExtendedWords lWords(l, wordCount);
+    ExtendedWords rWords(r, wordCount);
+    std::unique_ptr<mp_limb_t[]> product(new mp_limb_t[wordCount * 2]);
+    mpn_mul_n(product.get(),
+              reinterpret_cast<const mp_limb_t *>(lWords.get()),
+              reinterpret_cast<const mp_limb_t *>(rWords.get()),
+              wordCount);
+    std::copy(product.get(), product.get() + wordCount, retval.getWords());
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVector::shiftLeftSlow(Kind kind,
+                                   std::size_t bitCount,
+                                   const BitVector &l,
+                                   std::size_t shiftCount)
+{
+    BitVector retval(kind, bitCount);
+    kernels::shiftLeftWords(retval.getWords(),
+                            retval.getWordCount(),
+                            l.getWords(),
+                            l.getWordCount(),
+                            shiftCount,
+                            l.getFillWord());
+    retval.normalize();
+    return retval;
+}
+
+/** writes the magnitude of value, returning its word count without leading zero words */
+static std::size_t getMagnitude(std::unique_ptr<std::uint64_t[]> &magnitude,
+                                const BitVector &value)
+{
+    auto wordCount = value.getWordCount();
+    magnitude.reset(new std::uint64_t[wordCount]);
+    if(value.isNegative())
+        kernels::negateWords(magnitude.get(), value.getWords(), wordCount);
+    else
+        std::copy(value.getWords(), value.getWords() + wordCount, magnitude.get());
+    while(wordCount > 0 && magnitude[wordCount - 1] == 0)
+        wordCount--;
+    return wordCount;
+}
+
+BitVector BitVector::divideSlow(Kind kind,
+                                std::size_t bitCount,
+                                const BitVector &l,
+                                const BitVector &r,
+                                bool wantRemainder)
+{
+    bool lIsNegative = l.isNegative();
+    bool rIsNegative = r.isNegative();
+    bool isNegative = wantRemainder ? lIsNegative : lIsNegative != rIsNegative;
+    if(bitCount <= maxInlineBitCount && l.isInline() && r.isInline())
+    {
+        auto lMagnitude = l.getInlineValue();
+        if(lIsNegative)
+            lMagnitude = 0 - lMagnitude;
+        auto rMagnitude = r.getInlineValue();
+        if(rIsNegative)
+            rMagnitude = 0 - rMagnitude;
+        if(rMagnitude == 0)
+            throw std::domain_error("division by zero");
+        auto magnitude = wantRemainder ? lMagnitude % rMagnitude : lMagnitude / rMagnitude;
+        return makeInline(kind, bitCount, isNegative ? 0 - magnitude : magnitude);
+    }
+    std::unique_ptr<std::uint64_t[]> lMagnitude, rMagnitude;
+    auto lWordCount = getMagnitude(lMagnitude, l);
+    auto rWordCount = getMagnitude(rMagnitude, r);
+    if(rWordCount == 0)
+        throw std::domain_error("division by zero");
+    std::unique_ptr<std::uint64_t[]> magnitude;
+    std::size_t magnitudeWordCount = 0;
+    if(lWordCount < rWordCount)
+    {
+        if(wantRemainder)
+        {
+            magnitude = std::move(lMagnitude);
+            magnitudeWordCount = lWordCount;
+        }
+    }
+    else
+    {
+        auto quotientWordCount = lWordCount - rWordCount + 1;
+        std::unique_ptr<std::uint64_t[]> quotient(new std::uint64_t[quotientWordCount]);
+        std::unique_ptr<std::uint64_t[]> remainder(new std::uint64_t[rWordCount]);
+        mpn_tdiv_qr(reinterpret_cast<mp_limb_t *>(quotient.get()),
+                    reinterpret_cast<mp_limb_t *>(remainder.get()),
+                    0,
+                    reinterpret_cast<const mp_limb_t *>(lMagnitude.get()),
+                    lWordCount,
+                    reinterpret_cast<const mp_limb_t *>(rMagnitude.get()),
+                    rWordCount);
+        magnitude = std::move(wantRemainder ? remainder : quotient);
+        magnitudeWordCount = wantRemainder ? rWordCount : quotientWordCount;
+    }
+    BitVector retval(kind, bitCount);
+    auto *words = retval.getWords();
+    auto wordCount = retval.getWordCount();
+    std::copy(magnitude.get(),
+              magnitude.get() + std::min(magnitudeWordCount, wordCount),
+              words);
+    if(isNegative)
+        kernels::negateWords(words, words, wordCount);
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVector::bitwiseSlow(BitwiseKernel kernel,
+                                 Kind kind,
+                                 std::size_t bitCount,
+                                 const BitVector &l,
+                                 const BitVector &r)
+{
+    BitVector retval(kind, bitCount);
+    auto wordCount = retval.getWordCount();
+    ExtendedWords lWords(l, wordCount);
+    ExtendedWords rWords(r, wordCount);
+    kernel(retval.getWords(), lWords.get(), rWords.get(), wordCount);
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVector::bitwiseNotSlow(Kind kind, std::size_t bitCount, const BitVector &value)
+{
+    BitVector retval(kind, bitCount);
+    auto wordCount = retval.getWordCount();
+    ExtendedWords valueWords(value, wordCount);
+    kernels::notWords(retval.getWords(), valueWords.get(), wordCount);
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVector::concatenateSlow(const BitVector &l, const BitVector &r)
+{
+    BitVector retval(l.kind, l.bitCount + r.bitCount);
+    auto *words = retval.getWords();
+    kernels::shiftLeftWords(words,
+                            retval.getWordCount(),
+                            l.getWords(),
+                            l.getWordCount(),
+                            r.bitCount,
+                            l.getFillWord());
+    auto rWordCount = (r.bitCount + kernels::bitsPerWord - 1) / kernels::bitsPerWord;
+    ExtendedWords rWords(r, rWordCount);
+    for(std::size_t i = 0; i < rWordCount; i++)
+    {
+        auto word = rWords.get()[i];
+        auto bitIndex = i * kernels::bitsPerWord;
+        if(r.bitCount - bitIndex < kernels::bitsPerWord)
+            word &= (static_cast<std::uint64_t>(1) << (r.bitCount - bitIndex)) - 1;
+        words[i] |= word;
+    }
+    retval.normalize();
+    return retval;
+}
+
+int BitVector::compareSlow(const BitVector &l, const BitVector &r) noexcept
+{
+    bool lIsNegative = l.isNegative();
+    if(lIsNegative != r.isNegative())
+        return lIsNegative ? -1 : 1;
+    // compare the words only one of them has against the other's fill word first, so nothing
+    // needs to be copied
+    auto lWordCount = l.getWordCount();
+    auto rWordCount = r.getWordCount();
+    auto commonWordCount = std::min(lWordCount, rWordCount);
+    for(std::size_t i = std::max(lWordCount, rWordCount); i-- > commonWordCount;)
+    {
+        auto lWord = i < lWordCount ? l.getWords()[i] : l.getFillWord();
+        auto rWord = i < rWordCount ? r.getWords()[i] : r.getFillWord();
+        if(lWord != rWord)
+            return lWord < rWord ? -1 : 1;
+    }
+    return kernels::compareWords(l.getWords(), r.getWords(), commonWordCount);
+}
+}
@@ -19,11 +19,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <type_traits>
-#include <gmp.h>
+#include "bit_vector_kernels.h"
+#include "gmp_integer.h"
 #include <stdexcept>
 #include <cassert>
 #include <ostream>
@@ -32,260 +35,437 @@
 
 namespace math
 {
-struct GMPInteger
+class BitVectorConcatenator;
+class BitVectorView;
+class FourStateBitVector;
+
+/** a two's complement integer with a fixed bit count, stored as 64-bit words, least significant
+ * first, sign or zero extended to fill the top word. Values up to maxInlineBitCount bits wide are
+ * stored inline in two words and use native 128-bit arithmetic; wider values are stored on the
+ * heap and use the kernels in bit_vector_kernels.h. */
+class BitVector
 {
-    mpz_t value;
-    GMPInteger()
+    friend class BitVectorConcatenator;
+    friend class BitVectorView;
+    friend class FourStateBitVector;
+
+public:
+    enum class Kind
     {
-        mpz_init(value);
+        Signed,
+        Unsigned,
+    };
+    static constexpr std::size_t maxInlineBitCount = 128;
+
+private:
+    typedef unsigned __int128 InlineValue;
+    typedef __int128 SignedInlineValue;
+    static constexpr std::size_t inlineWordCount = 2;
+    class ExtendedWords;
+    template <std::size_t N, Kind K>
+    friend class FixedBitVector;
+
+private:
+    Kind kind;
+    std::size_t bitCount;
+    /** the value sign or zero extended to 128 bits when bitCount <= maxInlineBitCount */
+    std::uint64_t inlineWords[inlineWordCount];
+    /** the value sign or zero extended to getWordCount() words when bitCount >
+     * maxInlineBitCount */
+    std::unique_ptr<std::uint64_t[]> heapWords;
+
+private:
+    static InlineValue normalizeInline(Kind kind, std::size_t bitCount, InlineValue value) noexcept
+    {
+        if(bitCount == 0)
+            return 0;
+        auto shiftCount = maxInlineBitCount - bitCount;
+        auto shifted = value << shiftCount;
+        auto signExtended =
+            static_cast<InlineValue>(static_cast<SignedInlineValue>(shifted) >> shiftCount);
+        return kind == Kind::Signed ? signExtended : shifted >> shiftCount;
+    }
+    static GMPInteger toGMPInteger(Kind kind, InlineValue value);
+    static std::size_t getWordCount(std::size_t bitCount) noexcept
+    {
+        if(bitCount <= maxInlineBitCount)
+            return inlineWordCount;
+        return (bitCount + kernels::bitsPerWord - 1) / kernels::bitsPerWord;
+    }
+    bool isInline() const noexcept
+    {
+        return bitCount <= maxInlineBitCount;
+    }
+    std::uint64_t *getWords() noexcept
+    {
+        return isInline() ? inlineWords : heapWords.get();
+    }
+    InlineValue getInlineValue() const noexcept
+    {
+        return static_cast<InlineValue>(inlineWords[1]) << 64 | inlineWords[0];
+    }
+    void setInlineValue(InlineValue newValue) noexcept
+    {
+        inlineWords[0] = static_cast<std::uint64_t>(newValue);
+        inlineWords[1] = static_cast<std::uint64_t>(newValue >> 64);
+    }
+    /** the low 128 bits of the value, which is all an inline result depends on for most
+     * operations */
+    InlineValue getLowBits() const noexcept
+    {
+        auto *words = getWords();
+        return static_cast<InlineValue>(words[1]) << 64 | words[0];
+    }
+    /** the word the value is extended with past its top word */
+    std::uint64_t getFillWord() const noexcept
+    {
+        return isNegative() ? ~static_cast<std::uint64_t>(0) : 0;
+    }
+    /** sign or zero extends the value from bitCount bits to fill the top word */
+    void normalize() noexcept;
+    void setValue(const GMPInteger &newValue);
+    /** returns bitCount if shiftCount is negative or at least bitCount */
+    static std::size_t getShiftCount(const BitVector &shiftCount, std::size_t bitCount) noexcept;
+    static BitVector makeInline(Kind kind, std::size_t bitCount, InlineValue value) noexcept
+    {
+        BitVector retval(kind, bitCount);
+        retval.setInlineValue(normalizeInline(kind, bitCount, value));
+        return retval;
+    }
+    static BitVector addSlow(Kind kind,
+                             std::size_t bitCount,
+                             const BitVector &l,
+                             const BitVector &r);
+    static BitVector subtractSlow(Kind kind,
+                                  std::size_t bitCount,
+                                  const BitVector &l,
+                                  const BitVector &r);
+    static BitVector multiplySlow(Kind kind,
+                                  std::size_t bitCount,
+                                  const BitVector &l,
+                                  const BitVector &r);
+    static BitVector shiftLeftSlow(Kind kind,
+                                   std::size_t bitCount,
+                                   const BitVector &l,
+                                   std::size_t shiftCount);
+    static BitVector divideSlow(Kind kind,
+                                std::size_t bitCount,
+                                const BitVector &l,
+                                const BitVector &r,
+                                bool wantRemainder);
+    typedef void (*BitwiseKernel)(std::uint64_t *result,
+                                  const std::uint64_t *l,
+                                  const std::uint64_t *r,
+                                  std::size_t wordCount);
+    static BitVector bitwiseSlow(BitwiseKernel kernel,
+                                 Kind kind,
+                                 std::size_t bitCount,
+                                 const BitVector &l,
+                                 const BitVector &r);
+    static BitVector bitwiseNotSlow(Kind kind, std::size_t bitCount, const BitVector &value);
+    static BitVector concatenateSlow(const BitVector &l, const BitVector &r);
+    static int compareSlow(const BitVector &l, const BitVector &r) noexcept;
+    /** word index of the bitCount-bit pattern zero extended to any number of words */
+    std::uint64_t getBitPatternWord(std::size_t index) const noexcept
+    {
+        if(index >= getWordCount())
+            return 0;
+        auto word = getWords()[index];
+        auto bitIndex = index * kernels::bitsPerWord;
+        if(bitIndex >= bitCount)
+            return 0;
+        if(bitCount - bitIndex < kernels::bitsPerWord)
+            word &= (static_cast<std::uint64_t>(1) << (bitCount - bitIndex)) - 1;
+        return word;
+    }
+    static BitVector fromBool(bool value) noexcept
+    {
+        BitVector retval;
+        retval.inlineWords[0] = value;
+        return retval;
     }
-    GMPInteger(const GMPInteger &rt)
+
+public:
+    BitVector() noexcept : kind(Kind::Unsigned), bitCount(1), inlineWords{0, 0}, heapWords()
     {
-        mpz_init_set(value, rt.value);
     }
-    explicit GMPInteger(double newValue)
+    BitVector(Kind kind, std::size_t bitCount)
+        : kind(kind),
+          bitCount(bitCount),
+          inlineWords{0, 0},
+          heapWords(isInline() ? nullptr : new std::uint64_t[getWordCount(bitCount)]())
     {
-        mpz_init_set_d(value, newValue);
+        assert(bitCount <= maxBitCount());
     }
-    explicit GMPInteger(long newValue)
+    BitVector(Kind kind, std::size_t bitCount, const GMPInteger &value) : BitVector(kind, bitCount)
     {
-        mpz_init_set_si(value, newValue);
+        setValue(value);
     }
-    explicit GMPInteger(unsigned long newValue)
+    BitVector(const BitVector &rt)
+        : kind(rt.kind),
+          bitCount(rt.bitCount),
+          inlineWords{rt.inlineWords[0], rt.inlineWords[1]},
+          heapWords()
     {
-        mpz_init_set_ui(value, newValue);
+        if(!isInline())
+        {
+            heapWords.reset(new std::uint64_t[getWordCount()]);
+            std::copy(rt.heapWords.get(), rt.heapWords.get() + getWordCount(), heapWords.get());
+        }
     }
-    explicit GMPInteger(const char *newValue, int base = 0)
+    BitVector(BitVector &&) noexcept = default;
+    BitVector &operator=(BitVector rt) noexcept
     {
-        if(mpz_init_set_str(value, newValue, base) != 0)
-            throw std::runtime_error("mpz_init_set_str failed: invalid number");
+        kind = rt.kind;
+        bitCount = rt.bitCount;
+        inlineWords[0] = rt.inlineWords[0];
+        inlineWords[1] = rt.inlineWords[1];
+        heapWords.swap(rt.heapWords);
+        return *this;
     }
-    GMPInteger(GMPInteger &&rt)
+    static constexpr std::size_t maxBitCount() noexcept
     {
-        mpz_init(value);
-        mpz_swap(value, rt.value);
+        auto a = std::numeric_limits<std::size_t>::max();
+        auto b = std::numeric_limits<unsigned long>::max();
+        if(a < b)
+            return a;
+        return b;
     }
-    ~GMPInteger()
+    std::size_t getBitCount() const noexcept
     {
-        mpz_clear(value);
+        return bitCount;
     }
-    GMPInteger &operator=(GMPInteger rt)
+    Kind getKind() const noexcept
     {
-        mpz_swap(value, rt.value);
-        return *this;
+        return kind;
     }
-    operator mpz_t &() & noexcept
+    std::size_t getWordCount() const noexcept
     {
-        return value;
+        return getWordCount(bitCount);
     }
-    operator const mpz_t &() const &noexcept
+    /** the value sign or zero extended to getWordCount() words, least significant first */
+    const std::uint64_t *getWords() const noexcept
     {
-        return value;
+        return isInline() ? inlineWords : heapWords.get();
     }
-    operator mpz_t &&() && noexcept
+    std::size_t getHash() const noexcept
     {
-        return std::move(value);
+        std::size_t retval = bitCount * 2 + (kind == Kind::Signed);
+        auto *words = getWords();
+        for(std::size_t i = 0; i < getWordCount(); i++)
+            retval = retval * 0x100000001B3ULL ^ std::hash<std::uint64_t>()(words[i]);
+        return retval;
     }
-    operator const mpz_t &&() const &&noexcept
+    /** the bytes allocated on the heap for the value */
+    std::size_t getHeapBytes() const noexcept
     {
-        return std::move(value);
+        return isInline() ? 0 : getWordCount() * sizeof(std::uint64_t);
     }
-    operator bool() const = delete;
-    friend std::ostream &operator<<(std::ostream &os, const GMPInteger &value)
+    bool isNegative() const noexcept
     {
-        using namespace util::string_view_literals;
-        if(mpz_sgn(value.value) == 0)
-        {
-            os << "0";
-            return os;
-        }
-        int base = 10;
-        auto baseIndicatorUpper = ""_sv;
-        auto baseIndicatorLower = ""_sv;
-        switch(os.flags() & std::ios::basefield)
-        {
-        case std::ios::oct:
-            base = 8;
-            baseIndicatorUpper = "0"_sv;
-            baseIndicatorLower = "0"_sv;
-            break;
-        case std::ios::hex:
-            base = 16;
-            baseIndicatorUpper = "0X"_sv;
-            baseIndicatorLower = "0x"_sv;
-            break;
-        default:
-            break;
-        }
-        auto baseIndicator = ""_sv;
-        if(os.flags() & std::ios::uppercase)
-        {
-            base = -base;
-            if(os.flags() & std::ios::showbase)
-                baseIndicator = baseIndicatorUpper;
-        }
-        else if(os.flags() & std::ios::showbase)
-        {
-            baseIndicator = baseIndicatorLower;
-        }
-        std::unique_ptr<char[]> buffer(
-            new char[mpz_sizeinbase(value, base) + 2 + baseIndicator.size()]);
-        for(std::size_t i = 0; i < baseIndicator.size(); i++)
-            buffer[i] = baseIndicator[i];
-        mpz_get_str(buffer.get() + baseIndicator.size(), base, value);
-        if(buffer.get()[baseIndicator.size()] == '-')
-        {
-            // put sign before base indicator
-            buffer[0] = '-';
-            for(std::size_t i = 0; i < baseIndicator.size(); i++)
-                buffer[i + 1] = baseIndicator[i];
-        }
-        os << buffer.get();
-        return os;
+        return kind == Kind::Signed && getWords()[getWordCount() - 1] >> 63;
     }
-};
-
-class BitVector
-{
-public:
-    enum class Kind
+    bool isZero() const noexcept
     {
-        Signed,
-        Unsigned,
-    };
-
-private:
-    Kind kind;
-    std::size_t bitCount;
-    GMPInteger value;
-    struct NormalizedAlreadyTag
+        auto *words = getWords();
+        return std::all_of(
+            words, words + getWordCount(), [](std::uint64_t word) { return word == 0; });
+    }
+    GMPInteger getValue() const;
+    static BitVector add(Kind kind, std::size_t bitCount, const BitVector &l, const BitVector &r)
     {
-        friend class BitVector;
-
-    private:
-        explicit NormalizedAlreadyTag() = default;
-    };
-    static GMPInteger normalizeUnsigned(std::size_t bitCount, GMPInteger value)
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() + r.getLowBits());
+        return addSlow(kind, bitCount, l, r);
+    }
+    static BitVector subtract(Kind kind,
+                              std::size_t bitCount,
+                              const BitVector &l,
+                              const BitVector &r)
     {
-        mpz_fdiv_r_2exp(value, value, bitCount);
-        return value;
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() - r.getLowBits());
+        return subtractSlow(kind, bitCount, l, r);
     }
-    static GMPInteger normalizeSigned(std::size_t bitCount, GMPInteger value)
+    static BitVector multiply(Kind kind,
+                              std::size_t bitCount,
+                              const BitVector &l,
+                              const BitVector &r)
     {
-        if(bitCount == 0)
-        {
-            mpz_set_ui(value, 0);
-            return value;
-        }
-        bool isNegative = mpz_tstbit(value, bitCount - 1);
-        if(isNegative)
-            mpz_neg(value, value);
-        mpz_fdiv_r_2exp(value, value, bitCount);
-        if(isNegative)
-            mpz_neg(value, value);
-        return value;
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() * r.getLowBits());
+        return multiplySlow(kind, bitCount, l, r);
     }
-    static GMPInteger normalize(Kind kind, std::size_t bitCount, GMPInteger value)
+    static BitVector shiftLeft(Kind kind,
+                               std::size_t bitCount,
+                               const BitVector &l,
+                               const BitVector &r)
     {
-        switch(kind)
+        auto shiftCount = getShiftCount(r, bitCount);
+        if(shiftCount >= bitCount)
+            return BitVector(kind, bitCount);
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() << shiftCount);
+        return shiftLeftSlow(kind, bitCount, l, shiftCount);
+    }
+    /** shifts right with the value's sign or zero extension, so signed values round towards
+     * negative infinity */
+    static BitVector shiftRight(Kind kind,
+                                std::size_t bitCount,
+                                const BitVector &l,
+                                const BitVector &r)
+    {
+        auto shiftCount = getShiftCount(r, l.bitCount);
+        if(bitCount <= maxInlineBitCount && l.isInline())
         {
-        case Kind::Unsigned:
-            return normalizeUnsigned(bitCount, std::move(value));
-        case Kind::Signed:
-            return normalizeSigned(bitCount, std::move(value));
+            if(shiftCount >= maxInlineBitCount)
+                return makeInline(kind, bitCount, static_cast<InlineValue>(0) - l.isNegative());
+            auto value = l.getInlineValue();
+            if(l.kind == Kind::Signed)
+                return makeInline(
+                    kind,
+                    bitCount,
+                    static_cast<InlineValue>(static_cast<SignedInlineValue>(value) >> shiftCount));
+            return makeInline(kind, bitCount, value >> shiftCount);
         }
-        assert(false);
-        return normalizeUnsigned(bitCount, std::move(value));
+        return slice(kind, bitCount, l, shiftCount);
     }
-
-public:
-    BitVector() : kind(Kind::Unsigned), bitCount(1), value()
+    static BitVector negate(Kind kind, std::size_t bitCount, const BitVector &value)
     {
+        return subtract(kind, bitCount, BitVector(kind, bitCount), value);
     }
-    BitVector(Kind kind, std::size_t bitCount) : kind(kind), bitCount(bitCount), value()
+    /** divides the values, rounding towards zero */
+    static BitVector divide(Kind kind, std::size_t bitCount, const BitVector &l, const BitVector &r)
     {
-        assert(bitCount <= maxBitCount());
+        return divideSlow(kind, bitCount, l, r, false);
     }
-    BitVector(Kind kind, std::size_t bitCount, GMPInteger value)
-        : kind(kind), bitCount(bitCount), value(normalize(kind, bitCount, std::move(value)))
+    /** the remainder of divide, which has the sign of l */
+    static BitVector remainder(Kind kind,
+                               std::size_t bitCount,
+                               const BitVector &l,
+                               const BitVector &r)
     {
-        assert(bitCount <= maxBitCount());
+        return divideSlow(kind, bitCount, l, r, true);
     }
-    BitVector(Kind kind, std::size_t bitCount, GMPInteger value, NormalizedAlreadyTag)
-        : kind(kind), bitCount(bitCount), value(std::move(value))
+    static BitVector bitwiseAnd(Kind kind,
+                                std::size_t bitCount,
+                                const BitVector &l,
+                                const BitVector &r)
     {
-        assert(bitCount <= maxBitCount());
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() & r.getLowBits());
+        return bitwiseSlow(kernels::andWords, kind, bitCount, l, r);
     }
-    static constexpr std::size_t maxBitCount() noexcept
+    static BitVector bitwiseOr(Kind kind,
+                               std::size_t bitCount,
+                               const BitVector &l,
+                               const BitVector &r)
     {
-        auto a = std::numeric_limits<std::size_t>::max();
-        auto b = std::numeric_limits<unsigned long>::max();
-        if(a < b)
-            return a;
-        return b;
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() | r.getLowBits());
+        return bitwiseSlow(kernels::orWords, kind, bitCount, l, r);
     }
-    std::size_t getBitCount() const noexcept
+    static BitVector bitwiseXor(Kind kind,
+                                std::size_t bitCount,
+                                const BitVector &l,
+                                const BitVector &r)
     {
-        return bitCount;
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, l.getLowBits() ^ r.getLowBits());
+        return bitwiseSlow(kernels::xorWords, kind, bitCount, l, r);
     }
-    Kind getKind() const noexcept
+    static BitVector bitwiseNot(Kind kind, std::size_t bitCount, const BitVector &value)
     {
-        return kind;
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, ~value.getLowBits());
+        return bitwiseNotSlow(kind, bitCount, value);
     }
-    const GMPInteger &getValue() const noexcept
+    /** the number of one bits in the value's bitCount bits */
+    std::size_t popCount() const noexcept
     {
-        return value;
+        auto fullWordCount = bitCount / kernels::bitsPerWord;
+        auto retval = kernels::popCountWords(getWords(), fullWordCount);
+        if(bitCount % kernels::bitsPerWord != 0)
+            retval += __builtin_popcountll(getBitPatternWord(fullWordCount));
+        return retval;
     }
-    static BitVector add(Kind kind, std::size_t bitCount, BitVector l, const BitVector &r)
+    static BitVector popCount(Kind kind, std::size_t bitCount, const BitVector &value)
     {
-        mpz_add(l.value, l.value, r.value);
-        return BitVector(kind, bitCount, std::move(l.value));
+        BitVector retval(kind, bitCount);
+        retval.getWords()[0] = value.popCount();
+        retval.normalize();
+        return retval;
     }
-    static BitVector subtract(Kind kind, std::size_t bitCount, BitVector l, const BitVector &r)
+    /** reduceAnd, reduceOr and reduceXor return 1-bit unsigned values */
+    static BitVector reduceAnd(const BitVector &value) noexcept
     {
-        mpz_sub(l.value, l.value, r.value);
-        return BitVector(kind, bitCount, std::move(l.value));
+        return fromBool(value.popCount() == value.bitCount);
     }
-    static BitVector multiply(Kind kind, std::size_t bitCount, BitVector l, const BitVector &r)
+    static BitVector reduceOr(const BitVector &value) noexcept
     {
-        mpz_mul(l.value, l.value, r.value);
-        return BitVector(kind, bitCount, std::move(l.value));
+        return fromBool(value.popCount() != 0);
     }
-    static BitVector shiftLeft(Kind kind, std::size_t bitCount, BitVector l, const BitVector &r)
+    static BitVector reduceXor(const BitVector &value) noexcept
     {
-        if(mpz_cmp_ui(r.value.value, bitCount) >= 0 || mpz_sgn(r.value.value) < 0)
-            mpz_set_ui(l.value, 0);
-        else
-            mpz_mul_2exp(l.value, l.value, mpz_get_ui(r.value));
-        return BitVector(kind, bitCount, std::move(l.value));
+        return fromBool(value.popCount() % 2 != 0);
     }
-    static BitVector shiftRight(Kind kind, std::size_t bitCount, BitVector l, const BitVector &r)
+    static BitVector concatenate(const BitVector &l, const BitVector &r)
     {
-        if(mpz_cmp_ui(r.value.value, bitCount) >= 0 || mpz_sgn(r.value.value) < 0)
-            mpz_set_ui(l.value, mpz_sgn(l.value.value) < 0 ? -1 : 0);
-        else
-            mpz_fdiv_r_2exp(l.value, l.value, mpz_get_ui(r.value));
-        return BitVector(kind, bitCount, std::move(l.value));
+        auto bitCount = l.bitCount + r.bitCount;
+        if(bitCount <= maxInlineBitCount)
+        {
+            auto high = r.bitCount >= maxInlineBitCount ? 0 : l.getLowBits() << r.bitCount;
+            auto low = normalizeInline(Kind::Unsigned, r.bitCount, r.getLowBits());
+            return makeInline(l.kind, bitCount, high | low);
+        }
+        return concatenateSlow(l, r);
     }
-    static BitVector concatenate(BitVector l, const BitVector &r)
+    static BitVector slice(Kind kind,
+                           std::size_t bitCount,
+                           const BitVector &value,
+                           std::size_t startBit)
     {
-        l.bitCount += r.bitCount;
-        mpz_mul_2exp(l.value, l.value, r.bitCount);
-        mpz_add(l.value, l.value, normalizeUnsigned(r.bitCount, r.value));
-        return l;
+        BitVector retval(kind, bitCount);
+        kernels::shiftRightWords(retval.getWords(),
+                                 retval.getWordCount(),
+                                 value.getWords(),
+                                 value.getWordCount(),
+                                 startBit,
+                                 value.getFillWord());
+        retval.normalize();
+        return retval;
     }
-    static BitVector slice(Kind kind, std::size_t bitCount, BitVector value, std::size_t startBit)
+    static BitVector cast(Kind kind, std::size_t bitCount, const BitVector &value)
     {
-        mpz_fdiv_q_2exp(value.value, value.value, startBit);
-        return BitVector(kind, bitCount, std::move(value.value));
+        if(bitCount <= maxInlineBitCount)
+            return makeInline(kind, bitCount, value.getLowBits());
+        return slice(kind, bitCount, value, 0);
     }
-    static BitVector cast(Kind kind, std::size_t bitCount, BitVector value)
+    static int compare(const BitVector &l, const BitVector &r) noexcept
     {
-        return BitVector(kind, bitCount, std::move(value.value));
+        if(l.isInline() && r.isInline())
+        {
+            bool lIsNegative = l.isNegative();
+            if(lIsNegative != r.isNegative())
+                return lIsNegative ? -1 : 1;
+            // both are sign extended the same way, so they compare the same as unsigned
+            auto lValue = l.getInlineValue();
+            auto rValue = r.getInlineValue();
+            return lValue < rValue ? -1 : lValue > rValue ? 1 : 0;
+        }
+        return compareSlow(l, r);
     }
-    static int compare(const BitVector &l, const BitVector &r) noexcept
+    /** compares the bit patterns of l and r as unsigned integers, ignoring their kinds */
+    static int compareUnsigned(const BitVector &l, const BitVector &r) noexcept
     {
-        return mpz_cmp(l.value, r.value);
+        for(std::size_t i = std::max(l.getWordCount(), r.getWordCount()); i-- > 0;)
+        {
+            auto lWord = l.getBitPatternWord(i);
+            auto rWord = r.getBitPatternWord(i);
+            if(lWord != rWord)
+                return lWord < rWord ? -1 : 1;
+        }
+        return 0;
     }
 };
 }
@@ -0,0 +1,485 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bit_vector_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// the vector kernels need SSE2; AVX2 is detected at run time
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define MATH_KERNELS_X86 1
+#else
+#define MATH_KERNELS_X86 0
+#endif
+
+namespace math
+{
+namespace kernels
+{
+namespace
+{
+KernelPath kernelPath = getBestKernelPath();
+
+#if MATH_KERNELS_X86
+
+/** the index of the highest word below end where l and r differ, or wordCount if they're the same
+ * below end */
+__attribute__((target("avx2"))) std::size_t findHighestDifferenceAVX2(
+    const std::uint64_t *l, const std::uint64_t *r, std::size_t wordCount) noexcept
+{
+    std::size_t end = wordCount;
+    for(; end >= 4; end -= 4)
+    {
+        auto lVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(l + end - 4));
+        auto rVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + end - 4));
+        auto equalMask = static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lVector, rVector))));
+        if(equalMask != 0xF)
+            return end - 4 + (31 - __builtin_clz(~equalMask & 0xF));
+    }
+    while(end-- > 0)
+        if(l[end] != r[end])
+            return end;
+    return wordCount;
+}
+#endif
+
+#if MATH_KERNELS_X86
+std::size_t findHighestDifferenceSSE2(const std::uint64_t *l,
+                                      const std::uint64_t *r,
+                                      std::size_t wordCount) noexcept
+{
+    std::size_t end = wordCount;
+    for(; end >= 2; end -= 2)
+    {
+        auto lVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(l + end - 2));
+        auto rVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r + end - 2));
+        // SSE2 only compares 32-bit lanes, so a word is equal if both of its halves are
+        auto equalMask =
+            static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(lVector, rVector)));
+        if(equalMask != 0xFFFF)
+            return (equalMask & 0xFF00) != 0xFF00 ? end - 1 : end - 2;
+    }
+    while(end-- > 0)
+        if(l[end] != r[end])
+            return end;
+    return wordCount;
+}
+#endif
+
+std::size_t findHighestDifference(const std::uint64_t *l,
+                                  const std::uint64_t *r,
+                                  std::size_t wordCount) noexcept
+{
+#if MATH_KERNELS_X86
+    if(kernelPath == KernelPath::AVX2)
+        return findHighestDifferenceAVX2(l, r, wordCount);
+    if(kernelPath == KernelPath::SSE2)
+        return findHighestDifferenceSSE2(l, r, wordCount);
+#endif
+    std::size_t end = wordCount;
+    while(end-- > 0)
+        if(l[end] != r[end])
+            return end;
+    return wordCount;
+}
+}
+
+KernelPath getBestKernelPath() noexcept
+{
+#if MATH_KERNELS_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        return KernelPath::AVX2;
+    return KernelPath::SSE2;
+#else
+    return KernelPath::Scalar;
+#endif
+}
+
+KernelPath getKernelPath() noexcept
+{
+    return kernelPath;
+}
+
+bool setKernelPath(KernelPath path) noexcept
+{
+    if(path > getBestKernelPath())
+        return false;
+    kernelPath = path;
+    return true;
+}
+
+#if MATH_KERNELS_X86
+#define MATH_BITWISE_KERNEL(name, scalarExpression, sseFunction, avxFunction)                 \
+    __attribute__((target("avx2"))) static void name##AVX2(std::uint64_t *result,            \
+                                                           const std::uint64_t *l,           \
+                                                           const std::uint64_t *r,           \
+                                                           std::size_t wordCount) noexcept   \
+    {                                                                                         \
+        std::size_t i = 0;                                                                    \
+        for(; i + 4 <= wordCount; i += 4)                                                     \
+        {                                                                                     \
+            auto lVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(l + i));     \
+            auto rVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + i));     \
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + i),                      \
+                                avxFunction(lVector, rVector));                               \
+        }                                                                                     \
+        for(; i < wordCount; i++)                                                             \
+            result[i] = scalarExpression;                                                     \
+    }                                                                                         \
+    void name(std::uint64_t *result,                                                          \
+              const std::uint64_t *l,                                                         \
+              const std::uint64_t *r,                                                         \
+              std::size_t wordCount) noexcept                                                 \
+    {                                                                                         \
+        if(kernelPath == KernelPath::AVX2)                                                    \
+            return name##AVX2(result, l, r, wordCount);                                       \
+        std::size_t i = 0;                                                                    \
+        if(kernelPath == KernelPath::SSE2)                                                    \
+        {                                                                                     \
+            for(; i + 2 <= wordCount; i += 2)                                                 \
+            {                                                                                 \
+                auto lVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(l + i));    \
+                auto rVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r + i));    \
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i),                     \
+                                 sseFunction(lVector, rVector));                              \
+            }                                                                                 \
+        }                                                                                     \
+        for(; i < wordCount; i++)                                                             \
+            result[i] = scalarExpression;                                                     \
+    }
+#else
+#define MATH_BITWISE_KERNEL(name, scalarExpression, sseFunction, avxFunction) \
+    void name(std::uint64_t *result,                                          \
+              const std::uint64_t *l,                                         \
+              const std::uint64_t *r,                                         \
+              std::size_t wordCount) noexcept                                 \
+    {                                                                         \
+        for(std::size_t i = 0; i < wordCount; i++)                            \
+            result[i] = scalarExpression;                                     \
+    }
+#endif
+
+MATH_BITWISE_KERNEL(andWords, l[i] & r[i], _mm_and_si128, _mm256_and_si256)
+MATH_BITWISE_KERNEL(orWords, l[i] | r[i], _mm_or_si128, _mm256_or_si256)
+MATH_BITWISE_KERNEL(xorWords, l[i] ^ r[i], _mm_xor_si128, _mm256_xor_si256)
+#undef MATH_BITWISE_KERNEL
+
+#if MATH_KERNELS_X86
+__attribute__((target("avx2"))) static void notWordsAVX2(std::uint64_t *result,
+                                                         const std::uint64_t *value,
+                                                         std::size_t wordCount) noexcept
+{
+    auto allOnes = _mm256_set1_epi64x(-1);
+    std::size_t i = 0;
+    for(; i + 4 <= wordCount; i += 4)
+    {
+        auto vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(value + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + i),
+                            _mm256_xor_si256(vector, allOnes));
+    }
+    for(; i < wordCount; i++)
+        result[i] = ~value[i];
+}
+#endif
+
+void notWords(std::uint64_t *result, const std::uint64_t *value, std::size_t wordCount) noexcept
+{
+    std::size_t i = 0;
+#if MATH_KERNELS_X86
+    if(kernelPath == KernelPath::AVX2)
+        return notWordsAVX2(result, value, wordCount);
+    if(kernelPath == KernelPath::SSE2)
+    {
+        auto allOnes = _mm_set1_epi32(-1);
+        for(; i + 2 <= wordCount; i += 2)
+        {
+            auto vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(value + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i),
+                             _mm_xor_si128(vector, allOnes));
+        }
+    }
+#endif
+    for(; i < wordCount; i++)
+        result[i] = ~value[i];
+}
+
+bool addWords(std::uint64_t *result,
+              const std::uint64_t *l,
+              const std::uint64_t *r,
+              std::size_t wordCount,
+              bool carry) noexcept
+{
+#if defined(__x86_64__)
+    unsigned char carryFlag = carry;
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        unsigned long long sum;
+        carryFlag = _addcarry_u64(carryFlag, l[i], r[i], &sum);
+        result[i] = sum;
+    }
+    return carryFlag;
+#else
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        std::uint64_t sum;
+        bool carry1 = __builtin_add_overflow(l[i], r[i], &sum);
+        bool carry2 = __builtin_add_overflow(sum, static_cast<std::uint64_t>(carry), &sum);
+        result[i] = sum;
+        carry = carry1 || carry2;
+    }
+    return carry;
+#endif
+}
+
+bool subtractWords(std::uint64_t *result,
+                   const std::uint64_t *l,
+                   const std::uint64_t *r,
+                   std::size_t wordCount,
+                   bool borrow) noexcept
+{
+#if defined(__x86_64__)
+    unsigned char borrowFlag = borrow;
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        unsigned long long difference;
+        borrowFlag = _subborrow_u64(borrowFlag, l[i], r[i], &difference);
+        result[i] = difference;
+    }
+    return borrowFlag;
+#else
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        std::uint64_t difference;
+        bool borrow1 = __builtin_sub_overflow(l[i], r[i], &difference);
+        bool borrow2 =
+            __builtin_sub_overflow(difference, static_cast<std::uint64_t>(borrow), &difference);
+        result[i] = difference;
+        borrow = borrow1 || borrow2;
+    }
+    return borrow;
+#endif
+}
+
+void negateWords(std::uint64_t *result, const std::uint64_t *value, std::size_t wordCount) noexcept
+{
+    bool borrow = false;
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        std::uint64_t difference;
+        bool borrow1 = __builtin_sub_overflow(static_cast<std::uint64_t>(0), value[i], &difference);
+        bool borrow2 =
+            __builtin_sub_overflow(difference, static_cast<std::uint64_t>(borrow), &difference);
+        result[i] = difference;
+        borrow = borrow1 || borrow2;
+    }
+}
+
+bool equalWords(const std::uint64_t *l, const std::uint64_t *r, std::size_t wordCount) noexcept
+{
+    return findHighestDifference(l, r, wordCount) == wordCount;
+}
+
+int compareWords(const std::uint64_t *l, const std::uint64_t *r, std::size_t wordCount) noexcept
+{
+    auto index = findHighestDifference(l, r, wordCount);
+    if(index == wordCount)
+        return 0;
+    return l[index] < r[index] ? -1 : 1;
+}
+
+std::size_t popCountWords(const std::uint64_t *value, std::size_t wordCount) noexcept
+{
+    std::size_t retval = 0;
+    for(std::size_t i = 0; i < wordCount; i++)
+        retval += __builtin_popcountll(value[i]);
+    return retval;
+}
+
+void shiftLeftWords(std::uint64_t *result,
+                    std::size_t resultWordCount,
+                    const std::uint64_t *value,
+                    std::size_t valueWordCount,
+                    std::size_t shiftCount,
+                    std::uint64_t fillWord) noexcept
+{
+    auto wordShift = shiftCount / bitsPerWord;
+    auto bitShift = shiftCount % bitsPerWord;
+    if(wordShift > resultWordCount)
+        wordShift = resultWordCount;
+    // the word of value that ends up in word index of the result, before the bit shift
+    auto getWord = [&](std::size_t index) -> std::uint64_t
+    {
+        if(index < wordShift)
+            return 0;
+        index -= wordShift;
+        return index < valueWordCount ? value[index] : fillWord;
+    };
+    // go downwards so result can be value
+    for(std::size_t i = resultWordCount; i-- > 0;)
+    {
+        if(bitShift == 0)
+            result[i] = getWord(i);
+        else
+            result[i] = getWord(i) << bitShift
+                        | (i == 0 ? 0 : getWord(i - 1) >> (bitsPerWord - bitShift));
+    }
+}
+
+void shiftRightWords(std::uint64_t *result,
+                     std::size_t resultWordCount,
+                     const std::uint64_t *value,
+                     std::size_t valueWordCount,
+                     std::size_t shiftCount,
+                     std::uint64_t fillWord) noexcept
+{
+    auto wordShift = shiftCount / bitsPerWord;
+    auto bitShift = shiftCount % bitsPerWord;
+    if(wordShift > valueWordCount)
+        wordShift = valueWordCount;
+    auto getWord = [&](std::size_t index) -> std::uint64_t
+    {
+        index += wordShift;
+        return index < valueWordCount ? value[index] : fillWord;
+    };
+    // go upwards so result can be value
+    for(std::size_t i = 0; i < resultWordCount; i++)
+    {
+        if(bitShift == 0)
+            result[i] = getWord(i);
+        else
+            result[i] = getWord(i) >> bitShift | getWord(i + 1) << (bitsPerWord - bitShift);
+    }
+}
+
+void depositBits(std::uint64_t *result,
+                 std::size_t resultWordCount,
+                 std::size_t resultBitOffset,
+                 const std::uint64_t *value,
+                 std::size_t valueWordCount,
+                 std::uint64_t fillWord,
+                 std::size_t valueBitOffset,
+                 std::size_t bitCount) noexcept
+{
+    for(std::size_t done = 0; done < bitCount; done += bitsPerWord)
+    {
+        auto word = extractWord(value, valueWordCount, fillWord, valueBitOffset + done);
+        if(bitCount - done < bitsPerWord)
+            word &= (static_cast<std::uint64_t>(1) << (bitCount - done)) - 1;
+        auto wordIndex = (resultBitOffset + done) / bitsPerWord;
+        auto bitIndex = (resultBitOffset + done) % bitsPerWord;
+        if(wordIndex >= resultWordCount)
+            break;
+        result[wordIndex] |= word << bitIndex;
+        if(bitIndex != 0 && wordIndex + 1 < resultWordCount)
+            result[wordIndex + 1] |= word >> (bitsPerWord - bitIndex);
+    }
+}
+
+// the four-state kernels handle 64 bits per word with plain bitwise operations, which the compiler
+// vectorizes well enough without hand-written intrinsics
+
+void fourStateAndWords(std::uint64_t *resultValue,
+                       std::uint64_t *resultUnknown,
+                       const std::uint64_t *lValue,
+                       const std::uint64_t *lUnknown,
+                       const std::uint64_t *rValue,
+                       const std::uint64_t *rUnknown,
+                       std::size_t wordCount) noexcept
+{
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        auto lv = lValue[i], lu = lUnknown[i], rv = rValue[i], ru = rUnknown[i];
+        // a known zero on either side makes the result a known zero
+        auto zero = (~lv & ~lu) | (~rv & ~ru);
+        auto unknown = (lu | ru) & ~zero;
+        resultValue[i] = (lv & rv) | unknown;
+        resultUnknown[i] = unknown;
+    }
+}
+
+void fourStateOrWords(std::uint64_t *resultValue,
+                      std::uint64_t *resultUnknown,
+                      const std::uint64_t *lValue,
+                      const std::uint64_t *lUnknown,
+                      const std::uint64_t *rValue,
+                      const std::uint64_t *rUnknown,
+                      std::size_t wordCount) noexcept
+{
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        auto lv = lValue[i], lu = lUnknown[i], rv = rValue[i], ru = rUnknown[i];
+        // a known one on either side makes the result a known one
+        auto one = (lv & ~lu) | (rv & ~ru);
+        auto unknown = (lu | ru) & ~one;
+        resultValue[i] = one | unknown;
+        resultUnknown[i] = unknown;
+    }
+}
+
+void fourStateXorWords(std::uint64_t *resultValue,
+                       std::uint64_t *resultUnknown,
+                       const std::uint64_t *lValue,
+                       const std::uint64_t *lUnknown,
+                       const std::uint64_t *rValue,
+                       const std::uint64_t *rUnknown,
+                       std::size_t wordCount) noexcept
+{
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        auto unknown = lUnknown[i] | rUnknown[i];
+        resultValue[i] = (lValue[i] ^ rValue[i]) | unknown;
+        resultUnknown[i] = unknown;
+    }
+}
+
+void fourStateNotWords(std::uint64_t *resultValue,
+                       std::uint64_t *resultUnknown,
+                       const std::uint64_t *value,
+                       const std::uint64_t *unknown,
+                       std::size_t wordCount) noexcept
+{
+    for(std::size_t i = 0; i < wordCount; i++)
+    {
+        auto u = unknown[i];
+        resultValue[i] = ~value[i] | u;
+        resultUnknown[i] = u;
+    }
+}
+
+bool fourStateHasKnownWords(const std::uint64_t *value,
+                            const std::uint64_t *unknown,
+                            std::size_t wordCount,
+                            std::uint64_t topWordMask,
+                            bool wantOne) noexcept
+{
+    if(wordCount == 0)
+        return false;
+    auto flip = wantOne ? 0 : ~static_cast<std::uint64_t>(0);
+    std::uint64_t found = 0;
+    for(std::size_t i = 0; i < wordCount - 1; i++)
+        found |= (value[i] ^ flip) & ~unknown[i];
+    found |= (value[wordCount - 1] ^ flip) & ~unknown[wordCount - 1] & topWordMask;
+    return found != 0;
+}
+}
+}
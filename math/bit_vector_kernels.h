@@ -0,0 +1,162 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace math
+{
+/** word-level kernels for BitVector. Values are arrays of 64-bit words, least significant word
+ * first. The bitwise kernels and the comparisons use AVX2 or SSE2 when the CPU has them and fall
+ * back to scalar loops otherwise; the carry chains and shifts are always scalar, since each word
+ * depends on its neighbor. */
+namespace kernels
+{
+constexpr std::size_t bitsPerWord = 64;
+
+/** the instruction sets the kernels can use, each faster than the one before it */
+enum class KernelPath
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/** the fastest path this build and CPU support, which is the path used by default */
+KernelPath getBestKernelPath() noexcept;
+KernelPath getKernelPath() noexcept;
+/** forces the kernels to use path, so tests can check every path on one machine. Returns false
+ * and leaves the path alone if path isn't supported. Not thread safe. */
+bool setKernelPath(KernelPath path) noexcept;
+
+void andWords(std::uint64_t *result,
+              const std::uint64_t *l,
+              const std::uint64_t *r,
+              std::size_t wordCount) noexcept;
+void orWords(std::uint64_t *result,
+             const std::uint64_t *l,
+             const std::uint64_t *r,
+             std::size_t wordCount) noexcept;
+void xorWords(std::uint64_t *result,
+              const std::uint64_t *l,
+              const std::uint64_t *r,
+              std::size_t wordCount) noexcept;
+void notWords(std::uint64_t *result, const std::uint64_t *value, std::size_t wordCount) noexcept;
+/** returns the carry out */
+bool addWords(std::uint64_t *result,
+              const std::uint64_t *l,
+              const std::uint64_t *r,
+              std::size_t wordCount,
+              bool carry = false) noexcept;
+/** returns the borrow out */
+bool subtractWords(std::uint64_t *result,
+                   const std::uint64_t *l,
+                   const std::uint64_t *r,
+                   std::size_t wordCount,
+                   bool borrow = false) noexcept;
+/** two's complement negation */
+void negateWords(std::uint64_t *result, const std::uint64_t *value, std::size_t wordCount) noexcept;
+bool equalWords(const std::uint64_t *l, const std::uint64_t *r, std::size_t wordCount) noexcept;
+/** compares l and r as unsigned integers, returning -1, 0 or 1 */
+int compareWords(const std::uint64_t *l, const std::uint64_t *r, std::size_t wordCount) noexcept;
+/** the number of one bits */
+std::size_t popCountWords(const std::uint64_t *value, std::size_t wordCount) noexcept;
+/** writes the low resultWordCount words of value shifted left by shiftCount bits, where value is
+ * extended past valueWordCount words with fillWord. result may be value. */
+void shiftLeftWords(std::uint64_t *result,
+                    std::size_t resultWordCount,
+                    const std::uint64_t *value,
+                    std::size_t valueWordCount,
+                    std::size_t shiftCount,
+                    std::uint64_t fillWord) noexcept;
+/** writes the low resultWordCount words of value shifted right by shiftCount bits, where value is
+ * extended past valueWordCount words with fillWord. result may be value. */
+void shiftRightWords(std::uint64_t *result,
+                     std::size_t resultWordCount,
+                     const std::uint64_t *value,
+                     std::size_t valueWordCount,
+                     std::size_t shiftCount,
+                     std::uint64_t fillWord) noexcept;
+/** returns the 64 bits of value starting at bitOffset, where value is extended past valueWordCount
+ * words with fillWord */
+inline std::uint64_t extractWord(const std::uint64_t *value,
+                                 std::size_t valueWordCount,
+                                 std::uint64_t fillWord,
+                                 std::size_t bitOffset) noexcept
+{
+    auto wordIndex = bitOffset / bitsPerWord;
+    auto bitIndex = bitOffset % bitsPerWord;
+    auto low = wordIndex < valueWordCount ? value[wordIndex] : fillWord;
+    if(bitIndex == 0)
+        return low;
+    auto high = wordIndex + 1 < valueWordCount ? value[wordIndex + 1] : fillWord;
+    return low >> bitIndex | high << (bitsPerWord - bitIndex);
+}
+/** ors bitCount bits of value starting at valueBitOffset into result starting at resultBitOffset.
+ * value is extended past valueWordCount words with fillWord. Bits past resultWordCount words are
+ * dropped. */
+void depositBits(std::uint64_t *result,
+                 std::size_t resultWordCount,
+                 std::size_t resultBitOffset,
+                 const std::uint64_t *value,
+                 std::size_t valueWordCount,
+                 std::uint64_t fillWord,
+                 std::size_t valueBitOffset,
+                 std::size_t bitCount) noexcept;
+
+/** the four-state kernels take each value as a value plane and an unknown plane, where an unknown
+ * bit is X if its value bit is set and Z otherwise. Unknown result bits are always X. The results
+ * may be any of the operands. */
+void fourStateAndWords(std::uint64_t *resultValue,
+                       std::uint64_t *resultUnknown,
+                       const std::uint64_t *lValue,
+                       const std::uint64_t *lUnknown,
+                       const std::uint64_t *rValue,
+                       const std::uint64_t *rUnknown,
+                       std::size_t wordCount) noexcept;
+void fourStateOrWords(std::uint64_t *resultValue,
+                      std::uint64_t *resultUnknown,
+                      const std::uint64_t *lValue,
+                      const std::uint64_t *lUnknown,
+                      const std::uint64_t *rValue,
+                      const std::uint64_t *rUnknown,
+                      std::size_t wordCount) noexcept;
+void fourStateXorWords(std::uint64_t *resultValue,
+                       std::uint64_t *resultUnknown,
+                       const std::uint64_t *lValue,
+                       const std::uint64_t *lUnknown,
+                       const std::uint64_t *rValue,
+                       const std::uint64_t *rUnknown,
+                       std::size_t wordCount) noexcept;
+void fourStateNotWords(std::uint64_t *resultValue,
+                       std::uint64_t *resultUnknown,
+                       const std::uint64_t *value,
+                       const std::uint64_t *unknown,
+                       std::size_t wordCount) noexcept;
+/** returns true if any bit is a known zero (wantOne is false) or a known one (wantOne is true),
+ * only looking at the bits of the top word that are set in topWordMask */
+bool fourStateHasKnownWords(const std::uint64_t *value,
+                            const std::uint64_t *unknown,
+                            std::size_t wordCount,
+                            std::uint64_t topWordMask,
+                            bool wantOne) noexcept;
+}
+}
@@ -0,0 +1,44 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bit_vector_view.h"
+
+namespace math
+{
+BitVector BitVectorView::toBitVector(BitVector::Kind kind) const
+{
+    BitVector retval(kind, bitCount);
+    depositInto(retval, 0);
+    retval.normalize();
+    return retval;
+}
+
+BitVector BitVectorConcatenator::finish(BitVector::Kind kind) const
+{
+    BitVector retval(kind, bitCount);
+    auto resultBitOffset = bitCount;
+    for(auto &part : parts)
+    {
+        resultBitOffset -= part.getBitCount();
+        part.depositInto(retval, resultBitOffset);
+    }
+    retval.normalize();
+    return retval;
+}
+}
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "bit_vector.h"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace math
+{
+/** a non-owning view of bitCount bits of a BitVector's words, starting at bitOffset. Bits past the
+ * viewed BitVector's words read as its sign or zero extension. The view is only valid while the
+ * BitVector is alive and unmodified. Views pay off when several parts are combined, as in
+ * BitVectorConcatenator; a lone slice still uses BitVector::slice, which already shifts straight
+ * into the result. */
+class BitVectorView final
+{
+    friend class BitVectorConcatenator;
+
+private:
+    const std::uint64_t *words;
+    std::size_t wordCount;
+    std::uint64_t fillWord;
+    std::size_t bitOffset;
+    std::size_t bitCount;
+
+private:
+    /** ors the viewed bits into result starting at resultBitOffset, which must be zero there */
+    void depositInto(BitVector &result, std::size_t resultBitOffset) const noexcept
+    {
+        kernels::depositBits(result.getWords(),
+                             result.getWordCount(),
+                             resultBitOffset,
+                             words,
+                             wordCount,
+                             fillWord,
+                             bitOffset,
+                             bitCount);
+    }
+
+public:
+    BitVectorView() noexcept : words(nullptr), wordCount(0), fillWord(0), bitOffset(0), bitCount(0)
+    {
+    }
+    explicit BitVectorView(const BitVector &value) noexcept
+        : BitVectorView(value, 0, value.getBitCount())
+    {
+    }
+    BitVectorView(const BitVector &value, std::size_t startBit, std::size_t bitCount) noexcept
+        : words(value.getWords()),
+          wordCount(value.getWordCount()),
+          fillWord(value.getFillWord()),
+          bitOffset(startBit),
+          bitCount(bitCount)
+    {
+    }
+    std::size_t getBitCount() const noexcept
+    {
+        return bitCount;
+    }
+    std::size_t getBitOffset() const noexcept
+    {
+        return bitOffset;
+    }
+    BitVectorView slice(std::size_t startBit, std::size_t bitCount) const noexcept
+    {
+        assert(startBit <= this->bitCount && bitCount <= this->bitCount - startBit);
+        auto retval = *this;
+        retval.bitOffset += startBit;
+        retval.bitCount = bitCount;
+        return retval;
+    }
+    bool getBit(std::size_t index) const noexcept
+    {
+        assert(index < bitCount);
+        return kernels::extractWord(words, wordCount, fillWord, bitOffset + index) & 1;
+    }
+    /** the 64 bits starting at bit index * 64, with the bits past getBitCount() cleared */
+    std::uint64_t getWord(std::size_t index) const noexcept
+    {
+        auto startBit = index * kernels::bitsPerWord;
+        if(startBit >= bitCount)
+            return 0;
+        auto retval = kernels::extractWord(words, wordCount, fillWord, bitOffset + startBit);
+        if(bitCount - startBit < kernels::bitsPerWord)
+            retval &= (static_cast<std::uint64_t>(1) << (bitCount - startBit)) - 1;
+        return retval;
+    }
+    /** copies the viewed bits into a new BitVector, which is sign extended if kind is signed */
+    BitVector toBitVector(BitVector::Kind kind) const;
+};
+
+/** builds the concatenation of any number of parts at once: the total bit count is known before
+ * anything is copied, and each part is written straight into its place in the result. Parts are
+ * appended most significant first, in the order of cat(a, b, c). */
+class BitVectorConcatenator final
+{
+private:
+    std::vector<BitVectorView> parts;
+    std::size_t bitCount;
+
+public:
+    BitVectorConcatenator() : parts(), bitCount(0)
+    {
+    }
+    void reserve(std::size_t partCount)
+    {
+        parts.reserve(partCount);
+    }
+    void append(const BitVectorView &part)
+    {
+        parts.push_back(part);
+        bitCount += part.getBitCount();
+    }
+    std::size_t getBitCount() const noexcept
+    {
+        return bitCount;
+    }
+    void clear() noexcept
+    {
+        parts.clear();
+        bitCount = 0;
+    }
+    BitVector finish(BitVector::Kind kind) const;
+};
+}
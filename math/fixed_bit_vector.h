@@ -0,0 +1,452 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "bit_vector.h"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace math
+{
+/** a BitVector with the bit count and kind fixed at compile time, for generated simulation code.
+ * Values up to 64 bits are a single std::uint64_t, values up to 128 bits are a single unsigned
+ * __int128, and wider values are an array of 64-bit limbs, least significant first. Like
+ * BitVector, the limbs are sign or zero extended to fill the top limb. Every loop has a
+ * compile-time trip count, so narrow values compile to plain native arithmetic. */
+template <std::size_t N, BitVector::Kind K>
+class FixedBitVector final
+{
+    template <std::size_t, BitVector::Kind>
+    friend class FixedBitVector;
+    static_assert(N > 0, "FixedBitVector must have at least one bit");
+
+public:
+    static constexpr std::size_t bitCount = N;
+    static constexpr BitVector::Kind kind = K;
+    typedef typename std::conditional<(N <= 64),
+                                      std::uint64_t,
+                                      typename std::conditional<(N <= 128),
+                                                                unsigned __int128,
+                                                                std::uint64_t>::type>::type Limb;
+    static constexpr std::size_t limbBitCount = sizeof(Limb) * 8;
+    static constexpr std::size_t limbCount = (N + limbBitCount - 1) / limbBitCount;
+
+private:
+    typedef typename std::conditional<(N > 64 && N <= 128), __int128, std::int64_t>::type
+        SignedLimb;
+    typedef std::array<Limb, limbCount> Limbs;
+    typedef std::integral_constant<bool, limbCount == 1> IsNative;
+    static constexpr bool isSigned = K == BitVector::Kind::Signed;
+    static constexpr std::size_t wordsPerLimb = limbBitCount / kernels::bitsPerWord;
+    static constexpr std::size_t topLimbShift = limbCount * limbBitCount - N;
+
+private:
+    Limbs limbs;
+
+private:
+    void normalize() noexcept
+    {
+        auto shifted = limbs[limbCount - 1] << topLimbShift;
+        if(isSigned)
+            limbs[limbCount - 1] =
+                static_cast<Limb>(static_cast<SignedLimb>(shifted) >> topLimbShift);
+        else
+            limbs[limbCount - 1] = shifted >> topLimbShift;
+    }
+    Limb getFillLimb() const noexcept
+    {
+        return isNegative() ? ~static_cast<Limb>(0) : 0;
+    }
+    /** sets the value from its 64-bit words, least significant first */
+    template <typename GetWord>
+    void setWords(GetWord getWord) noexcept
+    {
+        for(std::size_t i = 0; i < limbCount; i++)
+        {
+            Limb limb = 0;
+            for(std::size_t j = 0; j < wordsPerLimb; j++)
+                limb |= static_cast<Limb>(getWord(i * wordsPerLimb + j))
+                        << (j * kernels::bitsPerWord);
+            limbs[i] = limb;
+        }
+        normalize();
+    }
+    static std::size_t popCountLimb(Limb limb) noexcept
+    {
+        std::size_t retval = 0;
+        for(std::size_t j = 0; j < wordsPerLimb; j++)
+            retval += __builtin_popcountll(
+                static_cast<std::uint64_t>(limb >> (j * kernels::bitsPerWord)));
+        return retval;
+    }
+    /** not normalized, so the magnitude of the most negative value doesn't wrap */
+    static Limbs getMagnitude(const FixedBitVector &value) noexcept
+    {
+        if(!value.isNegative())
+            return value.limbs;
+        Limbs retval;
+        subtractLimbs(retval, Limbs(), value.limbs);
+        return retval;
+    }
+    static void multiplyLimbs(Limbs &result,
+                              const Limbs &l,
+                              const Limbs &r,
+                              std::true_type) noexcept
+    {
+        result[0] = l[0] * r[0];
+    }
+    static void multiplyLimbs(Limbs &result,
+                              const Limbs &l,
+                              const Limbs &r,
+                              std::false_type) noexcept
+    {
+        result = Limbs();
+        for(std::size_t i = 0; i < limbCount; i++)
+        {
+            Limb carry = 0;
+            for(std::size_t j = 0; i + j < limbCount; j++)
+            {
+                auto product =
+                    static_cast<unsigned __int128>(l[i]) * r[j] + result[i + j] + carry;
+                result[i + j] = static_cast<Limb>(product);
+                carry = static_cast<Limb>(product >> limbBitCount);
+            }
+        }
+    }
+    static void divideLimbs(Limbs &quotient,
+                            Limbs &remainder,
+                            const Limbs &l,
+                            const Limbs &r,
+                            std::true_type) noexcept
+    {
+        quotient[0] = l[0] / r[0];
+        remainder[0] = l[0] % r[0];
+    }
+    /** binary long division, only used for widths past 128 bits */
+    static void divideLimbs(Limbs &quotient,
+                            Limbs &remainder,
+                            const Limbs &l,
+                            const Limbs &r,
+                            std::false_type) noexcept
+    {
+        quotient = Limbs();
+        remainder = Limbs();
+        for(std::size_t bit = limbCount * limbBitCount; bit-- > 0;)
+        {
+            bool carry = remainder[limbCount - 1] >> (limbBitCount - 1);
+            for(std::size_t i = limbCount; i-- > 1;)
+                remainder[i] = remainder[i] << 1 | remainder[i - 1] >> (limbBitCount - 1);
+            remainder[0] =
+                remainder[0] << 1 | ((l[bit / limbBitCount] >> (bit % limbBitCount)) & 1);
+            if(carry || compareLimbs(remainder, r) >= 0)
+            {
+                subtractLimbs(remainder, remainder, r);
+                quotient[bit / limbBitCount] |= static_cast<Limb>(1) << (bit % limbBitCount);
+            }
+        }
+    }
+    static void subtractLimbs(Limbs &result, const Limbs &l, const Limbs &r) noexcept
+    {
+        bool borrow = false;
+        for(std::size_t i = 0; i < limbCount; i++)
+        {
+            Limb difference;
+            bool borrow1 = __builtin_sub_overflow(l[i], r[i], &difference);
+            bool borrow2 =
+                __builtin_sub_overflow(difference, static_cast<Limb>(borrow), &difference);
+            result[i] = difference;
+            borrow = borrow1 || borrow2;
+        }
+    }
+    /** compares as unsigned */
+    static int compareLimbs(const Limbs &l, const Limbs &r) noexcept
+    {
+        for(std::size_t i = limbCount; i-- > 0;)
+            if(l[i] != r[i])
+                return l[i] < r[i] ? -1 : 1;
+        return 0;
+    }
+    FixedBitVector divide(const FixedBitVector &r, bool wantRemainder) const
+    {
+        if(r.isZero())
+            throw std::domain_error("division by zero");
+        FixedBitVector quotient, remainder;
+        divideLimbs(
+            quotient.limbs, remainder.limbs, getMagnitude(*this), getMagnitude(r), IsNative());
+        if(wantRemainder)
+        {
+            remainder.normalize();
+            return isNegative() ? -remainder : remainder;
+        }
+        quotient.normalize();
+        return isNegative() != r.isNegative() ? -quotient : quotient;
+    }
+
+public:
+    FixedBitVector() noexcept : limbs()
+    {
+    }
+    /** sign or zero extends value by its own type */
+    template <typename Int, typename = typename std::enable_if<std::is_integral<Int>::value>::type>
+    explicit FixedBitVector(Int value) noexcept : limbs()
+    {
+        typedef typename std::
+            conditional<std::is_signed<Int>::value, __int128, unsigned __int128>::type ExtendedInt;
+        auto extended = static_cast<unsigned __int128>(static_cast<ExtendedInt>(value));
+        auto fillWord = value < 0 ? ~static_cast<std::uint64_t>(0) : 0;
+        setWords([&](std::size_t index) -> std::uint64_t
+                 {
+                     if(index >= 2)
+                         return fillWord;
+                     return static_cast<std::uint64_t>(extended >> (index * kernels::bitsPerWord));
+                 });
+    }
+    /** sign or zero extends or truncates value, like BitVector::cast */
+    template <std::size_t M, BitVector::Kind K2>
+    explicit FixedBitVector(const FixedBitVector<M, K2> &value) noexcept : limbs()
+    {
+        setWords([&](std::size_t index)
+                 {
+                     return value.getWord(index);
+                 });
+    }
+    explicit FixedBitVector(const BitVector &value) noexcept : limbs()
+    {
+        auto *words = value.getWords();
+        auto wordCount = value.getWordCount();
+        auto fillWord = value.isNegative() ? ~static_cast<std::uint64_t>(0) : 0;
+        setWords([&](std::size_t index)
+                 {
+                     return index < wordCount ? words[index] : fillWord;
+                 });
+    }
+    BitVector toBitVector() const
+    {
+        BitVector retval(K, N);
+        auto *words = retval.getWords();
+        for(std::size_t i = 0; i < retval.getWordCount(); i++)
+            words[i] = getWord(i);
+        retval.normalize();
+        return retval;
+    }
+    /** word index of the value sign or zero extended to any number of 64-bit words */
+    std::uint64_t getWord(std::size_t index) const noexcept
+    {
+        auto limbIndex = index / wordsPerLimb;
+        if(limbIndex >= limbCount)
+            return static_cast<std::uint64_t>(getFillLimb());
+        return static_cast<std::uint64_t>(limbs[limbIndex]
+                                          >> (index % wordsPerLimb * kernels::bitsPerWord));
+    }
+    const Limbs &getLimbs() const noexcept
+    {
+        return limbs;
+    }
+    bool isNegative() const noexcept
+    {
+        return isSigned && (limbs[limbCount - 1] >> (limbBitCount - 1)) != 0;
+    }
+    bool isZero() const noexcept
+    {
+        for(auto limb : limbs)
+            if(limb != 0)
+                return false;
+        return true;
+    }
+    std::size_t popCount() const noexcept
+    {
+        std::size_t retval = 0;
+        for(std::size_t i = 0; i + 1 < limbCount; i++)
+            retval += popCountLimb(limbs[i]);
+        auto topLimbMask = ~static_cast<Limb>(0) >> topLimbShift;
+        return retval + popCountLimb(limbs[limbCount - 1] & topLimbMask);
+    }
+    FixedBitVector operator+(const FixedBitVector &r) const noexcept
+    {
+        FixedBitVector retval;
+        bool carry = false;
+        for(std::size_t i = 0; i < limbCount; i++)
+        {
+            Limb sum;
+            bool carry1 = __builtin_add_overflow(limbs[i], r.limbs[i], &sum);
+            bool carry2 = __builtin_add_overflow(sum, static_cast<Limb>(carry), &sum);
+            retval.limbs[i] = sum;
+            carry = carry1 || carry2;
+        }
+        retval.normalize();
+        return retval;
+    }
+    FixedBitVector operator-(const FixedBitVector &r) const noexcept
+    {
+        FixedBitVector retval;
+        subtractLimbs(retval.limbs, limbs, r.limbs);
+        retval.normalize();
+        return retval;
+    }
+    FixedBitVector operator-() const noexcept
+    {
+        return FixedBitVector() - *this;
+    }
+    FixedBitVector operator*(const FixedBitVector &r) const noexcept
+    {
+        FixedBitVector retval;
+        multiplyLimbs(retval.limbs, limbs, r.limbs, IsNative());
+        retval.normalize();
+        return retval;
+    }
+    /** rounds towards zero; throws std::domain_error when dividing by zero, like BitVector */
+    FixedBitVector operator/(const FixedBitVector &r) const
+    {
+        return divide(r, false);
+    }
+    FixedBitVector operator%(const FixedBitVector &r) const
+    {
+        return divide(r, true);
+    }
+    FixedBitVector operator&(const FixedBitVector &r) const noexcept
+    {
+        FixedBitVector retval;
+        for(std::size_t i = 0; i < limbCount; i++)
+            retval.limbs[i] = limbs[i] & r.limbs[i];
+        return retval;
+    }
+    FixedBitVector operator|(const FixedBitVector &r) const noexcept
+    {
+        FixedBitVector retval;
+        for(std::size_t i = 0; i < limbCount; i++)
+            retval.limbs[i] = limbs[i] | r.limbs[i];
+        return retval;
+    }
+    FixedBitVector operator^(const FixedBitVector &r) const noexcept
+    {
+        FixedBitVector retval;
+        for(std::size_t i = 0; i < limbCount; i++)
+            retval.limbs[i] = limbs[i] ^ r.limbs[i];
+        return retval;
+    }
+    FixedBitVector operator~() const noexcept
+    {
+        FixedBitVector retval;
+        for(std::size_t i = 0; i < limbCount; i++)
+            retval.limbs[i] = ~limbs[i];
+        retval.normalize();
+        return retval;
+    }
+    FixedBitVector operator<<(std::size_t shiftCount) const noexcept
+    {
+        FixedBitVector retval;
+        if(shiftCount >= N)
+            return retval;
+        auto limbShift = shiftCount / limbBitCount;
+        auto bitShift = shiftCount % limbBitCount;
+        for(std::size_t i = limbShift; i < limbCount; i++)
+        {
+            retval.limbs[i] = limbs[i - limbShift] << bitShift;
+            if(bitShift != 0 && i > limbShift)
+                retval.limbs[i] |= limbs[i - limbShift - 1] >> (limbBitCount - bitShift);
+        }
+        retval.normalize();
+        return retval;
+    }
+    /** shifts in the sign or zero extension, so signed values round towards negative infinity */
+    FixedBitVector operator>>(std::size_t shiftCount) const noexcept
+    {
+        FixedBitVector retval;
+        auto fillLimb = getFillLimb();
+        if(shiftCount >= N)
+        {
+            retval.limbs.fill(fillLimb);
+            return retval;
+        }
+        auto limbShift = shiftCount / limbBitCount;
+        auto bitShift = shiftCount % limbBitCount;
+        auto getLimb = [&](std::size_t index)
+        {
+            return index < limbCount ? limbs[index] : fillLimb;
+        };
+        for(std::size_t i = 0; i < limbCount; i++)
+        {
+            retval.limbs[i] = getLimb(i + limbShift) >> bitShift;
+            if(bitShift != 0)
+                retval.limbs[i] |= getLimb(i + limbShift + 1) << (limbBitCount - bitShift);
+        }
+        retval.normalize();
+        return retval;
+    }
+    bool operator==(const FixedBitVector &r) const noexcept
+    {
+        return limbs == r.limbs;
+    }
+    bool operator!=(const FixedBitVector &r) const noexcept
+    {
+        return limbs != r.limbs;
+    }
+    bool operator<(const FixedBitVector &r) const noexcept
+    {
+        bool lIsNegative = isNegative();
+        if(lIsNegative != r.isNegative())
+            return lIsNegative;
+        // both are sign extended the same way, so they compare the same as unsigned
+        return compareLimbs(limbs, r.limbs) < 0;
+    }
+    bool operator>(const FixedBitVector &r) const noexcept
+    {
+        return r < *this;
+    }
+    bool operator<=(const FixedBitVector &r) const noexcept
+    {
+        return !(r < *this);
+    }
+    bool operator>=(const FixedBitVector &r) const noexcept
+    {
+        return !(*this < r);
+    }
+    /** the M bits starting at startBit, like BitVector::slice */
+    template <std::size_t M, BitVector::Kind K2>
+    FixedBitVector<M, K2> slice(std::size_t startBit) const noexcept
+    {
+        return FixedBitVector<M, K2>(*this >> startBit);
+    }
+};
+
+template <std::size_t N, BitVector::Kind K>
+constexpr std::size_t FixedBitVector<N, K>::bitCount;
+
+template <std::size_t N, BitVector::Kind K>
+constexpr BitVector::Kind FixedBitVector<N, K>::kind;
+
+template <std::size_t N, BitVector::Kind K>
+constexpr std::size_t FixedBitVector<N, K>::limbBitCount;
+
+template <std::size_t N, BitVector::Kind K>
+constexpr std::size_t FixedBitVector<N, K>::limbCount;
+
+/** high followed by low, with the kind of high, like BitVector::concatenate */
+template <std::size_t N, BitVector::Kind K, std::size_t M, BitVector::Kind K2>
+FixedBitVector<N + M, K> concatenate(const FixedBitVector<N, K> &high,
+                                     const FixedBitVector<M, K2> &low) noexcept
+{
+    typedef FixedBitVector<N + M, K> Result;
+    return (Result(high) << M)
+           | Result(FixedBitVector<M, BitVector::Kind::Unsigned>(low));
+}
+}
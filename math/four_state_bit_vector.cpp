@@ -0,0 +1,106 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "four_state_bit_vector.h"
+#include <algorithm>
+#include <cassert>
+
+namespace math
+{
+FourStateBitVector FourStateBitVector::bitwise(BitwiseKernel kernel,
+                                               Kind kind,
+                                               std::size_t bitCount,
+                                               const FourStateBitVector &l,
+                                               const FourStateBitVector &r)
+{
+    auto retval = cast(kind, bitCount, l);
+    auto extendedR = cast(kind, bitCount, r);
+    kernel(retval.value.getWords(),
+           retval.unknown.getWords(),
+           retval.value.getWords(),
+           retval.unknown.getWords(),
+           extendedR.value.getWords(),
+           extendedR.unknown.getWords(),
+           retval.value.getWordCount());
+    retval.value.normalize();
+    retval.unknown.normalize();
+    return retval;
+}
+
+FourStateBitVector FourStateBitVector::bitwiseNot(Kind kind,
+                                                  std::size_t bitCount,
+                                                  const FourStateBitVector &value)
+{
+    auto retval = cast(kind, bitCount, value);
+    kernels::fourStateNotWords(retval.value.getWords(),
+                               retval.unknown.getWords(),
+                               retval.value.getWords(),
+                               retval.unknown.getWords(),
+                               retval.value.getWordCount());
+    retval.value.normalize();
+    retval.unknown.normalize();
+    return retval;
+}
+
+bool FourStateBitVector::hasKnownBit(bool wantOne) const noexcept
+{
+    auto bitCount = getBitCount();
+    auto wordCount = (bitCount + kernels::bitsPerWord - 1) / kernels::bitsPerWord;
+    auto topWordBitCount = bitCount % kernels::bitsPerWord;
+    auto topWordMask = ~static_cast<std::uint64_t>(0);
+    if(topWordBitCount != 0)
+        topWordMask = (static_cast<std::uint64_t>(1) << topWordBitCount) - 1;
+    return kernels::fourStateHasKnownWords(
+        value.getWords(), unknown.getWords(), wordCount, topWordMask, wantOne);
+}
+
+FourStateBitVector::Bit FourStateBitVector::getBit(std::size_t index) const noexcept
+{
+    assert(index < getBitCount());
+    auto wordIndex = index / kernels::bitsPerWord;
+    auto bitIndex = index % kernels::bitsPerWord;
+    bool valueBit = (value.getWords()[wordIndex] >> bitIndex) & 1;
+    bool unknownBit = (unknown.getWords()[wordIndex] >> bitIndex) & 1;
+    if(unknownBit)
+        return valueBit ? Bit::X : Bit::Z;
+    return valueBit ? Bit::One : Bit::Zero;
+}
+
+FourStateBitVector FourStateBitVector::equal(const FourStateBitVector &l,
+                                             const FourStateBitVector &r)
+{
+    // one extra bit keeps unsigned values from matching negative ones
+    auto bitCount = std::max(l.getBitCount(), r.getBitCount()) + 1;
+    auto difference = cast(Kind::Signed, bitCount, l);
+    auto extendedR = cast(Kind::Signed, bitCount, r);
+    // xor leaves known ones exactly where known bits differ
+    kernels::fourStateXorWords(difference.value.getWords(),
+                               difference.unknown.getWords(),
+                               difference.value.getWords(),
+                               difference.unknown.getWords(),
+                               extendedR.value.getWords(),
+                               extendedR.unknown.getWords(),
+                               difference.value.getWordCount());
+    if(difference.hasKnownBit(true))
+        return fromBool(false);
+    if(difference.hasUnknownBits())
+        return allX(Kind::Unsigned, 1);
+    return fromBool(true);
+}
+}
@@ -0,0 +1,326 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "bit_vector.h"
+#include <cstdint>
+#include <utility>
+
+namespace math
+{
+/** a four-state (0, 1, X, Z) vector for simulation, stored as a value plane and an unknown plane
+ * that each use the BitVector layout. An unknown bit is X if its value bit is set and Z otherwise.
+ * Bitwise operators, reductions and compares produce X, never Z, for unknown result bits, while
+ * shifts, slice, cast and concatenate move X and Z bits along unchanged. Arithmetic on an operand
+ * with any unknown bit gives all X. */
+class FourStateBitVector final
+{
+public:
+    typedef BitVector::Kind Kind;
+    enum class Bit
+    {
+        Zero,
+        One,
+        X,
+        Z,
+    };
+
+private:
+    BitVector value;
+    BitVector unknown;
+
+private:
+    FourStateBitVector(BitVector value, BitVector unknown) noexcept
+        : value(std::move(value)), unknown(std::move(unknown))
+    {
+    }
+    template <typename Fn>
+    static FourStateBitVector twoStateOperation(Kind kind,
+                                                std::size_t bitCount,
+                                                const FourStateBitVector &l,
+                                                const FourStateBitVector &r,
+                                                Fn fn)
+    {
+        if(l.hasUnknownBits() || r.hasUnknownBits())
+            return allX(kind, bitCount);
+        return FourStateBitVector(fn(kind, bitCount, l.value, r.value));
+    }
+    typedef void (*BitwiseKernel)(std::uint64_t *resultValue,
+                                  std::uint64_t *resultUnknown,
+                                  const std::uint64_t *lValue,
+                                  const std::uint64_t *lUnknown,
+                                  const std::uint64_t *rValue,
+                                  const std::uint64_t *rUnknown,
+                                  std::size_t wordCount);
+    static FourStateBitVector bitwise(BitwiseKernel kernel,
+                                      Kind kind,
+                                      std::size_t bitCount,
+                                      const FourStateBitVector &l,
+                                      const FourStateBitVector &r);
+    /** returns true if any of the bitCount bits is a known one (wantOne is true) or a known zero
+     * (wantOne is false) */
+    bool hasKnownBit(bool wantOne) const noexcept;
+    static FourStateBitVector fromBool(bool value) noexcept
+    {
+        return FourStateBitVector(BitVector::fromBool(value));
+    }
+    static FourStateBitVector compareValues(const FourStateBitVector &l,
+                                            const FourStateBitVector &r,
+                                            bool wantLess,
+                                            bool orEqual)
+    {
+        if(l.hasUnknownBits() || r.hasUnknownBits())
+            return allX(Kind::Unsigned, 1);
+        auto result = BitVector::compare(l.value, r.value);
+        if(result == 0)
+            return fromBool(orEqual);
+        return fromBool(wantLess ? result < 0 : result > 0);
+    }
+
+public:
+    FourStateBitVector() noexcept : value(), unknown()
+    {
+    }
+    FourStateBitVector(Kind kind, std::size_t bitCount)
+        : value(kind, bitCount), unknown(kind, bitCount)
+    {
+    }
+    explicit FourStateBitVector(BitVector value)
+        : value(std::move(value)), unknown(this->value.getKind(), this->value.getBitCount())
+    {
+    }
+    /** the value of an uninitialized register */
+    static FourStateBitVector allX(Kind kind, std::size_t bitCount)
+    {
+        auto ones = BitVector::bitwiseNot(kind, bitCount, BitVector(kind, bitCount));
+        auto unknown = ones;
+        return FourStateBitVector(std::move(ones), std::move(unknown));
+    }
+    /** the value of an undriven net */
+    static FourStateBitVector allZ(Kind kind, std::size_t bitCount)
+    {
+        return FourStateBitVector(BitVector(kind, bitCount),
+                                  BitVector::bitwiseNot(kind, bitCount, BitVector(kind, bitCount)));
+    }
+    std::size_t getBitCount() const noexcept
+    {
+        return value.getBitCount();
+    }
+    Kind getKind() const noexcept
+    {
+        return value.getKind();
+    }
+    const BitVector &getValuePlane() const noexcept
+    {
+        return value;
+    }
+    const BitVector &getUnknownPlane() const noexcept
+    {
+        return unknown;
+    }
+    bool hasUnknownBits() const noexcept
+    {
+        return !unknown.isZero();
+    }
+    /** the two-state value, or nullptr if any bit is X or Z. Doesn't copy anything, so checking a
+     * settled design costs a scan of the unknown plane. */
+    const BitVector *getTwoState() const noexcept
+    {
+        return hasUnknownBits() ? nullptr : &value;
+    }
+    Bit getBit(std::size_t index) const noexcept;
+    static FourStateBitVector add(Kind kind,
+                                  std::size_t bitCount,
+                                  const FourStateBitVector &l,
+                                  const FourStateBitVector &r)
+    {
+        return twoStateOperation(kind, bitCount, l, r, BitVector::add);
+    }
+    static FourStateBitVector subtract(Kind kind,
+                                       std::size_t bitCount,
+                                       const FourStateBitVector &l,
+                                       const FourStateBitVector &r)
+    {
+        return twoStateOperation(kind, bitCount, l, r, BitVector::subtract);
+    }
+    static FourStateBitVector multiply(Kind kind,
+                                       std::size_t bitCount,
+                                       const FourStateBitVector &l,
+                                       const FourStateBitVector &r)
+    {
+        return twoStateOperation(kind, bitCount, l, r, BitVector::multiply);
+    }
+    /** dividing by zero gives all X */
+    static FourStateBitVector divide(Kind kind,
+                                     std::size_t bitCount,
+                                     const FourStateBitVector &l,
+                                     const FourStateBitVector &r)
+    {
+        if(r.value.isZero())
+            return allX(kind, bitCount);
+        return twoStateOperation(kind, bitCount, l, r, BitVector::divide);
+    }
+    static FourStateBitVector remainder(Kind kind,
+                                        std::size_t bitCount,
+                                        const FourStateBitVector &l,
+                                        const FourStateBitVector &r)
+    {
+        if(r.value.isZero())
+            return allX(kind, bitCount);
+        return twoStateOperation(kind, bitCount, l, r, BitVector::remainder);
+    }
+    static FourStateBitVector negate(Kind kind,
+                                     std::size_t bitCount,
+                                     const FourStateBitVector &value)
+    {
+        if(value.hasUnknownBits())
+            return allX(kind, bitCount);
+        return FourStateBitVector(BitVector::negate(kind, bitCount, value.value));
+    }
+    /** an unknown shift count gives all X, otherwise unknown bits are shifted along with the
+     * value */
+    static FourStateBitVector shiftLeft(Kind kind,
+                                        std::size_t bitCount,
+                                        const FourStateBitVector &l,
+                                        const FourStateBitVector &r)
+    {
+        if(r.hasUnknownBits())
+            return allX(kind, bitCount);
+        return FourStateBitVector(BitVector::shiftLeft(kind, bitCount, l.value, r.value),
+                                  BitVector::shiftLeft(kind, bitCount, l.unknown, r.value));
+    }
+    static FourStateBitVector shiftRight(Kind kind,
+                                         std::size_t bitCount,
+                                         const FourStateBitVector &l,
+                                         const FourStateBitVector &r)
+    {
+        if(r.hasUnknownBits())
+            return allX(kind, bitCount);
+        return FourStateBitVector(BitVector::shiftRight(kind, bitCount, l.value, r.value),
+                                  BitVector::shiftRight(kind, bitCount, l.unknown, r.value));
+    }
+    static FourStateBitVector bitwiseAnd(Kind kind,
+                                         std::size_t bitCount,
+                                         const FourStateBitVector &l,
+                                         const FourStateBitVector &r)
+    {
+        return bitwise(kernels::fourStateAndWords, kind, bitCount, l, r);
+    }
+    static FourStateBitVector bitwiseOr(Kind kind,
+                                        std::size_t bitCount,
+                                        const FourStateBitVector &l,
+                                        const FourStateBitVector &r)
+    {
+        return bitwise(kernels::fourStateOrWords, kind, bitCount, l, r);
+    }
+    static FourStateBitVector bitwiseXor(Kind kind,
+                                         std::size_t bitCount,
+                                         const FourStateBitVector &l,
+                                         const FourStateBitVector &r)
+    {
+        return bitwise(kernels::fourStateXorWords, kind, bitCount, l, r);
+    }
+    static FourStateBitVector bitwiseNot(Kind kind,
+                                         std::size_t bitCount,
+                                         const FourStateBitVector &value);
+    /** reduceAnd, reduceOr, reduceXor, the comparisons and the equality operators return 1-bit
+     * unsigned values. A known zero makes reduceAnd zero and a known one makes reduceOr one even
+     * if other bits are unknown. */
+    static FourStateBitVector reduceAnd(const FourStateBitVector &value)
+    {
+        if(value.hasKnownBit(false))
+            return fromBool(false);
+        if(value.hasUnknownBits())
+            return allX(Kind::Unsigned, 1);
+        return fromBool(true);
+    }
+    static FourStateBitVector reduceOr(const FourStateBitVector &value)
+    {
+        if(value.hasKnownBit(true))
+            return fromBool(true);
+        if(value.hasUnknownBits())
+            return allX(Kind::Unsigned, 1);
+        return fromBool(false);
+    }
+    static FourStateBitVector reduceXor(const FourStateBitVector &value)
+    {
+        if(value.hasUnknownBits())
+            return allX(Kind::Unsigned, 1);
+        return FourStateBitVector(BitVector::reduceXor(value.value));
+    }
+    static FourStateBitVector popCount(Kind kind,
+                                       std::size_t bitCount,
+                                       const FourStateBitVector &value)
+    {
+        if(value.hasUnknownBits())
+            return allX(kind, bitCount);
+        return FourStateBitVector(BitVector::popCount(kind, bitCount, value.value));
+    }
+    /** zero if any bit known in both operands differs, otherwise X if any bit is unknown */
+    static FourStateBitVector equal(const FourStateBitVector &l, const FourStateBitVector &r);
+    static FourStateBitVector notEqual(const FourStateBitVector &l, const FourStateBitVector &r)
+    {
+        return bitwiseNot(Kind::Unsigned, 1, equal(l, r));
+    }
+    static FourStateBitVector lessThan(const FourStateBitVector &l, const FourStateBitVector &r)
+    {
+        return compareValues(l, r, true, false);
+    }
+    static FourStateBitVector lessEqual(const FourStateBitVector &l, const FourStateBitVector &r)
+    {
+        return compareValues(l, r, true, true);
+    }
+    static FourStateBitVector greaterThan(const FourStateBitVector &l, const FourStateBitVector &r)
+    {
+        return compareValues(l, r, false, false);
+    }
+    static FourStateBitVector greaterEqual(const FourStateBitVector &l,
+                                           const FourStateBitVector &r)
+    {
+        return compareValues(l, r, false, true);
+    }
+    /** true if l and r have the same bit count and every bit, including X and Z, matches */
+    static bool identical(const FourStateBitVector &l, const FourStateBitVector &r) noexcept
+    {
+        return l.getBitCount() == r.getBitCount()
+               && BitVector::compareUnsigned(l.value, r.value) == 0
+               && BitVector::compareUnsigned(l.unknown, r.unknown) == 0;
+    }
+    static FourStateBitVector concatenate(const FourStateBitVector &l,
+                                          const FourStateBitVector &r)
+    {
+        return FourStateBitVector(BitVector::concatenate(l.value, r.value),
+                                  BitVector::concatenate(l.unknown, r.unknown));
+    }
+    static FourStateBitVector slice(Kind kind,
+                                    std::size_t bitCount,
+                                    const FourStateBitVector &value,
+                                    std::size_t startBit)
+    {
+        return FourStateBitVector(BitVector::slice(kind, bitCount, value.value, startBit),
+                                  BitVector::slice(kind, bitCount, value.unknown, startBit));
+    }
+    static FourStateBitVector cast(Kind kind, std::size_t bitCount, const FourStateBitVector &value)
+    {
+        return FourStateBitVector(BitVector::cast(kind, bitCount, value.value),
+                                  BitVector::cast(kind, bitCount, value.unknown));
+    }
+};
+}
@@ -0,0 +1,233 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gmp_integer.h"
+#include <cmath>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include "../util/string_view.h"
+
+namespace math
+{
+GMPInteger::GMPInteger(double newValue) : smallValue(0), isBig(false)
+{
+    newValue = std::trunc(newValue);
+    if(newValue >= -0x1p63 && newValue < 0x1p63)
+    {
+        smallValue = static_cast<std::int64_t>(newValue);
+        return;
+    }
+    mpz_init_set_d(&bigValue, newValue);
+    isBig = true;
+}
+
+GMPInteger::GMPInteger(unsigned long newValue) : smallValue(0), isBig(false)
+{
+    if(newValue <= static_cast<unsigned long>(std::numeric_limits<std::int64_t>::max()))
+    {
+        smallValue = static_cast<std::int64_t>(newValue);
+        return;
+    }
+    mpz_init_set_ui(&bigValue, newValue);
+    isBig = true;
+}
+
+GMPInteger::GMPInteger(const char *newValue, int base) : smallValue(0), isBig(false)
+{
+    promote();
+    if(mpz_set_str(&bigValue, newValue, base) != 0)
+        throw std::runtime_error("mpz_set_str failed: invalid number");
+    shrinkToFit();
+}
+
+void GMPInteger::promote()
+{
+    auto value = getMpz();
+    mpz_init_set(&bigValue, value);
+    isBig = true;
+}
+
+void GMPInteger::shrinkToFit() noexcept
+{
+    if(!isBig || mpz_sizeinbase(&bigValue, 2) > 63)
+        return;
+    std::uint64_t magnitude = 0;
+    for(std::size_t i = smallLimbCount; i > 0; i--)
+    {
+        magnitude = GMP_NUMB_BITS < 64 ? magnitude << (GMP_NUMB_BITS % 64) : 0;
+        magnitude |= mpz_getlimbn(&bigValue, i - 1);
+    }
+    auto value = static_cast<std::int64_t>(magnitude);
+    if(mpz_sgn(&bigValue) < 0)
+        value = -value;
+    mpz_clear(&bigValue);
+    smallValue = value;
+    isBig = false;
+}
+
+GMPInteger GMPInteger::addSlow(const GMPInteger &l, const GMPInteger &r)
+{
+    GMPInteger retval;
+    mpz_add(retval.getMutableMpz(), l.getMpz(), r.getMpz());
+    retval.shrinkToFit();
+    return retval;
+}
+
+GMPInteger GMPInteger::subtractSlow(const GMPInteger &l, const GMPInteger &r)
+{
+    GMPInteger retval;
+    mpz_sub(retval.getMutableMpz(), l.getMpz(), r.getMpz());
+    retval.shrinkToFit();
+    return retval;
+}
+
+GMPInteger GMPInteger::multiplySlow(const GMPInteger &l, const GMPInteger &r)
+{
+    GMPInteger retval;
+    mpz_mul(retval.getMutableMpz(), l.getMpz(), r.getMpz());
+    retval.shrinkToFit();
+    return retval;
+}
+
+GMPInteger GMPInteger::shiftLeftSlow(const GMPInteger &value, std::size_t shiftCount)
+{
+    GMPInteger retval;
+    mpz_mul_2exp(retval.getMutableMpz(), value.getMpz(), shiftCount);
+    retval.shrinkToFit();
+    return retval;
+}
+
+GMPInteger GMPInteger::shiftRightSlow(const GMPInteger &value, std::size_t shiftCount)
+{
+    GMPInteger retval;
+    mpz_fdiv_q_2exp(retval.getMutableMpz(), value.getMpz(), shiftCount);
+    retval.shrinkToFit();
+    return retval;
+}
+
+int GMPInteger::compareSlow(const GMPInteger &l, const GMPInteger &r) noexcept
+{
+    return mpz_cmp(l.getMpz(), r.getMpz());
+}
+
+void GMPInteger::truncateUnsignedSlow(std::size_t bitCount)
+{
+    auto value = getMutableMpz();
+    mpz_fdiv_r_2exp(value, value, bitCount);
+    shrinkToFit();
+}
+
+void GMPInteger::truncateSignedSlow(std::size_t bitCount)
+{
+    auto value = getMutableMpz();
+    if(bitCount == 0)
+    {
+        mpz_set_ui(value, 0);
+    }
+    else
+    {
+        bool isNegative = mpz_tstbit(value, bitCount - 1);
+        if(isNegative)
+            mpz_neg(value, value);
+        mpz_fdiv_r_2exp(value, value, bitCount);
+        if(isNegative)
+            mpz_neg(value, value);
+    }
+    shrinkToFit();
+}
+
+std::uint64_t GMPInteger::getLowBitsSlow(std::size_t bitCount) const noexcept
+{
+    std::uint64_t retval = 0;
+    for(std::size_t i = smallLimbCount; i > 0; i--)
+    {
+        retval = GMP_NUMB_BITS < 64 ? retval << (GMP_NUMB_BITS % 64) : 0;
+        retval |= mpz_getlimbn(&bigValue, i - 1);
+    }
+    if(mpz_sgn(&bigValue) < 0)
+        retval = 0 - retval;
+    if(bitCount < 64)
+        retval &= (static_cast<std::uint64_t>(1) << bitCount) - 1;
+    return retval;
+}
+
+void GMPInteger::write(std::ostream &os) const
+{
+    using namespace util::string_view_literals;
+    if(sign() == 0)
+    {
+        os << "0";
+        return;
+    }
+    int base = 10;
+    auto baseIndicatorUpper = ""_sv;
+    auto baseIndicatorLower = ""_sv;
+    switch(os.flags() & std::ios::basefield)
+    {
+    case std::ios::oct:
+        base = 8;
+        baseIndicatorUpper = "0"_sv;
+        baseIndicatorLower = "0"_sv;
+        break;
+    case std::ios::hex:
+        base = 16;
+        baseIndicatorUpper = "0X"_sv;
+        baseIndicatorLower = "0x"_sv;
+        break;
+    default:
+        break;
+    }
+    auto baseIndicator = ""_sv;
+    bool isUppercase = os.flags() & std::ios::uppercase;
+    if(os.flags() & std::ios::showbase)
+        baseIndicator = isUppercase ? baseIndicatorUpper : baseIndicatorLower;
+    if(!isBig)
+    {
+        // sign, base indicator, and 64 binary digits at most
+        char buffer[1 + 2 + 64 + 1];
+        char *end = buffer + sizeof(buffer);
+        char *start = end;
+        *--start = '\0';
+        auto digits = isUppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+        for(auto magnitude = getMagnitude(smallValue); magnitude != 0; magnitude /= base)
+            *--start = digits[magnitude % base];
+        for(std::size_t i = baseIndicator.size(); i > 0; i--)
+            *--start = baseIndicator[i - 1];
+        if(smallValue < 0)
+            *--start = '-';
+        os << start;
+        return;
+    }
+    if(isUppercase)
+        base = -base;
+    std::unique_ptr<char[]> buffer(
+        new char[mpz_sizeinbase(&bigValue, base) + 2 + baseIndicator.size()]);
+    for(std::size_t i = 0; i < baseIndicator.size(); i++)
+        buffer[i] = baseIndicator[i];
+    mpz_get_str(buffer.get() + baseIndicator.size(), base, &bigValue);
+    if(buffer.get()[baseIndicator.size()] == '-')
+    {
+        // put sign before base indicator
+        buffer[0] = '-';
+        for(std::size_t i = 0; i < baseIndicator.size(); i++)
+            buffer[i + 1] = baseIndicator[i];
+    }
+    os << buffer.get();
+}
+}
@@ -0,0 +1,333 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <gmp.h>
+#include <iosfwd>
+#include <limits>
+#include <utility>
+
+namespace math
+{
+/** an arbitrary-precision integer that keeps values that fit in 64 bits inline and only switches
+ * to a GMP integer when a result overflows. The arithmetic operators and comparisons have fast
+ * paths for the inline representation and switch back to it when a result fits again. */
+class GMPInteger final
+{
+private:
+    static constexpr std::size_t smallLimbCount = (64 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    union
+    {
+        std::int64_t smallValue;
+        __mpz_struct bigValue;
+    };
+    bool isBig;
+
+private:
+    struct SmallTag final
+    {
+    };
+    constexpr GMPInteger(SmallTag, std::int64_t smallValue) noexcept : smallValue(smallValue),
+                                                                       isBig(false)
+    {
+    }
+    static constexpr std::uint64_t getMagnitude(std::int64_t value) noexcept
+    {
+        return value < 0 ? 0 - static_cast<std::uint64_t>(value) :
+                           static_cast<std::uint64_t>(value);
+    }
+    static constexpr std::int64_t shiftRightSmall(std::int64_t value,
+                                                  std::size_t shiftCount) noexcept
+    {
+        return shiftCount >= 63 ? (value < 0 ? -1 : 0) :
+                                  value >= 0 ? value >> shiftCount : ~(~value >> shiftCount);
+    }
+    /** switches to the GMP representation, keeping the value */
+    void promote();
+    static GMPInteger addSlow(const GMPInteger &l, const GMPInteger &r);
+    static GMPInteger subtractSlow(const GMPInteger &l, const GMPInteger &r);
+    static GMPInteger multiplySlow(const GMPInteger &l, const GMPInteger &r);
+    static GMPInteger shiftLeftSlow(const GMPInteger &value, std::size_t shiftCount);
+    static GMPInteger shiftRightSlow(const GMPInteger &value, std::size_t shiftCount);
+    static int compareSlow(const GMPInteger &l, const GMPInteger &r) noexcept;
+    void truncateUnsignedSlow(std::size_t bitCount);
+    void truncateSignedSlow(std::size_t bitCount);
+    std::uint64_t getLowBitsSlow(std::size_t bitCount) const noexcept;
+
+public:
+    /** a read-only mpz_t view of a GMPInteger; it doesn't allocate, even for inline values */
+    class MpzView final
+    {
+        friend class GMPInteger;
+
+    private:
+        std::int64_t smallValue;
+        mp_limb_t limbs[smallLimbCount];
+        __mpz_struct readOnlyValue;
+        const __mpz_struct *value;
+
+    private:
+        void initialize() noexcept
+        {
+            auto magnitude = getMagnitude(smallValue);
+            for(auto &limb : limbs)
+            {
+                limb = static_cast<mp_limb_t>(magnitude & GMP_NUMB_MASK);
+                magnitude = GMP_NUMB_BITS < 64 ? magnitude >> (GMP_NUMB_BITS % 64) : 0;
+            }
+            mp_size_t size = smallValue < 0 ? -static_cast<mp_size_t>(smallLimbCount) :
+                                              static_cast<mp_size_t>(smallLimbCount);
+            mpz_roinit_n(&readOnlyValue, limbs, size);
+            value = &readOnlyValue;
+        }
+        explicit MpzView(const GMPInteger &integer) noexcept
+            : smallValue(integer.isBig ? 0 : integer.smallValue),
+              value(&integer.bigValue)
+        {
+            if(!integer.isBig)
+                initialize();
+        }
+
+    public:
+        MpzView(const MpzView &rt) noexcept : smallValue(rt.smallValue), value(rt.value)
+        {
+            if(rt.value == &rt.readOnlyValue)
+                initialize();
+        }
+        MpzView &operator=(const MpzView &) = delete;
+        operator mpz_srcptr() const noexcept
+        {
+            return value;
+        }
+    };
+    constexpr GMPInteger() noexcept : smallValue(0), isBig(false)
+    {
+    }
+    GMPInteger(const GMPInteger &rt) : smallValue(0), isBig(rt.isBig)
+    {
+        if(isBig)
+            mpz_init_set(&bigValue, &rt.bigValue);
+        else
+            smallValue = rt.smallValue;
+    }
+    GMPInteger(GMPInteger &&rt) noexcept : smallValue(0), isBig(false)
+    {
+        swap(*this, rt);
+    }
+    explicit GMPInteger(double newValue);
+    explicit GMPInteger(long newValue) noexcept : smallValue(newValue), isBig(false)
+    {
+    }
+    explicit GMPInteger(unsigned long newValue);
+    explicit GMPInteger(const char *newValue, int base = 0);
+    ~GMPInteger()
+    {
+        if(isBig)
+            mpz_clear(&bigValue);
+    }
+    GMPInteger &operator=(GMPInteger rt) noexcept
+    {
+        swap(*this, rt);
+        return *this;
+    }
+    friend void swap(GMPInteger &a, GMPInteger &b) noexcept
+    {
+        if(a.isBig && b.isBig)
+        {
+            mpz_swap(&a.bigValue, &b.bigValue);
+            return;
+        }
+        if(!a.isBig && !b.isBig)
+        {
+            std::swap(a.smallValue, b.smallValue);
+            return;
+        }
+        GMPInteger &big = a.isBig ? a : b;
+        GMPInteger &small = a.isBig ? b : a;
+        auto smallValue = small.smallValue;
+        small.bigValue = big.bigValue;
+        small.isBig = true;
+        big.smallValue = smallValue;
+        big.isBig = false;
+    }
+    explicit operator bool() const = delete;
+    bool isSmall() const noexcept
+    {
+        return !isBig;
+    }
+    /** precondition: isSmall() */
+    std::int64_t getSmallValue() const noexcept
+    {
+        return smallValue;
+    }
+    MpzView getMpz() const noexcept
+    {
+        return MpzView(*this);
+    }
+    /** switches to the GMP representation so the value can be modified through the GMP API. Call
+     * shrinkToFit afterwards to switch back to the inline representation if the result fits. */
+    mpz_ptr getMutableMpz()
+    {
+        if(!isBig)
+            promote();
+        return &bigValue;
+    }
+    void shrinkToFit() noexcept;
+    /** the number of bytes allocated by GMP */
+    std::size_t getHeapBytes() const noexcept
+    {
+        return isBig ? bigValue._mp_alloc * sizeof(mp_limb_t) : 0;
+    }
+    int sign() const noexcept
+    {
+        if(isBig)
+            return mpz_sgn(&bigValue);
+        return smallValue < 0 ? -1 : smallValue > 0 ? 1 : 0;
+    }
+    /** returns the low bitCount bits of the two's complement representation; bitCount <= 64 */
+    std::uint64_t getLowBits(std::size_t bitCount) const noexcept
+    {
+        if(isBig)
+            return getLowBitsSlow(bitCount);
+        auto retval = static_cast<std::uint64_t>(smallValue);
+        if(bitCount < 64)
+            retval &= (static_cast<std::uint64_t>(1) << bitCount) - 1;
+        return retval;
+    }
+    /** reduces the value modulo 2^bitCount to the range [0, 2^bitCount) */
+    void truncateUnsigned(std::size_t bitCount)
+    {
+        if(isBig || (bitCount >= 64 && smallValue < 0))
+            truncateUnsignedSlow(bitCount);
+        else if(bitCount < 64)
+            smallValue = static_cast<std::int64_t>(getLowBits(bitCount));
+    }
+    /** reduces the value modulo 2^bitCount to the range [-2^(bitCount-1), 2^(bitCount-1)) */
+    void truncateSigned(std::size_t bitCount)
+    {
+        if(isBig)
+            truncateSignedSlow(bitCount);
+        else if(bitCount == 0)
+            smallValue = 0;
+        else if(bitCount < 64)
+        {
+            auto lowBits = getLowBits(bitCount);
+            auto signBit = static_cast<std::uint64_t>(1) << (bitCount - 1);
+            if(lowBits & signBit)
+                smallValue = -static_cast<std::int64_t>((signBit << 1) - lowBits);
+            else
+                smallValue = static_cast<std::int64_t>(lowBits);
+        }
+    }
+    static int compare(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        if(!l.isBig && !r.isBig)
+            return l.smallValue < r.smallValue ? -1 : l.smallValue > r.smallValue ? 1 : 0;
+        return compareSlow(l, r);
+    }
+    friend bool operator==(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        return compare(l, r) == 0;
+    }
+    friend bool operator!=(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        return compare(l, r) != 0;
+    }
+    friend bool operator<(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        return compare(l, r) < 0;
+    }
+    friend bool operator>(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        return compare(l, r) > 0;
+    }
+    friend bool operator<=(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        return compare(l, r) <= 0;
+    }
+    friend bool operator>=(const GMPInteger &l, const GMPInteger &r) noexcept
+    {
+        return compare(l, r) >= 0;
+    }
+    friend GMPInteger operator+(const GMPInteger &l, const GMPInteger &r)
+    {
+        std::int64_t result;
+        if(!l.isBig && !r.isBig && !__builtin_add_overflow(l.smallValue, r.smallValue, &result))
+            return GMPInteger(SmallTag(), result);
+        return addSlow(l, r);
+    }
+    friend GMPInteger operator-(const GMPInteger &l, const GMPInteger &r)
+    {
+        std::int64_t result;
+        if(!l.isBig && !r.isBig && !__builtin_sub_overflow(l.smallValue, r.smallValue, &result))
+            return GMPInteger(SmallTag(), result);
+        return subtractSlow(l, r);
+    }
+    friend GMPInteger operator*(const GMPInteger &l, const GMPInteger &r)
+    {
+        std::int64_t result;
+        if(!l.isBig && !r.isBig && !__builtin_mul_overflow(l.smallValue, r.smallValue, &result))
+            return GMPInteger(SmallTag(), result);
+        return multiplySlow(l, r);
+    }
+    friend GMPInteger operator<<(const GMPInteger &value, std::size_t shiftCount)
+    {
+        if(!value.isBig && shiftCount < 63
+           && getMagnitude(value.smallValue) < static_cast<std::uint64_t>(1) << (63 - shiftCount))
+            return GMPInteger(SmallTag(),
+                              value.smallValue * (static_cast<std::int64_t>(1) << shiftCount));
+        return shiftLeftSlow(value, shiftCount);
+    }
+    /** rounds towards negative infinity, like an arithmetic shift */
+    friend GMPInteger operator>>(const GMPInteger &value, std::size_t shiftCount)
+    {
+        if(!value.isBig)
+            return GMPInteger(SmallTag(), shiftRightSmall(value.smallValue, shiftCount));
+        return shiftRightSlow(value, shiftCount);
+    }
+    GMPInteger &operator+=(const GMPInteger &rt)
+    {
+        return *this = *this + rt;
+    }
+    GMPInteger &operator-=(const GMPInteger &rt)
+    {
+        return *this = *this - rt;
+    }
+    GMPInteger &operator*=(const GMPInteger &rt)
+    {
+        return *this = *this * rt;
+    }
+    GMPInteger &operator<<=(std::size_t shiftCount)
+    {
+        return *this = *this << shiftCount;
+    }
+    GMPInteger &operator>>=(std::size_t shiftCount)
+    {
+        return *this = *this >> shiftCount;
+    }
+    void write(std::ostream &os) const;
+    friend std::ostream &operator<<(std::ostream &os, const GMPInteger &value)
+    {
+        value.write(os);
+        return os;
+    }
+};
+}
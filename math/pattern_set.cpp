@@ -0,0 +1,305 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pattern_set.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace math
+{
+constexpr PatternSet::NodeIndex PatternSet::falseNode;
+constexpr PatternSet::NodeIndex PatternSet::trueNode;
+
+PatternSet::PatternSet(std::size_t bitCount)
+    : bitCount(bitCount), levelBits(), nodes(), uniqueNodes(), root(falseNode)
+{
+    assert(bitCount < std::numeric_limits<std::uint32_t>::max());
+    levelBits.reserve(bitCount);
+    for(std::size_t level = 0; level < bitCount; level++)
+        levelBits.push_back(static_cast<std::uint32_t>(bitCount - 1 - level));
+    auto terminalLevel = static_cast<std::uint32_t>(bitCount);
+    nodes.push_back(Node{terminalLevel, falseNode, falseNode});
+    nodes.push_back(Node{terminalLevel, trueNode, trueNode});
+}
+
+PatternSet::PatternSet(std::size_t bitCount, const std::vector<GMPInteger> &masks)
+    : PatternSet(bitCount)
+{
+    std::vector<std::size_t> fixedCounts(bitCount);
+    for(auto &mask : masks)
+    {
+        auto maskMpzView = mask.getMpz();
+        mpz_srcptr maskMpz = maskMpzView;
+        for(std::size_t bit = 0; bit < bitCount; bit++)
+            if(mpz_tstbit(maskMpz, bit))
+                fixedCounts[bit]++;
+    }
+    std::stable_sort(levelBits.begin(),
+                     levelBits.end(),
+                     [&](std::uint32_t a, std::uint32_t b)
+                     {
+                         return fixedCounts[a] > fixedCounts[b];
+                     });
+}
+
+PatternSet::NodeIndex PatternSet::makeNode(std::uint32_t level, NodeIndex low, NodeIndex high)
+{
+    if(low == high)
+        return low;
+    Node node{level, low, high};
+    auto iter = uniqueNodes.find(node);
+    if(iter != uniqueNodes.end())
+        return iter->second;
+    auto retval = static_cast<NodeIndex>(nodes.size());
+    nodes.push_back(node);
+    uniqueNodes.emplace(node, retval);
+    return retval;
+}
+
+PatternSet::NodeIndex PatternSet::unionNodes(NodeIndex l,
+                                             NodeIndex r,
+                                             std::unordered_map<std::uint64_t, NodeIndex> &cache)
+{
+    if(l == trueNode || r == trueNode)
+        return trueNode;
+    if(l == falseNode || l == r)
+        return r;
+    if(r == falseNode)
+        return l;
+    if(l > r)
+        std::swap(l, r);
+    auto key = static_cast<std::uint64_t>(l) << 32 | r;
+    auto iter = cache.find(key);
+    if(iter != cache.end())
+        return iter->second;
+    auto lNode = nodes[l];
+    auto rNode = nodes[r];
+    auto level = std::min(lNode.level, rNode.level);
+    auto lLow = lNode.level == level ? lNode.low : l;
+    auto lHigh = lNode.level == level ? lNode.high : l;
+    auto rLow = rNode.level == level ? rNode.low : r;
+    auto rHigh = rNode.level == level ? rNode.high : r;
+    auto low = unionNodes(lLow, rLow, cache);
+    auto high = unionNodes(lHigh, rHigh, cache);
+    auto retval = makeNode(level, low, high);
+    cache.emplace(key, retval);
+    return retval;
+}
+
+bool PatternSet::canMatch(std::size_t bitCount, const GMPInteger &value, const GMPInteger &mask)
+{
+    // bits past bitCount are zero in every value, so a pattern requiring a one there never matches
+    mpz_t requiredBits;
+    mpz_init(requiredBits);
+    mpz_and(requiredBits, value.getMpz(), mask.getMpz());
+    mpz_fdiv_q_2exp(requiredBits, requiredBits, bitCount);
+    bool retval = mpz_sgn(requiredBits) == 0;
+    mpz_clear(requiredBits);
+    return retval;
+}
+
+bool PatternSet::makeCube(Cube &cube, const GMPInteger &value, const GMPInteger &mask) const
+{
+    auto valueMpzView = value.getMpz();
+    auto maskMpzView = mask.getMpz();
+    mpz_srcptr valueMpz = valueMpzView;
+    mpz_srcptr maskMpz = maskMpzView;
+    if(!canMatch(bitCount, value, mask))
+        return false;
+    cube.resize(bitCount);
+    for(std::size_t level = 0; level < bitCount; level++)
+    {
+        auto bit = levelBits[level];
+        if(!mpz_tstbit(maskMpz, bit))
+            cube[level] = Literal::Any;
+        else if(mpz_tstbit(valueMpz, bit))
+            cube[level] = Literal::One;
+        else
+            cube[level] = Literal::Zero;
+    }
+    return true;
+}
+
+PatternSet::NodeIndex PatternSet::makeCubeNode(const Cube &cube)
+{
+    NodeIndex retval = trueNode;
+    for(std::size_t level = bitCount; level-- > 0;)
+    {
+        switch(cube[level])
+        {
+        case Literal::Zero:
+            retval = makeNode(static_cast<std::uint32_t>(level), retval, falseNode);
+            break;
+        case Literal::One:
+            retval = makeNode(static_cast<std::uint32_t>(level), falseNode, retval);
+            break;
+        case Literal::Any:
+            break;
+        }
+    }
+    return retval;
+}
+
+bool PatternSet::covers(NodeIndex node,
+                        const Cube &cube,
+                        std::unordered_map<NodeIndex, bool> &cache) const
+{
+    if(node == trueNode || node == falseNode)
+        return node == trueNode;
+    auto iter = cache.find(node);
+    if(iter != cache.end())
+        return iter->second;
+    auto &nodeValue = nodes[node];
+    bool retval = false;
+    switch(cube[nodeValue.level])
+    {
+    case Literal::Zero:
+        retval = covers(nodeValue.low, cube, cache);
+        break;
+    case Literal::One:
+        retval = covers(nodeValue.high, cube, cache);
+        break;
+    case Literal::Any:
+        retval = covers(nodeValue.low, cube, cache) && covers(nodeValue.high, cube, cache);
+        break;
+    }
+    cache.emplace(node, retval);
+    return retval;
+}
+
+bool PatternSet::overlaps(NodeIndex node,
+                          const Cube &cube,
+                          std::unordered_map<NodeIndex, bool> &cache) const
+{
+    if(node == trueNode || node == falseNode)
+        return node == trueNode;
+    auto iter = cache.find(node);
+    if(iter != cache.end())
+        return iter->second;
+    auto &nodeValue = nodes[node];
+    bool retval = false;
+    switch(cube[nodeValue.level])
+    {
+    case Literal::Zero:
+        retval = overlaps(nodeValue.low, cube, cache);
+        break;
+    case Literal::One:
+        retval = overlaps(nodeValue.high, cube, cache);
+        break;
+    case Literal::Any:
+        retval = overlaps(nodeValue.low, cube, cache) || overlaps(nodeValue.high, cube, cache);
+        break;
+    }
+    cache.emplace(node, retval);
+    return retval;
+}
+
+void PatternSet::insert(const GMPInteger &value, const GMPInteger &mask)
+{
+    Cube cube;
+    if(!makeCube(cube, value, mask))
+        return;
+    auto cubeNode = makeCubeNode(cube);
+    std::unordered_map<std::uint64_t, NodeIndex> cache;
+    root = unionNodes(root, cubeNode, cache);
+}
+
+bool PatternSet::covers(const GMPInteger &value, const GMPInteger &mask) const
+{
+    Cube cube;
+    if(!makeCube(cube, value, mask))
+        return true;
+    std::unordered_map<NodeIndex, bool> cache;
+    return covers(root, cube, cache);
+}
+
+bool PatternSet::overlaps(const GMPInteger &value, const GMPInteger &mask) const
+{
+    Cube cube;
+    if(!makeCube(cube, value, mask))
+        return false;
+    std::unordered_map<NodeIndex, bool> cache;
+    return overlaps(root, cube, cache);
+}
+
+bool PatternSet::findMissingValue(GMPInteger &value) const
+{
+    if(root == trueNode)
+        return false;
+    value = GMPInteger();
+    auto *mpz = value.getMutableMpz();
+    // taking the low branch whenever it isn't full gives the smallest missing value
+    auto node = root;
+    while(node != falseNode)
+    {
+        auto &nodeValue = nodes[node];
+        if(nodeValue.low != trueNode)
+        {
+            node = nodeValue.low;
+            continue;
+        }
+        mpz_setbit(mpz, levelBits[nodeValue.level]);
+        node = nodeValue.high;
+    }
+    value.shrinkToFit();
+    return true;
+}
+
+bool PatternSet::patternsOverlap(std::size_t bitCount,
+                                 const GMPInteger &value1,
+                                 const GMPInteger &mask1,
+                                 const GMPInteger &value2,
+                                 const GMPInteger &mask2)
+{
+    if(!canMatch(bitCount, value1, mask1) || !canMatch(bitCount, value2, mask2))
+        return false;
+    auto value1MpzView = value1.getMpz(), mask1MpzView = mask1.getMpz();
+    auto value2MpzView = value2.getMpz(), mask2MpzView = mask2.getMpz();
+    mpz_srcptr value1Mpz = value1MpzView, mask1Mpz = mask1MpzView;
+    mpz_srcptr value2Mpz = value2MpzView, mask2Mpz = mask2MpzView;
+    for(std::size_t bit = 0; bit < bitCount; bit++)
+        if(mpz_tstbit(mask1Mpz, bit) && mpz_tstbit(mask2Mpz, bit)
+           && mpz_tstbit(value1Mpz, bit) != mpz_tstbit(value2Mpz, bit))
+            return false;
+    return true;
+}
+
+bool PatternSet::patternSubsumes(std::size_t bitCount,
+                                 const GMPInteger &value1,
+                                 const GMPInteger &mask1,
+                                 const GMPInteger &value2,
+                                 const GMPInteger &mask2)
+{
+    if(!canMatch(bitCount, value2, mask2))
+        return true;
+    if(!canMatch(bitCount, value1, mask1))
+        return false;
+    auto value1MpzView = value1.getMpz(), mask1MpzView = mask1.getMpz();
+    auto value2MpzView = value2.getMpz(), mask2MpzView = mask2.getMpz();
+    mpz_srcptr value1Mpz = value1MpzView, mask1Mpz = mask1MpzView;
+    mpz_srcptr value2Mpz = value2MpzView, mask2Mpz = mask2MpzView;
+    for(std::size_t bit = 0; bit < bitCount; bit++)
+        if(mpz_tstbit(mask1Mpz, bit)
+           && (!mpz_tstbit(mask2Mpz, bit)
+               || mpz_tstbit(value1Mpz, bit) != mpz_tstbit(value2Mpz, bit)))
+            return false;
+    return true;
+}
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gmp_integer.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace math
+{
+/** a set of bitCount-bit values built from value/mask patterns, stored as a reduced ordered binary
+ * decision diagram. A pattern matches the values whose bits under mask equal the bits of value,
+ * like parse::Token::IntegerValue. Adding a pattern and each query take time proportional to the
+ * part of the diagram the pattern's fixed bits select instead of comparing against every pattern
+ * so far. The diagram stays small when the bits most patterns fix are tested first, so construct
+ * the set from the masks of the patterns that will be inserted when they are known.
+ *
+ * to find the unreachable arms of a match statement, check covers() for each arm's patterns
+ * before inserting them; the match is exhaustive if isFull() after inserting every arm. */
+class PatternSet final
+{
+public:
+    typedef std::uint32_t NodeIndex;
+
+private:
+    struct Node final
+    {
+        /** the level tested, from 0 for the first bit tested; bitCount for the terminals */
+        std::uint32_t level;
+        NodeIndex low;
+        NodeIndex high;
+    };
+    struct NodeHasher final
+    {
+        std::size_t operator()(const Node &node) const noexcept
+        {
+            return (static_cast<std::size_t>(node.level) * 0x9E3779B97F4A7C15ULL
+                    ^ static_cast<std::size_t>(node.low) * 0x100000001B3ULL)
+                   + node.high;
+        }
+    };
+    struct NodeEqual final
+    {
+        bool operator()(const Node &l, const Node &r) const noexcept
+        {
+            return l.level == r.level && l.low == r.low && l.high == r.high;
+        }
+    };
+    /** the bit each level of a pattern requires */
+    enum class Literal : std::uint8_t
+    {
+        Zero,
+        One,
+        Any,
+    };
+    /** the literals of a pattern by level */
+    typedef std::vector<Literal> Cube;
+    static constexpr NodeIndex falseNode = 0;
+    static constexpr NodeIndex trueNode = 1;
+
+private:
+    std::size_t bitCount;
+    /** the bit index tested at each level */
+    std::vector<std::uint32_t> levelBits;
+    std::vector<Node> nodes;
+    std::unordered_map<Node, NodeIndex, NodeHasher, NodeEqual> uniqueNodes;
+    NodeIndex root;
+
+private:
+    NodeIndex makeNode(std::uint32_t level, NodeIndex low, NodeIndex high);
+    NodeIndex unionNodes(NodeIndex l,
+                         NodeIndex r,
+                         std::unordered_map<std::uint64_t, NodeIndex> &cache);
+    /** returns false if the pattern can't match any bitCount-bit value */
+    static bool canMatch(std::size_t bitCount, const GMPInteger &value, const GMPInteger &mask);
+    bool makeCube(Cube &cube, const GMPInteger &value, const GMPInteger &mask) const;
+    NodeIndex makeCubeNode(const Cube &cube);
+    bool covers(NodeIndex node,
+                const Cube &cube,
+                std::unordered_map<NodeIndex, bool> &cache) const;
+    bool overlaps(NodeIndex node,
+                  const Cube &cube,
+                  std::unordered_map<NodeIndex, bool> &cache) const;
+
+public:
+    /** tests the most significant bit first */
+    explicit PatternSet(std::size_t bitCount);
+    /** tests the bits fixed by the most masks first */
+    PatternSet(std::size_t bitCount, const std::vector<GMPInteger> &masks);
+    std::size_t getBitCount() const noexcept
+    {
+        return bitCount;
+    }
+    /** the number of decision nodes, not counting the two terminals */
+    std::size_t getNodeCount() const noexcept
+    {
+        return nodes.size() - 2;
+    }
+    bool isEmpty() const noexcept
+    {
+        return root == falseNode;
+    }
+    /** true if every bitCount-bit value is in the set */
+    bool isFull() const noexcept
+    {
+        return root == trueNode;
+    }
+    void insert(const GMPInteger &value, const GMPInteger &mask);
+    /** true if the set contains every value the pattern matches, so a match arm with the pattern
+     * after the arms in the set is unreachable */
+    bool covers(const GMPInteger &value, const GMPInteger &mask) const;
+    /** true if the set contains any value the pattern matches */
+    bool overlaps(const GMPInteger &value, const GMPInteger &mask) const;
+    bool contains(const GMPInteger &value) const
+    {
+        return overlaps(value, GMPInteger(-1L));
+    }
+    /** returns true and sets value to a value not in the set, or returns false if the set is
+     * full. The value is the smallest missing value if the most significant bit is tested
+     * first. */
+    bool findMissingValue(GMPInteger &value) const;
+    /** true if some value matches both patterns */
+    static bool patternsOverlap(std::size_t bitCount,
+                                const GMPInteger &value1,
+                                const GMPInteger &mask1,
+                                const GMPInteger &value2,
+                                const GMPInteger &mask2);
+    /** true if every value matching the second pattern matches the first */
+    static bool patternSubsumes(std::size_t bitCount,
+                                const GMPInteger &value1,
+                                const GMPInteger &mask1,
+                                const GMPInteger &value2,
+                                const GMPInteger &mask2);
+};
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "import_loader.h"
+#include "../ast/import.h"
+#include "../ast/interface_summary.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace parse
+{
+namespace
+{
+struct FileModificationTime final
+{
+    bool exists;
+    std::int64_t seconds;
+    std::int64_t nanoseconds;
+    friend bool operator<(const FileModificationTime &a, const FileModificationTime &b) noexcept
+    {
+        if(a.seconds != b.seconds)
+            return a.seconds < b.seconds;
+        return a.nanoseconds < b.nanoseconds;
+    }
+};
+
+FileModificationTime getFileModificationTime(const std::string &fileName) noexcept
+{
+    struct stat statResult;
+    if(::stat(fileName.c_str(), &statResult) != 0)
+        return {false, 0, 0};
+#if defined(__APPLE__)
+    return {true, statResult.st_mtimespec.tv_sec, statResult.st_mtimespec.tv_nsec};
+#elif defined(__unix__)
+    return {true, statResult.st_mtim.tv_sec, statResult.st_mtim.tv_nsec};
+#else
+    return {true, statResult.st_mtime, 0};
+#endif
+}
+}
+
+ast::TopLevelModule *ImportLoader::loadImport(util::StringPool::Entry name)
+{
+    auto iter = loadedModules.find(name);
+    if(iter != loadedModules.end())
+        return std::get<1>(*iter);
+    // insert first so import cycles terminate
+    auto &retval = loadedModules[name];
+    retval = nullptr;
+    for(auto &directory : searchPath)
+    {
+        std::string sourceFileName = directory + "/" + static_cast<std::string>(*name) + ".hdl";
+        std::string summaryFileName = getSummaryFileName(sourceFileName);
+        auto sourceTime = getFileModificationTime(sourceFileName);
+        auto summaryTime = getFileModificationTime(summaryFileName);
+        std::unique_ptr<Source> summary;
+        if(summaryTime.exists && (!sourceTime.exists || sourceTime < summaryTime))
+        {
+            summary = Source::makeSourceFromFile(summaryFileName);
+            // a summary written in another format is regenerated, unless there's no source to
+            // regenerate it from
+            if(sourceTime.exists && !ast::isCurrentInterfaceSummary(summary->text()))
+                summary = nullptr;
+        }
+        if(summary)
+        {
+            sources.push_back(std::move(summary));
+            retval = parseTopLevelModule(context, sources.back().get(), errorHandler);
+        }
+        else if(sourceTime.exists)
+        {
+            sources.push_back(Source::makeSourceFromFile(sourceFileName));
+            retval = parseTopLevelModule(context, sources.back().get(), errorHandler);
+            if(retval)
+            {
+                // the summary is just a cache, so failing to write it isn't an error. Write to a
+                // temporary file first so a partially written summary is never newer than the
+                // source.
+                std::string temporaryFileName = summaryFileName + ".tmp";
+                std::ofstream os(temporaryFileName);
+                ast::writeInterfaceSummary(os, retval);
+                os.close();
+                if(os)
+                    std::rename(temporaryFileName.c_str(), summaryFileName.c_str());
+                else
+                    std::remove(temporaryFileName.c_str());
+            }
+        }
+        else
+        {
+            continue;
+        }
+        if(retval)
+            resolveImports(retval);
+        return retval;
+    }
+    return nullptr;
+}
+
+void ImportLoader::resolveImports(ast::TopLevelModule *topLevelModule)
+{
+    for(auto *import : topLevelModule->imports)
+        import->importedModule = loadImport(import->name);
+}
+}
@@ -0,0 +1,71 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "parser.h"
+#include "source.h"
+#include "../ast/context.h"
+#include "../ast/top_level_module.h"
+#include "../util/string_pool.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parse
+{
+/** finds the file for each import as <directory>/<name>.hdl in the search path and links it to
+ * Import::importedModule. Importers only need the interface of a module, so after parsing a source
+ * file its interface summary is written to <name>.hdli, which is loaded instead of the source the
+ * next time as long as it's newer and in the current summary format. */
+class ImportLoader final
+{
+public:
+    typedef std::function<void(LocationRange locationRange, std::string message)> ErrorHandler;
+
+private:
+    ast::Context &context;
+    std::vector<std::string> searchPath;
+    ErrorHandler errorHandler;
+    std::vector<std::unique_ptr<Source>> sources;
+    std::unordered_map<util::StringPool::Entry, ast::TopLevelModule *> loadedModules;
+
+public:
+    explicit ImportLoader(ast::Context &context,
+                          std::vector<std::string> searchPath,
+                          ErrorHandler errorHandler = defaultParseErrorHandler)
+        : context(context),
+          searchPath(std::move(searchPath)),
+          errorHandler(std::move(errorHandler))
+    {
+    }
+    ImportLoader(const ImportLoader &) = delete;
+    ImportLoader &operator=(const ImportLoader &) = delete;
+    static std::string getSummaryFileName(const std::string &sourceFileName)
+    {
+        return sourceFileName + "i";
+    }
+    /** returns nullptr if the import can't be found or it failed to parse */
+    ast::TopLevelModule *loadImport(util::StringPool::Entry name);
+    /** loads the imports of topLevelModule and, transitively, their imports */
+    void resolveImports(ast::TopLevelModule *topLevelModule);
+};
+}
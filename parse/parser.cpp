@@ -21,6 +21,7 @@
 #include "token.h"
 #include "tokenizer.h"
 #include "../ast/ast.h"
+#include "../ast/snapshot.h"
 #include <cassert>
 #include <utility>
 #include <type_traits>
@@ -45,6 +46,10 @@ struct Parser
     {
         return context.arena.create<T>(std::forward<Args>(args)...);
     }
+    util::StringPool::Entry intern(const Token &token)
+    {
+        return context.stringPool.intern(token.getText(), token.getTextHash());
+    }
     ast::SymbolLookupChain currentSymbolLookupChain;
     ast::SymbolLookupChain globalSymbolLookupChain;
     template <typename T>
@@ -158,6 +163,9 @@ struct Parser
             nullptr, ast::SymbolTable::getGlobalSymbolTable(context)));
         currentSymbolLookupChain = globalSymbolLookupChain;
         auto pushedSymbolLookupChain = makePushNewSymbolTable();
+        // names starting with :: are looked up from this file's top level, where its main module
+        // and imports are
+        globalSymbolLookupChain = currentSymbolLookupChain;
         Location startLocation = peek().token.locationRange.begin();
         std::vector<ast::Import *> imports;
         while(peek().token.type == TokenType::Import)
@@ -186,7 +194,7 @@ struct Parser
                                 importKeyword.comments,
                                 importName.comments,
                                 importName.token.locationRange,
-                                context.stringPool.intern(importName.token.getText()),
+                                intern(importName.token),
                                 finalSemicolon.comments));
     }
     ast::Module *parseModule()
@@ -218,7 +226,7 @@ struct Parser
                                 moduleKeyword.comments,
                                 moduleName.comments,
                                 moduleName.token.locationRange,
-                                context.stringPool.intern(moduleName.token.getText()),
+                                intern(moduleName.token),
                                 templateParameters,
                                 implementsKeyword.comments,
                                 parentType,
@@ -280,7 +288,7 @@ struct Parser
                 typeToken.comments,
                 nameToken.comments,
                 nameToken.token.locationRange,
-                context.stringPool.intern(nameToken.token.getText()),
+                intern(nameToken.token),
                 implementsKeyword.comments,
                 parentType,
                 dotDotDotToken.comments,
@@ -304,7 +312,7 @@ struct Parser
                 locationRange,
                 nameToken.comments,
                 nameToken.token.locationRange,
-                context.stringPool.intern(nameToken.token.getText()),
+                intern(nameToken.token),
                 colonToken.comments,
                 valueType,
                 dotDotDotToken.comments,
@@ -345,7 +353,7 @@ struct Parser
                                    interfaceKeyword.comments,
                                    interfaceName.comments,
                                    interfaceName.token.locationRange,
-                                   context.stringPool.intern(interfaceName.token.getText()),
+                                   intern(interfaceName.token),
                                    templateParameters,
                                    implementsKeyword.comments,
                                    parentType,
@@ -384,7 +392,7 @@ struct Parser
                 create<ast::EnumPart>(locationRange,
                                       enumValueName.comments,
                                       enumValueName.token.locationRange,
-                                      context.stringPool.intern(enumValueName.token.getText()),
+                                      intern(enumValueName.token),
                                       equalToken.comments,
                                       value);
             insertSymbolInCurrentScopeOrReportError(enumPart);
@@ -406,7 +414,7 @@ struct Parser
                                          enumKeyword.comments,
                                          enumName.comments,
                                          enumName.token.locationRange,
-                                         context.stringPool.intern(enumName.token.getText()),
+                                         intern(enumName.token),
                                          colonToken.comments,
                                          underlyingType,
                                          openingLBrace.comments,
@@ -458,7 +466,7 @@ struct Parser
                                   functionKeyword.comments,
                                   functionName.comments,
                                   functionName.token.locationRange,
-                                  context.stringPool.intern(functionName.token.getText()),
+                                  intern(functionName.token),
                                   templateParameters,
                                   openingLParen.comments,
                                   firstParameter,
@@ -482,7 +490,7 @@ struct Parser
             create<ast::FunctionParameter>(locationRange,
                                            parameterName.comments,
                                            parameterName.token.locationRange,
-                                           context.stringPool.intern(parameterName.token.getText()),
+                                           intern(parameterName.token),
                                            colonToken.comments,
                                            type));
     }
@@ -523,7 +531,7 @@ struct Parser
                                            typeKeyword.comments,
                                            typeName.comments,
                                            typeName.token.locationRange,
-                                           context.stringPool.intern(typeName.token.getText()),
+                                           intern(typeName.token),
                                            equalToken.comments,
                                            type,
                                            finalSemicolon.comments));
@@ -651,7 +659,7 @@ struct Parser
                         typeName.token.locationRange,
                         typeName.comments,
                         typeName.token.locationRange,
-                        context.stringPool.intern(typeName.token.getText()),
+                        intern(typeName.token),
                         nullptr));
                 auto inKeyword = matchAndGet(TokenType::In);
                 auto *type = parseType();
@@ -680,7 +688,7 @@ struct Parser
                     variableName.token.locationRange,
                     variableName.comments,
                     variableName.token.locationRange,
-                    context.stringPool.intern(variableName.token.getText()),
+                    intern(variableName.token),
                     nullptr));
             auto inKeyword = matchAndGet(TokenType::In);
             auto *firstExpression = parseExpression();
@@ -809,7 +817,7 @@ struct Parser
             create<ast::ConstStatementPart>(locationRange,
                                             constName.comments,
                                             constName.token.locationRange,
-                                            context.stringPool.intern(constName.token.getText()),
+                                            intern(constName.token),
                                             equalToken.comments,
                                             expression));
     }
@@ -880,7 +888,7 @@ struct Parser
             create<ast::LetStatementName>(idToken.token.locationRange,
                                           idToken.comments,
                                           idToken.token.locationRange,
-                                          context.stringPool.intern(idToken.token.getText())));
+                                          intern(idToken.token)));
     }
     ast::InputOutputStatementPart *parseInputOutputStatementPart(bool isInput)
     {
@@ -909,7 +917,7 @@ struct Parser
             idToken.token.locationRange,
             idToken.comments,
             idToken.token.locationRange,
-            context.stringPool.intern(idToken.token.getText())));
+            intern(idToken.token)));
     }
     ast::RegStatementPart *parseRegStatementPart()
     {
@@ -946,7 +954,7 @@ struct Parser
             locationRange,
             regName.comments,
             regName.token.locationRange,
-            context.stringPool.intern(regName.token.getText()),
+            intern(regName.token),
             equalToken.comments,
             initializer));
     }
@@ -1231,7 +1239,7 @@ struct Parser
                     dotToken.comments,
                     memberName.comments,
                     memberName.token.locationRange,
-                    context.stringPool.intern(memberName.token.getText()));
+                    intern(memberName.token));
             }
             else
             {
@@ -1706,7 +1714,7 @@ struct Parser
             hasInitialColonColon,
             initialName.comments,
             initialName.token.locationRange,
-            context.stringPool.intern(initialName.token.getText()),
+            intern(initialName.token),
             initialTemplateArguments,
             hasInitialColonColon ? globalSymbolLookupChain : currentSymbolLookupChain);
         while(peek().token.type == TokenType::ColonColon)
@@ -1726,7 +1734,7 @@ struct Parser
                                            true,
                                            name.comments,
                                            name.token.locationRange,
-                                           context.stringPool.intern(name.token.getText()),
+                                           intern(name.token),
                                            templateArguments,
                                            ast::SymbolLookupChain());
         }
@@ -1938,7 +1946,7 @@ struct Parser
                         auto *type = parseType();
                         return {name.comments,
                                 name.token.locationRange,
-                                context.stringPool.intern(name.token.getText()),
+                                intern(name.token),
                                 colonToken.comments,
                                 type};
                     }
@@ -2076,4 +2084,34 @@ ast::TopLevelModule *parseTopLevelModule(
         return nullptr;
     }
 }
+
+ast::TopLevelModule *parseTopLevelModuleWithSnapshot(
+    ast::Context &context,
+    const Source *source,
+    const std::string &snapshotFileName,
+    std::function<void(LocationRange locationRange, std::string message)> errorHandler)
+{
+    try
+    {
+        auto *retval = ast::loadSnapshotFile(context, source, snapshotFileName);
+        if(retval)
+            return retval;
+    }
+    catch(std::runtime_error &)
+    {
+        // a missing or corrupt snapshot just means we have to parse
+    }
+    auto *retval = parseTopLevelModule(context, source, std::move(errorHandler));
+    if(retval)
+    {
+        try
+        {
+            ast::saveSnapshotFile(snapshotFileName, context, source, retval);
+        }
+        catch(std::runtime_error &)
+        {
+        }
+    }
+    return retval;
+}
 }
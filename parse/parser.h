@@ -40,4 +40,13 @@ ast::TopLevelModule *parseTopLevelModule(
     const Source *source,
     std::function<void(LocationRange locationRange, std::string message)> errorHandler =
         defaultParseErrorHandler);
+
+/** loads the snapshot in snapshotFileName if it was made from the same source text, otherwise
+ * parses source and replaces the snapshot. Snapshot errors are never fatal. */
+ast::TopLevelModule *parseTopLevelModuleWithSnapshot(
+    ast::Context &context,
+    const Source *source,
+    const std::string &snapshotFileName,
+    std::function<void(LocationRange locationRange, std::string message)> errorHandler =
+        defaultParseErrorHandler);
 }
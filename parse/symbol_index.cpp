@@ -0,0 +1,639 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "symbol_index.h"
+#include "import_loader.h"
+#include "parser.h"
+#include "source.h"
+#include "../ast/ast.h"
+#include "../ast/name_resolver.h"
+#include "../ast/snapshot.h"
+#include "../util/memory_mapped_file.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_set>
+
+namespace parse
+{
+namespace
+{
+constexpr char symbolIndexMagic[8] = {'H', 'D', 'L', 'S', 'Y', 'M', 'I', 'X'};
+constexpr std::uint32_t symbolIndexVersion = 2;
+constexpr std::uint32_t symbolIndexByteOrderMark = 0x01020304UL;
+constexpr std::size_t bytesPerWord = sizeof(std::uint32_t);
+constexpr std::size_t wordsPerEntry = 7;
+
+struct SymbolIndexFormatError final
+{
+};
+
+void appendWord64(std::vector<std::uint32_t> &words, std::uint64_t value)
+{
+    words.push_back(static_cast<std::uint32_t>(value));
+    words.push_back(static_cast<std::uint32_t>(value >> 32));
+}
+
+void appendString(std::vector<std::uint32_t> &words, util::string_view value)
+{
+    if(value.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("string too long for symbol index");
+    words.push_back(static_cast<std::uint32_t>(value.size()));
+    std::size_t start = words.size();
+    words.resize(start + (value.size() + bytesPerWord - 1) / bytesPerWord, 0);
+    std::memcpy(words.data() + start, value.data(), value.size());
+}
+
+std::uint32_t checkedOffset(std::size_t offset)
+{
+    if(offset >= SymbolIndex::npos)
+        throw std::length_error("source too big for symbol index");
+    return static_cast<std::uint32_t>(offset);
+}
+
+/** gets the kind of a node without visiting its children */
+class NodeKindGetter final : public ast::NodeFieldVisitor
+{
+public:
+    ast::NodeKind kind = ast::NodeKind::ScopedId;
+    bool haveKind = false;
+
+public:
+    virtual void visitNodeKind(ast::NodeKind kind) override
+    {
+        // like in Builder, only the first kind visited is the node's own
+        if(haveKind)
+            return;
+        this->kind = kind;
+        haveKind = true;
+    }
+    virtual void visitLocationRange(const LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ast::ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const ast::Node *) override
+    {
+    }
+    virtual void visitSymbolTable(const ast::SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const ast::SymbolLookupChain &) override
+    {
+    }
+};
+
+/** the source file a symbol was parsed from, which for imports loaded from an interface summary
+ * is the file the summary was written for. Returns "" for built-in symbols. */
+std::string getSourceFileName(const ast::Symbol *symbol)
+{
+    auto *source = symbol->symbolLocationRange.source;
+    if(!source)
+        return std::string();
+    auto fileName = static_cast<std::string>(source->getFileName());
+    // imports from the current directory are looked for in "."
+    if(fileName.compare(0, 2, "./") == 0)
+        fileName.erase(0, 2);
+    constexpr util::string_view summaryExtension = ".hdli";
+    if(fileName.size() >= summaryExtension.size()
+       && util::string_view(fileName).substr(fileName.size() - summaryExtension.size())
+              == summaryExtension)
+        fileName.pop_back();
+    return fileName;
+}
+}
+
+constexpr std::uint32_t SymbolIndex::npos;
+
+/** collects the definitions of a file in pre-order, each with the innermost definition containing
+ * it as its scope, followed by the references */
+class SymbolIndex::Builder final : public ast::NodeFieldVisitor
+{
+private:
+    util::StringPool &names;
+    const ast::NameResolver &nameResolver;
+    std::vector<Entry> &entries;
+    std::vector<Entry> references;
+    std::vector<const ast::Symbol *> referenceTargets;
+    std::unordered_map<const ast::Symbol *, std::uint32_t> definitionIndexes;
+    /** the node whose kind is visited next */
+    const ast::Node *pendingNode = nullptr;
+    std::uint32_t currentScopeIndex = npos;
+
+public:
+    Builder(util::StringPool &names,
+            const ast::NameResolver &nameResolver,
+            std::vector<Entry> &entries) noexcept : names(names),
+                                                    nameResolver(nameResolver),
+                                                    entries(entries)
+    {
+    }
+    virtual void visitNodeKind(ast::NodeKind kind) override
+    {
+        auto *node = pendingNode;
+        pendingNode = nullptr;
+        if(!node)
+            return;
+        if(auto *symbol = dynamic_cast<const ast::Symbol *>(node))
+        {
+            auto index = checkedOffset(entries.size());
+            definitionIndexes.emplace(symbol, index);
+            entries.push_back(Entry{names.intern(*symbol->name),
+                                    kind,
+                                    false,
+                                    checkedOffset(symbol->symbolLocationRange.offset),
+                                    currentScopeIndex,
+                                    npos,
+                                    npos});
+            currentScopeIndex = index;
+        }
+        else if(auto *scopedId = dynamic_cast<const ast::ScopedId *>(node))
+        {
+            references.push_back(Entry{names.intern(*scopedId->name),
+                                       ast::NodeKind::ScopedId,
+                                       true,
+                                       checkedOffset(scopedId->nameLocationRange.offset),
+                                       currentScopeIndex,
+                                       npos,
+                                       npos});
+            referenceTargets.push_back(nameResolver.getSymbol(scopedId));
+        }
+    }
+    virtual void visitLocationRange(const LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ast::ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const ast::Node *value) override
+    {
+        if(!value)
+            return;
+        auto savedScopeIndex = currentScopeIndex;
+        pendingNode = value;
+        value->visitFields(*this);
+        pendingNode = nullptr;
+        currentScopeIndex = savedScopeIndex;
+    }
+    virtual void visitSymbolTable(const ast::SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const ast::SymbolLookupChain &) override
+    {
+    }
+    /** binds the references to the definitions they resolve to, in this file (which is
+     * fileIndex) or in the indexed files it imports, and appends them to entries */
+    void finish(const SymbolIndex &symbolIndex, std::uint32_t fileIndex)
+    {
+        for(std::size_t i = 0; i < references.size(); i++)
+        {
+            auto *target = referenceTargets[i];
+            if(!target)
+                continue;
+            auto iter = definitionIndexes.find(target);
+            if(iter != definitionIndexes.end())
+            {
+                references[i].targetIndex = std::get<1>(*iter);
+                references[i].targetFileIndex = fileIndex;
+                references[i].kind = entries[references[i].targetIndex].kind;
+                continue;
+            }
+            NodeKindGetter nodeKindGetter;
+            if(auto *targetNode = dynamic_cast<const ast::Node *>(target))
+                targetNode->visitFields(nodeKindGetter);
+            references[i].kind = nodeKindGetter.kind;
+            references[i].targetFileIndex = symbolIndex.getFileIndex(getSourceFileName(target));
+        }
+        checkedOffset(entries.size() + references.size());
+        entries.insert(entries.end(), references.begin(), references.end());
+    }
+};
+
+class SymbolIndex::Reader final
+{
+private:
+    const unsigned char *data;
+    std::size_t wordCount;
+    std::size_t position = 0;
+
+public:
+    Reader(const unsigned char *data, std::size_t size) noexcept : data(data),
+                                                                   wordCount(size / bytesPerWord)
+    {
+    }
+    std::uint32_t readWord()
+    {
+        if(position >= wordCount)
+            throw SymbolIndexFormatError();
+        std::uint32_t retval;
+        std::memcpy(&retval, data + position++ * bytesPerWord, bytesPerWord);
+        return retval;
+    }
+    std::uint64_t readWord64()
+    {
+        std::uint64_t retval = readWord();
+        return retval | static_cast<std::uint64_t>(readWord()) << 32;
+    }
+    /** checks that count records of at least wordsPerRecord words could follow */
+    std::size_t readCount(std::size_t wordsPerRecord)
+    {
+        std::size_t retval = readWord();
+        if(retval > (wordCount - position) / wordsPerRecord)
+            throw SymbolIndexFormatError();
+        return retval;
+    }
+    util::string_view readString()
+    {
+        std::size_t size = readWord();
+        std::size_t sizeInWords = (size + bytesPerWord - 1) / bytesPerWord;
+        if(sizeInWords > wordCount - position)
+            throw SymbolIndexFormatError();
+        auto *text = reinterpret_cast<const char *>(data + position * bytesPerWord);
+        position += sizeInWords;
+        return util::string_view(text, size);
+    }
+    bool readHeader()
+    {
+        if(wordCount < sizeof(symbolIndexMagic) / bytesPerWord
+           || std::memcmp(data, symbolIndexMagic, sizeof(symbolIndexMagic)) != 0)
+            return false;
+        position = sizeof(symbolIndexMagic) / bytesPerWord;
+        return readWord() == symbolIndexVersion && readWord() == symbolIndexByteOrderMark;
+    }
+    bool isAtEnd() const noexcept
+    {
+        return position == wordCount;
+    }
+};
+
+void SymbolIndex::addOccurrences(std::uint32_t fileIndex)
+{
+    definitionsByName.resize(names.getIdBound());
+    referencesByName.resize(names.getIdBound());
+    auto &entries = files[fileIndex].entries;
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        auto &occurrencesByName = entries[i].isReference ? referencesByName : definitionsByName;
+        occurrencesByName[entries[i].name.getId()].push_back(
+            Occurrence{fileIndex, static_cast<std::uint32_t>(i)});
+    }
+}
+
+void SymbolIndex::removeOccurrences(std::uint32_t fileIndex)
+{
+    for(auto &entry : files[fileIndex].entries)
+    {
+        auto &occurrences = (entry.isReference ? referencesByName :
+                                                 definitionsByName)[entry.name.getId()];
+        std::size_t newSize = 0;
+        for(auto &occurrence : occurrences)
+            if(occurrence.fileIndex != fileIndex)
+                occurrences[newSize++] = occurrence;
+        occurrences.resize(newSize);
+    }
+}
+
+std::uint32_t SymbolIndex::getOrAddFileIndex(const std::string &fileName)
+{
+    auto iter = fileIndexes.find(fileName);
+    if(iter != fileIndexes.end())
+        return std::get<1>(*iter);
+    auto retval = checkedOffset(files.size());
+    files.push_back(File{fileName, 0, 0, false, {}});
+    fileIndexes.emplace(fileName, retval);
+    return retval;
+}
+
+const std::vector<SymbolIndex::Occurrence> &SymbolIndex::findOccurrences(
+    const std::vector<std::vector<Occurrence>> &occurrencesByName,
+    util::string_view name) const noexcept
+{
+    static const std::vector<Occurrence> empty;
+    auto id = names.find(name).getId();
+    if(id == 0 || id >= occurrencesByName.size())
+        return empty;
+    return occurrencesByName[id];
+}
+
+bool SymbolIndex::updateFile(const std::string &fileName)
+{
+    std::unique_ptr<Source> source;
+    try
+    {
+        source = Source::makeSourceFromFile(fileName);
+    }
+    catch(std::system_error &)
+    {
+        return removeFile(fileName);
+    }
+    auto contentHash = ast::hashSourceText(source->text());
+    auto fileIndex = getFileIndex(fileName);
+    if(fileIndex != npos && files[fileIndex].size == source->size()
+       && files[fileIndex].contentHash == contentHash)
+        return false;
+    if(fileIndex == npos)
+        fileIndex = getOrAddFileIndex(fileName);
+    else
+        removeOccurrences(fileIndex);
+    File file{fileName, source->size(), contentHash, false, {}};
+    try
+    {
+        ast::Context context;
+        auto *tree = parseTopLevelModule(context, source.get());
+        auto searchPath = importSearchPath;
+        auto directorySeparator = fileName.find_last_of('/');
+        if(directorySeparator == std::string::npos)
+            searchPath.push_back(".");
+        else
+            searchPath.push_back(fileName.substr(0, directorySeparator));
+        // an import that fails to load just leaves the names in it unresolved
+        ImportLoader importLoader(context,
+                                  std::move(searchPath),
+                                  [](LocationRange, std::string)
+                                  {
+                                  });
+        importLoader.resolveImports(tree);
+        ast::NameResolver nameResolver;
+        nameResolver.resolveAll(tree);
+        Builder builder(names, nameResolver, file.entries);
+        builder.visitNode(tree);
+        builder.finish(*this, fileIndex);
+        file.isParsed = true;
+    }
+    catch(ParseError &)
+    {
+        file.entries.clear();
+    }
+    files[fileIndex] = std::move(file);
+    addOccurrences(fileIndex);
+    return true;
+}
+
+std::size_t SymbolIndex::updateWorkspace(const std::vector<std::string> &fileNames)
+{
+    std::size_t retval = 0;
+    std::unordered_set<std::string> fileNameSet(fileNames.begin(), fileNames.end());
+    for(auto &file : files)
+        if(!file.fileName.empty() && fileNameSet.count(file.fileName) == 0
+           && removeFile(std::string(file.fileName)))
+            retval++;
+    // the placeholders added here never match the hash of a real file, so they're all parsed
+    for(auto &fileName : fileNames)
+        getOrAddFileIndex(fileName);
+    for(auto &fileName : fileNames)
+        if(updateFile(fileName))
+            retval++;
+    return retval;
+}
+
+bool SymbolIndex::removeFile(const std::string &fileName)
+{
+    auto iter = fileIndexes.find(fileName);
+    if(iter == fileIndexes.end())
+        return false;
+    auto fileIndex = std::get<1>(*iter);
+    fileIndexes.erase(iter);
+    removeOccurrences(fileIndex);
+    files[fileIndex] = File{std::string(), 0, 0, false, {}};
+    return true;
+}
+
+void SymbolIndex::clear() noexcept
+{
+    files.clear();
+    fileIndexes.clear();
+    definitionsByName.clear();
+    referencesByName.clear();
+}
+
+bool SymbolIndex::load(const std::string &fileName)
+{
+    clear();
+    auto file = util::MemoryMappedFile::open(fileName);
+    if(!file)
+        return false;
+    Reader reader(file->data(), file->size());
+    try
+    {
+        if(!reader.readHeader())
+            return false;
+        std::vector<util::StringPool::Entry> savedNames(reader.readCount(1));
+        for(auto &name : savedNames)
+            name = names.intern(reader.readString());
+        std::size_t fileCount = reader.readCount(1);
+        for(std::size_t i = 0; i < fileCount; i++)
+        {
+            auto fileIndex = getOrAddFileIndex(static_cast<std::string>(reader.readString()));
+            if(fileIndex != i)
+                throw SymbolIndexFormatError();
+            auto &indexedFile = files[fileIndex];
+            indexedFile.size = reader.readWord64();
+            indexedFile.contentHash = reader.readWord64();
+            indexedFile.isParsed = reader.readWord() != 0;
+            indexedFile.entries.resize(reader.readCount(wordsPerEntry));
+            for(auto &entry : indexedFile.entries)
+            {
+                std::size_t nameIndex = reader.readWord();
+                std::size_t kind = reader.readWord();
+                if(nameIndex >= savedNames.size() || kind >= ast::nodeKindCount)
+                    throw SymbolIndexFormatError();
+                entry.name = savedNames[nameIndex];
+                entry.kind = static_cast<ast::NodeKind>(kind);
+                entry.isReference = reader.readWord() != 0;
+                entry.offset = reader.readWord();
+                entry.scopeIndex = reader.readWord();
+                entry.targetIndex = reader.readWord();
+                entry.targetFileIndex = reader.readWord();
+                auto entryCount = indexedFile.entries.size();
+                if((entry.scopeIndex != npos && entry.scopeIndex >= entryCount)
+                   || (entry.targetIndex != npos && entry.targetIndex >= entryCount)
+                   || (entry.targetFileIndex != npos && entry.targetFileIndex >= fileCount))
+                    throw SymbolIndexFormatError();
+            }
+            addOccurrences(fileIndex);
+        }
+        if(!reader.isAtEnd())
+            throw SymbolIndexFormatError();
+    }
+    catch(SymbolIndexFormatError &)
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void SymbolIndex::save(const std::string &fileName) const
+{
+    std::vector<std::uint32_t> words(sizeof(symbolIndexMagic) / bytesPerWord);
+    std::memcpy(words.data(), symbolIndexMagic, sizeof(symbolIndexMagic));
+    words.push_back(symbolIndexVersion);
+    words.push_back(symbolIndexByteOrderMark);
+    // name IDs are saved as indexes into the list of names. The pool keeps the names of removed
+    // and re-indexed files, so only the names the remaining entries use are saved.
+    std::vector<std::uint32_t> savedNameIndexes(names.getIdBound(), npos);
+    std::vector<util::StringPool::Entry> savedNames;
+    for(auto &file : files)
+    {
+        for(auto &entry : file.entries)
+        {
+            auto &savedNameIndex = savedNameIndexes[entry.name.getId()];
+            if(savedNameIndex != npos)
+                continue;
+            savedNameIndex = checkedOffset(savedNames.size());
+            savedNames.push_back(entry.name);
+        }
+    }
+    words.push_back(checkedOffset(savedNames.size()));
+    for(auto name : savedNames)
+        appendString(words, *name);
+    // removed files aren't saved, so the files after them move down
+    std::vector<std::uint32_t> savedFileIndexes;
+    savedFileIndexes.reserve(files.size());
+    std::uint32_t savedFileCount = 0;
+    for(auto &file : files)
+        savedFileIndexes.push_back(file.fileName.empty() ? npos : savedFileCount++);
+    words.push_back(checkedOffset(fileIndexes.size()));
+    for(auto &file : files)
+    {
+        if(file.fileName.empty())
+            continue;
+        appendString(words, file.fileName);
+        appendWord64(words, file.size);
+        appendWord64(words, file.contentHash);
+        words.push_back(file.isParsed);
+        words.push_back(checkedOffset(file.entries.size()));
+        for(auto &entry : file.entries)
+        {
+            words.push_back(savedNameIndexes[entry.name.getId()]);
+            words.push_back(static_cast<std::uint32_t>(entry.kind));
+            words.push_back(entry.isReference);
+            words.push_back(entry.offset);
+            words.push_back(entry.scopeIndex);
+            words.push_back(entry.targetIndex);
+            words.push_back(entry.targetFileIndex == npos ?
+                                npos :
+                                savedFileIndexes[entry.targetFileIndex]);
+        }
+    }
+    // write to a temporary file first so a partially written index never replaces a good one
+    std::string temporaryFileName = fileName + ".tmp";
+    std::ofstream os(temporaryFileName, std::ios::binary);
+    os.write(reinterpret_cast<const char *>(words.data()), words.size() * bytesPerWord);
+    os.close();
+    if(!os || std::rename(temporaryFileName.c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(temporaryFileName.c_str());
+        throw std::runtime_error("writing symbol index " + fileName + " failed");
+    }
+}
+
+std::uint32_t SymbolIndex::getFileIndex(const std::string &fileName) const noexcept
+{
+    auto iter = fileIndexes.find(fileName);
+    if(iter == fileIndexes.end())
+        return npos;
+    return std::get<1>(*iter);
+}
+
+bool SymbolIndex::findTarget(Occurrence reference, Occurrence &target) const noexcept
+{
+    auto &entry = getEntry(reference);
+    if(!entry.isReference || entry.targetFileIndex == npos)
+        return false;
+    if(entry.targetIndex != npos)
+    {
+        target = Occurrence{entry.targetFileIndex, entry.targetIndex};
+        return true;
+    }
+    auto &targetEntries = files[entry.targetFileIndex].entries;
+    for(std::size_t i = 0; i < targetEntries.size(); i++)
+    {
+        if(!targetEntries[i].isReference && targetEntries[i].name == entry.name
+           && targetEntries[i].kind == entry.kind)
+        {
+            target = Occurrence{entry.targetFileIndex, static_cast<std::uint32_t>(i)};
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<SymbolIndex::Occurrence> SymbolIndex::searchDefinitions(
+    util::string_view prefix) const
+{
+    std::vector<Occurrence> retval;
+    for(std::uint32_t id = 1; id < definitionsByName.size(); id++)
+    {
+        auto &name = *names.getEntry(id);
+        if(name.size() >= prefix.size() && name.compare(0, prefix.size(), prefix) == 0)
+            retval.insert(retval.end(), definitionsByName[id].begin(), definitionsByName[id].end());
+    }
+    return retval;
+}
+
+std::vector<util::string_view> SymbolIndex::getImports(const std::string &fileName) const
+{
+    std::vector<util::string_view> retval;
+    auto fileIndex = getFileIndex(fileName);
+    if(fileIndex == npos)
+        return retval;
+    for(auto &entry : files[fileIndex].entries)
+        if(!entry.isReference && entry.kind == ast::NodeKind::Import)
+            retval.push_back(*entry.name);
+    return retval;
+}
+
+std::vector<std::uint32_t> SymbolIndex::findImporters(util::string_view moduleName) const
+{
+    std::vector<std::uint32_t> retval;
+    for(auto &occurrence : findDefinitions(moduleName))
+        if(getEntry(occurrence).kind == ast::NodeKind::Import)
+            retval.push_back(occurrence.fileIndex);
+    return retval;
+}
+}
@@ -0,0 +1,157 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../ast/node_kind.h"
+#include "../util/string_pool.h"
+#include "../util/string_view.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace parse
+{
+/** an index of the symbols defined and referenced in every file of a workspace, so workspace
+ * symbol search, find-references and import queries don't need to parse anything. Each file is
+ * keyed by the hash of its contents and is only parsed again when that changes. Imports are
+ * loaded the same way hdlc loads them, so references into imported files are resolved too. The
+ * index is saved as a stream of native-endian 32-bit words; like snapshots, it's just a cache, so
+ * a missing, stale or corrupt index file just means starting over. */
+class SymbolIndex final
+{
+public:
+    static constexpr std::uint32_t npos = 0xFFFFFFFFUL;
+    struct Entry final
+    {
+        util::StringPool::Entry name;
+        /** the kind of the defining node; for references, the kind of the definition the
+         * reference resolves to, or ScopedId if it isn't resolved */
+        ast::NodeKind kind;
+        bool isReference;
+        std::uint32_t offset;
+        /** the index of the innermost definition containing this entry, or npos */
+        std::uint32_t scopeIndex;
+        /** for references, the index of the definition in the same file the reference resolves
+         * to, or npos */
+        std::uint32_t targetIndex;
+        /** for references, the index of the file holding the definition the reference resolves
+         * to, or npos if it isn't resolved or that file isn't indexed */
+        std::uint32_t targetFileIndex;
+    };
+    struct Occurrence final
+    {
+        std::uint32_t fileIndex;
+        std::uint32_t entryIndex;
+    };
+    struct File final
+    {
+        /** empty for files that were removed */
+        std::string fileName;
+        std::uint64_t size;
+        std::uint64_t contentHash;
+        /** false if the file failed to parse, in which case there are no entries */
+        bool isParsed;
+        /** in the order they were found: definitions in pre-order, then references */
+        std::vector<Entry> entries;
+    };
+
+private:
+    class Builder;
+    class Reader;
+
+private:
+    std::vector<std::string> importSearchPath;
+    util::StringPool names;
+    std::vector<File> files;
+    std::unordered_map<std::string, std::uint32_t> fileIndexes;
+    /** indexed by name ID */
+    std::vector<std::vector<Occurrence>> definitionsByName;
+    /** indexed by name ID */
+    std::vector<std::vector<Occurrence>> referencesByName;
+
+private:
+    void addOccurrences(std::uint32_t fileIndex);
+    void removeOccurrences(std::uint32_t fileIndex);
+    std::uint32_t getOrAddFileIndex(const std::string &fileName);
+    const std::vector<Occurrence> &findOccurrences(
+        const std::vector<std::vector<Occurrence>> &occurrencesByName,
+        util::string_view name) const noexcept;
+
+public:
+    SymbolIndex() = default;
+    /** imports are looked for in importSearchPath, then in the directory of the importing file */
+    explicit SymbolIndex(std::vector<std::string> importSearchPath)
+        : importSearchPath(std::move(importSearchPath))
+    {
+    }
+    SymbolIndex(const SymbolIndex &) = delete;
+    SymbolIndex &operator=(const SymbolIndex &) = delete;
+    /** parses fileName again if its contents changed since it was indexed. Returns true if the
+     * index changed. Files that don't exist any more are removed. */
+    bool updateFile(const std::string &fileName);
+    /** updates every file in fileNames and removes indexed files that aren't in fileNames.
+     * Returns the number of files that changed. Every file in fileNames is added before any is
+     * parsed, so references into imported files are resolved whatever order they're listed in. */
+    std::size_t updateWorkspace(const std::vector<std::string> &fileNames);
+    /** returns true if fileName was indexed */
+    bool removeFile(const std::string &fileName);
+    void clear() noexcept;
+    /** returns false and leaves the index empty if fileName doesn't exist or isn't a valid
+     * index */
+    bool load(const std::string &fileName);
+    /** throws std::runtime_error on failure */
+    void save(const std::string &fileName) const;
+    const std::vector<File> &getFiles() const noexcept
+    {
+        return files;
+    }
+    /** returns npos if fileName isn't indexed */
+    std::uint32_t getFileIndex(const std::string &fileName) const noexcept;
+    const File &getFile(std::uint32_t fileIndex) const noexcept
+    {
+        return files[fileIndex];
+    }
+    const Entry &getEntry(Occurrence occurrence) const noexcept
+    {
+        return files[occurrence.fileIndex].entries[occurrence.entryIndex];
+    }
+    /** returns the definition reference resolves to, or false if it isn't resolved to an indexed
+     * file. References into other files are matched by name and kind, so they still find their
+     * definition after the other file is indexed again. */
+    bool findTarget(Occurrence reference, Occurrence &target) const noexcept;
+    const std::vector<Occurrence> &findDefinitions(util::string_view name) const noexcept
+    {
+        return findOccurrences(definitionsByName, name);
+    }
+    const std::vector<Occurrence> &findReferences(util::string_view name) const noexcept
+    {
+        return findOccurrences(referencesByName, name);
+    }
+    /** returns the definitions of every name starting with prefix */
+    std::vector<Occurrence> searchDefinitions(util::string_view prefix) const;
+    /** the names of the modules fileName imports */
+    std::vector<util::string_view> getImports(const std::string &fileName) const;
+    /** the indexes of the files that import moduleName */
+    std::vector<std::uint32_t> findImporters(util::string_view moduleName) const;
+};
+}
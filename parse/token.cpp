@@ -80,14 +80,14 @@ Token::IntegerValue Token::getIntegerValue() const
             continue;
         int digitValue = CharProperties<char>::getDigitValue(ch, base);
         bool isWildcard = digitValue < 0;
-        mpz_mul_ui(value, value, base);
+        value *= math::GMPInteger(static_cast<long>(base));
         if(!isWildcard && digitValue != 0)
-            mpz_add_ui(value, value, digitValue);
+            value += math::GMPInteger(static_cast<long>(digitValue));
         if(isPattern)
         {
-            mpz_mul_ui(mask, mask, base);
+            mask *= math::GMPInteger(static_cast<long>(base));
             if(!isWildcard)
-                mpz_add_ui(mask, mask, base - 1);
+                mask += math::GMPInteger(static_cast<long>(base - 1));
         }
     }
     return {std::move(value), std::move(mask)};
@@ -95,7 +95,7 @@ Token::IntegerValue Token::getIntegerValue() const
 
 Token::IntegerValue::operator std::string() const
 {
-    if(mpz_sgn(value.value) < 0)
+    if(value.sign() < 0)
     {
         // default printing algorithm doesn't work for negative numbers
         std::ostringstream ss;
@@ -129,13 +129,12 @@ Token::IntegerValue::operator std::string() const
     constexpr int digitsBetweenSeparator = 4;
     int digitsBeforeSeparator = digitsBetweenSeparator;
     constexpr char digitSeparator = '_';
-    while(mpz_sgn(value.value) != 0
-          || (mpz_cmp_si(mask.value, -1) != 0 && mpz_sgn(mask.value) != 0))
+    while(value.sign() != 0 || (mask != math::GMPInteger(-1L) && mask.sign() != 0))
     {
-        auto digitValue = mpz_fdiv_ui(value, 1UL << baseBitCount);
-        auto digitMask = mpz_fdiv_ui(mask, 1UL << baseBitCount);
-        mpz_fdiv_q_2exp(value, value, baseBitCount);
-        mpz_fdiv_q_2exp(mask, mask, baseBitCount);
+        auto digitValue = value.getLowBits(baseBitCount);
+        auto digitMask = mask.getLowBits(baseBitCount);
+        value >>= baseBitCount;
+        mask >>= baseBitCount;
         if(digitMask == 0)
             retval += '?';
         else if(digitValue < 10)
@@ -161,12 +160,12 @@ bool isPowerOf2BaseMask(math::GMPInteger mask)
 {
     if(BitCount < 2)
         return true;
-    while(mpz_cmp_si(mask.value, -1) != 0 && mpz_sgn(mask.value) != 0)
+    while(mask != math::GMPInteger(-1L) && mask.sign() != 0)
     {
-        auto digitBits = mpz_fdiv_ui(mask, 1UL << BitCount);
+        auto digitBits = mask.getLowBits(BitCount);
         if(digitBits != 0 && digitBits != (1UL << BitCount) - 1)
             return false;
-        mpz_fdiv_q_2exp(mask, mask, BitCount);
+        mask >>= BitCount;
     }
     return true;
 }
@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include "../util/string_view.h"
+#include "../util/string_pool.h"
 #include "source.h"
 #include "../math/bit_vector.h"
 #include <string>
@@ -318,15 +319,25 @@ struct Token final
     }
     Type type;
     LocationRange locationRange;
+    /** util::StringPool::hashString(getText()) for identifiers, computed while tokenizing */
+    std::size_t identifierHash;
     util::string_view getText() const noexcept
     {
         return locationRange.getText();
     }
-    constexpr Token() noexcept : type(Type::EndOfFile), locationRange()
+    std::size_t getTextHash() const noexcept
     {
+        if(type == Type::Identifier)
+            return identifierHash;
+        return util::StringPool::hashString(getText());
     }
-    constexpr Token(Type type, LocationRange locationRange) noexcept : type(type),
-                                                                       locationRange(locationRange)
+    constexpr Token() noexcept : type(Type::EndOfFile), locationRange(), identifierHash(0)
+    {
+    }
+    constexpr Token(Type type, LocationRange locationRange, std::size_t identifierHash = 0) noexcept
+        : type(type),
+          locationRange(locationRange),
+          identifierHash(identifierHash)
     {
     }
     struct IntegerValue
@@ -98,9 +98,10 @@ struct Tokenizer::TokenParser
         Location startLocation = currentLocation;
         if(CharProperties<CharType>::isIdentifierStart(peek()))
         {
+            auto identifierHash = util::StringPool::hashStart();
             do
             {
-                get();
+                identifierHash = util::StringPool::hashStep(identifierHash, get());
             } while(CharProperties<CharType>::isIdentifierContinue(peek()));
             LocationRange locationRange(startLocation, currentLocation);
             auto tokenText = locationRange.getText();
@@ -116,7 +117,7 @@ struct Tokenizer::TokenParser
                     break;
                 }
             }
-            return Token(tokenType, locationRange);
+            return Token(tokenType, locationRange, identifierHash);
         }
         if(CharProperties<CharType>::isDigit(peek()))
         {
@@ -0,0 +1,217 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../math/bit_vector_kernels.h"
+#include <cstdint>
+#include <gmp.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// checks every math::kernels path this machine supports against GMP and plain loops, with random
+// operands of every length up to a few AVX2 blocks
+
+namespace
+{
+using namespace math::kernels;
+typedef std::vector<std::uint64_t> Words;
+constexpr std::size_t maxWordCount = 19;
+constexpr std::size_t iterationCount = 200;
+std::size_t failureCount = 0;
+
+const char *getPathName(KernelPath path) noexcept
+{
+    switch(path)
+    {
+    case KernelPath::Scalar:
+        return "scalar";
+    case KernelPath::SSE2:
+        return "SSE2";
+    case KernelPath::AVX2:
+        return "AVX2";
+    }
+    return "unknown";
+}
+
+class Mpz final
+{
+public:
+    mpz_t value;
+
+public:
+    Mpz() noexcept
+    {
+        mpz_init(value);
+    }
+    explicit Mpz(const Words &words) noexcept
+    {
+        mpz_init(value);
+        mpz_import(value, words.size(), -1, sizeof(std::uint64_t), 0, 0, words.data());
+    }
+    Mpz(const Mpz &) = delete;
+    Mpz &operator=(const Mpz &) = delete;
+    ~Mpz()
+    {
+        mpz_clear(value);
+    }
+    /** the low wordCount words of value, modulo 2 to the 64 * wordCount */
+    Words getWords(std::size_t wordCount) const
+    {
+        Mpz truncated;
+        mpz_fdiv_r_2exp(truncated.value, value, wordCount * bitsPerWord);
+        Words retval(wordCount);
+        std::size_t count;
+        mpz_export(retval.data(), &count, -1, sizeof(std::uint64_t), 0, 0, truncated.value);
+        return retval;
+    }
+    /** the bit at wordCount words */
+    bool getCarry(std::size_t wordCount) const noexcept
+    {
+        return mpz_tstbit(value, wordCount * bitsPerWord);
+    }
+};
+
+void check(bool isOk, const char *operation, KernelPath path, std::size_t wordCount)
+{
+    if(isOk)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << operation << " with the " << getPathName(path) << " path and "
+                  << wordCount << " words" << std::endl;
+}
+
+Words makeWords(std::mt19937_64 &random, std::size_t wordCount)
+{
+    Words retval(wordCount);
+    switch(random() % 4)
+    {
+    case 0:
+        break;
+    case 1:
+        for(auto &word : retval)
+            word = ~static_cast<std::uint64_t>(0);
+        break;
+    default:
+        for(auto &word : retval)
+            word = random();
+        break;
+    }
+    return retval;
+}
+
+/** r is usually l with at most one word changed, so the comparisons see long equal runs */
+Words makeSimilarWords(std::mt19937_64 &random, const Words &l)
+{
+    if(l.empty() || random() % 4 == 0)
+        return makeWords(random, l.size());
+    Words retval = l;
+    if(random() % 3 != 0)
+        retval[random() % l.size()] ^= static_cast<std::uint64_t>(1) << random() % bitsPerWord;
+    return retval;
+}
+
+void testPath(KernelPath path, std::mt19937_64 &random)
+{
+    for(std::size_t wordCount = 0; wordCount <= maxWordCount; wordCount++)
+    {
+        for(std::size_t iteration = 0; iteration < iterationCount; iteration++)
+        {
+            auto l = makeWords(random, wordCount);
+            auto r = makeSimilarWords(random, l);
+            Mpz lMpz(l), rMpz(r);
+            Words result(wordCount), expected(wordCount);
+            andWords(result.data(), l.data(), r.data(), wordCount);
+            for(std::size_t i = 0; i < wordCount; i++)
+                expected[i] = l[i] & r[i];
+            check(result == expected, "andWords", path, wordCount);
+            orWords(result.data(), l.data(), r.data(), wordCount);
+            for(std::size_t i = 0; i < wordCount; i++)
+                expected[i] = l[i] | r[i];
+            check(result == expected, "orWords", path, wordCount);
+            xorWords(result.data(), l.data(), r.data(), wordCount);
+            for(std::size_t i = 0; i < wordCount; i++)
+                expected[i] = l[i] ^ r[i];
+            check(result == expected, "xorWords", path, wordCount);
+            notWords(result.data(), l.data(), wordCount);
+            for(std::size_t i = 0; i < wordCount; i++)
+                expected[i] = ~l[i];
+            check(result == expected, "notWords", path, wordCount);
+            int comparison = mpz_cmp(lMpz.value, rMpz.value);
+            comparison = comparison < 0 ? -1 : comparison > 0 ? 1 : 0;
+            check(equalWords(l.data(), r.data(), wordCount) == (comparison == 0),
+                  "equalWords",
+                  path,
+                  wordCount);
+            check(compareWords(l.data(), r.data(), wordCount) == comparison,
+                  "compareWords",
+                  path,
+                  wordCount);
+            check(popCountWords(l.data(), wordCount) == mpz_popcount(lMpz.value),
+                  "popCountWords",
+                  path,
+                  wordCount);
+            bool carry = random() % 2;
+            Mpz sum;
+            mpz_add(sum.value, lMpz.value, rMpz.value);
+            mpz_add_ui(sum.value, sum.value, carry);
+            bool carryOut = addWords(result.data(), l.data(), r.data(), wordCount, carry);
+            check(result == sum.getWords(wordCount) && carryOut == sum.getCarry(wordCount),
+                  "addWords",
+                  path,
+                  wordCount);
+            Mpz difference;
+            mpz_sub(difference.value, lMpz.value, rMpz.value);
+            mpz_sub_ui(difference.value, difference.value, carry);
+            bool borrowOut = subtractWords(result.data(), l.data(), r.data(), wordCount, carry);
+            check(result == difference.getWords(wordCount)
+                      && borrowOut == (mpz_sgn(difference.value) < 0),
+                  "subtractWords",
+                  path,
+                  wordCount);
+            Mpz negation;
+            mpz_neg(negation.value, lMpz.value);
+            negateWords(result.data(), l.data(), wordCount);
+            check(result == negation.getWords(wordCount), "negateWords", path, wordCount);
+        }
+    }
+}
+}
+
+int main()
+{
+    std::mt19937_64 random(0x5EED);
+    auto bestPath = getBestKernelPath();
+    for(auto path : {KernelPath::Scalar, KernelPath::SSE2, KernelPath::AVX2})
+    {
+        if(!setKernelPath(path))
+        {
+            std::cout << "skipping the " << getPathName(path) << " path, it isn't supported"
+                      << std::endl;
+            continue;
+        }
+        testPath(path, random);
+        std::cout << "tested the " << getPathName(path) << " path" << std::endl;
+    }
+    setKernelPath(bestPath);
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
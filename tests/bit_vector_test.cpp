@@ -0,0 +1,503 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../math/bit_vector.h"
+#include "../math/gmp_integer.h"
+#include <cstdint>
+#include <functional>
+#include <gmp.h>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// checks the math::BitVector operators against GMP: exhaustively for every operand up to
+// maxExhaustiveBitCount bits, then on random operands around the inline and word boundaries up
+// to about a thousand bits
+
+namespace
+{
+typedef math::BitVector BitVector;
+typedef BitVector::Kind Kind;
+constexpr std::size_t maxExhaustiveBitCount = 4;
+constexpr std::size_t randomIterationCount = 3000;
+constexpr std::size_t bitsPerWord = 64;
+const std::size_t interestingBitCounts[] = {
+    1, 2, 31, 32, 63, 64, 65, 100, 127, 128, 129, 191, 192, 193, 255, 256, 257, 511, 512, 513,
+    1000};
+std::size_t checkCount = 0;
+std::size_t failureCount = 0;
+
+class Mpz final
+{
+public:
+    mpz_t value;
+
+public:
+    Mpz() noexcept
+    {
+        mpz_init(value);
+    }
+    Mpz(const Mpz &) = delete;
+    Mpz &operator=(const Mpz &) = delete;
+    ~Mpz()
+    {
+        mpz_clear(value);
+    }
+    std::string toString() const
+    {
+        std::string retval(mpz_sizeinbase(value, 16) + 2, '\0');
+        mpz_get_str(&retval[0], 16, value);
+        retval.resize(std::char_traits<char>::length(retval.c_str()));
+        return retval;
+    }
+};
+
+const char *getKindName(Kind kind) noexcept
+{
+    return kind == Kind::Signed ? "sint" : "uint";
+}
+
+/** reduces value to the range of a bitCount-bit integer of kind, like the hardware would */
+void wrap(mpz_ptr value, Kind kind, std::size_t bitCount)
+{
+    mpz_fdiv_r_2exp(value, value, bitCount);
+    if(kind == Kind::Signed && mpz_tstbit(value, bitCount - 1))
+    {
+        Mpz modulus;
+        mpz_setbit(modulus.value, bitCount);
+        mpz_sub(value, value, modulus.value);
+    }
+}
+
+/** reads value from its words, without BitVector::getValue */
+void getValue(mpz_ptr result, const BitVector &value)
+{
+    mpz_import(
+        result, value.getWordCount(), -1, sizeof(std::uint64_t), 0, 0, value.getWords());
+    wrap(result, value.getKind(), value.getBitCount());
+}
+
+BitVector makeBitVector(Kind kind, std::size_t bitCount, mpz_srcptr value)
+{
+    math::GMPInteger integer;
+    mpz_set(integer.getMutableMpz(), value);
+    integer.shrinkToFit();
+    return BitVector(kind, bitCount, integer);
+}
+
+std::string describe(const BitVector &value)
+{
+    Mpz mpz;
+    getValue(mpz.value, value);
+    return std::string(getKindName(value.getKind())) + "!{" + std::to_string(value.getBitCount())
+           + "}(0x" + mpz.toString() + ")";
+}
+
+/** checks that result is expected wrapped to kind and bitCount, including that its words are
+ * sign or zero extended */
+void check(const BitVector &result,
+           Kind kind,
+           std::size_t bitCount,
+           mpz_ptr expected,
+           const std::string &operation)
+{
+    checkCount++;
+    wrap(expected, kind, bitCount);
+    bool isOk = result.getKind() == kind && result.getBitCount() == bitCount;
+    if(isOk)
+    {
+        auto wordCount = result.getWordCount();
+        Mpz pattern;
+        mpz_fdiv_r_2exp(pattern.value, expected, wordCount * bitsPerWord);
+        std::vector<std::uint64_t> expectedWords(wordCount);
+        std::size_t count;
+        mpz_export(
+            expectedWords.data(), &count, -1, sizeof(std::uint64_t), 0, 0, pattern.value);
+        isOk = std::equal(expectedWords.begin(), expectedWords.end(), result.getWords());
+    }
+    if(isOk)
+        return;
+    if(failureCount++ < 20)
+    {
+        Mpz expectedCopy;
+        mpz_set(expectedCopy.value, expected);
+        std::cerr << "FAIL: " << operation << " gave " << describe(result) << ", expected "
+                  << getKindName(kind) << "!{" << bitCount << "}(0x" << expectedCopy.toString()
+                  << ")" << std::endl;
+    }
+}
+
+void checkInteger(long long result, long long expected, const std::string &operation)
+{
+    checkCount++;
+    if(result == expected)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << operation << " gave " << result << ", expected " << expected
+                  << std::endl;
+}
+
+int getSign(int value) noexcept
+{
+    return value < 0 ? -1 : value > 0 ? 1 : 0;
+}
+
+/** the shift count BitVector uses: out of range counts shift everything out */
+std::size_t getShiftCount(mpz_srcptr shiftCount, std::size_t bitCount)
+{
+    if(mpz_sgn(shiftCount) < 0 || mpz_cmp_ui(shiftCount, bitCount) >= 0)
+        return bitCount;
+    return mpz_get_ui(shiftCount);
+}
+
+struct BinaryOperation final
+{
+    const char *name;
+    std::function<BitVector(Kind, std::size_t, const BitVector &, const BitVector &)> function;
+    /** returns false if the operation throws std::domain_error */
+    std::function<bool(
+        mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &lValue, std::size_t bitCount)>
+        reference;
+};
+
+const std::vector<BinaryOperation> &getBinaryOperations()
+{
+    static const std::vector<BinaryOperation> operations = {
+        {"add",
+         BitVector::add,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             mpz_add(result, l, r);
+             return true;
+         }},
+        {"subtract",
+         BitVector::subtract,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             mpz_sub(result, l, r);
+             return true;
+         }},
+        {"multiply",
+         BitVector::multiply,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             mpz_mul(result, l, r);
+             return true;
+         }},
+        {"divide",
+         BitVector::divide,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             if(mpz_sgn(r) == 0)
+                 return false;
+             mpz_tdiv_q(result, l, r);
+             return true;
+         }},
+        {"remainder",
+         BitVector::remainder,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             if(mpz_sgn(r) == 0)
+                 return false;
+             mpz_tdiv_r(result, l, r);
+             return true;
+         }},
+        {"bitwiseAnd",
+         BitVector::bitwiseAnd,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             mpz_and(result, l, r);
+             return true;
+         }},
+        {"bitwiseOr",
+         BitVector::bitwiseOr,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             mpz_ior(result, l, r);
+             return true;
+         }},
+        {"bitwiseXor",
+         BitVector::bitwiseXor,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t)
+         {
+             mpz_xor(result, l, r);
+             return true;
+         }},
+        {"shiftLeft",
+         BitVector::shiftLeft,
+         [](mpz_ptr result, mpz_srcptr l, mpz_srcptr r, const BitVector &, std::size_t bitCount)
+         {
+             // shifting by the result width or more clears it, which wrap does too
+             mpz_mul_2exp(result, l, getShiftCount(r, bitCount));
+             return true;
+         }},
+        {"shiftRight",
+         BitVector::shiftRight,
+         [](mpz_ptr result,
+            mpz_srcptr l,
+            mpz_srcptr r,
+            const BitVector &lValue,
+            std::size_t)
+         {
+             mpz_fdiv_q_2exp(result, l, getShiftCount(r, lValue.getBitCount()));
+             return true;
+         }},
+    };
+    return operations;
+}
+
+void testBinary(const BitVector &l, const BitVector &r, Kind kind, std::size_t bitCount)
+{
+    Mpz lMpz, rMpz;
+    getValue(lMpz.value, l);
+    getValue(rMpz.value, r);
+    for(auto &operation : getBinaryOperations())
+    {
+        auto description = std::string(operation.name) + "(" + getKindName(kind) + "!{"
+                           + std::to_string(bitCount) + "}, " + describe(l) + ", " + describe(r)
+                           + ")";
+        Mpz expected;
+        bool isValid = operation.reference(expected.value, lMpz.value, rMpz.value, l, bitCount);
+        try
+        {
+            auto result = operation.function(kind, bitCount, l, r);
+            if(isValid)
+                check(result, kind, bitCount, expected.value, description);
+            else
+                checkInteger(0, 1, description + " didn't throw");
+        }
+        catch(std::domain_error &)
+        {
+            checkInteger(isValid, false, description + " threw");
+        }
+    }
+}
+
+void testUnary(const BitVector &value, Kind kind, std::size_t bitCount)
+{
+    Mpz mpz;
+    getValue(mpz.value, value);
+    auto suffix = std::string("(") + getKindName(kind) + "!{" + std::to_string(bitCount) + "}, "
+                  + describe(value) + ")";
+    Mpz expected;
+    mpz_neg(expected.value, mpz.value);
+    check(BitVector::negate(kind, bitCount, value),
+          kind,
+          bitCount,
+          expected.value,
+          "negate" + suffix);
+    mpz_com(expected.value, mpz.value);
+    check(BitVector::bitwiseNot(kind, bitCount, value),
+          kind,
+          bitCount,
+          expected.value,
+          "bitwiseNot" + suffix);
+    mpz_set(expected.value, mpz.value);
+    check(BitVector::cast(kind, bitCount, value), kind, bitCount, expected.value, "cast" + suffix);
+    Mpz pattern;
+    mpz_fdiv_r_2exp(pattern.value, mpz.value, value.getBitCount());
+    auto popCount = mpz_popcount(pattern.value);
+    mpz_set_ui(expected.value, popCount);
+    check(BitVector::popCount(kind, bitCount, value),
+          kind,
+          bitCount,
+          expected.value,
+          "popCount" + suffix);
+    for(std::size_t startBit : {std::size_t(0), std::size_t(1), value.getBitCount() / 2,
+                                value.getBitCount() - 1, value.getBitCount() + bitsPerWord})
+    {
+        mpz_fdiv_q_2exp(expected.value, mpz.value, startBit);
+        check(BitVector::slice(kind, bitCount, value, startBit),
+              kind,
+              bitCount,
+              expected.value,
+              "slice" + suffix + " from bit " + std::to_string(startBit));
+    }
+}
+
+void testOperand(const BitVector &value)
+{
+    Mpz mpz, pattern;
+    getValue(mpz.value, value);
+    mpz_fdiv_r_2exp(pattern.value, mpz.value, value.getBitCount());
+    auto popCount = mpz_popcount(pattern.value);
+    auto description = "(" + describe(value) + ")";
+    checkInteger(value.popCount(), popCount, "popCount" + description);
+    checkInteger(!BitVector::reduceAnd(value).isZero(),
+                 popCount == value.getBitCount(),
+                 "reduceAnd" + description);
+    checkInteger(
+        !BitVector::reduceOr(value).isZero(), popCount != 0, "reduceOr" + description);
+    checkInteger(
+        !BitVector::reduceXor(value).isZero(), popCount % 2, "reduceXor" + description);
+    checkInteger(value.isZero(), mpz_sgn(mpz.value) == 0, "isZero" + description);
+    checkInteger(value.isNegative(), mpz_sgn(mpz.value) < 0, "isNegative" + description);
+    checkInteger(mpz_cmp(value.getValue().getMpz(), mpz.value), 0, "getValue" + description);
+}
+
+void testPair(const BitVector &l, const BitVector &r)
+{
+    Mpz lMpz, rMpz;
+    getValue(lMpz.value, l);
+    getValue(rMpz.value, r);
+    auto description = "(" + describe(l) + ", " + describe(r) + ")";
+    checkInteger(BitVector::compare(l, r),
+                 getSign(mpz_cmp(lMpz.value, rMpz.value)),
+                 "compare" + description);
+    Mpz lPattern, rPattern;
+    mpz_fdiv_r_2exp(lPattern.value, lMpz.value, l.getBitCount());
+    mpz_fdiv_r_2exp(rPattern.value, rMpz.value, r.getBitCount());
+    checkInteger(BitVector::compareUnsigned(l, r),
+                 getSign(mpz_cmp(lPattern.value, rPattern.value)),
+                 "compareUnsigned" + description);
+    Mpz expected;
+    mpz_mul_2exp(expected.value, lPattern.value, r.getBitCount());
+    mpz_ior(expected.value, expected.value, rPattern.value);
+    check(BitVector::concatenate(l, r),
+          l.getKind(),
+          l.getBitCount() + r.getBitCount(),
+          expected.value,
+          "concatenate" + description);
+}
+
+std::vector<BitVector> getAllValues()
+{
+    std::vector<BitVector> retval;
+    for(auto kind : {Kind::Unsigned, Kind::Signed})
+    {
+        for(std::size_t bitCount = 1; bitCount <= maxExhaustiveBitCount; bitCount++)
+        {
+            for(unsigned long pattern = 0; pattern < 1UL << bitCount; pattern++)
+            {
+                Mpz value;
+                mpz_set_ui(value.value, pattern);
+                wrap(value.value, kind, bitCount);
+                retval.push_back(makeBitVector(kind, bitCount, value.value));
+            }
+        }
+    }
+    return retval;
+}
+
+void testExhaustive()
+{
+    auto values = getAllValues();
+    for(auto &l : values)
+    {
+        testOperand(l);
+        for(auto kind : {Kind::Unsigned, Kind::Signed})
+            for(std::size_t bitCount = 1; bitCount <= maxExhaustiveBitCount + 1; bitCount++)
+                testUnary(l, kind, bitCount);
+        for(auto &r : values)
+        {
+            testPair(l, r);
+            for(auto kind : {Kind::Unsigned, Kind::Signed})
+                for(std::size_t bitCount = 1; bitCount <= maxExhaustiveBitCount + 1; bitCount++)
+                    testBinary(l, r, kind, bitCount);
+        }
+    }
+}
+
+std::size_t makeBitCount(std::mt19937_64 &random)
+{
+    if(random() % 4 == 0)
+        return random() % 1100 + 1;
+    return interestingBitCounts[random() % (sizeof(interestingBitCounts)
+                                            / sizeof(interestingBitCounts[0]))];
+}
+
+Kind makeKind(std::mt19937_64 &random)
+{
+    return random() % 2 ? Kind::Signed : Kind::Unsigned;
+}
+
+/** random bits, or one of the values at the edges of the range */
+BitVector makeValue(std::mt19937_64 &random, Kind kind, std::size_t bitCount)
+{
+    Mpz value;
+    switch(random() % 8)
+    {
+    case 0:
+        break;
+    case 1:
+        mpz_set_si(value.value, -1);
+        break;
+    case 2:
+        mpz_setbit(value.value, bitCount - 1);
+        break;
+    case 3:
+        mpz_setbit(value.value, bitCount - 1);
+        mpz_sub_ui(value.value, value.value, 1);
+        break;
+    case 4:
+        mpz_set_ui(value.value, random() % 8);
+        break;
+    default:
+    {
+        std::vector<std::uint64_t> words((bitCount + bitsPerWord - 1) / bitsPerWord);
+        for(auto &word : words)
+            word = random();
+        // sometimes keep the operand short, so wide divisions see small divisors
+        if(random() % 4 == 0)
+            words.resize(1);
+        mpz_import(value.value, words.size(), -1, sizeof(std::uint64_t), 0, 0, words.data());
+        break;
+    }
+    }
+    wrap(value.value, kind, bitCount);
+    return makeBitVector(kind, bitCount, value.value);
+}
+
+void testRandom()
+{
+    std::mt19937_64 random(0x5EED);
+    for(std::size_t iteration = 0; iteration < randomIterationCount; iteration++)
+    {
+        auto l = makeValue(random, makeKind(random), makeBitCount(random));
+        auto r = makeValue(random, makeKind(random), makeBitCount(random));
+        auto kind = makeKind(random);
+        auto bitCount = makeBitCount(random);
+        // a narrow shift count, so shifts don't usually shift everything out
+        Mpz shiftCountValue;
+        mpz_set_si(shiftCountValue.value,
+                   static_cast<long>(random() % (l.getBitCount() + 70)) - 2);
+        auto shiftCount = makeBitVector(Kind::Signed, 16, shiftCountValue.value);
+        testOperand(l);
+        testUnary(l, kind, bitCount);
+        testPair(l, r);
+        testPair(l, makeValue(random, makeKind(random), l.getBitCount()));
+        testBinary(l, r, kind, bitCount);
+        testBinary(l, shiftCount, kind, bitCount);
+    }
+}
+}
+
+int main()
+{
+    testExhaustive();
+    testRandom();
+    std::cout << checkCount << " checks" << std::endl;
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
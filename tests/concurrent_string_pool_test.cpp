@@ -0,0 +1,149 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../util/concurrent_string_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// interns overlapping sets of strings from several threads at once and checks that every thread
+// gets the same entry for the same string and that the IDs stay dense
+
+namespace
+{
+constexpr std::size_t threadCount = 8;
+constexpr std::size_t sharedStringCount = 20000;
+constexpr std::size_t privateStringCount = 2000;
+std::size_t failureCount = 0;
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+std::string getSharedString(std::size_t index)
+{
+    return "shared" + std::to_string(index);
+}
+
+std::string getPrivateString(std::size_t threadIndex, std::size_t index)
+{
+    return "thread" + std::to_string(threadIndex) + "_" + std::to_string(index);
+}
+
+struct ThreadResult final
+{
+    /** indexed by shared string index */
+    std::vector<util::ConcurrentStringPool::Entry> sharedEntries;
+    std::vector<util::ConcurrentStringPool::Entry> privateEntries;
+    bool foundWrongString = false;
+};
+
+/** each thread interns the shared strings in its own random order, mixed with its own strings,
+ * and looks up strings other threads may be interning at the same time */
+void internStrings(util::ConcurrentStringPool &stringPool,
+                   std::size_t threadIndex,
+                   ThreadResult &result)
+{
+    std::vector<std::size_t> order;
+    for(std::size_t i = 0; i < sharedStringCount; i++)
+        order.push_back(i);
+    std::mt19937_64 randomEngine(threadIndex);
+    std::shuffle(order.begin(), order.end(), randomEngine);
+    result.sharedEntries.resize(sharedStringCount);
+    for(std::size_t i = 0; i < sharedStringCount; i++)
+    {
+        result.sharedEntries[order[i]] = stringPool.intern(getSharedString(order[i]));
+        if(i % (sharedStringCount / privateStringCount) == 0)
+            result.privateEntries.push_back(stringPool.intern(
+                getPrivateString(threadIndex, result.privateEntries.size())));
+        auto lookedUpString = getSharedString(randomEngine() % sharedStringCount);
+        auto found = stringPool.find(lookedUpString);
+        if(found && *found != lookedUpString)
+            result.foundWrongString = true;
+    }
+}
+
+void testThreads()
+{
+    static_assert(alignof(util::ConcurrentStringPool) >= 64,
+                  "the shards of ConcurrentStringPool must be cache line aligned");
+    static util::ConcurrentStringPool stringPool;
+    std::vector<ThreadResult> results(threadCount);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < threadCount; i++)
+        threads.emplace_back(internStrings, std::ref(stringPool), i, std::ref(results[i]));
+    for(auto &thread : threads)
+        thread.join();
+    auto expectedSize = sharedStringCount + threadCount * privateStringCount;
+    check(stringPool.size() == expectedSize,
+          "size is " + std::to_string(stringPool.size()) + ", expected "
+              + std::to_string(expectedSize));
+    std::vector<bool> usedIds(expectedSize + 1, false);
+    auto useId = [&](util::ConcurrentStringPool::Entry entry)
+    {
+        auto id = entry.getId();
+        check(id != 0 && id <= expectedSize && !usedIds[id],
+              "ID " + std::to_string(id) + " isn't dense or is used twice");
+        if(id != 0 && id <= expectedSize)
+            usedIds[id] = true;
+    };
+    for(std::size_t i = 0; i < sharedStringCount; i++)
+    {
+        auto entry = results[0].sharedEntries[i];
+        check(entry && *entry == getSharedString(i), "wrong text for " + getSharedString(i));
+        for(auto &result : results)
+            check(result.sharedEntries[i] == entry,
+                  "threads got different entries for " + getSharedString(i));
+        check(stringPool.find(getSharedString(i)) == entry, "find doesn't agree with intern");
+        useId(entry);
+    }
+    for(std::size_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+    {
+        check(!results[threadIndex].foundWrongString, "find returned the wrong string");
+        auto &privateEntries = results[threadIndex].privateEntries;
+        check(privateEntries.size() == privateStringCount, "a thread lost its private strings");
+        for(std::size_t i = 0; i < privateEntries.size(); i++)
+        {
+            check(*privateEntries[i] == getPrivateString(threadIndex, i),
+                  "wrong text for " + getPrivateString(threadIndex, i));
+            useId(privateEntries[i]);
+        }
+    }
+}
+}
+
+int main()
+{
+    testThreads();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
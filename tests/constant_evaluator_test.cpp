@@ -0,0 +1,190 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../ast/bytecode_compiler.h"
+#include "../ast/bytecode_interpreter.h"
+#include "../ast/constant_evaluator.h"
+#include "../ast/context.h"
+#include "../ast/module.h"
+#include "../ast/name_resolver.h"
+#include "../ast/top_level_module.h"
+#include "../parse/parse_error.h"
+#include "../parse/parser.h"
+#include "../parse/source.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// evaluates the constants of small modules, both directly and through functions compiled to
+// bytecode, and checks their values or the errors they report
+
+namespace
+{
+std::size_t failureCount = 0;
+
+/** returns the value of the const named name in the module body, "not constant", or the error
+ * message */
+std::string evaluateConstant(const std::string &body, const std::string &name)
+{
+    ast::Context context;
+    auto source = parse::Source::makeSourceFromText("module top\n{\n" + body + "\n}\n", "test.hdl");
+    try
+    {
+        auto *tree = parse::parseTopLevelModule(context, source.get());
+        ast::NameResolver nameResolver;
+        nameResolver.resolveAll(tree);
+        ast::ConstantEvaluator constantEvaluator(nameResolver);
+        ast::BytecodeCompiler bytecodeCompiler(constantEvaluator);
+        ast::BytecodeInterpreter bytecodeInterpreter(bytecodeCompiler);
+        constantEvaluator.setFunctionEvaluator(&bytecodeInterpreter);
+        constantEvaluator.evaluateAll(tree);
+        auto *symbol = tree->mainModule->symbolTable->find(context.stringPool.intern(name));
+        auto *value = symbol ? constantEvaluator.getSymbolValue(symbol) : nullptr;
+        if(!value)
+            return "not constant";
+        std::ostringstream ss;
+        ss << value->getValue();
+        return ss.str();
+    }
+    catch(parse::ParseError &e)
+    {
+        return e.what();
+    }
+}
+
+void check(const std::string &body, const std::string &name, const std::string &expected)
+{
+    auto result = evaluateConstant(body, name);
+    if(result == expected)
+        return;
+    failureCount++;
+    std::cerr << "FAIL: " << name << " in:\n" << body << "\ngave: " << result
+              << "\nexpected: " << expected << std::endl;
+}
+
+/** checks that evaluating body reports an error containing message */
+void checkError(const std::string &body, const std::string &message)
+{
+    auto result = evaluateConstant(body, "");
+    if(result.find("error: " + message) != std::string::npos)
+        return;
+    failureCount++;
+    std::cerr << "FAIL: evaluating:\n" << body << "\ngave: " << result
+              << "\nexpected the error: " << message << std::endl;
+}
+
+void testEnums()
+{
+    const char *enumE = R"(
+    enum E : u8
+    {
+        A = 254,
+        B,
+        C = 3,
+        D,
+        F = 255,
+    }
+)";
+    check(std::string(enumE) + "const x = E::B;", "x", "255");
+    check(std::string(enumE) + "const x = E::D;", "x", "4");
+    check(std::string(enumE) + "const x = E::F;", "x", "255");
+    checkError("enum E : u8 { A = 255, B, } const x = E::B;",
+               "enum value doesn't fit in the enum's underlying type");
+    checkError("enum E : u8 { A = 300, } const x = E::A;",
+               "enum value doesn't fit in the enum's underlying type");
+    checkError("enum E : u8 { A = -1, } const x = E::A;",
+               "enum value doesn't fit in the enum's underlying type");
+    checkError("enum E : s8 { A = 127, B, } const x = E::B;",
+               "enum value doesn't fit in the enum's underlying type");
+    check("enum E : s8 { A = -128, B, } const x = E::B;", "x", "-127");
+    // without an underlying type, values widen as needed
+    check("enum E { A = 255, B, } const x = E::B;", "x", "256");
+}
+
+void testSlices()
+{
+    // 165 is 0b1010_0101
+    check("const x = 165[7 to 0];", "x", "165");
+    check("const x = 165[7 to 4];", "x", "10");
+    check("const x = 165[3 to 0];", "x", "5");
+    check("const x = 165[2 to 2];", "x", "1");
+    check("const x = 165[1];", "x", "0");
+    checkError("const x = 165[0 to 7];", "slice indexes are reversed");
+    checkError("const x = 165[9 to 0];", "slice is out of range");
+    const char *functions = R"(
+    function highNibble(v : u8) : u8
+    {
+        return v[7 to 4];
+    }
+    function getBit(v : u8, i : u8) : u8
+    {
+        return v[i];
+    }
+    function reversed(v : u8) : u8
+    {
+        return v[0 to 7];
+    }
+)";
+    check(std::string(functions) + "const x = highNibble(165);", "x", "10");
+    check(std::string(functions) + "const x = getBit(165, 7);", "x", "1");
+    check(std::string(functions) + "const x = getBit(165, 6);", "x", "0");
+    checkError(std::string(functions) + "const x = reversed(165);", "slice indexes are reversed");
+    checkError(std::string(functions) + "const x = getBit(165, 8);", "slice is out of range");
+}
+
+void testFunctionCalls()
+{
+    const char *functions = R"(
+    function nothing()
+    {
+    }
+    function callsNothing() : u8
+    {
+        nothing();
+        return 3;
+    }
+    function count(n : u32) : u32
+    {
+        let c : u32;
+        for(i in n)
+        {
+            c = c + 1;
+            n = 0;
+        }
+        return c;
+    }
+)";
+    check(std::string(functions) + "const x = callsNothing();", "x", "3");
+    check(std::string(functions) + "const x = nothing();", "x", "not constant");
+    check(std::string(functions) + "const x = count(3);", "x", "3");
+}
+}
+
+int main()
+{
+    testEnums();
+    testSlices();
+    testFunctionCalls();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../math/bit_vector.h"
+#include "../math/fixed_bit_vector.h"
+#include "../math/gmp_integer.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// checks math::FixedBitVector against math::BitVector at widths on both sides of the native and
+// multi-limb layouts, with random operands and the values at the edges of each range
+
+namespace
+{
+typedef math::BitVector BitVector;
+typedef BitVector::Kind Kind;
+constexpr std::size_t iterationCount = 2000;
+std::size_t failureCount = 0;
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+/** true if both have the same kind, bit count and sign or zero extended words */
+bool same(const BitVector &a, const BitVector &b) noexcept
+{
+    if(a.getKind() != b.getKind() || a.getBitCount() != b.getBitCount())
+        return false;
+    for(std::size_t i = 0; i < a.getWordCount(); i++)
+        if(a.getWords()[i] != b.getWords()[i])
+            return false;
+    return true;
+}
+
+BitVector fromLong(Kind kind, std::size_t bitCount, long value)
+{
+    return BitVector(kind, bitCount, math::GMPInteger(value));
+}
+
+BitVector makeShiftCount(std::size_t shiftCount)
+{
+    return fromLong(Kind::Unsigned, 32, static_cast<long>(shiftCount));
+}
+
+/** random bits, or one of the values at the edges of the range */
+BitVector makeValue(Kind kind, std::size_t bitCount, std::mt19937_64 &random)
+{
+    auto topBit = BitVector::shiftLeft(
+        kind, bitCount, fromLong(kind, bitCount, 1), makeShiftCount(bitCount - 1));
+    switch(random() % 8)
+    {
+    case 0:
+        return BitVector(kind, bitCount);
+    case 1:
+        return fromLong(kind, bitCount, -1);
+    case 2:
+        return topBit;
+    case 3:
+        return BitVector::subtract(kind, bitCount, topBit, fromLong(kind, bitCount, 1));
+    case 4:
+        return fromLong(kind, bitCount, static_cast<long>(random() % 8));
+    case 5:
+        // a short operand, so wide divisions see small divisors
+        return BitVector::cast(
+            kind, bitCount, fromLong(Kind::Unsigned, 64, static_cast<long>(random())));
+    default:
+        break;
+    }
+    auto retval = fromLong(Kind::Unsigned, 64, static_cast<long>(random()));
+    while(retval.getBitCount() < bitCount)
+        retval = BitVector::concatenate(
+            retval, fromLong(Kind::Unsigned, 64, static_cast<long>(random())));
+    return BitVector::cast(kind, bitCount, retval);
+}
+
+int getSign(int value) noexcept
+{
+    return value < 0 ? -1 : value > 0 ? 1 : 0;
+}
+
+template <std::size_t N, Kind K>
+void testWidth(std::mt19937_64 &random)
+{
+    typedef math::FixedBitVector<N, K> Fixed;
+    typedef math::FixedBitVector<N + 7, Kind::Signed> Wider;
+    typedef math::FixedBitVector<(N + 1) / 2, Kind::Unsigned> Half;
+    auto context = std::string(K == Kind::Signed ? "signed " : "unsigned ") + std::to_string(N)
+                   + " bits: ";
+    for(std::size_t iteration = 0; iteration < iterationCount; iteration++)
+    {
+        auto l = makeValue(K, N, random);
+        auto r = makeValue(K, N, random);
+        Fixed fixedL(l), fixedR(r);
+        check(same(fixedL.toBitVector(), l), context + "round trip");
+        check(fixedL.isNegative() == l.isNegative(), context + "isNegative");
+        check(fixedL.isZero() == l.isZero(), context + "isZero");
+        check(fixedL.popCount() == l.popCount(), context + "popCount");
+        check(same((fixedL + fixedR).toBitVector(), BitVector::add(K, N, l, r)), context + "add");
+        check(same((fixedL - fixedR).toBitVector(), BitVector::subtract(K, N, l, r)),
+              context + "subtract");
+        check(same((-fixedL).toBitVector(), BitVector::negate(K, N, l)), context + "negate");
+        check(same((fixedL * fixedR).toBitVector(), BitVector::multiply(K, N, l, r)),
+              context + "multiply");
+        if(r.isZero())
+        {
+            bool threw = false;
+            try
+            {
+                fixedL / fixedR;
+            }
+            catch(std::domain_error &)
+            {
+                threw = true;
+            }
+            check(threw, context + "dividing by zero didn't throw");
+        }
+        else
+        {
+            check(same((fixedL / fixedR).toBitVector(), BitVector::divide(K, N, l, r)),
+                  context + "divide");
+            check(same((fixedL % fixedR).toBitVector(), BitVector::remainder(K, N, l, r)),
+                  context + "remainder");
+        }
+        check(same((fixedL & fixedR).toBitVector(), BitVector::bitwiseAnd(K, N, l, r)),
+              context + "and");
+        check(same((fixedL | fixedR).toBitVector(), BitVector::bitwiseOr(K, N, l, r)),
+              context + "or");
+        check(same((fixedL ^ fixedR).toBitVector(), BitVector::bitwiseXor(K, N, l, r)),
+              context + "xor");
+        check(same((~fixedL).toBitVector(), BitVector::bitwiseNot(K, N, l)), context + "not");
+        auto shiftCount = random() % (N + 2);
+        check(same((fixedL << shiftCount).toBitVector(),
+                   BitVector::shiftLeft(K, N, l, makeShiftCount(shiftCount))),
+              context + "shiftLeft by " + std::to_string(shiftCount));
+        check(same((fixedL >> shiftCount).toBitVector(),
+                   BitVector::shiftRight(K, N, l, makeShiftCount(shiftCount))),
+              context + "shiftRight by " + std::to_string(shiftCount));
+        auto comparison = getSign(BitVector::compare(l, r));
+        check((fixedL == fixedR) == (comparison == 0), context + "==");
+        check((fixedL != fixedR) == (comparison != 0), context + "!=");
+        check((fixedL < fixedR) == (comparison < 0), context + "<");
+        check((fixedL > fixedR) == (comparison > 0), context + ">");
+        check((fixedL <= fixedR) == (comparison <= 0), context + "<=");
+        check((fixedL >= fixedR) == (comparison >= 0), context + ">=");
+        check(same(Wider(fixedL).toBitVector(), BitVector::cast(Kind::Signed, N + 7, l)),
+              context + "extending cast");
+        auto startBit = random() % N;
+        check(same(fixedL.template slice<Half::bitCount, Kind::Unsigned>(startBit).toBitVector(),
+                   BitVector::slice(Kind::Unsigned, Half::bitCount, l, startBit)),
+              context + "slice at " + std::to_string(startBit));
+        auto smallValue = static_cast<long>(random()) >> (random() % 64);
+        check(same(Fixed(smallValue).toBitVector(),
+                   BitVector(K, N, math::GMPInteger(smallValue))),
+              context + "constructing from " + std::to_string(smallValue));
+    }
+}
+
+template <Kind K>
+void testKind(std::mt19937_64 &random)
+{
+    testWidth<1, K>(random);
+    testWidth<64, K>(random);
+    testWidth<65, K>(random);
+    testWidth<128, K>(random);
+    testWidth<129, K>(random);
+    testWidth<256, K>(random);
+}
+}
+
+int main()
+{
+    std::mt19937_64 random;
+    testKind<Kind::Unsigned>(random);
+    testKind<Kind::Signed>(random);
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../ast/flat_symbol_table.h"
+#include "../ast/symbol_lookup_chain.h"
+#include "../ast/symbol_table.h"
+#include "../util/string_pool.h"
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// checks that ast::FlatSymbolTable finds the same symbols as walking the SymbolLookupChain, while
+// moving between random scopes of a tree, and that popping a scope unshadows its names
+
+namespace
+{
+constexpr std::size_t scopeCount = 60;
+constexpr std::size_t nameCount = 24;
+constexpr std::size_t moveCount = 3000;
+std::size_t failureCount = 0;
+
+class TestSymbol final : public ast::Symbol
+{
+public:
+    explicit TestSymbol(util::StringPool::Entry name) noexcept : Symbol({}, name)
+    {
+    }
+};
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+struct ScopeTree final
+{
+    std::vector<std::unique_ptr<TestSymbol>> symbols;
+    std::vector<std::unique_ptr<ast::SymbolTable>> symbolTables;
+    std::vector<std::unique_ptr<ast::SymbolLookupChainNode>> chainNodes;
+};
+
+/** a random tree of scopes, some holding more symbols than fit inline in a SymbolTable */
+void makeScopeTree(ScopeTree &tree,
+                   const std::vector<util::StringPool::Entry> &names,
+                   std::mt19937_64 &randomEngine)
+{
+    for(std::size_t i = 0; i < scopeCount; i++)
+    {
+        const ast::SymbolLookupChainNode *parent = nullptr;
+        if(i != 0)
+            parent = tree.chainNodes[std::uniform_int_distribution<std::size_t>(0, i - 1)(
+                                         randomEngine)].get();
+        tree.symbolTables.push_back(std::unique_ptr<ast::SymbolTable>(new ast::SymbolTable));
+        auto *symbolTable = tree.symbolTables.back().get();
+        auto symbolCount = std::uniform_int_distribution<std::size_t>(0, 3)(randomEngine) == 0 ?
+                               ast::SymbolTable::inlineCapacity + 4 :
+                               std::uniform_int_distribution<std::size_t>(0, 3)(randomEngine);
+        for(std::size_t j = 0; j < symbolCount; j++)
+        {
+            auto name = names[std::uniform_int_distribution<std::size_t>(0, nameCount - 1)(
+                randomEngine)];
+            tree.symbols.push_back(std::unique_ptr<TestSymbol>(new TestSymbol(name)));
+            if(!symbolTable->insert(tree.symbols.back().get()))
+                tree.symbols.pop_back();
+        }
+        tree.chainNodes.push_back(std::unique_ptr<ast::SymbolLookupChainNode>(
+            new ast::SymbolLookupChainNode(parent, symbolTable)));
+    }
+}
+
+void testChains()
+{
+    util::StringPool stringPool;
+    std::vector<util::StringPool::Entry> names;
+    for(std::size_t i = 0; i < nameCount; i++)
+        names.push_back(stringPool.intern("name" + std::to_string(i)));
+    std::mt19937_64 randomEngine;
+    ScopeTree tree;
+    makeScopeTree(tree, names, randomEngine);
+    ast::FlatSymbolTable flatSymbolTable;
+    for(std::size_t i = 0; i < moveCount; i++)
+    {
+        auto scopeIndex =
+            std::uniform_int_distribution<std::size_t>(0, scopeCount - 1)(randomEngine);
+        ast::SymbolLookupChain chain(tree.chainNodes[scopeIndex].get());
+        flatSymbolTable.enterSymbolLookupChain(chain);
+        std::size_t depth = 0;
+        for(auto *node = chain.head; node; node = node->parent)
+            depth++;
+        check(flatSymbolTable.getScopeDepth() == depth,
+              "wrong scope depth in scope " + std::to_string(scopeIndex));
+        for(auto name : names)
+            check(flatSymbolTable.find(name) == chain.find(name),
+                  "find(" + static_cast<std::string>(*name) + ") is wrong in scope "
+                      + std::to_string(scopeIndex));
+    }
+    check(!flatSymbolTable.find(stringPool.intern("unused")), "found a name never inserted");
+}
+
+void testShadowing()
+{
+    util::StringPool stringPool;
+    auto a = stringPool.intern("a");
+    auto b = stringPool.intern("b");
+    TestSymbol outerA(a), innerA(a), secondInnerA(a), innerB(b);
+    ast::FlatSymbolTable flatSymbolTable;
+    flatSymbolTable.pushScope();
+    check(flatSymbolTable.insert(&outerA), "inserting into an empty scope failed");
+    flatSymbolTable.pushScope();
+    check(flatSymbolTable.insert(&innerA), "shadowing an outer name failed");
+    check(!flatSymbolTable.insert(&secondInnerA), "inserted a name twice in one scope");
+    check(flatSymbolTable.insert(&innerB), "inserting a new name failed");
+    check(flatSymbolTable.find(a) == &innerA, "the inner symbol doesn't shadow the outer one");
+    flatSymbolTable.popScope();
+    check(flatSymbolTable.find(a) == &outerA, "popping didn't unshadow the outer symbol");
+    check(!flatSymbolTable.find(b), "popping didn't remove the inner symbol");
+    flatSymbolTable.popScope();
+    check(!flatSymbolTable.find(a) && flatSymbolTable.getScopeDepth() == 0,
+          "popping every scope didn't empty the table");
+}
+}
+
+int main()
+{
+    testChains();
+    testShadowing();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
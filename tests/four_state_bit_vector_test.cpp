@@ -0,0 +1,280 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../math/four_state_bit_vector.h"
+#include "../math/gmp_integer.h"
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// checks math::FourStateBitVector bit by bit against the four-state truth tables, with random
+// mixes of 0, 1, X and Z on both sides of the inline and heap BitVector sizes
+
+namespace
+{
+typedef math::FourStateBitVector FourStateBitVector;
+typedef FourStateBitVector::Bit Bit;
+typedef FourStateBitVector::Kind Kind;
+typedef std::vector<Bit> Bits;
+constexpr std::size_t iterationCount = 50;
+const std::size_t bitCounts[] = {1, 2, 63, 64, 65, 127, 128, 130, 200};
+std::size_t failureCount = 0;
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+bool isUnknown(Bit bit) noexcept
+{
+    return bit == Bit::X || bit == Bit::Z;
+}
+
+Bit andBit(Bit l, Bit r) noexcept
+{
+    if(l == Bit::Zero || r == Bit::Zero)
+        return Bit::Zero;
+    if(l == Bit::One && r == Bit::One)
+        return Bit::One;
+    return Bit::X;
+}
+
+Bit orBit(Bit l, Bit r) noexcept
+{
+    if(l == Bit::One || r == Bit::One)
+        return Bit::One;
+    if(l == Bit::Zero && r == Bit::Zero)
+        return Bit::Zero;
+    return Bit::X;
+}
+
+Bit xorBit(Bit l, Bit r) noexcept
+{
+    if(isUnknown(l) || isUnknown(r))
+        return Bit::X;
+    return l == r ? Bit::Zero : Bit::One;
+}
+
+Bit notBit(Bit bit) noexcept
+{
+    if(isUnknown(bit))
+        return Bit::X;
+    return bit == Bit::One ? Bit::Zero : Bit::One;
+}
+
+FourStateBitVector fromBit(Bit bit)
+{
+    switch(bit)
+    {
+    case Bit::Zero:
+        return FourStateBitVector(math::BitVector(Kind::Unsigned, 1));
+    case Bit::One:
+        return FourStateBitVector(
+            math::BitVector(Kind::Unsigned, 1, math::GMPInteger(static_cast<long>(1))));
+    case Bit::X:
+        return FourStateBitVector::allX(Kind::Unsigned, 1);
+    case Bit::Z:
+        break;
+    }
+    return FourStateBitVector::allZ(Kind::Unsigned, 1);
+}
+
+/** bits[0] is the least significant bit */
+FourStateBitVector fromBits(Kind kind, const Bits &bits)
+{
+    auto retval = fromBit(bits.back());
+    for(std::size_t i = bits.size() - 1; i-- > 0;)
+        retval = FourStateBitVector::concatenate(retval, fromBit(bits[i]));
+    return FourStateBitVector::cast(kind, bits.size(), retval);
+}
+
+Bits makeRandomBits(std::size_t bitCount, std::mt19937_64 &randomEngine)
+{
+    // some vectors are mostly known, so the reductions see both outcomes
+    auto unknownOdds = std::uniform_int_distribution<int>(0, 3)(randomEngine) == 0 ? 200 : 4;
+    Bits retval;
+    for(std::size_t i = 0; i < bitCount; i++)
+    {
+        if(std::uniform_int_distribution<int>(0, unknownOdds - 1)(randomEngine) != 0)
+            retval.push_back(randomEngine() & 1 ? Bit::One : Bit::Zero);
+        else
+            retval.push_back(randomEngine() & 1 ? Bit::X : Bit::Z);
+    }
+    return retval;
+}
+
+void checkBits(const FourStateBitVector &value, const Bits &expected, const std::string &message)
+{
+    if(value.getBitCount() != expected.size())
+    {
+        check(false, message + ": bit count is " + std::to_string(value.getBitCount()));
+        return;
+    }
+    for(std::size_t i = 0; i < expected.size(); i++)
+    {
+        if(value.getBit(i) != expected[i])
+        {
+            check(false, message + ": bit " + std::to_string(i) + " is wrong");
+            return;
+        }
+    }
+}
+
+void checkBit(const FourStateBitVector &value, Bit expected, const std::string &message)
+{
+    checkBits(value, Bits{expected}, message);
+}
+
+template <typename Fn>
+Bits mapBits(const Bits &l, const Bits &r, Fn fn)
+{
+    Bits retval;
+    for(std::size_t i = 0; i < l.size(); i++)
+        retval.push_back(fn(l[i], r[i]));
+    return retval;
+}
+
+Bit reduce(const Bits &bits, Bit (*fn)(Bit l, Bit r)) noexcept
+{
+    auto retval = bits.front();
+    for(std::size_t i = 1; i < bits.size(); i++)
+        retval = fn(retval, bits[i]);
+    // a single unknown bit still reduces to X
+    return isUnknown(retval) ? Bit::X : retval;
+}
+
+Bit equalBits(const Bits &l, const Bits &r) noexcept
+{
+    bool anyUnknown = false;
+    for(std::size_t i = 0; i < l.size(); i++)
+    {
+        if(isUnknown(l[i]) || isUnknown(r[i]))
+            anyUnknown = true;
+        else if(l[i] != r[i])
+            return Bit::Zero;
+    }
+    return anyUnknown ? Bit::X : Bit::One;
+}
+
+FourStateBitVector makeShiftCount(std::size_t shiftCount)
+{
+    return FourStateBitVector(math::BitVector(
+        Kind::Unsigned, 32, math::GMPInteger(static_cast<long>(shiftCount))));
+}
+
+void testBitCount(Kind kind, std::size_t bitCount, std::mt19937_64 &randomEngine)
+{
+    auto context = std::string(kind == Kind::Signed ? "signed " : "unsigned ")
+                   + std::to_string(bitCount) + " bits";
+    for(std::size_t iteration = 0; iteration < iterationCount; iteration++)
+    {
+        auto lBits = makeRandomBits(bitCount, randomEngine);
+        auto rBits = makeRandomBits(bitCount, randomEngine);
+        auto l = fromBits(kind, lBits);
+        auto r = fromBits(kind, rBits);
+        checkBits(l, lBits, context + ": building the operand");
+        checkBits(FourStateBitVector::bitwiseAnd(kind, bitCount, l, r),
+                  mapBits(lBits, rBits, andBit),
+                  context + ": and");
+        checkBits(FourStateBitVector::bitwiseOr(kind, bitCount, l, r),
+                  mapBits(lBits, rBits, orBit),
+                  context + ": or");
+        checkBits(FourStateBitVector::bitwiseXor(kind, bitCount, l, r),
+                  mapBits(lBits, rBits, xorBit),
+                  context + ": xor");
+        checkBits(FourStateBitVector::bitwiseNot(kind, bitCount, l),
+                  mapBits(lBits, lBits, [](Bit bit, Bit) { return notBit(bit); }),
+                  context + ": not");
+        checkBit(FourStateBitVector::reduceAnd(l), reduce(lBits, andBit), context + ": reduceAnd");
+        checkBit(FourStateBitVector::reduceOr(l), reduce(lBits, orBit), context + ": reduceOr");
+        checkBit(FourStateBitVector::reduceXor(l), reduce(lBits, xorBit), context + ": reduceXor");
+        // compare against a copy with some bits changed, so equal sees more than known differences
+        auto nearBits = lBits;
+        nearBits[std::uniform_int_distribution<std::size_t>(0, bitCount - 1)(randomEngine)] =
+            static_cast<Bit>(randomEngine() % 4);
+        checkBit(FourStateBitVector::equal(l, fromBits(kind, nearBits)),
+                 equalBits(lBits, nearBits),
+                 context + ": equal");
+        checkBit(FourStateBitVector::equal(l, r), equalBits(lBits, rBits), context + ": equal");
+        // shifts and slices move X and Z along unchanged
+        auto shiftCount = std::uniform_int_distribution<std::size_t>(0, bitCount - 1)(randomEngine);
+        Bits shiftedLeft, shiftedRight;
+        for(std::size_t i = 0; i < bitCount; i++)
+        {
+            shiftedLeft.push_back(i < shiftCount ? Bit::Zero : lBits[i - shiftCount]);
+            if(i + shiftCount < bitCount)
+                shiftedRight.push_back(lBits[i + shiftCount]);
+            else
+                shiftedRight.push_back(kind == Kind::Signed ? lBits.back() : Bit::Zero);
+        }
+        checkBits(FourStateBitVector::shiftLeft(kind, bitCount, l, makeShiftCount(shiftCount)),
+                  shiftedLeft,
+                  context + ": shiftLeft");
+        checkBits(FourStateBitVector::shiftRight(kind, bitCount, l, makeShiftCount(shiftCount)),
+                  shiftedRight,
+                  context + ": shiftRight");
+        auto sliceStart = shiftCount;
+        auto sliceBitCount = bitCount - sliceStart;
+        checkBits(FourStateBitVector::slice(Kind::Unsigned, sliceBitCount, l, sliceStart),
+                  Bits(lBits.begin() + sliceStart, lBits.end()),
+                  context + ": slice");
+    }
+}
+
+void testUnknownOperands()
+{
+    auto x = FourStateBitVector::allX(Kind::Unsigned, 8);
+    auto z = FourStateBitVector::allZ(Kind::Unsigned, 8);
+    auto one = FourStateBitVector(
+        math::BitVector(Kind::Unsigned, 8, math::GMPInteger(static_cast<long>(1))));
+    auto zero = FourStateBitVector(math::BitVector(Kind::Unsigned, 8));
+    Bits allX(8, Bit::X);
+    checkBits(FourStateBitVector::add(Kind::Unsigned, 8, one, z), allX, "add with a Z operand");
+    checkBits(FourStateBitVector::multiply(Kind::Unsigned, 8, x, one), allX, "multiply with X");
+    checkBits(FourStateBitVector::divide(Kind::Unsigned, 8, one, zero), allX, "divide by zero");
+    checkBits(FourStateBitVector::shiftLeft(Kind::Unsigned, 8, one, z),
+              allX,
+              "shiftLeft by an unknown count");
+    checkBit(FourStateBitVector::lessThan(one, x), Bit::X, "lessThan with X");
+    check(FourStateBitVector::identical(z, FourStateBitVector::allZ(Kind::Unsigned, 8))
+              && !FourStateBitVector::identical(z, x),
+          "identical doesn't tell X from Z");
+    check(one.getTwoState() && !z.getTwoState(), "getTwoState is wrong");
+}
+}
+
+int main()
+{
+    std::mt19937_64 randomEngine;
+    for(auto kind : {Kind::Unsigned, Kind::Signed})
+        for(auto bitCount : bitCounts)
+            testBitCount(kind, bitCount, randomEngine);
+    testUnknownOperands();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
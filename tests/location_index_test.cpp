@@ -0,0 +1,234 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../ast/context.h"
+#include "../ast/location_index.h"
+#include "../ast/node_field_visitor.h"
+#include "../ast/top_level_module.h"
+#include "../parse/parser.h"
+#include "../parse/source.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// checks ast::LocationIndex against brute-force searches of a parsed module, including that the
+// parser gives every node a range inside its parent's, which the index relies on
+
+namespace
+{
+std::size_t failureCount = 0;
+constexpr std::size_t overlapQueryCount = 2000;
+
+struct TreeNode final
+{
+    const ast::Node *node;
+    const ast::Node *parent;
+    std::size_t depth;
+    std::size_t begin;
+    std::size_t end;
+};
+
+/** lists the nodes in source the same way the index does, with their parents */
+class TreeCollector final : public ast::NodeFieldVisitor
+{
+private:
+    const parse::Source *source;
+    const ast::Node *parent = nullptr;
+    std::size_t depth = 0;
+
+public:
+    std::vector<TreeNode> nodes;
+
+public:
+    explicit TreeCollector(const parse::Source *source) noexcept : source(source)
+    {
+    }
+    virtual void visitNodeKind(ast::NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ast::ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const ast::Node *value) override
+    {
+        if(!value)
+            return;
+        auto &locationRange = value->locationRange;
+        if(locationRange.source != source)
+        {
+            value->visitFields(*this);
+            return;
+        }
+        nodes.push_back(TreeNode{value,
+                                 parent,
+                                 depth,
+                                 locationRange.offset,
+                                 locationRange.offset + locationRange.size});
+        auto savedParent = parent;
+        parent = value;
+        depth++;
+        value->visitFields(*this);
+        depth--;
+        parent = savedParent;
+    }
+    virtual void visitSymbolTable(const ast::SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const ast::SymbolLookupChain &) override
+    {
+    }
+};
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+constexpr auto testSource = R"(module top
+{
+    interface I
+    {
+        input i : bit;
+        output o : u64;
+    }
+    module c!{type T implements I, V : sint!{128}} implements I
+    {
+        input i : bit;
+        output o : u64;
+        reg r = 5 : u64;
+        match(r)
+        {
+            0x?1 =>
+            {
+                r = 23 + r;
+            }
+            0x????_????_????_???? =>
+            {
+                if(cast!{s64}(r) < 0)
+                    r = r * 2;
+                else
+                    r = 43 - 1;
+            }
+        }
+    }
+    const n = 3;
+    function f(a : u8, b : u8) : u8
+    {
+        let t : u8;
+        t = a + b * n;
+        return t[7 to 0];
+    }
+    const g = f(1, 2) == 7;
+}
+)";
+
+void testModule()
+{
+    ast::Context context;
+    auto source = parse::Source::makeSourceFromText(testSource, "test.hdl");
+    auto *tree = parse::parseTopLevelModule(context, source.get());
+    ast::LocationIndex locationIndex(tree);
+    TreeCollector collector(source.get());
+    collector.visitNode(tree);
+    auto &nodes = collector.nodes;
+    check(locationIndex.getEntries().size() == nodes.size(), "the index has the wrong node count");
+    std::unordered_map<const ast::Node *, const TreeNode *> treeNodes;
+    for(auto &node : nodes)
+        treeNodes.emplace(node.node, &node);
+    for(auto &node : nodes)
+    {
+        auto text =
+            static_cast<std::string>(source->text().substr(node.begin, node.end - node.begin));
+        if(node.parent)
+        {
+            auto *parent = treeNodes.at(node.parent);
+            check(parent->begin <= node.begin && node.end <= parent->end,
+                  "a node's range isn't inside its parent's: " + text);
+        }
+        check(locationIndex.getParent(node.node) == node.parent, "wrong parent of " + text);
+        auto index = locationIndex.getIndex(node.node);
+        check(index != ast::LocationIndex::npos
+                  && locationIndex.getEntries()[index].node == node.node,
+              "getIndex is wrong for " + text);
+    }
+    // the innermost node is the deepest one whose non-empty range contains the offset
+    for(std::size_t offset = 0; offset <= source->size(); offset++)
+    {
+        const TreeNode *expected = nullptr;
+        for(auto &node : nodes)
+            if(node.begin <= offset && offset < node.end
+               && (!expected || node.depth > expected->depth))
+                expected = &node;
+        check(locationIndex.findInnermostNode(offset) == (expected ? expected->node : nullptr),
+              "wrong innermost node at offset " + std::to_string(offset));
+    }
+    std::mt19937_64 randomEngine;
+    for(std::size_t i = 0; i < overlapQueryCount; i++)
+    {
+        auto begin = std::uniform_int_distribution<std::size_t>(0, source->size())(randomEngine);
+        auto end = std::min(
+            source->size(),
+            begin + std::uniform_int_distribution<std::size_t>(0, 40)(randomEngine));
+        std::vector<const ast::Node *> expected;
+        for(auto &node : nodes)
+            if(begin < end && node.begin < end && begin < node.end)
+                expected.push_back(node.node);
+        std::vector<const ast::Node *> found;
+        for(auto index : locationIndex.findOverlapping(begin, end))
+            found.push_back(locationIndex.getEntries()[index].node);
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        check(found == expected,
+              "findOverlapping(" + std::to_string(begin) + ", " + std::to_string(end)
+                  + ") is wrong");
+    }
+}
+}
+
+int main()
+{
+    testModule();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../math/gmp_integer.h"
+#include "../math/pattern_set.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// checks math::PatternSet against a brute-force set of every value, for random value/mask
+// patterns on widths small enough to enumerate
+
+namespace
+{
+constexpr std::size_t maxBitCount = 8;
+constexpr std::size_t setsPerBitCount = 40;
+constexpr std::size_t maxPatternsPerSet = 24;
+std::size_t failureCount = 0;
+
+struct Pattern final
+{
+    std::uint64_t value;
+    std::uint64_t mask;
+    math::GMPInteger getValue() const
+    {
+        return math::GMPInteger(static_cast<long>(value));
+    }
+    math::GMPInteger getMask() const
+    {
+        return math::GMPInteger(static_cast<long>(mask));
+    }
+    bool matches(std::uint64_t v) const noexcept
+    {
+        return (v & mask) == value;
+    }
+    std::string toString() const
+    {
+        return "{value " + std::to_string(value) + ", mask " + std::to_string(mask) + "}";
+    }
+};
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+Pattern makeRandomPattern(std::size_t bitCount, std::mt19937_64 &randomEngine)
+{
+    // one bit wider than the set, so some patterns can't match any value
+    std::uint64_t widthMask = (static_cast<std::uint64_t>(2) << bitCount) - 1;
+    Pattern pattern;
+    pattern.mask = randomEngine() & randomEngine() & widthMask;
+    pattern.value = randomEngine() & pattern.mask;
+    if(pattern.value >> bitCount && randomEngine() % 4 != 0)
+        pattern.value &= (static_cast<std::uint64_t>(1) << bitCount) - 1;
+    return pattern;
+}
+
+void testSet(std::size_t bitCount,
+             const std::vector<Pattern> &patterns,
+             bool useMasks,
+             std::mt19937_64 &randomEngine)
+{
+    std::size_t valueCount = static_cast<std::size_t>(1) << bitCount;
+    std::vector<math::GMPInteger> masks;
+    for(auto &pattern : patterns)
+        masks.push_back(pattern.getMask());
+    math::PatternSet set =
+        useMasks ? math::PatternSet(bitCount, masks) : math::PatternSet(bitCount);
+    std::vector<bool> oracle(valueCount, false);
+    auto context = "bitCount " + std::to_string(bitCount) + (useMasks ? " with masks" : "");
+    for(auto &pattern : patterns)
+    {
+        bool covers = true;
+        bool overlaps = false;
+        for(std::uint64_t v = 0; v < valueCount; v++)
+        {
+            if(!pattern.matches(v))
+                continue;
+            covers = covers && oracle[v];
+            overlaps = overlaps || oracle[v];
+        }
+        check(set.covers(pattern.getValue(), pattern.getMask()) == covers,
+              context + ": covers" + pattern.toString());
+        check(set.overlaps(pattern.getValue(), pattern.getMask()) == overlaps,
+              context + ": overlaps" + pattern.toString());
+        set.insert(pattern.getValue(), pattern.getMask());
+        for(std::uint64_t v = 0; v < valueCount; v++)
+            if(pattern.matches(v))
+                oracle[v] = true;
+        bool isFull = true;
+        bool isEmpty = true;
+        std::uint64_t smallestMissing = 0;
+        for(std::uint64_t v = valueCount; v-- > 0;)
+        {
+            if(oracle[v])
+            {
+                isEmpty = false;
+                continue;
+            }
+            isFull = false;
+            smallestMissing = v;
+        }
+        check(set.isFull() == isFull, context + ": isFull");
+        check(set.isEmpty() == isEmpty, context + ": isEmpty");
+        math::GMPInteger missing;
+        bool foundMissing = set.findMissingValue(missing);
+        check(foundMissing == !isFull, context + ": findMissingValue's result");
+        if(foundMissing && !isFull)
+        {
+            auto missingValue = missing.getLowBits(64);
+            check(missingValue < valueCount && !oracle[missingValue],
+                  context + ": findMissingValue gave a value in the set");
+            if(!useMasks)
+                check(missingValue == smallestMissing,
+                      context + ": findMissingValue didn't give the smallest value");
+        }
+        auto probe = randomEngine() & (valueCount - 1);
+        check(set.contains(math::GMPInteger(static_cast<long>(probe))) == oracle[probe],
+              context + ": contains(" + std::to_string(probe) + ")");
+    }
+}
+
+void testStatics(std::size_t bitCount, const Pattern &a, const Pattern &b)
+{
+    std::size_t valueCount = static_cast<std::size_t>(1) << bitCount;
+    bool overlap = false;
+    bool subsumes = true;
+    for(std::uint64_t v = 0; v < valueCount; v++)
+    {
+        overlap = overlap || (a.matches(v) && b.matches(v));
+        subsumes = subsumes && (!b.matches(v) || a.matches(v));
+    }
+    auto context = "bitCount " + std::to_string(bitCount) + ": " + a.toString() + ", "
+                   + b.toString();
+    check(math::PatternSet::patternsOverlap(
+              bitCount, a.getValue(), a.getMask(), b.getValue(), b.getMask())
+              == overlap,
+          context + ": patternsOverlap");
+    check(math::PatternSet::patternSubsumes(
+              bitCount, a.getValue(), a.getMask(), b.getValue(), b.getMask())
+              == subsumes,
+          context + ": patternSubsumes");
+}
+
+void testRandom()
+{
+    std::mt19937_64 randomEngine;
+    for(std::size_t bitCount = 1; bitCount <= maxBitCount; bitCount++)
+    {
+        for(std::size_t i = 0; i < setsPerBitCount; i++)
+        {
+            std::vector<Pattern> patterns;
+            auto patternCount = 1 + randomEngine() % maxPatternsPerSet;
+            for(std::size_t j = 0; j < patternCount; j++)
+                patterns.push_back(makeRandomPattern(bitCount, randomEngine));
+            testSet(bitCount, patterns, false, randomEngine);
+            testSet(bitCount, patterns, true, randomEngine);
+            testStatics(bitCount, patterns.front(), patterns.back());
+        }
+    }
+}
+
+void testMatchAllAndNone()
+{
+    math::PatternSet set(4);
+    check(set.isEmpty() && !set.isFull(), "a new set isn't empty");
+    math::GMPInteger missing;
+    check(set.findMissingValue(missing) && missing.getLowBits(64) == 0,
+          "a new set's missing value isn't 0");
+    set.insert(math::GMPInteger(0L), math::GMPInteger(0L));
+    check(set.isFull(), "a wildcard didn't fill the set");
+    check(!set.findMissingValue(missing), "a full set has a missing value");
+}
+}
+
+int main()
+{
+    testMatchAllAndNone();
+    testRandom();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
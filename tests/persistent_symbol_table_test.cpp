@@ -0,0 +1,189 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../ast/persistent_symbol_table.h"
+#include "../util/string_pool.h"
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// checks PersistentSymbolTable against a std::map with random inserts and erases, including names
+// whose hashes collide partly or completely, and checks that old versions don't change
+
+namespace
+{
+constexpr std::size_t operationCount = 20000;
+std::size_t failureCount = 0;
+
+class TestSymbol final : public ast::Symbol
+{
+public:
+    explicit TestSymbol(util::StringPool::Entry name) noexcept : Symbol({}, name)
+    {
+    }
+};
+
+typedef std::map<std::string, const ast::Symbol *> Oracle;
+
+struct Version final
+{
+    ast::PersistentSymbolTable table;
+    Oracle oracle;
+};
+
+void fail(const std::string &message)
+{
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+void check(const Version &version, const std::vector<util::StringPool::Entry> &names)
+{
+    if(version.table.size() != version.oracle.size())
+        fail("size is " + std::to_string(version.table.size()) + ", expected "
+             + std::to_string(version.oracle.size()));
+    if(version.table.empty() != version.oracle.empty())
+        fail("empty() is wrong");
+    for(auto name : names)
+    {
+        auto iter = version.oracle.find(static_cast<std::string>(*name));
+        auto *expected = iter == version.oracle.end() ? nullptr : std::get<1>(*iter);
+        if(version.table.find(name) != expected)
+            fail("find(" + static_cast<std::string>(*name) + ") is wrong");
+    }
+    std::size_t count = 0;
+    version.table.forEach(
+        [&](const ast::Symbol *symbol)
+        {
+            count++;
+            auto iter = version.oracle.find(static_cast<std::string>(*symbol->name));
+            if(iter == version.oracle.end() || std::get<1>(*iter) != symbol)
+                fail("forEach visited " + static_cast<std::string>(*symbol->name));
+        });
+    if(count != version.oracle.size())
+        fail("forEach visited " + std::to_string(count) + " symbols");
+}
+
+/** these all have the same 64-bit hash, so they end up listed past the last level of the trie */
+const char *const fullyCollidingNames[] = {
+    "2hfyoty3ugxb0xlfdpkk0nywaAp20vdj0wqkwb0",
+    "qyddz2abaksa\xef"
+    "xlfdpkk0nywaAp20vdj0wqkwb0",
+    "2hfyoty3ugxb0pmmtnwyos5saip20vdj0wqkwb0",
+    "qyddz2abaksa\xef"
+    "pmmtnwyos5saip20vdj0wqkwb0",
+    "2hfyoty3ugxb0xlfdpkk0nywaA4xzqtlys3qmaM",
+    "qyddz2abaksa\xef"
+    "xlfdpkk0nywaA4xzqtlys3qmaM",
+    "2hfyoty3ugxb0pmmtnwyos5sai4xzqtlys3qmaM",
+    "qyddz2abaksa\xef"
+    "pmmtnwyos5sai4xzqtlys3qmaM",
+};
+
+std::vector<util::StringPool::Entry> makeNames(util::StringPool &stringPool)
+{
+    std::vector<util::StringPool::Entry> names;
+    for(std::size_t i = 0; i < 200; i++)
+        names.push_back(stringPool.intern("name" + std::to_string(i)));
+    for(auto *name : fullyCollidingNames)
+    {
+        names.push_back(stringPool.intern(name));
+        if(names.back().getHash() != names[200].getHash())
+            fail("fullyCollidingNames don't collide");
+    }
+    // these share the low 20 bits of their hashes, so they only split four levels down
+    constexpr std::size_t partialMask = (static_cast<std::size_t>(1) << 20) - 1;
+    auto partialHash = util::StringPool::hashString("partial0") & partialMask;
+    std::size_t partialCount = 0;
+    for(std::size_t i = 0; partialCount < 16; i++)
+    {
+        auto str = "partial" + std::to_string(i);
+        if((util::StringPool::hashString(str) & partialMask) != partialHash)
+            continue;
+        names.push_back(stringPool.intern(str));
+        partialCount++;
+    }
+    return names;
+}
+
+void testRandom()
+{
+    util::StringPool stringPool;
+    auto names = makeNames(stringPool);
+    std::vector<std::unique_ptr<TestSymbol>> symbols;
+    std::vector<Version> savedVersions;
+    Version current;
+    std::mt19937_64 randomEngine;
+    for(std::size_t i = 0; i < operationCount; i++)
+    {
+        auto name = names[std::uniform_int_distribution<std::size_t>(0, names.size() - 1)(
+            randomEngine)];
+        // erase a bit less often than insert, so the table grows and shrinks
+        if(std::uniform_int_distribution<int>(0, 9)(randomEngine) < 4)
+        {
+            current.table = current.table.erase(name);
+            current.oracle.erase(static_cast<std::string>(*name));
+        }
+        else
+        {
+            symbols.push_back(std::unique_ptr<TestSymbol>(new TestSymbol(name)));
+            current.table = current.table.insert(symbols.back().get());
+            current.oracle[static_cast<std::string>(*name)] = symbols.back().get();
+        }
+        if(i % 97 == 0)
+            check(current, names);
+        if(i % 1000 == 0)
+            savedVersions.push_back(current);
+    }
+    check(current, names);
+    for(auto &version : savedVersions)
+        check(version, names);
+    // erasing everything has to give back the empty table
+    for(auto name : names)
+        current.table = current.table.erase(name);
+    if(!current.table.empty() || current.table != ast::PersistentSymbolTable())
+        fail("erasing every name didn't give an empty table");
+}
+
+void testSharing()
+{
+    util::StringPool stringPool;
+    auto name = stringPool.intern("a");
+    TestSymbol symbol(name);
+    auto table = ast::PersistentSymbolTable().insert(&symbol);
+    if(table.erase(stringPool.intern("b")) != table)
+        fail("erasing a missing name made a new version");
+}
+}
+
+int main()
+{
+    testRandom();
+    testSharing();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../ast/context.h"
+#include "../ast/int_type.h"
+#include "../ast/name_resolver.h"
+#include "../ast/node_field_visitor.h"
+#include "../ast/structural_interner.h"
+#include "../ast/top_level_module.h"
+#include "../parse/parser.h"
+#include "../parse/source.h"
+#include <iostream>
+#include <vector>
+
+// checks that equal types intern to the same canonical node whatever order their parts are
+// interned in
+
+namespace
+{
+std::size_t failureCount = 0;
+
+class UIntTypeCollector final : public ast::NodeFieldVisitor
+{
+public:
+    std::vector<const ast::UIntType *> uIntTypes;
+
+public:
+    virtual void visitNodeKind(ast::NodeKind) override
+    {
+    }
+    virtual void visitLocationRange(const parse::LocationRange &) override
+    {
+    }
+    virtual void visitComments(const ast::ConsecutiveComments &) override
+    {
+    }
+    virtual void visitName(util::StringPool::Entry) override
+    {
+    }
+    virtual void visitBool(bool) override
+    {
+    }
+    virtual void visitInteger(const math::GMPInteger &) override
+    {
+    }
+    virtual void visitArraySize(std::size_t, std::size_t) override
+    {
+    }
+    virtual void visitNode(const ast::Node *value) override
+    {
+        if(!value)
+            return;
+        if(auto *uIntType = dynamic_cast<const ast::UIntType *>(value))
+            uIntTypes.push_back(uIntType);
+        value->visitFields(*this);
+    }
+    virtual void visitSymbolTable(const ast::SymbolTable *) override
+    {
+    }
+    virtual void visitSymbolLookupChain(const ast::SymbolLookupChain &) override
+    {
+    }
+};
+
+void check(bool condition, const char *message)
+{
+    if(condition)
+        return;
+    failureCount++;
+    std::cerr << "FAIL: " << message << std::endl;
+}
+
+void testNamesInTypes()
+{
+    ast::Context context;
+    auto source = parse::Source::makeSourceFromText(R"(module top
+{
+    const n = 8;
+    reg a : uint!{n};
+    reg b : uint!{n};
+}
+)",
+                                                    "test.hdl");
+    auto *tree = parse::parseTopLevelModule(context, source.get());
+    ast::NameResolver nameResolver;
+    nameResolver.resolveAll(tree);
+    UIntTypeCollector collector;
+    collector.visitNode(tree);
+    if(collector.uIntTypes.size() != 2)
+    {
+        check(false, "expected two uint types");
+        return;
+    }
+    ast::StructuralInterner structuralInterner(nameResolver);
+    // a name outside of a type isn't interned, but that mustn't stop the type around it from
+    // being interned later
+    check(!structuralInterner.intern(collector.uIntTypes[0]->bitCount),
+          "a name outside of a type was interned");
+    auto *a = structuralInterner.intern(collector.uIntTypes[0]);
+    auto *b = structuralInterner.intern(collector.uIntTypes[1]);
+    check(a, "a type containing a name wasn't interned");
+    check(a == b, "equal types weren't interned to the same node");
+}
+}
+
+int main()
+{
+    testNamesInTypes();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
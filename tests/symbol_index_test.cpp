@@ -0,0 +1,202 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../parse/symbol_index.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// indexes a small workspace in a temporary directory and checks definitions, references into
+// the same file and into imported files, import queries, and saving and loading the index
+
+namespace
+{
+std::size_t failureCount = 0;
+
+void check(bool condition, const std::string &message)
+{
+    if(condition)
+        return;
+    if(failureCount++ < 20)
+        std::cerr << "FAIL: " << message << std::endl;
+}
+
+class Workspace final
+{
+public:
+    std::string directory;
+    std::vector<std::string> createdFiles;
+
+public:
+    Workspace()
+    {
+        char directoryTemplate[] = "/tmp/symbol_index_test.XXXXXX";
+        if(!::mkdtemp(directoryTemplate))
+        {
+            std::cerr << "can't create a temporary directory" << std::endl;
+            std::exit(1);
+        }
+        directory = directoryTemplate;
+    }
+    Workspace(const Workspace &) = delete;
+    Workspace &operator=(const Workspace &) = delete;
+    ~Workspace()
+    {
+        for(auto &fileName : createdFiles)
+            std::remove(fileName.c_str());
+        ::rmdir(directory.c_str());
+    }
+    std::string getFileName(const std::string &name)
+    {
+        auto retval = directory + "/" + name;
+        createdFiles.push_back(retval);
+        return retval;
+    }
+    /** also notes the interface summary the import loader writes */
+    std::string writeSource(const std::string &name, const std::string &text)
+    {
+        auto retval = getFileName(name + ".hdl");
+        getFileName(name + ".hdli");
+        std::ofstream(retval) << text;
+        return retval;
+    }
+};
+
+/** returns the name of the file holding the definition reference resolves to, or "" */
+std::string getTargetFileName(const parse::SymbolIndex &symbolIndex,
+                              parse::SymbolIndex::Occurrence reference)
+{
+    parse::SymbolIndex::Occurrence target;
+    if(!symbolIndex.findTarget(reference, target))
+        return "";
+    if(symbolIndex.getEntry(target).isReference)
+        return "a reference";
+    return symbolIndex.getFile(target.fileIndex).fileName;
+}
+
+/** checks the queries that don't depend on the order the files were indexed in */
+void checkQueries(const parse::SymbolIndex &symbolIndex,
+                  const std::string &aFileName,
+                  const std::string &bFileName,
+                  const std::string &context)
+{
+    auto &xDefinitions = symbolIndex.findDefinitions("x");
+    check(xDefinitions.size() == 1
+              && symbolIndex.getFile(xDefinitions[0].fileIndex).fileName == bFileName,
+          context + "x isn't defined in b");
+    auto &xReferences = symbolIndex.findReferences("x");
+    check(xReferences.size() == 1
+              && symbolIndex.getFile(xReferences[0].fileIndex).fileName == aFileName,
+          context + "x isn't referenced in a");
+    if(xReferences.size() == 1 && xDefinitions.size() == 1)
+    {
+        check(getTargetFileName(symbolIndex, xReferences[0]) == bFileName,
+              context + "b::x doesn't resolve into b");
+        check(symbolIndex.getEntry(xReferences[0]).kind
+                  == symbolIndex.getEntry(xDefinitions[0]).kind,
+              context + "b::x has the wrong kind");
+    }
+    auto &yReferences = symbolIndex.findReferences("y");
+    check(yReferences.size() == 1 && getTargetFileName(symbolIndex, yReferences[0]) == aFileName,
+          context + "y doesn't resolve in the same file");
+    auto &missingReferences = symbolIndex.findReferences("missing");
+    check(missingReferences.size() == 1
+              && symbolIndex.getEntry(missingReferences[0]).kind == ast::NodeKind::ScopedId
+              && getTargetFileName(symbolIndex, missingReferences[0]).empty(),
+          context + "b::missing resolved");
+    auto imports = symbolIndex.getImports(aFileName);
+    check(imports.size() == 1 && imports[0] == "b", context + "a doesn't import b");
+    auto importers = symbolIndex.findImporters("b");
+    check(importers.size() == 1 && symbolIndex.getFile(importers[0]).fileName == aFileName,
+          context + "b isn't imported by a");
+    check(symbolIndex.searchDefinitions("z").size() == 2,
+          context + "searching for z didn't find z and zz");
+}
+
+void testWorkspace()
+{
+    Workspace workspace;
+    auto aFileName = workspace.writeSource("a", R"(import b;
+
+module a
+{
+    const y = b::x;
+    const z = y;
+    const zz = b::missing;
+}
+)");
+    auto bFileName = workspace.writeSource("b", R"(module b
+{
+    const x = 5;
+}
+)");
+    auto cFileName = workspace.writeSource("c", R"(module c
+{
+    const w = 1;
+}
+)");
+    auto indexFileName = workspace.getFileName("index");
+    workspace.getFileName("index.tmp");
+    parse::SymbolIndex symbolIndex;
+    // a comes before b, so b must be known before a is parsed
+    check(symbolIndex.updateWorkspace({cFileName, aFileName, bFileName}) == 3,
+          "indexing every file didn't change all of them");
+    checkQueries(symbolIndex, aFileName, bFileName, "");
+    check(symbolIndex.updateWorkspace({cFileName, aFileName, bFileName}) == 0,
+          "indexing unchanged files changed them");
+    // removing the first file leaves a gap that saving has to close
+    check(symbolIndex.updateWorkspace({aFileName, bFileName}) == 1, "removing c didn't change it");
+    check(symbolIndex.findDefinitions("w").empty(), "c's definitions are still indexed");
+    checkQueries(symbolIndex, aFileName, bFileName, "after removing c: ");
+    symbolIndex.save(indexFileName);
+    parse::SymbolIndex loadedSymbolIndex;
+    check(loadedSymbolIndex.load(indexFileName), "loading the index failed");
+    checkQueries(loadedSymbolIndex, aFileName, bFileName, "after loading: ");
+    check(loadedSymbolIndex.updateWorkspace({aFileName, bFileName}) == 0,
+          "the loaded index parsed unchanged files again");
+    // a's reference still finds x after b changes and x moves
+    workspace.writeSource("b", R"(module b
+{
+    const v = 4;
+    const x = 5;
+}
+)");
+    check(loadedSymbolIndex.updateWorkspace({aFileName, bFileName}) == 1,
+          "changing b didn't update only b");
+    checkQueries(loadedSymbolIndex, aFileName, bFileName, "after changing b: ");
+    std::ofstream(indexFileName) << "not an index";
+    check(!loadedSymbolIndex.load(indexFileName) && loadedSymbolIndex.getFiles().empty(),
+          "loaded a corrupt index");
+}
+}
+
+int main()
+{
+    testWorkspace();
+    if(failureCount != 0)
+    {
+        std::cerr << failureCount << " checks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
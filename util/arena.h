@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <deque>
 #include <utility>
@@ -29,6 +30,7 @@ class Arena
 {
 private:
     std::deque<std::unique_ptr<void, void (*)(void *object)>> objects;
+    std::size_t objectBytes = 0;
 
 public:
     template <typename T, typename... Args>
@@ -43,7 +45,21 @@ public:
         std::unique_ptr<T> object(new T(std::forward<Args>(args)...));
         T *retval = object.get();
         objectSlot.reset(const_cast<void *>(static_cast<const void *>(object.release())));
+        objectBytes += sizeof(T);
         return retval;
     }
+    std::size_t getObjectCount() const noexcept
+    {
+        return objects.size();
+    }
+    /** the sum of sizeof of the created objects */
+    std::size_t getObjectBytes() const noexcept
+    {
+        return objectBytes;
+    }
+    std::size_t getBookkeepingBytes() const noexcept
+    {
+        return objects.size() * sizeof(objects.front());
+    }
 };
 }
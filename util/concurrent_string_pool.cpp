@@ -0,0 +1,134 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "concurrent_string_pool.h"
+#include <stdexcept>
+
+namespace util
+{
+constexpr std::size_t ConcurrentStringPool::shardIndexBits;
+constexpr std::size_t ConcurrentStringPool::shardCount;
+constexpr std::size_t ConcurrentStringPool::initialSlotCount;
+constexpr std::size_t ConcurrentStringPool::cacheLineSize;
+
+ConcurrentStringPool::Table::Table(std::size_t slotCount)
+    : mask(slotCount - 1), slots(new std::atomic<const StringPoolRecord *>[slotCount])
+{
+    for(std::size_t i = 0; i < slotCount; i++)
+        slots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+const StringPoolRecord *ConcurrentStringPool::Table::find(string_view str,
+                                                          std::size_t hash) const noexcept
+{
+    for(std::size_t index = hash & mask;; index = (index + 1) & mask)
+    {
+        auto *record = slots[index].load(std::memory_order_acquire);
+        if(!record)
+            return nullptr;
+        if(record->hash == hash && record->text == str)
+            return record;
+    }
+}
+
+void ConcurrentStringPool::grow(Shard &shard)
+{
+    auto *oldTable = shard.currentTable.load(std::memory_order_relaxed);
+    std::size_t newSlotCount = oldTable ? (oldTable->mask + 1) * 2 : initialSlotCount;
+    std::unique_ptr<Table> newTable(new Table(newSlotCount));
+    if(oldTable)
+    {
+        for(std::size_t i = 0; i <= oldTable->mask; i++)
+        {
+            auto *record = oldTable->slots[i].load(std::memory_order_relaxed);
+            if(!record)
+                continue;
+            std::size_t index = record->hash & newTable->mask;
+            while(newTable->slots[index].load(std::memory_order_relaxed))
+                index = (index + 1) & newTable->mask;
+            newTable->slots[index].store(record, std::memory_order_relaxed);
+        }
+    }
+    shard.tables.push_back(std::move(newTable));
+    shard.currentTable.store(shard.tables.back().get(), std::memory_order_release);
+}
+
+ConcurrentStringPool::Entry ConcurrentStringPool::intern(string_view str, std::size_t hash)
+{
+    assert(hash == StringPool::hashString(str));
+    auto &shard = shards[getShardIndex(hash)];
+    if(auto *table = shard.currentTable.load(std::memory_order_acquire))
+        if(auto *record = table->find(str, hash))
+            return Entry(record);
+    std::unique_lock<std::mutex> lockIt(shard.mutex);
+    auto *table = shard.currentTable.load(std::memory_order_relaxed);
+    if(table)
+        if(auto *record = table->find(str, hash))
+            return Entry(record);
+    // keep the load factor at most 3/4
+    if(!table || (shard.recordCount + 1) * 4 > (table->mask + 1) * 3)
+    {
+        grow(shard);
+        table = shard.currentTable.load(std::memory_order_relaxed);
+    }
+    auto id = nextId.fetch_add(1, std::memory_order_relaxed);
+    if(id == 0)
+        throw std::length_error("too many strings in ConcurrentStringPool");
+    auto *record = shard.recordAllocator.createRecord(str, hash, id);
+    std::size_t index = hash & table->mask;
+    while(table->slots[index].load(std::memory_order_relaxed))
+        index = (index + 1) & table->mask;
+    table->slots[index].store(record, std::memory_order_release);
+    shard.recordCount++;
+    return Entry(record);
+}
+
+ConcurrentStringPool::Entry ConcurrentStringPool::find(string_view str) const noexcept
+{
+    auto hash = StringPool::hashString(str);
+    auto *table = shards[getShardIndex(hash)].currentTable.load(std::memory_order_acquire);
+    if(!table)
+        return Entry();
+    return Entry(table->find(str, hash));
+}
+
+std::size_t ConcurrentStringPool::size() const
+{
+    std::size_t retval = 0;
+    for(auto &shard : shards)
+    {
+        std::unique_lock<std::mutex> lockIt(shard.mutex);
+        retval += shard.recordCount;
+    }
+    return retval;
+}
+
+std::size_t ConcurrentStringPool::getHeapBytes() const
+{
+    std::size_t retval = 0;
+    for(auto &shard : shards)
+    {
+        std::unique_lock<std::mutex> lockIt(shard.mutex);
+        for(auto &table : shard.tables)
+            retval += sizeof(Table) + (table->mask + 1) * sizeof(table->slots[0]);
+        retval += shard.tables.capacity() * sizeof(shard.tables.front())
+                  + shard.recordAllocator.getHeapBytes();
+    }
+    return retval;
+}
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "string_pool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace util
+{
+/** a StringPool that can be shared by threads. The table is split into shards chosen by the top
+ * bits of the hash, each with its own lock, record allocator and open-addressing table. Looking
+ * up a string that is already interned doesn't lock: the slots are atomic and only go from empty
+ * to full, and a grown table is published atomically while the old one stays alive until the
+ * pool is destroyed. Entries are ordinary StringPoolEntry values, and IDs are handed out from one
+ * atomic counter so they stay dense across shards. */
+class ConcurrentStringPool final
+{
+private:
+    static constexpr std::size_t shardIndexBits = 6;
+    static constexpr std::size_t shardCount = static_cast<std::size_t>(1) << shardIndexBits;
+    static constexpr std::size_t initialSlotCount = 64;
+    static constexpr std::size_t cacheLineSize = 64;
+    struct Table final
+    {
+        std::size_t mask;
+        std::unique_ptr<std::atomic<const StringPoolRecord *>[]> slots;
+        explicit Table(std::size_t slotCount);
+        const StringPoolRecord *find(string_view str, std::size_t hash) const noexcept;
+    };
+    /** aligned so threads working in different shards never share a cache line. Before C++17,
+     * new doesn't honor the alignment, so the shards of a pool allocated with new may not start on
+     * a cache line. */
+    struct alignas(cacheLineSize) Shard final
+    {
+        std::atomic<const Table *> currentTable{nullptr};
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<Table>> tables;
+        std::size_t recordCount = 0;
+        StringPoolRecordAllocator recordAllocator;
+    };
+
+private:
+    Shard shards[shardCount];
+    std::atomic<std::uint32_t> nextId{1};
+
+private:
+    static std::size_t getShardIndex(std::size_t hash) noexcept
+    {
+        return hash >> (sizeof(std::size_t) * 8 - shardIndexBits);
+    }
+    static void grow(Shard &shard);
+
+public:
+    using Entry = StringPoolEntry;
+    ConcurrentStringPool() = default;
+    ConcurrentStringPool(const ConcurrentStringPool &) = delete;
+    ConcurrentStringPool &operator=(const ConcurrentStringPool &) = delete;
+    /** hash must be StringPool::hashString(str) */
+    Entry intern(string_view str, std::size_t hash);
+    Entry intern(string_view str)
+    {
+        return intern(str, StringPool::hashString(str));
+    }
+    /** returns a null entry if str isn't interned; never locks */
+    Entry find(string_view str) const noexcept;
+    std::size_t size() const;
+    std::size_t getHeapBytes() const;
+};
+}
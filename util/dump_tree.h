@@ -289,7 +289,7 @@ private:
     {
         if(!value)
             return "<nullptr>";
-        return *value;
+        return static_cast<std::string>(*value);
     }
     static std::string getNameWithIndex(string_view memberName, std::size_t index)
     {
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memory_mapped_file.h"
+#include <system_error>
+#include <cerrno>
+#include <cstdio>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define UTIL_MEMORY_MAPPED_FILE_USE_MMAP
+#endif
+
+namespace util
+{
+#ifdef UTIL_MEMORY_MAPPED_FILE_USE_MMAP
+struct MemoryMappedFile::Implementation final
+{
+    void *mapping;
+    std::size_t mappingSize;
+    Implementation(void *mapping, std::size_t mappingSize) noexcept : mapping(mapping),
+                                                                      mappingSize(mappingSize)
+    {
+    }
+    ~Implementation()
+    {
+        if(mapping)
+            ::munmap(mapping, mappingSize);
+    }
+};
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::open(const std::string &fileName)
+{
+    struct FileDescriptorCloser final
+    {
+        int fd;
+        ~FileDescriptorCloser()
+        {
+            ::close(fd);
+        }
+    };
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        int error = errno;
+        if(error == ENOENT)
+            return nullptr;
+        throw std::system_error(error, std::generic_category(), "opening " + fileName + " failed");
+    }
+    FileDescriptorCloser fileDescriptorCloser{fd};
+    struct stat statResult;
+    if(::fstat(fd, &statResult) != 0)
+    {
+        int error = errno;
+        throw std::system_error(error, std::generic_category(), "stat of " + fileName + " failed");
+    }
+    std::size_t size = statResult.st_size;
+    if(size == 0)
+        return std::unique_ptr<MemoryMappedFile>(new MemoryMappedFile(
+            std::unique_ptr<Implementation>(new Implementation(nullptr, 0)), nullptr, 0));
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapping == MAP_FAILED)
+    {
+        int error = errno;
+        throw std::system_error(
+            error, std::generic_category(), "memory mapping " + fileName + " failed");
+    }
+    std::unique_ptr<Implementation> implementation(new Implementation(mapping, size));
+    return std::unique_ptr<MemoryMappedFile>(new MemoryMappedFile(
+        std::move(implementation), static_cast<const unsigned char *>(mapping), size));
+}
+#else
+struct MemoryMappedFile::Implementation final
+{
+    std::vector<unsigned char> buffer;
+};
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::open(const std::string &fileName)
+{
+    struct FileCloser
+    {
+        void operator()(std::FILE *file) noexcept
+        {
+            std::fclose(file);
+        }
+    };
+    std::unique_ptr<std::FILE, FileCloser> file(std::fopen(fileName.c_str(), "rb"));
+    if(!file)
+    {
+        int error = errno;
+        if(error == ENOENT)
+            return nullptr;
+        throw std::system_error(error, std::generic_category(), "opening " + fileName + " failed");
+    }
+    std::unique_ptr<Implementation> implementation(new Implementation());
+    unsigned char block[4096];
+    std::size_t readSize;
+    while((readSize = std::fread(block, 1, sizeof(block), file.get())) != 0)
+        implementation->buffer.insert(implementation->buffer.end(), block, block + readSize);
+    if(std::ferror(file.get()))
+    {
+        int error = errno;
+        throw std::system_error(
+            error, std::generic_category(), "reading from " + fileName + " failed");
+    }
+    auto *data = implementation->buffer.data();
+    auto size = implementation->buffer.size();
+    return std::unique_ptr<MemoryMappedFile>(
+        new MemoryMappedFile(std::move(implementation), data, size));
+}
+#endif
+
+MemoryMappedFile::MemoryMappedFile(std::unique_ptr<Implementation> implementation,
+                                   const unsigned char *fileData,
+                                   std::size_t fileSize) noexcept
+    : implementation(std::move(implementation)),
+      fileData(fileData),
+      fileSize(fileSize)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile() = default;
+}
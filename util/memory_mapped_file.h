@@ -0,0 +1,57 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace util
+{
+class MemoryMappedFile final
+{
+private:
+    struct Implementation;
+
+private:
+    std::unique_ptr<Implementation> implementation;
+    const unsigned char *fileData;
+    std::size_t fileSize;
+
+private:
+    MemoryMappedFile(std::unique_ptr<Implementation> implementation,
+                     const unsigned char *fileData,
+                     std::size_t fileSize) noexcept;
+
+public:
+    ~MemoryMappedFile();
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+    const unsigned char *data() const noexcept
+    {
+        return fileData;
+    }
+    std::size_t size() const noexcept
+    {
+        return fileSize;
+    }
+    /** returns nullptr if the file doesn't exist */
+    static std::unique_ptr<MemoryMappedFile> open(const std::string &fileName);
+};
+}
@@ -0,0 +1,55 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace util
+{
+/** estimates the heap bytes owned by standard containers. The estimates assume the libstdc++
+ * layout: hash table nodes hold a next pointer, the value, and a cached hash. */
+template <typename T>
+std::size_t getHeapBytes(const std::vector<T> &value) noexcept
+{
+    return value.capacity() * sizeof(T);
+}
+
+inline std::size_t getHeapBytes(const std::string &value) noexcept
+{
+    auto *data = value.data();
+    auto *object = reinterpret_cast<const char *>(&value);
+    if(!std::less<const char *>()(data, object)
+       && std::less<const char *>()(data, object + sizeof(std::string)))
+        return 0;
+    return value.capacity() + 1;
+}
+
+template <typename HashTable>
+std::size_t getHashTableHeapBytes(const HashTable &value) noexcept
+{
+    return value.bucket_count() * sizeof(void *)
+           + value.size() * (sizeof(typename HashTable::value_type) + 2 * sizeof(void *));
+}
+
+/** returns the peak resident set size of this process in bytes, or 0 if it isn't available */
+std::size_t getPeakResidentSetSize() noexcept;
+}
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2018 Jacob Lifshay
+ *
+ * This file is part of Cpp-HDL.
+ *
+ * Cpp-HDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cpp-HDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "string_pool.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <new>
+
+namespace util
+{
+constexpr std::size_t StringPoolRecordAllocator::chunkSize;
+constexpr std::size_t StringPool::initialSlotCount;
+
+void *StringPoolRecordAllocator::allocate(std::size_t size)
+{
+    constexpr std::size_t alignment = alignof(StringPoolRecord);
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if(size > chunkFreeSize)
+    {
+        std::size_t newChunkSize = size > chunkSize ? size : chunkSize;
+        chunks.emplace_back(new char[newChunkSize]);
+        chunkBytes += newChunkSize;
+        if(newChunkSize != chunkSize)
+            return chunks.back().get();
+        chunkFreeSpace = chunks.back().get();
+        chunkFreeSize = newChunkSize;
+    }
+    void *retval = chunkFreeSpace;
+    chunkFreeSpace += size;
+    chunkFreeSize -= size;
+    return retval;
+}
+
+const StringPoolRecord *StringPoolRecordAllocator::createRecord(string_view str,
+                                                                std::size_t hash,
+                                                                std::uint32_t id)
+{
+    auto *memory = static_cast<char *>(allocate(sizeof(StringPoolRecord) + str.size() + 1));
+    char *text = memory + sizeof(StringPoolRecord);
+    if(!str.empty())
+        std::memcpy(text, str.data(), str.size());
+    text[str.size()] = '\0';
+    return ::new(memory) StringPoolRecord{string_view(text, str.size()), hash, id};
+}
+
+void StringPool::grow()
+{
+    std::size_t newSlotCount = slots.empty() ? initialSlotCount : slots.size() * 2;
+    std::vector<Slot> newSlots(newSlotCount, Slot{0, nullptr});
+    std::size_t mask = newSlotCount - 1;
+    for(auto &slot : slots)
+    {
+        if(!slot.record)
+            continue;
+        std::size_t index = slot.hash & mask;
+        while(newSlots[index].record)
+            index = (index + 1) & mask;
+        newSlots[index] = slot;
+    }
+    slots = std::move(newSlots);
+}
+
+StringPool::Entry StringPool::intern(string_view str, std::size_t hash)
+{
+    assert(hash == hashString(str));
+    // keep the load factor at most 3/4
+    if((records.size() + 1) * 4 > slots.size() * 3)
+        grow();
+    std::size_t mask = slots.size() - 1;
+    std::size_t index = hash & mask;
+    while(true)
+    {
+        auto &slot = slots[index];
+        if(!slot.record)
+            break;
+        if(slot.hash == hash && slot.record->text == str)
+            return Entry(slot.record);
+        index = (index + 1) & mask;
+    }
+    if(records.size() >= std::numeric_limits<std::uint32_t>::max() - 1)
+        throw std::length_error("too many strings in StringPool");
+    auto *record = recordAllocator.createRecord(str, hash, getIdBound());
+    slots[index] = Slot{hash, record};
+    records.push_back(record);
+    return Entry(record);
+}
+
+StringPool::Entry StringPool::find(string_view str) const noexcept
+{
+    if(slots.empty())
+        return Entry();
+    auto hash = hashString(str);
+    std::size_t mask = slots.size() - 1;
+    for(std::size_t index = hash & mask; slots[index].record; index = (index + 1) & mask)
+    {
+        auto &slot = slots[index];
+        if(slot.hash == hash && slot.record->text == str)
+            return Entry(slot.record);
+    }
+    return Entry();
+}
+}
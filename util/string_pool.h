@@ -16,14 +16,15 @@
  * You should have received a copy of the GNU General Public License
  * along with Cpp-HDL.  If not, see <http://www.gnu.org/licenses/>.
  */
-
 #pragma once
 
-#include <unordered_map>
-#include <string>
 #include "string_view.h"
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace util
 {
@@ -43,17 +44,26 @@ namespace util
 {
 class StringPool;
 
+/** an interned string; the text is stored right after the record in the pool's arena */
+struct StringPoolRecord final
+{
+    string_view text;
+    std::size_t hash;
+    std::uint32_t id;
+};
+
 class StringPoolEntry final
 {
     friend class StringPool;
+    friend class ConcurrentStringPool;
     friend std::size_t std::hash<util::StringPoolEntry>::operator()(
         const util::StringPoolEntry &entry) const noexcept;
 
 private:
-    const std::string *value;
+    const StringPoolRecord *value;
 
 private:
-    constexpr explicit StringPoolEntry(const std::string *value) noexcept : value(value)
+    constexpr explicit StringPoolEntry(const StringPoolRecord *value) noexcept : value(value)
     {
     }
 
@@ -65,14 +75,24 @@ public:
     {
         return value != nullptr;
     }
-    const std::string &operator*() const noexcept
+    const string_view &operator*() const noexcept
+    {
+        assert(operator bool());
+        return value->text;
+    }
+    const string_view *operator->() const noexcept
+    {
+        return value ? &value->text : nullptr;
+    }
+    std::size_t getHash() const noexcept
     {
         assert(operator bool());
-        return *value;
+        return value->hash;
     }
-    const std::string *operator->() const noexcept
+    /** the dense ID assigned by the pool, starting at 1; the null entry has ID 0 */
+    std::uint32_t getId() const noexcept
     {
-        return value;
+        return value ? value->id : 0;
     }
     constexpr friend bool operator==(StringPoolEntry a, StringPoolEntry b) noexcept
     {
@@ -84,22 +104,101 @@ public:
     }
 };
 
+/** allocates StringPoolRecords and their text from large chunks that are freed all at once */
+class StringPoolRecordAllocator final
+{
+private:
+    static constexpr std::size_t chunkSize = 16384;
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *chunkFreeSpace = nullptr;
+    std::size_t chunkFreeSize = 0;
+    std::size_t chunkBytes = 0;
+
+private:
+    void *allocate(std::size_t size);
+
+public:
+    const StringPoolRecord *createRecord(string_view str, std::size_t hash, std::uint32_t id);
+    std::size_t getHeapBytes() const noexcept
+    {
+        return chunks.capacity() * sizeof(chunks.front()) + chunkBytes;
+    }
+};
+
+/** interns strings into an open-addressing hash table with linear probing. The records and text
+ * live in large arena chunks, and every slot keeps the full hash so probing only compares text
+ * when the hashes match. Strings get sequential IDs, so tables keyed by name can be arrays
+ * indexed by StringPoolEntry::getId(). */
 class StringPool final
 {
 private:
-    std::unordered_multimap<std::size_t, std::string> strings;
+    struct Slot final
+    {
+        std::size_t hash;
+        const StringPoolRecord *record;
+    };
+    static constexpr std::size_t initialSlotCount = 256;
+
+private:
+    std::vector<Slot> slots;
+    /** indexed by ID - 1 */
+    std::vector<const StringPoolRecord *> records;
+    StringPoolRecordAllocator recordAllocator;
+
+private:
+    void grow();
 
 public:
     using Entry = StringPoolEntry;
+    StringPool() = default;
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+    static constexpr std::size_t hashStart() noexcept
+    {
+        return static_cast<std::size_t>(0xCBF29CE484222325ULL);
+    }
+    static constexpr std::size_t hashStep(std::size_t hash, unsigned char ch) noexcept
+    {
+        return (hash ^ ch) * static_cast<std::size_t>(0x100000001B3ULL);
+    }
+    /** the hash used to intern str; the tokenizer computes it with hashStart and hashStep while
+     * scanning identifiers */
+    static std::size_t hashString(string_view str) noexcept
+    {
+        auto retval = hashStart();
+        for(char ch : str)
+            retval = hashStep(retval, static_cast<unsigned char>(ch));
+        return retval;
+    }
+    /** hash must be hashString(str) */
+    Entry intern(string_view str, std::size_t hash);
     Entry intern(string_view str)
     {
-        auto hash = std::hash<string_view>()(str);
-        auto range = strings.equal_range(hash);
-        for(auto i = std::get<0>(range); i != std::get<1>(range); ++i)
-            if(std::get<1>(*i) == str)
-                return Entry(&std::get<1>(*i));
-        auto iter = strings.emplace(hash, static_cast<std::string>(str));
-        return Entry(&std::get<1>(*iter));
+        return intern(str, hashString(str));
+    }
+    /** returns the null entry if str hasn't been interned */
+    Entry find(string_view str) const noexcept;
+    std::size_t size() const noexcept
+    {
+        return records.size();
+    }
+    /** one more than the largest ID, for sizing arrays indexed by ID */
+    std::uint32_t getIdBound() const noexcept
+    {
+        return static_cast<std::uint32_t>(records.size() + 1);
+    }
+    /** returns the null entry for ID 0 */
+    Entry getEntry(std::uint32_t id) const noexcept
+    {
+        assert(id < getIdBound());
+        return id == 0 ? Entry() : Entry(records[id - 1]);
+    }
+    std::size_t getHeapBytes() const noexcept
+    {
+        return slots.capacity() * sizeof(Slot) + records.capacity() * sizeof(records.front())
+               + recordAllocator.getHeapBytes();
     }
 };
 }
@@ -109,6 +208,6 @@ namespace std
 inline std::size_t hash<util::StringPoolEntry>::operator()(const util::StringPoolEntry &entry) const
     noexcept
 {
-    return hash<const std::string *>()(entry.value);
+    return entry.value ? entry.value->hash : 0;
 }
 }